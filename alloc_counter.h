@@ -0,0 +1,11 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstdint>
+
+// 堆分配计数：alloc_counter.cpp 替换全局的 operator new，统计分配的次数和字节数
+// 只链接到需要检查分配的程序中 (例如 alloc_bench)，游戏本身不链接
+uint64_t getAllocationCount();
+uint64_t getAllocatedBytes();
+
+#endif
@@ -0,0 +1,144 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../alloc_counter.h"
+#include "../board_renderer.h"
+#include "../render_backend.h"
+#include "../terminal_backend.h"
+#include "../simulation.h"
+
+// 稳定运行时的堆分配检查：与 Game::runGame 相同的帧循环 (输入、模拟、事件、绘制、特殊效果计时)，
+// 链接 alloc_counter.cpp 统计每帧的堆分配次数
+// 第一局是预热 (创建蛇身、食物表和定时器节点池)，之后的帧 (包括游戏结束后的重新开始) 都不能分配内存
+
+const int BOARD_WIDTH = WINDOW_WIDTH - 10 * GRID_SIZE;
+const int BOARD_HEIGHT = WINDOW_HEIGHT - 2 * GRID_SIZE;
+const float FRAME_TIME = 1.0f / 30.0f;
+const int FRAMES = 20000;
+// 一局最多的帧数，之后强制重新开始
+const int MAX_GAME_FRAMES = 3000;
+
+struct Scenario
+{
+    const char *name;
+    GameMode mode;
+    MapType map;
+    int foods;
+    uint32_t foodLifetime;
+};
+
+// 随机转向的机器人：每隔几帧选择一个与当前方向垂直的方向
+static Direction chooseDirection(Random &random, Direction current)
+{
+    bool vertical = current == Direction::Up || current == Direction::Down;
+    if (vertical)
+    {
+        return random.nextInt(2) ? Direction::Left : Direction::Right;
+    }
+    return random.nextInt(2) ? Direction::Up : Direction::Down;
+}
+
+// 运行一个场景，返回稳定运行阶段分配了内存的帧数
+static int run(const Scenario &scenario, RenderBackend &backend, const char *backendName)
+{
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    EventBus eventBus;
+    EventBus::Subscription *events = eventBus.subscribe();
+    simulation.setEventBus(&eventBus);
+    simulation.setFoodOptions(scenario.foods, scenario.foodLifetime);
+    BoardRenderer renderer(backend, WINDOW_WIDTH, WINDOW_HEIGHT, BOARD_WIDTH, BOARD_HEIGHT);
+    renderer.renderStaticLayer(std::vector<int>(3, 0));
+
+    Random random(99);
+    uint64_t seed = 1;
+    uint64_t before = getAllocationCount();
+    simulation.reset(scenario.mode, Difficulty::Hard, scenario.map, seed);
+    uint64_t resetAllocations = getAllocationCount() - before;
+
+    bool warm = false;
+    int games = 0;
+    int gameFrames = 0;
+    int measuredFrames = 0;
+    int allocatingFrames = 0;
+    uint64_t steadyAllocations = 0;
+    uint64_t warmupAllocations = 0;
+    Direction direction = Direction::Up;
+    for (int frame = 0; measuredFrames < FRAMES; frame++)
+    {
+        before = getAllocationCount();
+
+        if (frame % 7 == 0)
+        {
+            direction = chooseDirection(random, direction);
+            simulation.addDirectionToQueue(direction, static_cast<uint64_t>(frame));
+        }
+        bool alive = simulation.update(FRAME_TIME);
+        uint64_t inputTime;
+        simulation.takeAppliedInput(inputTime);
+        GameEvent event;
+        while (events->pop(event))
+        {
+            if (event.type == GameEventType::GameOver)
+            {
+                alive = false;
+            }
+        }
+        renderer.renderFrame(simulation);
+        simulation.updateEffects(FRAME_TIME);
+        gameFrames++;
+        if (!alive || gameFrames >= MAX_GAME_FRAMES)
+        {
+            // 重新开始也在计数范围内
+            simulation.reset(scenario.mode, Difficulty::Hard, scenario.map, ++seed);
+            direction = Direction::Up;
+            gameFrames = 0;
+            games++;
+        }
+
+        uint64_t allocations = getAllocationCount() - before;
+        if (!warm)
+        {
+            warmupAllocations += allocations;
+            warm = games > 0;
+            continue;
+        }
+        measuredFrames++;
+        steadyAllocations += allocations;
+        if (allocations > 0)
+        {
+            allocatingFrames++;
+        }
+    }
+
+    std::cout << scenario.name << " / " << backendName << ": 第一次 reset 分配 " << resetAllocations
+              << " 次，第一局 " << warmupAllocations << " 次；之后 " << measuredFrames << " 帧 ("
+              << games - 1 << " 次重新开始) 分配 " << steadyAllocations << " 次，"
+              << allocatingFrames << " 帧有分配" << std::endl;
+    return allocatingFrames;
+}
+
+int main()
+{
+    const Scenario scenarios[] = {
+        {"bounded/empty/1 food", GameMode::Bounded, MapType::Empty, 1, 0},
+        {"unbounded/obstacles/50 foods", GameMode::Unbounded, MapType::Obstacles, 50, 300},
+    };
+    int failures = 0;
+    for (const Scenario &scenario : scenarios)
+    {
+        NullRenderBackend nullBackend;
+        failures += run(scenario, nullBackend, "null");
+        SoftwareRenderBackend softwareBackend(WINDOW_WIDTH, WINDOW_HEIGHT);
+        failures += run(scenario, softwareBackend, "software");
+        TerminalRenderBackend terminalBackend(WINDOW_WIDTH * 2 / GRID_SIZE, WINDOW_HEIGHT / GRID_SIZE, -1);
+        failures += run(scenario, terminalBackend, "terminal");
+    }
+    if (failures > 0)
+    {
+        std::cerr << "稳定运行时有 " << failures << " 帧分配了内存" << std::endl;
+        return 1;
+    }
+    std::cout << "稳定运行时每帧分配 0 次" << std::endl;
+    return 0;
+}
@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_harness.h"
+#include "../simulation.h"
+#include "../sound_mixer.h"
+
+// 音效混音器的测试：
+//   检查叠加、截断、声部替换和队列满时的丢弃
+//   用一个按缓冲区时长定时回调的线程模拟音频设备，游戏线程按 30 FPS 的帧触发音效，
+//   统计不同缓冲区大小下触发到音频回调取出命令的延迟 (以及加上一个缓冲区播放时长后的出声延迟)
+//   每次回调的混音耗时和占音频时长的比例
+
+const int SAMPLE_RATE = 44100;
+const int CHANNELS = 2;
+
+static bool check(bool condition, const char *message)
+{
+    if (!condition)
+    {
+        std::cerr << "检查失败: " << message << std::endl;
+    }
+    return condition;
+}
+
+static bool checkMixing()
+{
+    bool ok = true;
+    {
+        // 一个音效叠加到输出上，结果是两者之和
+        std::vector<int16_t> ramp(1000 * CHANNELS);
+        for (size_t i = 0; i < ramp.size(); i++)
+        {
+            ramp[i] = static_cast<int16_t>(i * 7 % 2000 - 1000);
+        }
+        SoundMixer mixer(SAMPLE_RATE, CHANNELS);
+        mixer.setSamples(SoundEffect::Eat, ramp.data(), 1000);
+        std::vector<int16_t> out(256 * CHANNELS, 100);
+        mixer.trigger(SoundEffect::Eat);
+        mixer.mix(out.data(), 256);
+        bool same = true;
+        for (size_t i = 0; i < out.size(); i++)
+        {
+            same = same && out[i] == ramp[i] + 100;
+        }
+        ok = check(same && mixer.getActiveVoices() == 1, "单个音效") && ok;
+        // 播放完之后声部释放 (1000 帧在第 4 次回调中途结束)
+        for (int i = 0; i < 3; i++)
+        {
+            mixer.mix(out.data(), 256);
+        }
+        ok = check(mixer.getActiveVoices() == 0, "播放完释放声部") && ok;
+    }
+    {
+        // 叠加超出 16 位范围时截断而不是回绕
+        std::vector<int16_t> loud(1024 * CHANNELS, 20000);
+        std::vector<int16_t> quiet(1024 * CHANNELS, -20000);
+        SoundMixer mixer(SAMPLE_RATE, CHANNELS);
+        mixer.setSamples(SoundEffect::Eat, loud.data(), 1024);
+        mixer.setSamples(SoundEffect::Death, quiet.data(), 1024);
+        std::vector<int16_t> out(512 * CHANNELS, 0);
+        mixer.trigger(SoundEffect::Eat);
+        mixer.trigger(SoundEffect::Eat);
+        mixer.mix(out.data(), 512);
+        ok = check(std::all_of(out.begin(), out.end(), [](int16_t v) { return v == 32767; }), "正向截断") && ok;
+        std::fill(out.begin(), out.end(), 0);
+        mixer.trigger(SoundEffect::Death);
+        mixer.trigger(SoundEffect::Death);
+        mixer.trigger(SoundEffect::Death);
+        mixer.trigger(SoundEffect::Death);
+        mixer.mix(out.data(), 512);
+        ok = check(std::all_of(out.begin(), out.end(), [](int16_t v) { return v == -32768; }), "负向截断") && ok;
+    }
+    {
+        // 声部池用完时替换，队列满时丢弃
+        SoundMixer mixer(SAMPLE_RATE, CHANNELS);
+        mixer.synthesize();
+        for (int i = 0; i < SoundMixer::MAX_VOICES + 4; i++)
+        {
+            mixer.trigger(SoundEffect::PowerUp);
+        }
+        std::vector<int16_t> out(256 * CHANNELS, 0);
+        mixer.mix(out.data(), 256);
+        ok = check(mixer.getActiveVoices() == SoundMixer::MAX_VOICES && mixer.getStolen() == 4, "替换声部") && ok;
+        for (size_t i = 0; i < SoundMixer::QUEUE_CAPACITY + 6; i++)
+        {
+            mixer.trigger(SoundEffect::Eat);
+        }
+        ok = check(mixer.getDropped() == 6, "队列满时丢弃") && ok;
+    }
+    return ok;
+}
+
+// 模拟音频设备：每个缓冲区时长回调一次；游戏线程按 30 FPS 的帧在随机的帧触发音效
+static bool measureLatency(int bufferFrames, double seconds)
+{
+    SoundMixer mixer(SAMPLE_RATE, CHANNELS);
+    mixer.synthesize();
+    std::atomic<bool> stop{false};
+    std::thread audio([&]() {
+        std::vector<int16_t> buffer(bufferFrames * CHANNELS);
+        auto period = std::chrono::nanoseconds(static_cast<int64_t>(1e9 * bufferFrames / SAMPLE_RATE));
+        auto next = std::chrono::steady_clock::now();
+        while (!stop.load())
+        {
+            std::this_thread::sleep_until(next);
+            std::fill(buffer.begin(), buffer.end(), 0);
+            mixer.mix(buffer.data(), bufferFrames);
+            next += period;
+        }
+        // 取出剩余的命令
+        mixer.mix(buffer.data(), bufferFrames);
+    });
+
+    Random random(7);
+    auto frame = std::chrono::microseconds(33333);
+    auto next = std::chrono::steady_clock::now();
+    auto end = next + std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(seconds));
+    while (next < end)
+    {
+        // 帧内的处理时间不固定，触发时刻与音频回调的相位随机
+        std::this_thread::sleep_until(next + std::chrono::microseconds(random.nextInt(5000)));
+        if (random.nextInt(2) == 0)
+        {
+            mixer.trigger(static_cast<SoundEffect>(random.nextInt(SOUND_EFFECT_COUNT)));
+        }
+        next += frame;
+    }
+    stop.store(true);
+    audio.join();
+
+    std::vector<double> latencies = mixer.getLatencies();
+    std::sort(latencies.begin(), latencies.end());
+    double bufferMs = 1000.0 * bufferFrames / SAMPLE_RATE;
+    std::cout << "buffer=" << bufferFrames << " (" << bufferMs << " ms): 触发 " << mixer.getTriggered()
+              << ", 回调 " << mixer.getCallbacks() << ", CPU " << mixer.getCpuLoad() * 100.0 << "%" << std::endl;
+    if (latencies.empty())
+    {
+        return check(false, "没有触发音效");
+    }
+    auto percentile = [&latencies](double p) {
+        return latencies[static_cast<size_t>(p * (latencies.size() - 1))];
+    };
+    std::cout << "  触发到回调 (ms): p50 " << percentile(0.5) << ", p99 " << percentile(0.99)
+              << ", 最大 " << latencies.back() << std::endl;
+    // 回调取出后的声音还要在设备中排队一个缓冲区
+    std::cout << "  触发到出声 (ms): p50 " << percentile(0.5) + bufferMs << ", p99 " << percentile(0.99) + bufferMs
+              << std::endl;
+    return check(latencies.size() == mixer.getTriggered() && mixer.getDropped() == 0, "每个触发都被音频回调取出");
+}
+
+// 每次回调的混音耗时
+static void benchMix(BenchSuite &suite, int bufferFrames, int voices)
+{
+    SoundMixer mixer(SAMPLE_RATE, CHANNELS);
+    mixer.synthesize();
+    std::vector<int16_t> buffer(bufferFrames * CHANNELS, 0);
+    // 每轮播放约 0.45 秒，短于最长的音效 (0.6 秒)
+    int iterations = 20000 / bufferFrames;
+    suite.run("mix", "frames=" + std::to_string(bufferFrames) + " voices=" + std::to_string(voices), iterations,
+              [&]() {
+                  // 等上一轮的声部播放完，重新开始 voices 个最长的音效 (每轮播放的长度小于音效长度)
+                  while (mixer.getActiveVoices() > 0)
+                  {
+                      mixer.mix(buffer.data(), bufferFrames);
+                  }
+                  for (int i = 0; i < voices; i++)
+                  {
+                      mixer.trigger(SoundEffect::Death);
+                  }
+                  mixer.mix(buffer.data(), 0);
+              },
+              [&](int) {
+                  mixer.mix(buffer.data(), bufferFrames);
+                  benchKeep(buffer[0]);
+              });
+    double periodNs = 1e9 * bufferFrames / SAMPLE_RATE;
+    std::cout << "  占音频时长 " << std::setprecision(3) << suite.getResults().back().medianNs / periodNs * 100.0 << "%"
+              << std::setprecision(1) << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    std::string jsonPath = argc > 2 && std::string(argv[1]) == "--json" ? argv[2] : "";
+    if (!checkMixing())
+    {
+        return 1;
+    }
+    std::cout << "叠加、截断、声部替换和丢弃检查通过" << std::endl;
+
+    bool ok = true;
+    for (int bufferFrames : {2048, 1024, 512, 256, 128})
+    {
+        ok = measureLatency(bufferFrames, 2.0) && ok;
+    }
+
+    BenchSuite suite;
+    for (int bufferFrames : {256, 2048})
+    {
+        for (int voices : {0, 1, 4, 16})
+        {
+            benchMix(suite, bufferFrames, voices);
+        }
+    }
+    if (!jsonPath.empty() && !suite.writeJson(jsonPath))
+    {
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
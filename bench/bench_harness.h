@@ -0,0 +1,133 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 微基准测试框架：预热之后重复计时若干轮，每轮执行固定次数的操作，
+// 报告每次操作耗时 (纳秒) 的中位数和绝对中位差 (MAD)，结果可以输出为 JSON
+
+// 防止编译器把被测代码当作无用代码删除
+inline void benchKeep(uint64_t value)
+{
+    static volatile uint64_t sink;
+    sink = sink + value;
+}
+
+// 一项测试的结果
+struct BenchResult
+{
+    std::string name;
+    std::string params; // 参数，例如 "length=64 board=40x28"
+    int iterations;     // 每轮的操作次数
+    int runs;           // 计时的轮数
+    double medianNs;    // 每次操作耗时的中位数
+    double madNs;       // 绝对中位差
+};
+
+class BenchSuite
+{
+public:
+    // filter 非空时只运行名字或参数包含 filter 的测试
+    explicit BenchSuite(const std::string &filter = "", int warmupRuns = 3, int runs = 15)
+        : mFilter(filter), mWarmupRuns(warmupRuns), mRuns(runs)
+    {
+    }
+
+    // 每轮开始前调用 setup (不计时)，然后计时执行 iterations 次 op
+    template <typename Setup, typename Op>
+    void run(const std::string &name, const std::string &params, int iterations, Setup setup, Op op)
+    {
+        if (!mFilter.empty() && name.find(mFilter) == std::string::npos && params.find(mFilter) == std::string::npos)
+        {
+            return;
+        }
+        std::vector<double> samples;
+        for (int run = 0; run < mWarmupRuns + mRuns; run++)
+        {
+            setup();
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; i++)
+            {
+                op(i);
+            }
+            double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            if (run >= mWarmupRuns)
+            {
+                samples.push_back(elapsed / iterations);
+            }
+        }
+
+        BenchResult result;
+        result.name = name;
+        result.params = params;
+        result.iterations = iterations;
+        result.runs = mRuns;
+        result.medianNs = median(samples);
+        std::vector<double> deviations;
+        for (double sample : samples)
+        {
+            deviations.push_back(std::fabs(sample - result.medianNs));
+        }
+        result.madNs = median(deviations);
+        mResults.push_back(result);
+
+        std::cout << std::left << std::setw(30) << name << " " << std::setw(44) << params << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(14) << result.medianNs << " ns/op  +- " << result.madNs << std::endl;
+    }
+
+    // 不需要每轮准备的测试
+    template <typename Op>
+    void run(const std::string &name, const std::string &params, int iterations, Op op)
+    {
+        run(name, params, iterations, []() {}, op);
+    }
+
+    const std::vector<BenchResult> &getResults() const
+    {
+        return mResults;
+    }
+
+    // 把所有结果写成 JSON 数组
+    bool writeJson(const std::string &path) const
+    {
+        std::ofstream file(path);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        file << "[\n";
+        for (size_t i = 0; i < mResults.size(); i++)
+        {
+            const BenchResult &result = mResults[i];
+            file << "  {\"name\": \"" << result.name << "\", \"params\": \"" << result.params
+                 << "\", \"iterations\": " << result.iterations << ", \"runs\": " << result.runs
+                 << ", \"median_ns\": " << result.medianNs << ", \"mad_ns\": " << result.madNs << "}"
+                 << (i + 1 < mResults.size() ? ",\n" : "\n");
+        }
+        file << "]\n";
+        return file.good();
+    }
+
+private:
+    std::string mFilter;
+    int mWarmupRuns;
+    int mRuns;
+    std::vector<BenchResult> mResults;
+
+    static double median(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        size_t middle = values.size() / 2;
+        return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+    }
+};
+
+#endif
@@ -0,0 +1,147 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdio>
+#include <sys/stat.h>
+
+#include "../simulation.h"
+#include "../board_renderer.h"
+#include "../frame_capture.h"
+
+// 录像基准测试：软件渲染后端按 30 和 60 FPS 的节奏运行游戏，对比开启录像前后每帧的耗时
+// 以及不限速运行时 (写入线程跟不上) 丢帧的情况，并检查写出的文件大小
+
+using benchClock = std::chrono::steady_clock;
+
+const int SCREEN_WIDTH = WINDOW_WIDTH;
+const int SCREEN_HEIGHT = WINDOW_HEIGHT;
+const int BOARD_WIDTH = WINDOW_WIDTH - 10 * GRID_SIZE;
+const int BOARD_HEIGHT = WINDOW_HEIGHT - 2 * GRID_SIZE;
+
+// 每帧耗时 (毫秒)
+struct FrameTimes
+{
+    double mean = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+// 运行 frames 帧，fps 为 0 时不限速；返回每帧模拟和渲染 (含录像的读回) 的耗时
+static FrameTimes runFrames(FrameCapture *capture, int fps, int frames)
+{
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    simulation.setFoodOptions(20, 0);
+    simulation.reset(GameMode::Unbounded, Difficulty::Easy, MapType::Obstacles, 42);
+    SoftwareRenderBackend backend(SCREEN_WIDTH, SCREEN_HEIGHT);
+    BoardRenderer boardRenderer(backend, SCREEN_WIDTH, SCREEN_HEIGHT, BOARD_WIDTH, BOARD_HEIGHT);
+    boardRenderer.renderStaticLayer(std::vector<int>(3, 0));
+    backend.setFrameCapture(capture);
+
+    std::vector<double> samples;
+    float frameTime = fps > 0 ? 1.0f / fps : 1.0f / 60.0f;
+    auto nextFrame = benchClock::now();
+    for (int i = 0; i < frames; i++)
+    {
+        auto start = benchClock::now();
+        if (!simulation.tick(frameTime))
+        {
+            simulation.reset(GameMode::Unbounded, Difficulty::Easy, MapType::Obstacles, 42 + i);
+        }
+        boardRenderer.renderFrame(simulation);
+        samples.push_back(std::chrono::duration<double, std::milli>(benchClock::now() - start).count());
+        if (fps > 0)
+        {
+            nextFrame += std::chrono::microseconds(1000000 / fps);
+            std::this_thread::sleep_until(nextFrame);
+        }
+    }
+    backend.setFrameCapture(nullptr);
+
+    FrameTimes times;
+    for (double sample : samples)
+    {
+        times.mean += sample;
+    }
+    times.mean /= samples.size();
+    std::sort(samples.begin(), samples.end());
+    times.p99 = samples[samples.size() * 99 / 100];
+    times.max = samples.back();
+    return times;
+}
+
+static long fileSize(const std::string &path)
+{
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? static_cast<long>(info.st_size) : -1;
+}
+
+// 录制 frames 帧并检查文件，返回是否成功
+static bool captureRun(const char *name, int fps, int frames, CaptureFormat format, const std::string &path, const FrameTimes *baseline)
+{
+    FrameCapture capture(SCREEN_WIDTH, SCREEN_HEIGHT, fps > 0 ? fps : 60, format);
+    if (!capture.start(path))
+    {
+        std::cerr << "无法创建录像文件: " << path << std::endl;
+        return false;
+    }
+    FrameTimes times = runFrames(&capture, fps, frames);
+    capture.stop();
+
+    long frameBytes = static_cast<long>(SCREEN_WIDTH) * SCREEN_HEIGHT * 3 + (format == CaptureFormat::Y4m ? 6 : 0);
+    long headerBytes = 0;
+    if (format == CaptureFormat::Y4m)
+    {
+        headerBytes = static_cast<long>(("YUV4MPEG2 W" + std::to_string(SCREEN_WIDTH) + " H" + std::to_string(SCREEN_HEIGHT) +
+                                         " F" + std::to_string(fps > 0 ? fps : 60) + ":1 Ip A1:1 C444\n").size());
+    }
+    long size = fileSize(path);
+    std::remove(path.c_str());
+
+    std::cout << "  " << name << ": frame mean " << times.mean << " ms, p99 " << times.p99 << " ms, max " << times.max << " ms";
+    if (baseline != nullptr)
+    {
+        std::cout << " (overhead mean " << times.mean - baseline->mean << " ms, p99 " << times.p99 - baseline->p99 << " ms)";
+    }
+    std::cout << "; captured " << capture.getCaptured() << ", dropped " << capture.getDropped()
+              << ", written " << capture.getWritten() << std::endl;
+
+    if (capture.hasFailed() || capture.getWritten() != capture.getCaptured() ||
+        capture.getCaptured() + capture.getDropped() != static_cast<uint64_t>(frames) ||
+        size != headerBytes + frameBytes * static_cast<long>(capture.getWritten()))
+    {
+        std::cerr << "录像文件不完整: " << size << " 字节" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    const std::string path = "/tmp/capture_bench.y4m";
+    const int rates[] = {30, 60};
+    for (int fps : rates)
+    {
+        int frames = fps * 3;
+        std::cout << fps << " FPS, " << frames << " frames, " << SCREEN_WIDTH << "x" << SCREEN_HEIGHT << ":" << std::endl;
+        FrameTimes baseline = runFrames(nullptr, fps, frames);
+        std::cout << "  no capture: frame mean " << baseline.mean << " ms, p99 " << baseline.p99 << " ms, max " << baseline.max << " ms" << std::endl;
+        if (!captureRun("y4m", fps, frames, CaptureFormat::Y4m, path, &baseline) ||
+            !captureRun("raw rgb", fps, frames, CaptureFormat::RawRgb, "/tmp/capture_bench.rgb", &baseline))
+        {
+            return 1;
+        }
+    }
+
+    // 不限速：写入线程跟不上，多出来的帧被丢弃，渲染不等待磁盘
+    std::cout << "unpaced, 300 frames:" << std::endl;
+    FrameTimes baseline = runFrames(nullptr, 0, 300);
+    std::cout << "  no capture: frame mean " << baseline.mean << " ms, p99 " << baseline.p99 << " ms, max " << baseline.max << " ms" << std::endl;
+    if (!captureRun("y4m", 0, 300, CaptureFormat::Y4m, path, &baseline))
+    {
+        return 1;
+    }
+    return 0;
+}
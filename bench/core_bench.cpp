@@ -0,0 +1,207 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include "bench_harness.h"
+#include "../snake.h"
+#include "../simulation.h"
+#include "../leader_board.h"
+
+// 核心逻辑的微基准测试：蛇的移动和碰撞检测、生成食物、排行榜
+// 每项测试按蛇的长度和游戏区域大小参数化，make bench 运行全部测试并把结果写入 bench_results.json
+// 用法: core_bench [--json 文件] [--filter 文本] [--quick]
+
+// 游戏区域大小 (格子)
+struct BoardSize
+{
+    int width;
+    int height;
+};
+
+static std::string boardParam(const BoardSize &board)
+{
+    return "board=" + std::to_string(board.width) + "x" + std::to_string(board.height);
+}
+
+// 蛇形排列的蛇身：从左下角开始逐行来回排列，蛇头在最后排到的位置，蛇尾在左下角
+// 返回蛇头的移动方向 (沿着所在行继续前进)
+static Direction serpentineBody(int left, int top, int width, int height, int length, std::vector<SnakeBody> &body)
+{
+    body.assign(length, SnakeBody());
+    for (int k = 0; k < length; k++)
+    {
+        int row = k / width;
+        int column = (row % 2 == 0) ? k % width : width - 1 - k % width;
+        body[length - 1 - k] = SnakeBody(left + column, top + height - 1 - row);
+    }
+    int headRow = (length - 1) / width;
+    return headRow % 2 == 0 ? Direction::Right : Direction::Left;
+}
+
+// 设置好长度和方向的蛇
+static void setupSnake(Snake &snake, const BoardSize &board, int length)
+{
+    std::vector<SnakeBody> body;
+    Direction direction = serpentineBody(0, 0, board.width, board.height, length, body);
+    snake.setBody(body);
+    snake.setDirection(direction);
+    snake.senseFood(NO_CELL);
+}
+
+static void benchSnake(BenchSuite &suite, const BoardSize &board, int length)
+{
+    std::string params = "length=" + std::to_string(length) + " " + boardParam(board);
+    Snake snake(board.width * GRID_SIZE, board.height * GRID_SIZE, 2, GameMode::Bounded);
+    Snake unboundedSnake(board.width * GRID_SIZE, board.height * GRID_SIZE, 2, GameMode::Unbounded);
+
+    // 没有吃到食物的移动：插入蛇头、删除蛇尾
+    suite.run("Snake::moveFoward", params, 1000, [&]() { setupSnake(snake, board, length); },
+              [&](int) { benchKeep(snake.moveFoward()); });
+
+    // 没有撞到自身：扫描整个蛇身
+    setupSnake(snake, board, length);
+    suite.run("Snake::hitSelf", params, 1000, [&](int) { benchKeep(snake.hitSelf()); });
+
+    // 查询游戏区域中伪随机的格子
+    std::vector<SnakeBody> queries;
+    uint32_t state = 12345;
+    for (int i = 0; i < 1024; i++)
+    {
+        state = state * 1664525u + 1013904223u;
+        queries.push_back(SnakeBody((state >> 8) % board.width, (state >> 20) % board.height));
+    }
+    suite.run("Snake::isPartOfSnake", params, 1024,
+              [&](int i) { benchKeep(snake.isPartOfSnake(queries[i].getX(), queries[i].getY())); });
+
+    // 两种模式下蛇头在游戏区域内
+    suite.run("Snake::hitWall", params + " mode=bounded", 10000, [&](int) { benchKeep(snake.hitWall()); });
+    setupSnake(unboundedSnake, board, length);
+    suite.run("Snake::hitWall", params + " mode=unbounded", 10000, [&](int) { benchKeep(unboundedSnake.hitWall()); });
+}
+
+// 蛇占据游戏区域内部 occupancy 比例的格子时生成食物的开销
+static void benchCreateFood(BenchSuite &suite, const BoardSize &board, double occupancy)
+{
+    Simulation simulation(board.width * GRID_SIZE, board.height * GRID_SIZE, 2);
+    simulation.setFoodOptions(1, 0);
+    simulation.reset(GameMode::Bounded, Difficulty::Easy, MapType::Empty, 42);
+    int innerWidth = board.width - 2;
+    int innerHeight = board.height - 2;
+    int length = std::max(2, static_cast<int>(occupancy * innerWidth * innerHeight));
+    std::vector<SnakeBody> body;
+    serpentineBody(1, 1, innerWidth, innerHeight, length, body);
+    simulation.setSnakeBody(body);
+    std::vector<uint8_t> snapshot;
+    simulation.saveSnapshot(snapshot);
+
+    std::string params = "occupancy=" + std::to_string(static_cast<int>(occupancy * 100 + 0.5)) + "% length=" +
+                         std::to_string(length) + " " + boardParam(board);
+    // 每轮从快照恢复，生成的食物数量相对于空格子数量可以忽略
+    suite.run("Simulation::createRamdomFood", params, 32,
+              [&]() { simulation.loadSnapshot(snapshot.data(), snapshot.size()); },
+              [&](int) { benchKeep(simulation.createRamdomFood()); });
+}
+
+// 蛇身占用的内存：紧凑的格子编号与每节保存坐标 (两个 int) 的对比
+static void reportBodyMemory(const BoardSize &board, int length)
+{
+    Snake snake(board.width * GRID_SIZE, board.height * GRID_SIZE, 2, GameMode::Bounded);
+    setupSnake(snake, board, length);
+    size_t cellBytes = snake.getCells().capacity() * sizeof(CellIndex);
+    size_t coordinateBytes = static_cast<size_t>(length) * sizeof(SnakeBody);
+    std::cout << "蛇身内存 length=" << length << " " << boardParam(board) << ": 格子编号 " << cellBytes
+              << " 字节 (每节 " << sizeof(CellIndex) << " 字节)，坐标 " << coordinateBytes << " 字节 (每节 "
+              << sizeof(SnakeBody) << " 字节)" << std::endl;
+}
+
+// 排行榜的更新和写入
+static void benchLeaderBoard(BenchSuite &suite, int leaders)
+{
+    const std::string path = "/tmp/core_bench_record.dat";
+    std::string params = "leaders=" + std::to_string(leaders);
+    LeaderBoard leaderBoard(path, leaders);
+    suite.run("LeaderBoard::update", params, 1000, [&]() { leaderBoard.clear(); },
+              [&](int i) { benchKeep(leaderBoard.update(static_cast<int>((i * 7919u) % 100000u))); });
+    suite.run("LeaderBoard::write", params, 100, [&](int) { benchKeep(leaderBoard.write()); });
+    suite.run("LeaderBoard::read", params, 100, [&](int) { benchKeep(leaderBoard.read()); });
+    suite.run("LeaderBoard::submit", params, 100,
+              [&](int i) { benchKeep(leaderBoard.submit(static_cast<int>((i * 7919u) % 100000u))); });
+    std::remove(path.c_str());
+    std::remove((path + ".lock").c_str());
+}
+
+int main(int argc, char **argv)
+{
+    std::string jsonPath;
+    std::string filter;
+    bool quick = false;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--json" && i + 1 < argc)
+            jsonPath = argv[++i];
+        else if (arg == "--filter" && i + 1 < argc)
+            filter = argv[++i];
+        else if (arg == "--quick")
+            quick = true;
+        else
+        {
+            std::cout << "用法: core_bench [--json 文件] [--filter 文本] [--quick]" << std::endl;
+            return 1;
+        }
+    }
+
+    BenchSuite suite(filter, quick ? 1 : 3, quick ? 5 : 15);
+
+    const BoardSize boards[] = {{40, 28}, {100, 100}, {250, 250}};
+    const int lengths[] = {4, 64, 1024, 16384};
+    for (const BoardSize &board : boards)
+    {
+        for (int length : lengths)
+        {
+            if (length <= board.width * board.height / 2)
+            {
+                benchSnake(suite, board, length);
+            }
+        }
+    }
+
+    if (filter.empty())
+    {
+        reportBodyMemory(BoardSize{250, 250}, 16384);
+    }
+
+    // 占用率越高，随机尝试越容易失败，最后退化为顺序查找空格子
+    const double occupancies[] = {0.0, 0.25, 0.5, 0.75, 0.9, 0.99};
+    for (const BoardSize &board : {BoardSize{40, 28}, BoardSize{100, 100}})
+    {
+        for (double occupancy : occupancies)
+        {
+            // 大区域上 99% 占用时每次生成要扫描上万个格子，单轮耗时过长
+            if (occupancy > 0.95 && board.width * board.height > 2000)
+            {
+                continue;
+            }
+            benchCreateFood(suite, board, occupancy);
+        }
+    }
+
+    const int leaderCounts[] = {3, 10, 100};
+    for (int leaders : leaderCounts)
+    {
+        benchLeaderBoard(suite, leaders);
+    }
+
+    if (!jsonPath.empty())
+    {
+        if (!suite.writeJson(jsonPath))
+        {
+            std::cerr << "无法写入 " << jsonPath << std::endl;
+            return 1;
+        }
+        std::cout << "结果已写入 " << jsonPath << std::endl;
+    }
+    return 0;
+}
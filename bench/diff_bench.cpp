@@ -0,0 +1,479 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../simulation.h"
+#include "../reference_simulation.h"
+
+// 差分测试：参考模型 (ReferenceSimulation) 与 Simulation 的特化移动步骤和通用移动步骤用同样的种子、
+// 设置和随机输入序列同时运行，每一帧之后比较蛇身、方向、得分、等级、速度、累积时间、食物、
+// 特殊效果层数、移动次数和是否结束，并检查 Simulation 增量更新的哈希等于从头计算的哈希
+// 每局随机选择模式、难度、地图、食物数量和寿命、基础速度、每次最多移动的次数和推进的时间；
+// 每帧的输入是一个动作 (方向、暂停或者没有) 和经过的时间 (包括 0 和超过 1/30 秒的卡顿)
+// 发现不一致时把这一局的输入序列缩小 (删除连续的输入段和单个输入，合并相邻的两帧，再把剩下的输入逐个简化)，
+// 打印设置、不一致的字段和缩小后的序列，返回非零
+// 开始之前先给特化版本注入一个差异 (吃到第一个食物之后多一次暂停)，检查能够发现并缩小
+// 用法: diff_bench [--games 局数] [--ticks 每局最多帧数] [--seed 种子]
+
+using benchClock = std::chrono::steady_clock;
+
+const int BOARD_WIDTH = WINDOW_WIDTH - 10 * GRID_SIZE;
+const int BOARD_HEIGHT = WINDOW_HEIGHT - 2 * GRID_SIZE;
+const int INITIAL_LENGTH = 2;
+
+// 一局的设置
+struct GameConfig
+{
+    uint64_t seed = 1;
+    GameMode mode = GameMode::Bounded;
+    Difficulty difficulty = Difficulty::Easy;
+    MapType mapType = MapType::Empty;
+    int foodCount = 1;
+    uint32_t foodLifetime = 0;
+    float speed = 0.0f; // 0 表示使用难度决定的速度
+    int maxMoves = Simulation::DEFAULT_MAX_MOVES_PER_TICK;
+    float maxTickTime = 0.0f; // 0 表示不限制一次 tick 推进的时间
+};
+
+// 一帧的输入：tick 之前的动作和这一帧经过的时间
+const uint8_t ACTION_PAUSE = 4;
+const uint8_t ACTION_NONE = 5;
+struct Input
+{
+    uint8_t action; // 0 到 3 为方向 (Direction)
+    float deltaTime;
+};
+
+// 第一次不一致的帧和字段
+struct Divergence
+{
+    int tick = -1;
+    std::string field;
+};
+
+// 运行的帧数和参考模型移动的步数
+struct Stats
+{
+    long ticks = 0;
+    uint64_t moves = 0;
+};
+
+static GameConfig randomConfig(Random &random, uint64_t seed)
+{
+    GameConfig config;
+    config.seed = seed;
+    config.mode = random.nextInt(2) ? GameMode::Unbounded : GameMode::Bounded;
+    config.difficulty = random.nextInt(2) ? Difficulty::Hard : Difficulty::Easy;
+    config.mapType = random.nextInt(2) ? MapType::Obstacles : MapType::Empty;
+    config.foodCount = 1 + random.nextInt(8);
+    // 寿命很短的食物经常到期，开局的几个食物在同一帧到期
+    config.foodLifetime = random.nextInt(2) ? 0 : 20 + random.nextInt(400);
+    config.speed = random.nextInt(4) == 0 ? 50.0f + random.nextInt(2000) : 0.0f;
+    config.maxMoves = random.nextInt(4) == 0 ? 1 + random.nextInt(8) : Simulation::DEFAULT_MAX_MOVES_PER_TICK;
+    config.maxTickTime = random.nextInt(4) == 0 ? 1.0f / 30.0f : 0.0f;
+    return config;
+}
+
+static std::vector<Input> randomInputs(Random &random, int ticks)
+{
+    std::vector<Input> inputs(ticks);
+    for (Input &input : inputs)
+    {
+        int action = random.nextInt(200);
+        input.action = action < 24 ? static_cast<uint8_t>(action % 4) : (action == 24 ? ACTION_PAUSE : ACTION_NONE);
+        int timing = random.nextInt(10);
+        if (timing < 6)
+        {
+            input.deltaTime = 1.0f / 120.0f;
+        }
+        else if (timing < 8)
+        {
+            input.deltaTime = 1.0f / 60.0f;
+        }
+        else if (timing == 8)
+        {
+            input.deltaTime = 1.0f / 240.0f;
+        }
+        else
+        {
+            input.deltaTime = random.nextInt(50) / 1000.0f;
+        }
+    }
+    return inputs;
+}
+
+template <typename Game>
+static void start(Game &game, const GameConfig &config)
+{
+    game.setFoodOptions(config.foodCount, config.foodLifetime);
+    game.reset(config.mode, config.difficulty, config.mapType, config.seed);
+    if (config.speed > 0.0f)
+    {
+        game.setBaseSpeed(config.speed);
+    }
+    game.setMaxMovesPerTick(config.maxMoves);
+    game.setMaxTickTime(config.maxTickTime);
+}
+
+template <typename Game>
+static void apply(Game &game, const Input &input)
+{
+    if (input.action == ACTION_PAUSE)
+    {
+        game.togglePause();
+    }
+    else if (input.action < 4)
+    {
+        game.addDirectionToQueue(static_cast<Direction>(input.action));
+    }
+    game.tick(input.deltaTime);
+}
+
+// 比较 Simulation 与参考模型，返回第一个不一致的字段 (一致时为空)
+// Simulation 的格子编号在这里转换成坐标，参考模型不使用格子编号
+static const char *compare(const ReferenceSimulation &reference, const Simulation &simulation)
+{
+    const CellGrid &grid = simulation.getGrid();
+    const Snake &actual = simulation.getSnake();
+    const std::deque<ReferenceSimulation::Cell> &body = reference.getBody();
+    const std::vector<CellIndex> &cells = actual.getCells();
+    if (body.size() != cells.size())
+    {
+        return "蛇身";
+    }
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+        if (body[i] != ReferenceSimulation::Cell(grid.getX(cells[i]), grid.getY(cells[i])))
+        {
+            return "蛇身";
+        }
+    }
+    if (reference.getDirection() != actual.getDirection())
+    {
+        return "方向";
+    }
+    if (reference.getPoints() != simulation.getPoints())
+    {
+        return "得分";
+    }
+    if (reference.getDifficulty() != simulation.getDifficulty())
+    {
+        return "等级";
+    }
+    if (reference.isGameOver() != simulation.isGameOver())
+    {
+        return "是否结束";
+    }
+    if (reference.getSpeed() != actual.getSpeed())
+    {
+        return "速度";
+    }
+    if (reference.getAccumulatedTime() != actual.getAccumulatedTime())
+    {
+        return "累积时间";
+    }
+    if (reference.getMoveCount() != simulation.getMoveCount() ||
+        reference.getThrottledTicks() != simulation.getThrottledTicks())
+    {
+        return "移动次数";
+    }
+    for (int type = 0; type < 4; type++)
+    {
+        if (reference.getActiveEffects(static_cast<FoodType>(type)) !=
+            simulation.getActiveEffects(static_cast<FoodType>(type)))
+        {
+            return "特殊效果";
+        }
+    }
+    // 食物按坐标排序后比较 (两边保存食物的顺序不同)
+    const std::vector<ReferenceSimulation::Food> &expectedFoods = reference.getFoods();
+    const std::vector<FoodItem> &actualFoods = simulation.getFoods().getItems();
+    if (expectedFoods.size() != actualFoods.size())
+    {
+        return "食物";
+    }
+    std::vector<std::pair<ReferenceSimulation::Cell, FoodType>> left, right;
+    for (const auto &food : expectedFoods)
+    {
+        left.push_back({food.cell, food.type});
+    }
+    for (const auto &food : actualFoods)
+    {
+        right.push_back({ReferenceSimulation::Cell(grid.getX(food.cell), grid.getY(food.cell)), food.type});
+    }
+    std::sort(left.begin(), left.end());
+    std::sort(right.begin(), right.end());
+    if (left != right)
+    {
+        return "食物";
+    }
+    if (simulation.getHash() != simulation.computeHash())
+    {
+        return "哈希";
+    }
+    return nullptr;
+}
+
+// 按输入序列运行一局，返回第一次不一致的帧；inject 为 true 时特化版本吃到第一个食物之后多暂停一次
+static Divergence runGame(const GameConfig &config, const std::vector<Input> &inputs, bool inject, Stats &stats)
+{
+    ReferenceSimulation reference(BOARD_WIDTH, BOARD_HEIGHT, INITIAL_LENGTH);
+    Simulation specialized(BOARD_WIDTH, BOARD_HEIGHT, INITIAL_LENGTH);
+    Simulation generic(BOARD_WIDTH, BOARD_HEIGHT, INITIAL_LENGTH);
+    generic.setSpecializedStep(false);
+    start(reference, config);
+    start(specialized, config);
+    start(generic, config);
+    bool injected = false;
+
+    Divergence divergence;
+    uint64_t moves = reference.getMoveCount();
+    for (size_t i = 0; i < inputs.size() && divergence.tick < 0 && !reference.isGameOver(); i++)
+    {
+        apply(reference, inputs[i]);
+        apply(specialized, inputs[i]);
+        apply(generic, inputs[i]);
+        if (inject && !injected && specialized.getPoints() > 0)
+        {
+            specialized.togglePause();
+            injected = true;
+        }
+        stats.ticks++;
+        const char *field = compare(reference, specialized);
+        const char *engine = specialized.getStepName();
+        if (field == nullptr)
+        {
+            field = compare(reference, generic);
+            engine = generic.getStepName();
+        }
+        if (field != nullptr)
+        {
+            divergence.tick = static_cast<int>(i);
+            divergence.field = std::string(field) + " (" + engine + ")";
+        }
+    }
+    stats.moves += reference.getMoveCount() - moves;
+    return divergence;
+}
+
+// 输入序列中动作 (方向和暂停) 的个数
+static size_t countActions(const std::vector<Input> &inputs, size_t length)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < length && i < inputs.size(); i++)
+    {
+        count += inputs[i].action != ACTION_NONE ? 1 : 0;
+    }
+    return count;
+}
+
+// 把不一致的输入序列缩小：先截断到不一致的帧，然后删除连续的输入段 (最后一轮逐个删除单个输入)，合并相邻的两帧，
+// 把剩下的输入逐个简化成没有动作和 1/120 秒，重复直到不再变化 (结果是局部最小的序列，不保证最短)。只接受仍然不一致、并且不一致的帧不晚于当前序列的候选，接受后截断到新的不一致的帧，
+// 序列只会变短。一次调用最多推进的时间和最多移动的次数限制了一帧能走多远，合并的帧会被截断，
+// 所以先去掉这两个限制 (改写 config)：推进时间的上限等价于把每帧的时间截断到上限，结果完全相同；
+// 最多移动的次数只在去掉之后仍然不一致时去掉
+static std::vector<Input> shrink(GameConfig &config, std::vector<Input> inputs, bool inject, Stats &stats)
+{
+    if (config.maxTickTime > 0.0f)
+    {
+        for (Input &input : inputs)
+        {
+            input.deltaTime = std::min(input.deltaTime, config.maxTickTime);
+        }
+        config.maxTickTime = 0.0f;
+    }
+    int limit = runGame(config, inputs, inject, stats).tick;
+    inputs.resize(limit + 1);
+    GameConfig unlimited = config;
+    unlimited.maxMoves = Simulation::DEFAULT_MAX_MOVES_PER_TICK;
+    Divergence relaxed = runGame(unlimited, inputs, inject, stats);
+    if (relaxed.tick >= 0 && relaxed.tick <= limit)
+    {
+        config = unlimited;
+        limit = relaxed.tick;
+        inputs.resize(limit + 1);
+    }
+    auto accept = [&](std::vector<Input> &candidate) {
+        Divergence divergence = runGame(config, candidate, inject, stats);
+        if (divergence.tick < 0 || divergence.tick > limit)
+        {
+            return false;
+        }
+        limit = divergence.tick;
+        candidate.resize(limit + 1);
+        inputs.swap(candidate);
+        return true;
+    };
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t chunk = std::max<size_t>(inputs.size() / 2, 1); chunk >= 1; chunk /= 2)
+        {
+            for (size_t first = 0; first < inputs.size();)
+            {
+                std::vector<Input> candidate(inputs.begin(), inputs.begin() + first);
+                candidate.insert(candidate.end(), inputs.begin() + std::min(first + chunk, inputs.size()), inputs.end());
+                if (accept(candidate))
+                {
+                    changed = true;
+                }
+                else
+                {
+                    first += chunk;
+                }
+            }
+        }
+        // 合并相邻的两帧：经过的时间相加，保留其中的动作 (两帧都有动作时不合并)
+        // 删除没有动作的帧会减少经过的时间，蛇到不了原来的位置；合并保持总的时间不变，帧数减少
+        for (size_t i = 0; i + 1 < inputs.size();)
+        {
+            const Input &first = inputs[i];
+            const Input &second = inputs[i + 1];
+            if (first.action != ACTION_NONE && second.action != ACTION_NONE)
+            {
+                i++;
+                continue;
+            }
+            std::vector<Input> candidate(inputs.begin(), inputs.begin() + i);
+            candidate.push_back({first.action != ACTION_NONE ? first.action : second.action,
+                                 first.deltaTime + second.deltaTime});
+            candidate.insert(candidate.end(), inputs.begin() + i + 2, inputs.end());
+            if (accept(candidate))
+            {
+                changed = true;
+            }
+            else
+            {
+                i++;
+            }
+        }
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            for (const Input &simpler : {Input{ACTION_NONE, inputs[i].deltaTime}, Input{inputs[i].action, 1.0f / 120.0f}})
+            {
+                if (simpler.action == inputs[i].action && simpler.deltaTime == inputs[i].deltaTime)
+                {
+                    continue;
+                }
+                std::vector<Input> candidate = inputs;
+                candidate[i] = simpler;
+                if (accept(candidate))
+                {
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+    return inputs;
+}
+
+static void printFailure(const GameConfig &config, const std::vector<Input> &inputs, const Divergence &divergence)
+{
+    static const char *ACTIONS[] = {"Up", "Down", "Left", "Right", "Pause", "-"};
+    std::printf("  设置: 种子 %llu, %s, %s, %s, 食物 %d 个 寿命 %u, 速度 %g, 每次最多移动 %d 次 推进 %g 秒\n",
+                static_cast<unsigned long long>(config.seed),
+                config.mode == GameMode::Bounded ? "有边界" : "无边界",
+                config.difficulty == Difficulty::Easy ? "Easy" : "Hard",
+                config.mapType == MapType::Empty ? "空地图" : "障碍物", config.foodCount, config.foodLifetime,
+                config.speed, config.maxMoves, config.maxTickTime);
+    std::printf("  第 %d 帧之后不一致: %s\n", divergence.tick, divergence.field.c_str());
+    std::printf("  缩小后的输入 (%zu 帧, 动作@经过的时间):", inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        std::printf("%s%s@%g", i % 10 == 0 ? "\n    " : " ", ACTIONS[inputs[i].action], inputs[i].deltaTime);
+    }
+    std::printf("\n");
+}
+
+// 检查差分测试本身：注入的差异能够被发现，并且缩小后的序列仍然不一致，只剩几帧，动作不多于原来
+static bool checkInjected(uint64_t seed)
+{
+    Random random(seed);
+    Stats stats;
+    for (int game = 0; game < 1000; game++)
+    {
+        GameConfig config = randomConfig(random, seed + game);
+        std::vector<Input> inputs = randomInputs(random, 2000);
+        Divergence divergence = runGame(config, inputs, true, stats);
+        if (divergence.tick < 0)
+        {
+            continue;
+        }
+        std::vector<Input> minimal = shrink(config, inputs, true, stats);
+        Divergence after = runGame(config, minimal, true, stats);
+        size_t actions = countActions(inputs, divergence.tick + 1);
+        // 缩小之后只剩几帧 (没有动作的帧都合并掉了)：不超过 16 帧或原来的十分之一
+        size_t expected = std::max<size_t>(16, (divergence.tick + 1) / 10);
+        bool ok = after.tick >= 0 && minimal.size() <= expected && countActions(minimal, minimal.size()) <= actions;
+        std::cout << "注入的差异: 第 " << game << " 局第 " << divergence.tick << " 帧发现 (" << actions
+                  << " 个动作), 缩小到 " << minimal.size() << " 帧 " << countActions(minimal, minimal.size())
+                  << " 个动作" << (ok ? "" : " (错误)") << std::endl;
+        printFailure(config, minimal, after);
+        return ok;
+    }
+    std::cout << "注入的差异没有被发现 (错误)" << std::endl;
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    int games = 2000;
+    int maxTicks = 3000;
+    uint64_t seed = 1;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string name = argv[i];
+        long long value = std::atoll(argv[i + 1]);
+        if (name == "--games")
+        {
+            games = static_cast<int>(std::max(1LL, value));
+        }
+        else if (name == "--ticks")
+        {
+            maxTicks = static_cast<int>(std::max(1LL, value));
+        }
+        else if (name == "--seed")
+        {
+            seed = static_cast<uint64_t>(value);
+        }
+    }
+
+    bool ok = checkInjected(seed + 1000000);
+
+    Random random(seed);
+    Stats stats;
+    auto begin = benchClock::now();
+    for (int game = 0; game < games; game++)
+    {
+        GameConfig config = randomConfig(random, seed * 1000003 + game);
+        std::vector<Input> inputs = randomInputs(random, maxTicks);
+        Divergence divergence = runGame(config, inputs, false, stats);
+        if (divergence.tick >= 0)
+        {
+            std::cout << "第 " << game << " 局不一致, 缩小输入序列..." << std::endl;
+            Stats shrinkStats;
+            std::vector<Input> minimal = shrink(config, inputs, false, shrinkStats);
+            printFailure(config, minimal, runGame(config, minimal, false, shrinkStats));
+            ok = false;
+            break;
+        }
+    }
+    double seconds = std::chrono::duration<double>(benchClock::now() - begin).count();
+    std::printf("%d 局, %ld 帧, %llu 步, 耗时 %.2f 秒, 每分钟 %.1f M 帧 (每帧运行参考模型和两个移动步骤并比较)\n",
+                games, stats.ticks, static_cast<unsigned long long>(stats.moves), seconds,
+                stats.ticks / seconds * 60.0 / 1e6);
+    if (!ok)
+    {
+        std::cerr << "参考模型与 Simulation 的结果不一致" << std::endl;
+    }
+    return ok ? 0 : 1;
+}
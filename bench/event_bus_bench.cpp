@@ -0,0 +1,138 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+#include "../event_bus.h"
+
+// 事件总线基准测试：发布开销、送达的吞吐量，以及消费者变慢时发布是否仍然不阻塞
+// 发布永远不等待消费者，消费者跟不上时大部分事件被丢弃，所以发布的速率不是吞吐量；
+// 吞吐量按消费者实际收到的事件计算，另外用一个等待队列有空位再发布的生产者测量不丢弃时的送达速率
+
+using benchClock = std::chrono::steady_clock;
+
+struct BusResult
+{
+    double publishNanos;    // 平均每个事件的发布耗时 (包括等待空位的时间)
+    double maxPublishNanos; // 单次发布的最大耗时 (每 1024 次采样一次)
+    double seconds;         // 从开始发布到消费者取完所有事件的时间
+    uint64_t consumed;      // 消费者收到的事件总数
+    uint64_t dropped;       // 丢弃的事件总数
+};
+
+// 发布 events 个事件，subscribers 个消费者线程各自取出事件
+// consumerSleepMicros 大于 0 时，消费者每取空一次就休眠，模拟慢速消费者
+// waitForRoom 为 true 时生产者等到每个订阅者的队列都有空位再发布，不丢弃事件
+static BusResult runBus(int subscribers, uint64_t events, int consumerSleepMicros, bool waitForRoom = false)
+{
+    EventBus bus;
+    std::vector<EventBus::Subscription *> subscriptions;
+    for (int i = 0; i < subscribers; i++)
+    {
+        subscriptions.push_back(bus.subscribe());
+    }
+
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> consumed{0};
+    std::vector<std::thread> consumers;
+    for (auto *subscription : subscriptions)
+    {
+        consumers.emplace_back([&, subscription]() {
+            GameEvent event;
+            uint64_t count = 0;
+            while (true)
+            {
+                bool finished = done.load(std::memory_order_acquire);
+                while (subscription->pop(event))
+                {
+                    count++;
+                }
+                if (finished)
+                {
+                    break;
+                }
+                if (consumerSleepMicros > 0)
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(consumerSleepMicros));
+                }
+            }
+            consumed.fetch_add(count);
+        });
+    }
+
+    GameEvent event;
+    event.type = GameEventType::FoodEaten;
+    double maxNanos = 0.0;
+    auto start = benchClock::now();
+    for (uint64_t i = 0; i < events; i++)
+    {
+        event.value = static_cast<int32_t>(i);
+        if (waitForRoom)
+        {
+            for (auto *subscription : subscriptions)
+            {
+                while (subscription->size() >= EventBus::QUEUE_CAPACITY)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        if ((i & 1023) == 0)
+        {
+            auto before = benchClock::now();
+            bus.publish(event);
+            maxNanos = std::max(maxNanos, std::chrono::duration<double, std::nano>(benchClock::now() - before).count());
+        }
+        else
+        {
+            bus.publish(event);
+        }
+    }
+    double publishNanos = std::chrono::duration<double, std::nano>(benchClock::now() - start).count();
+    done.store(true, std::memory_order_release);
+    for (auto &consumer : consumers)
+    {
+        consumer.join();
+    }
+    double seconds = std::chrono::duration<double>(benchClock::now() - start).count();
+    return {publishNanos / events, maxNanos, seconds, consumed.load(), bus.getDropped()};
+}
+
+// 发布耗时只说明发布不阻塞；送达的吞吐量是所有订阅者实际收到的事件数除以时间
+static void printResult(const char *name, int subscribers, uint64_t events, const BusResult &result)
+{
+    std::cout << name << ": subscribers " << subscribers << ", events " << events
+              << ", publish " << result.publishNanos << " ns/event, max sampled publish "
+              << result.maxPublishNanos << " ns";
+    if (subscribers > 0)
+    {
+        uint64_t offered = events * subscribers;
+        std::cout << ", delivered " << result.consumed << " (" << result.consumed / result.seconds / 1e6
+                  << " M events/s), dropped " << result.dropped << " (" << 100.0 * result.dropped / offered
+                  << "%)";
+    }
+    std::cout << std::endl;
+}
+
+int main()
+{
+    const uint64_t events = 10000000;
+    printResult("no subscribers", 0, events, runBus(0, events, 0));
+    // 生产者不等待：消费者跟不上时队列满，多出的事件被丢弃
+    for (int subscribers : {1, 2, 4})
+    {
+        printResult("spinning consumers", subscribers, events, runBus(subscribers, events, 0));
+    }
+    // 生产者等待空位：没有丢弃，送达的速率就是队列的吞吐量 (核数少时生产者和消费者轮流运行，事件数减少)
+    const uint64_t losslessEvents = events / 10;
+    for (int subscribers : {1, 2, 4})
+    {
+        printResult("lossless (publisher waits for room)", subscribers, losslessEvents,
+                    runBus(subscribers, losslessEvents, 0, true));
+    }
+    // 慢速消费者：队列满时丢弃事件，发布耗时不受影响
+    printResult("slow consumer (1 ms)", 1, events, runBus(1, events, 1000));
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+
+#include "../simulation.h"
+
+// 多食物基准测试：大游戏区域上 1、100、10000 个食物时
+// 按格子查找食物与线性扫描的对比，以及批量生成和到期的开销
+// 同时检查格子索引始终与食物列表一致
+
+using benchClock = std::chrono::steady_clock;
+
+// 大游戏区域 (格子数)，16 位格子编号能表示的最大区域
+const int BOARD_CELLS_X = 254;
+const int BOARD_CELLS_Y = 254;
+
+static double elapsedNanos(benchClock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(benchClock::now() - start).count();
+}
+
+// 检查每个食物都能通过格子找到，并且食物数量与有食物的格子数相同
+static bool consistent(const FoodManager &foods, const CellGrid &grid)
+{
+    size_t occupied = 0;
+    for (int y = 0; y < grid.getRows(); y++)
+    {
+        for (int x = 0; x < grid.getColumns(); x++)
+        {
+            occupied += foods.find(grid.toCell(x, y)) != nullptr;
+        }
+    }
+    for (const auto &item : foods.getItems())
+    {
+        const FoodItem *found = foods.find(item.cell);
+        if (found == nullptr || found->cell != item.cell || found->type != item.type)
+        {
+            return false;
+        }
+    }
+    return occupied == foods.size();
+}
+
+// 查找开销：格子索引与线性扫描
+static bool benchLookup(int count)
+{
+    const CellGrid grid(BOARD_CELLS_X, BOARD_CELLS_Y);
+    FoodManager foods;
+    foods.resize(grid);
+    std::vector<CellIndex> list;
+    Random random(count);
+    while (static_cast<int>(foods.size()) < count)
+    {
+        CellIndex food = grid.toCell(random.nextInt(BOARD_CELLS_X), random.nextInt(BOARD_CELLS_Y));
+        if (foods.add(food, FoodType::Normal))
+        {
+            list.push_back(food);
+        }
+    }
+
+    const int lookups = 1000000;
+    std::vector<CellIndex> heads;
+    for (int i = 0; i < 4096; i++)
+    {
+        heads.push_back(grid.toCell(random.nextInt(BOARD_CELLS_X), random.nextInt(BOARD_CELLS_Y)));
+    }
+
+    size_t hitsIndexed = 0;
+    auto start = benchClock::now();
+    for (int i = 0; i < lookups; i++)
+    {
+        hitsIndexed += foods.find(heads[i & 4095]) != nullptr;
+    }
+    double indexedNanos = elapsedNanos(start) / lookups;
+
+    // 线性扫描太慢，食物很多时减少查找次数
+    const int scans = count >= 10000 ? 10000 : lookups;
+    size_t hitsScan = 0;
+    size_t hitsCheck = 0;
+    start = benchClock::now();
+    for (int i = 0; i < scans; i++)
+    {
+        CellIndex head = heads[i & 4095];
+        for (CellIndex food : list)
+        {
+            if (food == head)
+            {
+                hitsScan++;
+                break;
+            }
+        }
+    }
+    double scanNanos = elapsedNanos(start) / scans;
+    for (int i = 0; i < scans; i++)
+    {
+        hitsCheck += foods.find(heads[i & 4095]) != nullptr;
+    }
+    if (hitsScan != hitsCheck)
+    {
+        std::cerr << "格子索引与线性扫描结果不一致" << std::endl;
+        return false;
+    }
+
+    std::cout << "lookup foods " << count << ": indexed " << indexedNanos << " ns, linear scan "
+              << scanNanos << " ns (hits " << hitsIndexed << ")" << std::endl;
+    return true;
+}
+
+// 批量生成 (包括 reset 本身的开销) 和到期：每个食物寿命 1 秒，到期后立即补充
+static bool benchSpawnExpiry(int count)
+{
+    Simulation simulation(BOARD_CELLS_X * GRID_SIZE, BOARD_CELLS_Y * GRID_SIZE, 2);
+    simulation.setFoodOptions(count, 100);
+    auto start = benchClock::now();
+    simulation.reset(GameMode::Unbounded, Difficulty::Easy, MapType::Empty, 7);
+    double spawnNanos = elapsedNanos(start);
+
+    // 暂停蛇，只推进时间，食物到期后重新生成
+    simulation.togglePause();
+    const int ticks = 1000;
+    start = benchClock::now();
+    for (int i = 0; i < ticks; i++)
+    {
+        simulation.updateEffects(EFFECT_TICK_SECONDS * 1.001f);
+    }
+    double tickNanos = elapsedNanos(start) / ticks;
+
+    const FoodManager &foods = simulation.getFoods();
+    if (static_cast<int>(foods.size()) != count ||
+        !consistent(foods, simulation.getGrid()))
+    {
+        std::cerr << "食物数量或格子索引错误: " << foods.size() << std::endl;
+        return false;
+    }
+
+    std::cout << "reset with " << count << " foods: " << spawnNanos / 1000.0 << " us ("
+              << spawnNanos / count << " ns/food), expiry and respawn " << tickNanos / 1000.0
+              << " us/tick (average over " << ticks << " ticks)" << std::endl;
+    return true;
+}
+
+// 在普通大小的游戏区域上用多个会到期的食物跑一段时间，检查食物始终补满
+static bool verifyGameplay()
+{
+    Simulation simulation(WINDOW_WIDTH - 10 * GRID_SIZE, WINDOW_HEIGHT - 2 * GRID_SIZE, 2);
+    simulation.setFoodOptions(50, 200);
+    simulation.reset(GameMode::Unbounded, Difficulty::Easy, MapType::Empty, 3);
+    Random inputs(5);
+    const Direction directions[] = {Direction::Up, Direction::Left, Direction::Down, Direction::Right};
+    for (int tick = 0; tick < 5000 && !simulation.isGameOver(); tick++)
+    {
+        if (inputs.nextInt(8) == 0)
+        {
+            simulation.addDirectionToQueue(directions[inputs.nextInt(4)]);
+        }
+        simulation.tick(0.05f);
+        const FoodManager &foods = simulation.getFoods();
+        if (foods.size() != 50 || !consistent(foods, simulation.getGrid()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    if (!verifyGameplay())
+    {
+        std::cerr << "多食物游戏过程中食物状态错误" << std::endl;
+        return 1;
+    }
+    for (int count : {1, 100, 10000})
+    {
+        if (!benchLookup(count) || !benchSpawnExpiry(count))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "../simulation.h"
+
+// 输入延迟测量：用虚拟时钟模拟 Game::runGame 的主循环 (每帧开始时处理输入，帧末提交画面)
+// 在随机时刻产生按键，统计按键到蛇移动、按键到画面提交的延迟分位数
+// 对比两种主循环：
+//   旧：50 ms 的逻辑门，只在门打开时用本帧的时间推进模拟，帧间隔为 "目标帧时间 - 上一帧间隔"
+//   新：每帧都用实际经过的时间推进模拟，帧间隔为 "目标帧时间 - 本帧处理时间"
+
+// 游戏区域 (像素)，与 Game 相同
+const int BOARD_WIDTH = WINDOW_WIDTH - 10 * GRID_SIZE;
+const int BOARD_HEIGHT = WINDOW_HEIGHT - 2 * GRID_SIZE;
+
+// 时间单位：微秒
+const uint64_t FRAME_TIME = 33333;   // 目标帧率 30 FPS
+const uint64_t LOGIC_GATE = 50000;   // 逻辑更新间隔
+const uint64_t FRAME_WORK = 2000;    // 每帧的处理和渲染时间
+const uint64_t KEY_INTERVAL = 250000; // 平均按键间隔
+const uint64_t DURATION = 120000000; // 模拟 120 秒
+
+struct LatencyResult
+{
+    std::vector<double> move;    // 按键到移动 (毫秒)
+    std::vector<double> present; // 按键到画面提交 (毫秒)
+    int keys = 0;
+    int frames = 0;
+    int resets = 0; // 游戏结束重新开始的次数，输入缓冲中的按键随之丢弃
+};
+
+static void printPercentiles(const char *name, std::vector<double> samples)
+{
+    if (samples.empty())
+    {
+        std::cout << "  " << name << ": 没有样本" << std::endl;
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) {
+        return samples[static_cast<size_t>(p * (samples.size() - 1))];
+    };
+    std::cout << "  " << name << " (ms): 样本 " << samples.size() << ", p50 " << percentile(0.5)
+              << ", p90 " << percentile(0.9) << ", p99 " << percentile(0.99)
+              << ", 最大 " << samples.back() << std::endl;
+}
+
+// 与当前方向垂直的随机方向，保证按键不会因为掉头而被拒绝
+static Direction perpendicular(Direction direction, Random &random)
+{
+    bool vertical = direction == Direction::Up || direction == Direction::Down;
+    if (vertical)
+    {
+        return random.nextInt(2) ? Direction::Left : Direction::Right;
+    }
+    return random.nextInt(2) ? Direction::Up : Direction::Down;
+}
+
+static LatencyResult run(Difficulty difficulty, bool newLoop)
+{
+    LatencyResult result;
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    simulation.reset(GameMode::Unbounded, difficulty, MapType::Empty, 11);
+    Random random(17);
+
+    uint64_t now = 0;
+    uint64_t lastFrame = 0;
+    uint64_t lastLogic = 0;
+    uint64_t nextKey = random.nextInt(2 * KEY_INTERVAL);
+    Direction lastKey = Direction::Up;
+    std::vector<uint64_t> pending;
+    while (now < DURATION)
+    {
+        uint64_t frameStart = now;
+        uint64_t delta = frameStart - lastFrame;
+        lastFrame = frameStart;
+
+        // 处理到达的按键
+        while (nextKey <= frameStart)
+        {
+            lastKey = perpendicular(lastKey, random);
+            simulation.addDirectionToQueue(lastKey, nextKey);
+            result.keys++;
+            nextKey += random.nextInt(2 * KEY_INTERVAL) + 1;
+        }
+
+        // 旧的主循环只在逻辑门打开时更新
+        if (newLoop || frameStart - lastLogic >= LOGIC_GATE)
+        {
+            lastLogic = frameStart;
+            if (!simulation.update(delta / 1e6f))
+            {
+                simulation.reset(GameMode::Unbounded, difficulty, MapType::Empty, random.next());
+                lastKey = Direction::Up;
+                result.resets++;
+            }
+            uint64_t inputTime;
+            if (simulation.takeAppliedInput(inputTime))
+            {
+                result.move.push_back((frameStart - inputTime) / 1000.0);
+                pending.push_back(inputTime);
+            }
+        }
+
+        // 渲染并提交画面
+        uint64_t presentTime = frameStart + FRAME_WORK;
+        for (uint64_t inputTime : pending)
+        {
+            result.present.push_back((presentTime - inputTime) / 1000.0);
+        }
+        pending.clear();
+        result.frames++;
+
+        // 控制帧率
+        int64_t sleep = newLoop ? static_cast<int64_t>(FRAME_TIME) - static_cast<int64_t>(FRAME_WORK)
+                                     : static_cast<int64_t>(FRAME_TIME) - static_cast<int64_t>(delta);
+        now = presentTime + (sleep > 0 ? sleep : 0);
+    }
+    return result;
+}
+
+int main()
+{
+    bool ok = true;
+    for (Difficulty difficulty : {Difficulty::Easy, Difficulty::Hard})
+    {
+        for (bool newLoop : {false, true})
+        {
+            LatencyResult result = run(difficulty, newLoop);
+            std::cout << (difficulty == Difficulty::Easy ? "Easy" : "Hard") << ", "
+                      << (newLoop ? "new loop" : "old loop") << ": "
+                      << result.frames * 1e6 / DURATION << " FPS, 按键 " << result.keys
+                      << ", 生效 " << result.move.size() << ", 重新开始 " << result.resets << std::endl;
+            printPercentiles("按键到移动", result.move);
+            printPercentiles("按键到画面", result.present);
+            // 新的主循环中，除了游戏结束时还在缓冲中的按键，每个按键都应该在之后的某一次移动生效
+            // (旧的主循环移动太慢，输入缓冲会溢出)
+            ok = ok && (!newLoop || result.move.size() + 3 * (result.resets + 1) >= static_cast<size_t>(result.keys));
+        }
+    }
+    if (!ok)
+    {
+        std::cerr << "有按键没有生效" << std::endl;
+        return 1;
+    }
+    return 0;
+}
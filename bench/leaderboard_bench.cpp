@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../leader_board.h"
+
+// 多进程共用排行榜文件的基准测试：
+//   几十个写入进程同时提交随机得分，另外几个读取进程不停读取排行榜，检查：
+//   1. 最终的排行榜等于所有提交的得分中最高的若干个 (没有丢失的更新)
+//   2. 读取进程每次读到的排行榜都是完整的 (从高到低排列)
+//   分别测试 LeaderBoard::submit 和没有在锁内重新读取的做法 (read、update、write)，
+//   后者在进程交错执行时会用旧的排行榜覆盖其他进程的得分
+// 子进程通过管道把每次提交的耗时发送给父进程，打印每秒合并的次数和耗时分位数
+// submit 丢失更新或者任何一种做法出现不完整的读取时返回非零
+// 用法: leaderboard_bench [--writers 进程数] [--scores 每个进程的提交次数] [--readers 进程数] [--leaders 记录数量]
+
+using benchClock = std::chrono::steady_clock;
+
+struct Options
+{
+    int writers = 32;
+    int scores = 200;
+    int readers = 4;
+    int leaders = 10;
+};
+
+// 一种做法的结果
+struct Result
+{
+    double seconds = 0.0;
+    std::vector<double> latencies; // 每次提交的耗时 (微秒)
+    int lost = 0;                  // 应该在排行榜中但是丢失的得分个数
+    long reads = 0;
+    long invalidReads = 0;
+    bool childFailed = false;
+};
+
+// 第 writer 个写入进程提交的得分，父进程用同样的种子重新生成
+static std::vector<int> writerScores(int writer, int count)
+{
+    std::mt19937 random(1000 + writer);
+    std::uniform_int_distribution<int> distribution(1, 1000000);
+    std::vector<int> scores(count);
+    for (int &score : scores)
+    {
+        score = distribution(random);
+    }
+    return scores;
+}
+
+// 把 bytes 个字节全部写入管道
+static bool writeAll(int fd, const void *data, size_t bytes)
+{
+    const char *pointer = static_cast<const char *>(data);
+    while (bytes > 0)
+    {
+        ssize_t count = ::write(fd, pointer, bytes);
+        if (count <= 0)
+        {
+            return false;
+        }
+        pointer += count;
+        bytes -= static_cast<size_t>(count);
+    }
+    return true;
+}
+
+// 读取管道直到对方关闭
+static std::vector<char> readAll(int fd)
+{
+    std::vector<char> data;
+    char buffer[4096];
+    ssize_t count;
+    while ((count = ::read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        data.insert(data.end(), buffer, buffer + count);
+    }
+    return data;
+}
+
+// 创建子进程执行 body，子进程的输出写到返回的管道中
+static pid_t spawn(int &outputFd, const std::function<bool(int)> &body)
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        close(fds[0]);
+        bool ok = body(fds[1]);
+        close(fds[1]);
+        _exit(ok ? 0 : 1);
+    }
+    close(fds[1]);
+    outputFd = fds[0];
+    return pid;
+}
+
+static Result runMode(const Options &options, const std::string &path, bool safe)
+{
+    Result result;
+    // 从空的排行榜开始
+    {
+        LeaderBoard board(path, options.leaders);
+        board.clear();
+        board.write();
+    }
+
+    // 读取进程一直读到父进程关闭 stop 管道
+    int stop[2];
+    if (pipe(stop) != 0)
+    {
+        result.childFailed = true;
+        return result;
+    }
+    fcntl(stop[0], F_SETFL, O_NONBLOCK);
+    std::vector<pid_t> pids;
+    std::vector<int> readerFds;
+    std::vector<int> writerFds;
+    std::cout.flush();
+    for (int reader = 0; reader < options.readers; reader++)
+    {
+        int fd = -1;
+        pid_t pid = spawn(fd, [&](int out) {
+            close(stop[1]);
+            LeaderBoard board(path, options.leaders);
+            long counts[2] = {0, 0};
+            char byte;
+            while (::read(stop[0], &byte, 1) < 0)
+            {
+                bool valid = board.read();
+                const std::vector<int> &scores = board.getScores();
+                valid = valid && std::is_sorted(scores.begin(), scores.end(), std::greater<int>());
+                counts[0]++;
+                counts[1] += valid ? 0 : 1;
+            }
+            return writeAll(out, counts, sizeof(counts));
+        });
+        pids.push_back(pid);
+        readerFds.push_back(fd);
+    }
+    close(stop[0]);
+
+    auto start = benchClock::now();
+    for (int writer = 0; writer < options.writers; writer++)
+    {
+        int fd = -1;
+        pid_t pid = spawn(fd, [&](int out) {
+            close(stop[1]);
+            // 每个进程有自己的 LeaderBoard (自己打开锁文件)
+            LeaderBoard board(path, options.leaders);
+            std::vector<double> latencies;
+            latencies.reserve(options.scores);
+            bool ok = true;
+            for (int score : writerScores(writer, options.scores))
+            {
+                auto submitStart = benchClock::now();
+                if (safe)
+                {
+                    ok = board.submit(score) && ok;
+                }
+                else
+                {
+                    board.clear();
+                    board.read();
+                    if (board.update(score))
+                    {
+                        ok = board.write() && ok;
+                    }
+                }
+                latencies.push_back(std::chrono::duration<double, std::micro>(benchClock::now() - submitStart).count());
+            }
+            return writeAll(out, latencies.data(), latencies.size() * sizeof(double)) && ok;
+        });
+        pids.push_back(pid);
+        writerFds.push_back(fd);
+    }
+
+    // 一个写入进程阻塞在管道上时不会影响其他进程，按顺序读取即可
+    for (int fd : writerFds)
+    {
+        std::vector<char> data = readAll(fd);
+        close(fd);
+        const double *latencies = reinterpret_cast<const double *>(data.data());
+        result.latencies.insert(result.latencies.end(), latencies, latencies + data.size() / sizeof(double));
+    }
+    result.seconds = std::chrono::duration<double>(benchClock::now() - start).count();
+    close(stop[1]);
+    for (int fd : readerFds)
+    {
+        std::vector<char> data = readAll(fd);
+        close(fd);
+        if (data.size() == 2 * sizeof(long))
+        {
+            const long *counts = reinterpret_cast<const long *>(data.data());
+            result.reads += counts[0];
+            result.invalidReads += counts[1];
+        }
+        else
+        {
+            result.childFailed = true;
+        }
+    }
+    for (pid_t pid : pids)
+    {
+        int status = 0;
+        if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            result.childFailed = true;
+        }
+    }
+    if (static_cast<int>(result.latencies.size()) != options.writers * options.scores)
+    {
+        result.childFailed = true;
+    }
+
+    // 期望的排行榜：所有提交的得分中最高的若干个
+    std::vector<int> expected(options.leaders, 0);
+    for (int writer = 0; writer < options.writers; writer++)
+    {
+        std::vector<int> scores = writerScores(writer, options.scores);
+        expected.insert(expected.end(), scores.begin(), scores.end());
+    }
+    std::partial_sort(expected.begin(), expected.begin() + options.leaders, expected.end(), std::greater<int>());
+    expected.resize(options.leaders);
+    LeaderBoard board(path, options.leaders);
+    board.read();
+    std::vector<int> actual = board.getScores();
+    std::vector<int> missing;
+    std::set_difference(expected.begin(), expected.end(), actual.begin(), actual.end(), std::back_inserter(missing),
+                        std::greater<int>());
+    result.lost = static_cast<int>(missing.size());
+    return result;
+}
+
+static double percentile(std::vector<double> &values, double fraction)
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(fraction * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+static void printResult(const char *name, Result &result)
+{
+    double merges = result.latencies.size() / std::max(result.seconds, 1e-9);
+    double p50 = percentile(result.latencies, 0.50);
+    double p99 = percentile(result.latencies, 0.99);
+    double maximum = result.latencies.empty() ? 0.0 : *std::max_element(result.latencies.begin(), result.latencies.end());
+    std::printf("%-24s %8zu 次提交 %9.0f 次/秒  p50 %7.1f us  p99 %8.1f us  最大 %8.1f us  丢失 %d  读取 %ld (不完整 %ld)%s\n",
+                name, result.latencies.size(), merges, p50, p99, maximum, result.lost, result.reads,
+                result.invalidReads, result.childFailed ? "  子进程失败" : "");
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string name = argv[i];
+        int value = std::atoi(argv[i + 1]);
+        if (name == "--writers")
+        {
+            options.writers = std::max(1, value);
+        }
+        else if (name == "--scores")
+        {
+            options.scores = std::max(1, value);
+        }
+        else if (name == "--readers")
+        {
+            options.readers = std::max(0, value);
+        }
+        else if (name == "--leaders")
+        {
+            options.leaders = std::max(1, value);
+        }
+    }
+
+    const std::string path = "/tmp/leaderboard_bench_" + std::to_string(getpid()) + ".dat";
+    std::cout << options.writers << " 个写入进程，每个提交 " << options.scores << " 个得分，" << options.readers
+              << " 个读取进程，排行榜 " << options.leaders << " 条记录" << std::endl;
+    Result safe = runMode(options, path, true);
+    printResult("submit (锁内重新读取)", safe);
+    Result naive = runMode(options, path, false);
+    printResult("read + update + write", naive);
+    std::remove(path.c_str());
+    std::remove((path + ".lock").c_str());
+
+    bool ok = true;
+    if (safe.lost != 0 || safe.childFailed)
+    {
+        std::cerr << "submit 丢失了 " << safe.lost << " 个得分" << std::endl;
+        ok = false;
+    }
+    if (safe.invalidReads != 0 || naive.invalidReads != 0)
+    {
+        std::cerr << "读取到不完整的排行榜" << std::endl;
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../mcts_bot.h"
+
+// 蒙特卡洛树搜索机器人与贪心机器人的对比：同样的种子和设置下各玩若干局，
+// 报告平均最终长度、平均存活的移动次数，以及搜索的每核每秒模拟次数和每次决策耗时的分位数
+// 复制的局面 (copyFrom) 与原局面在同样的输入下不一致，或决策耗时的 p99 超过时间上限的 1.5 倍时返回非零
+// 用法: mcts_bench [--games 局数] [--budget 微秒] [--threads 线程数] [--moves 每局最多移动次数]
+
+const int BOARD_WIDTH = WINDOW_WIDTH - 10 * GRID_SIZE;
+const int BOARD_HEIGHT = WINDOW_HEIGHT - 2 * GRID_SIZE;
+
+// 一种机器人的对局结果
+struct BotResult
+{
+    double totalLength = 0.0;
+    double totalMoves = 0.0;
+    int games = 0;
+    int survived = 0; // 到达移动次数上限时还活着的局数
+    uint64_t rollouts = 0;
+    double searchSeconds = 0.0;
+    std::vector<double> decisionMicros;
+};
+
+// 开始一局：有边界模式、有障碍物，加速和减速食物会改变移动节奏
+static void resetGame(Simulation &simulation, uint64_t seed)
+{
+    simulation.setFoodOptions(1, 0);
+    simulation.reset(GameMode::Bounded, Difficulty::Hard, MapType::Obstacles, seed);
+}
+
+// 用 choose 玩 games 局，每次移动之前决策一次
+template <typename Choose>
+static void play(BotResult &result, int games, int maxMoves, Choose choose)
+{
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    for (int game = 0; game < games; game++)
+    {
+        resetGame(simulation, 1000 + game);
+        int moves = 0;
+        bool alive = true;
+        while (alive && moves < maxMoves)
+        {
+            simulation.addDirectionToQueue(choose(simulation));
+            alive = simulation.advanceMove();
+            moves++;
+        }
+        result.totalLength += simulation.getSnake().getLength();
+        result.totalMoves += moves;
+        result.games++;
+        result.survived += alive ? 1 : 0;
+    }
+}
+
+// 复制局面后继续用相同的输入运行，每一步的校验和都必须相同
+static bool verifyCopy()
+{
+    Simulation original(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    Simulation copy(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    original.setFoodOptions(6, 300);
+    original.reset(GameMode::Unbounded, Difficulty::Hard, MapType::Obstacles, 5);
+    GreedyBot bot;
+    for (int i = 0; i < 300 && !original.isGameOver(); i++)
+    {
+        original.addDirectionToQueue(bot.choose(original));
+        original.advanceMove();
+    }
+    if (!copy.copyFrom(original) || copy.checksum() != original.checksum())
+    {
+        return false;
+    }
+    for (int i = 0; i < 2000; i++)
+    {
+        Direction direction = bot.choose(original);
+        original.addDirectionToQueue(direction);
+        copy.addDirectionToQueue(direction);
+        if (original.advanceMove() != copy.advanceMove() || original.checksum() != copy.checksum())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static double percentile(std::vector<double> &samples, double p)
+{
+    if (samples.empty())
+    {
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[static_cast<size_t>(p * (samples.size() - 1))];
+}
+
+static void report(const char *name, const BotResult &result)
+{
+    std::cout << "  " << std::left << std::setw(14) << name << std::right << " 平均长度 " << std::setw(6)
+              << result.totalLength / result.games << ", 平均移动 " << std::setw(7) << result.totalMoves / result.games
+              << ", 存活到上限 " << result.survived << "/" << result.games << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    int games = 6;
+    int budget = 2000;
+    int threads = 0;
+    int maxMoves = 1500;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        int value = std::atoi(argv[i + 1]);
+        if (arg == "--games")
+            games = std::max(1, value);
+        else if (arg == "--budget")
+            budget = std::max(100, value);
+        else if (arg == "--threads")
+            threads = value;
+        else if (arg == "--moves")
+            maxMoves = std::max(1, value);
+    }
+    if (!verifyCopy())
+    {
+        std::cerr << "复制的局面与原局面不一致" << std::endl;
+        return 1;
+    }
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << games << " 局，每局最多 " << maxMoves << " 次移动，每次决策 " << budget << " us" << std::endl;
+
+    BotResult greedy;
+    GreedyBot greedyBot;
+    play(greedy, games, maxMoves, [&](const Simulation &simulation) { return greedyBot.choose(simulation); });
+    report("贪心", greedy);
+
+    // 单线程和所有可用的核心各测一次 (只有一个核心时只测一次)，线程数不超过可用的核数
+    std::vector<int> threadCounts = {1};
+    int cores = std::min(threads > 0 ? threads : MctsBot::availableCores(), MctsBot::availableCores());
+    if (cores > 1)
+    {
+        threadCounts.push_back(cores);
+    }
+    bool ok = true;
+    for (int count : threadCounts)
+    {
+        Simulation prototype(BOARD_WIDTH, BOARD_HEIGHT, 2);
+        resetGame(prototype, 1);
+        MctsConfig config;
+        config.threads = count;
+        config.budgetMicros = budget;
+        MctsBot bot(prototype, config);
+        BotResult mcts;
+        uint64_t reused = 0;
+        play(mcts, games, maxMoves, [&](const Simulation &simulation) {
+            Direction direction = bot.choose(simulation);
+            const MctsStats &stats = bot.getStats();
+            mcts.rollouts += stats.rollouts;
+            mcts.searchSeconds += stats.seconds;
+            mcts.decisionMicros.push_back(stats.seconds * 1e6);
+            reused += stats.reusedVisits;
+            return direction;
+        });
+        std::string name = "MCTS x" + std::to_string(count);
+        report(name.c_str(), mcts);
+        double perCore = mcts.rollouts / mcts.searchSeconds / count;
+        double p50 = percentile(mcts.decisionMicros, 0.5);
+        double p99 = percentile(mcts.decisionMicros, 0.99);
+        std::cout << "                 每核每秒模拟 " << std::setprecision(0) << perCore << " 次，每次决策 "
+                  << mcts.rollouts / mcts.decisionMicros.size() << " 次模拟 (复用子树的访问 "
+                  << reused / mcts.decisionMicros.size() << " 次)，决策耗时 (us) p50 " << p50 << ", p99 " << p99
+                  << ", 最大 " << mcts.decisionMicros.back() << std::setprecision(1) << std::endl;
+        if (p99 > 1.5 * budget)
+        {
+            std::cerr << "决策耗时 p99 " << p99 << " us 超过时间上限的 1.5 倍" << std::endl;
+            ok = false;
+        }
+    }
+    return ok ? 0 : 1;
+}
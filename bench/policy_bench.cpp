@@ -0,0 +1,142 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench_harness.h"
+#include "../simulation.h"
+
+// 移动步骤特化的基准测试：同一个游戏区域和模式下对比通用版本和特化版本每次移动的耗时，
+// 并检查两个版本在同样的输入下每一步的校验和都相同
+
+// 游戏区域大小 (格子) 和对应的特化版本
+struct BoardSize
+{
+    int width;
+    int height;
+};
+
+// 伪随机的转向，不会直接掉头
+static Direction nextDirection(uint32_t &state, Direction current)
+{
+    state = state * 1664525u + 1013904223u;
+    if ((state >> 24) % 4 != 0)
+    {
+        return current;
+    }
+    Direction turn = static_cast<Direction>((state >> 16) % 4);
+    return (static_cast<int>(turn) ^ 1) == static_cast<int>(current) ? current : turn;
+}
+
+// 以恰好一次移动的时间推进，返回是否还活着
+static bool stepOnce(Simulation &simulation)
+{
+    return simulation.update(1.0001f / simulation.getSnake().getSpeed());
+}
+
+// 两个版本在同样的输入下逐步比较校验和
+static bool checkSameResult(const BoardSize &board, GameMode mode)
+{
+    Simulation generic(board.width * GRID_SIZE, board.height * GRID_SIZE, 2);
+    Simulation specialized(board.width * GRID_SIZE, board.height * GRID_SIZE, 2);
+    generic.setSpecializedStep(false);
+    generic.setFoodOptions(8, 0);
+    specialized.setFoodOptions(8, 0);
+    uint64_t seed = 1;
+    generic.reset(mode, Difficulty::Easy, MapType::Obstacles, seed);
+    specialized.reset(mode, Difficulty::Easy, MapType::Obstacles, seed);
+
+    uint32_t state = 99;
+    Direction direction = Direction::Up;
+    for (int i = 0; i < 20000; i++)
+    {
+        direction = nextDirection(state, direction);
+        generic.addDirectionToQueue(direction);
+        specialized.addDirectionToQueue(direction);
+        bool genericAlive = stepOnce(generic);
+        bool specializedAlive = stepOnce(specialized);
+        if (genericAlive != specializedAlive || generic.checksum() != specialized.checksum())
+        {
+            std::cerr << "第 " << i << " 步特化版本 (" << specialized.getStepName() << ") 的结果与通用版本不同" << std::endl;
+            return false;
+        }
+        if (!genericAlive)
+        {
+            seed++;
+            generic.reset(mode, Difficulty::Easy, MapType::Obstacles, seed);
+            specialized.reset(mode, Difficulty::Easy, MapType::Obstacles, seed);
+            direction = Direction::Up;
+        }
+    }
+    return true;
+}
+
+// 每次移动的耗时：有边界模式沿着一个正方形绕圈，无边界模式一直向右穿越边界
+static void benchStep(BenchSuite &suite, const BoardSize &board, GameMode mode, bool specializedStep)
+{
+    Simulation simulation(board.width * GRID_SIZE, board.height * GRID_SIZE, 2);
+    simulation.setSpecializedStep(specializedStep);
+    simulation.reset(mode, Difficulty::Easy, MapType::Empty, 7);
+    std::vector<uint8_t> snapshot;
+    simulation.saveSnapshot(snapshot);
+
+    std::vector<Direction> route;
+    if (mode == GameMode::Bounded)
+    {
+        const Direction sides[] = {Direction::Up, Direction::Right, Direction::Down, Direction::Left};
+        for (Direction side : sides)
+        {
+            route.insert(route.end(), 8, side);
+        }
+    }
+    else
+    {
+        route.push_back(Direction::Right);
+    }
+
+    std::string params = "board=" + std::to_string(board.width) + "x" + std::to_string(board.height) +
+                         (mode == GameMode::Bounded ? " mode=bounded " : " mode=unbounded ") + simulation.getStepName();
+    suite.run("Simulation::update (move)", params, 2000,
+              [&]() { simulation.loadSnapshot(snapshot.data(), snapshot.size()); },
+              [&](int i) {
+                  simulation.addDirectionToQueue(route[i % route.size()]);
+                  if (!stepOnce(simulation))
+                  {
+                      // 吃到食物变长后可能撞到自己，很少发生
+                      simulation.loadSnapshot(snapshot.data(), snapshot.size());
+                  }
+              });
+}
+
+int main(int argc, char **argv)
+{
+    std::string jsonPath = argc > 2 && std::string(argv[1]) == "--json" ? argv[2] : "";
+    const BoardSize boards[] = {{40, 28}, {64, 64}, {128, 128}, {100, 60}};
+    const GameMode modes[] = {GameMode::Bounded, GameMode::Unbounded};
+
+    for (const BoardSize &board : boards)
+    {
+        for (GameMode mode : modes)
+        {
+            if (!checkSameResult(board, mode))
+            {
+                return 1;
+            }
+        }
+    }
+    std::cout << "特化版本与通用版本的结果一致" << std::endl;
+
+    BenchSuite suite;
+    for (const BoardSize &board : boards)
+    {
+        for (GameMode mode : modes)
+        {
+            benchStep(suite, board, mode, false);
+            benchStep(suite, board, mode, true);
+        }
+    }
+    if (!jsonPath.empty() && !suite.writeJson(jsonPath))
+    {
+        return 1;
+    }
+    return 0;
+}
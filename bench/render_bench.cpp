@@ -0,0 +1,181 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <string>
+#include <algorithm>
+
+#include "../simulation.h"
+#include "../board_renderer.h"
+#ifdef SNAKE_RENDER_SDL
+#include "../sdl_render_backend.h"
+#endif
+
+// 渲染场景基准测试：分别测量每帧的模拟开销和提交绘制的开销，以及插值绘制蛇的开销
+// 后端：空后端 (只计数)、离屏软件渲染，以及 SDL 渲染器 (用 make render_bench_sdl 编译，
+// 在无界面主机上配合 SDL_VIDEODRIVER=dummy 运行)
+
+using benchClock = std::chrono::steady_clock;
+
+// 屏幕和游戏区域 (像素)，与 Game 相同
+const int SCREEN_WIDTH = WINDOW_WIDTH;
+const int SCREEN_HEIGHT = WINDOW_HEIGHT;
+const int BOARD_WIDTH = WINDOW_WIDTH - 10 * GRID_SIZE;
+const int BOARD_HEIGHT = WINDOW_HEIGHT - 2 * GRID_SIZE;
+const int FRAMES = 300;
+const float FRAME_TIME = 1.0f / 30.0f;
+
+// 测试场景
+struct Scenario
+{
+    const char *name;
+    MapType mapType;
+    int foods;
+    int snakeLength; // 0 表示使用初始长度
+};
+
+// 构造场景：长蛇从游戏区域底部开始蛇形排列
+static void setupScenario(Simulation &simulation, const Scenario &scenario)
+{
+    simulation.setFoodOptions(scenario.foods, 0);
+    simulation.reset(GameMode::Unbounded, Difficulty::Easy, scenario.mapType, 42);
+    if (scenario.snakeLength > 0)
+    {
+        int width = simulation.getBoardWidth();
+        int height = simulation.getBoardHeight();
+        std::vector<SnakeBody> body;
+        for (int i = 0; i < scenario.snakeLength; i++)
+        {
+            int row = i / width;
+            int column = (row % 2 == 0) ? i % width : width - 1 - i % width;
+            body.push_back(SnakeBody(column, height - 1 - row));
+        }
+        simulation.setSnakeBody(body);
+    }
+}
+
+// 执行 FRAMES 次 op，重复若干轮，返回每帧耗时 (微秒) 的中位数
+template <typename Op>
+static double medianMicros(Op op)
+{
+    std::vector<double> samples;
+    for (int round = 0; round < 7; round++)
+    {
+        auto start = benchClock::now();
+        for (int i = 0; i < FRAMES; i++)
+        {
+            op();
+        }
+        samples.push_back(std::chrono::duration<double, std::micro>(benchClock::now() - start).count() / FRAMES);
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+// 每帧的模拟开销：游戏结束时从快照恢复 (恢复的开销不计入)
+static double simulationMicros(const Scenario &scenario)
+{
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    setupScenario(simulation, scenario);
+    std::vector<uint8_t> snapshot;
+    simulation.saveSnapshot(snapshot);
+    std::vector<double> samples;
+    for (int round = 0; round < 7; round++)
+    {
+        double elapsed = 0.0;
+        for (int i = 0; i < FRAMES; i++)
+        {
+            auto start = benchClock::now();
+            bool alive = simulation.tick(FRAME_TIME);
+            elapsed += std::chrono::duration<double, std::micro>(benchClock::now() - start).count();
+            if (!alive)
+            {
+                simulation.loadSnapshot(snapshot.data(), snapshot.size());
+            }
+        }
+        samples.push_back(elapsed / FRAMES);
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+// 每帧提交绘制的开销和图元数量
+static void benchBackend(const char *backendName, RenderBackend &backend, const Scenario &scenario, double simMicros)
+{
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    setupScenario(simulation, scenario);
+    BoardRenderer boardRenderer(backend, SCREEN_WIDTH, SCREEN_HEIGHT, BOARD_WIDTH, BOARD_HEIGHT);
+    boardRenderer.renderStaticLayer(std::vector<int>(3, 0));
+
+    backend.resetStats();
+    double renderMicros = medianMicros([&]() { boardRenderer.renderFrame(simulation); });
+    const RenderStats &stats = backend.getStats();
+    std::cout << "  " << backendName << ": sim " << simMicros << " us, render " << renderMicros
+              << " us, frame " << simMicros + renderMicros << " us; per frame: "
+              << stats.rects / stats.frames << " rects in " << stats.rectCalls / stats.frames << " calls, "
+              << stats.texts / stats.frames << " texts" << std::endl;
+
+    // 插值绘制 (蛇头和蛇尾各画半截格子)：游戏按显示器的刷新率绘制，一帧的预算是 1 / 刷新率
+    BoardSnapshot snapshot;
+    snapshot.capture(simulation);
+    snapshot.vacatedTail = snapshot.snake.back();
+    float moveProgress = 0.0f;
+    double interpolatedMicros = medianMicros([&]() {
+        moveProgress = moveProgress >= 0.95f ? 0.0f : moveProgress + 0.05f;
+        boardRenderer.renderFrame(snapshot, moveProgress);
+    });
+    std::cout << "  " << backendName << " interpolated: render " << interpolatedMicros << " us, "
+              << 1e6 / interpolatedMicros << " FPS max (240 FPS budget " << 1e6 / 240.0 << " us)" << std::endl;
+}
+
+int main()
+{
+    const Scenario scenarios[] = {
+        {"start", MapType::Empty, 1, 0},
+        {"obstacles", MapType::Obstacles, 1, 0},
+        {"long snake", MapType::Empty, 1, 500},
+        {"many foods", MapType::Empty, 500, 0},
+    };
+
+#ifdef SNAKE_RENDER_SDL
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        std::cerr << "SDL 初始化失败: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    SDL_Window *window = SDL_CreateWindow("render_bench", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                                          SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_HIDDEN);
+    SDL_Renderer *renderer = window ? SDL_CreateRenderer(window, -1, 0) : nullptr;
+    if (renderer == nullptr)
+    {
+        std::cerr << "渲染器创建失败: " << SDL_GetError() << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+#endif
+
+    for (const Scenario &scenario : scenarios)
+    {
+        std::cout << scenario.name << ":" << std::endl;
+        double simMicros = simulationMicros(scenario);
+
+        NullRenderBackend nullBackend;
+        benchBackend("null", nullBackend, scenario, simMicros);
+
+        SoftwareRenderBackend softwareBackend(SCREEN_WIDTH, SCREEN_HEIGHT);
+        benchBackend("software", softwareBackend, scenario, simMicros);
+
+#ifdef SNAKE_RENDER_SDL
+        // 没有加载字体，SDL 后端不绘制文字
+        SdlRenderBackend sdlBackend(renderer, nullptr, SCREEN_WIDTH, SCREEN_HEIGHT);
+        benchBackend("sdl", sdlBackend, scenario, simMicros);
+#endif
+    }
+
+#ifdef SNAKE_RENDER_SDL
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+#endif
+    return 0;
+}
@@ -0,0 +1,340 @@
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench_harness.h"
+#include "../safety_oracle.h"
+
+// 蛇尾可达性判断的基准测试：
+//   1. 小游戏区域 (5x5、6x6，两种模式) 上随机生成蛇身，与穷举搜索对比每个方向的判断结果和耗时
+//      穷举搜索：这一步之后 (不再吃食物) 是否存在一种走法能再走 蛇长 步不撞
+//   2. 默认游戏区域 (40x28) 上不同蛇长时判断四个方向的耗时
+// 判断为 Blocked 的方向与穷举不同，或者判断为 Safe 而穷举无路可走的比例超过 2% 时返回非零
+
+using benchClock = std::chrono::steady_clock;
+
+// 穷举搜索：按格子计数的占用表和蛇身队列
+class ExhaustiveSearch
+{
+public:
+    ExhaustiveSearch(const CellGrid &grid, bool wraps) : mGrid(grid), mWraps(wraps), mOccupied(grid.getCellCount(), 0)
+    {
+    }
+
+    // 蛇身为 body (第一个是蛇头) 时能否再走 moves 步，搜索的节点数超过 limit 时 exhausted 为 true
+    bool canSurvive(const std::deque<CellIndex> &body, int moves, long limit, bool &exhausted)
+    {
+        mBody = body;
+        std::fill(mOccupied.begin(), mOccupied.end(), 0);
+        for (CellIndex cell : mBody)
+        {
+            mOccupied[cell]++;
+        }
+        mNodes = 0;
+        mLimit = limit;
+        bool result = search(moves);
+        exhausted = mNodes > mLimit;
+        return result;
+    }
+
+    long getNodes() const
+    {
+        return mNodes;
+    }
+
+private:
+    const CellGrid &mGrid;
+    const bool mWraps;
+    std::vector<uint8_t> mOccupied;
+    std::deque<CellIndex> mBody;
+    long mNodes = 0;
+    long mLimit = 0;
+
+    bool search(int moves)
+    {
+        if (moves == 0)
+        {
+            return true;
+        }
+        if (++mNodes > mLimit)
+        {
+            return false;
+        }
+        CellIndex head = mBody.front();
+        CellIndex tail = mBody.back();
+        for (int i = 0; i < 4; i++)
+        {
+            Direction direction = static_cast<Direction>(i);
+            CellIndex next = mGrid.neighbor(head, direction);
+            if (!mGrid.isInside(next))
+            {
+                if (!mWraps)
+                {
+                    continue;
+                }
+                next = mGrid.wrap(next, direction);
+            }
+            // 蛇尾在这一步让出格子
+            mOccupied[tail]--;
+            bool free = mOccupied[next] == 0;
+            bool survived = false;
+            if (free)
+            {
+                mBody.pop_back();
+                mBody.push_front(next);
+                mOccupied[next]++;
+                survived = search(moves - 1);
+                mOccupied[next]--;
+                mBody.pop_front();
+                mBody.push_back(tail);
+            }
+            mOccupied[tail]++;
+            if (survived)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// 随机的自回避路径作为蛇身，生成失败时返回空
+static std::vector<SnakeBody> randomBody(const CellGrid &grid, bool wraps, int length, Random &random)
+{
+    for (int attempt = 0; attempt < 200; attempt++)
+    {
+        std::vector<CellIndex> cells;
+        std::vector<uint8_t> used(grid.getCellCount(), 0);
+        CellIndex cell = grid.toCell(random.nextInt(grid.getColumns()), random.nextInt(grid.getRows()));
+        cells.push_back(cell);
+        used[cell] = 1;
+        while (static_cast<int>(cells.size()) < length)
+        {
+            CellIndex options[4];
+            int count = 0;
+            for (int i = 0; i < 4; i++)
+            {
+                Direction direction = static_cast<Direction>(i);
+                CellIndex next = grid.neighbor(cells.back(), direction);
+                if (!grid.isInside(next))
+                {
+                    if (!wraps)
+                    {
+                        continue;
+                    }
+                    next = grid.wrap(next, direction);
+                }
+                if (!used[next])
+                {
+                    options[count++] = next;
+                }
+            }
+            if (count == 0)
+            {
+                break;
+            }
+            cell = options[random.nextInt(count)];
+            cells.push_back(cell);
+            used[cell] = 1;
+        }
+        if (static_cast<int>(cells.size()) == length)
+        {
+            std::vector<SnakeBody> body;
+            for (CellIndex part : cells)
+            {
+                body.push_back(SnakeBody(grid.getX(part), grid.getY(part)));
+            }
+            return body;
+        }
+    }
+    return std::vector<SnakeBody>();
+}
+
+// 判断结果与穷举搜索的对比
+struct Accuracy
+{
+    long directions = 0;   // 比较的方向数
+    long safeAgree = 0;    // 都认为能走
+    long trappedAgree = 0; // 都认为走不出来
+    long falseSafe = 0;    // 判断为 Safe，穷举无路可走
+    long falseTrapped = 0; // 判断为 Trapped，穷举能走出来
+    long blockedMismatch = 0;
+    long skipped = 0; // 穷举超过节点上限
+    double oracleNs = 0.0;
+    double exhaustiveNs = 0.0;
+    long positions = 0;
+};
+
+static void compareBoard(int columns, int rows, GameMode mode, int positions, Accuracy &accuracy)
+{
+    Simulation simulation(columns * GRID_SIZE, rows * GRID_SIZE, 2);
+    simulation.setFoodOptions(1, 0);
+    const CellGrid &grid = simulation.getGrid();
+    const bool wraps = mode == GameMode::Unbounded;
+    SafetyOracle oracle(grid);
+    ExhaustiveSearch exhaustive(grid, wraps);
+    Random random(columns * 131 + rows * 7 + (wraps ? 1 : 0));
+    const int cells = columns * rows;
+
+    for (int p = 0; p < positions; p++)
+    {
+        int length = 3 + random.nextInt(cells * 4 / 5 - 2);
+        std::vector<SnakeBody> body = randomBody(grid, wraps, length, random);
+        if (body.empty())
+        {
+            continue;
+        }
+        simulation.reset(mode, Difficulty::Easy, MapType::Empty, p + 1);
+        simulation.setSnakeBody(body);
+
+        MoveSafety result[4];
+        auto start = benchClock::now();
+        oracle.evaluate(simulation, result);
+        accuracy.oracleNs += std::chrono::duration<double, std::nano>(benchClock::now() - start).count();
+        accuracy.positions++;
+
+        const Snake &snake = simulation.getSnake();
+        const std::vector<CellIndex> &cellsOfBody = snake.getCells();
+        const Direction opposites[4] = {Direction::Down, Direction::Up, Direction::Right, Direction::Left};
+        start = benchClock::now();
+        for (int i = 0; i < 4; i++)
+        {
+            Direction direction = static_cast<Direction>(i);
+            if (opposites[i] == snake.getDirection())
+            {
+                continue; // 掉头的方向由输入规则排除，不比较
+            }
+            // 这一步之后的蛇身
+            CellIndex next = grid.neighbor(snake.getHead(), direction);
+            bool blocked = false;
+            if (!grid.isInside(next))
+            {
+                blocked = !wraps;
+                next = wraps ? grid.wrap(next, direction) : next;
+            }
+            bool grows = !blocked && simulation.getFoods().find(next) != nullptr;
+            std::deque<CellIndex> after(cellsOfBody.begin(), cellsOfBody.end());
+            if (!blocked)
+            {
+                if (!grows)
+                {
+                    after.pop_back();
+                }
+                for (CellIndex part : after)
+                {
+                    blocked = blocked || part == next;
+                }
+            }
+            if (blocked != (result[i] == MoveSafety::Blocked))
+            {
+                accuracy.blockedMismatch++;
+                continue;
+            }
+            if (blocked)
+            {
+                continue;
+            }
+            after.push_front(next);
+            bool exhausted = false;
+            bool survives = exhaustive.canSurvive(after, static_cast<int>(after.size()), 2000000, exhausted);
+            if (exhausted)
+            {
+                accuracy.skipped++;
+                continue;
+            }
+            accuracy.directions++;
+            if (result[i] == MoveSafety::Safe)
+            {
+                (survives ? accuracy.safeAgree : accuracy.falseSafe)++;
+            }
+            else
+            {
+                (survives ? accuracy.falseTrapped : accuracy.trappedAgree)++;
+            }
+        }
+        accuracy.exhaustiveNs += std::chrono::duration<double, std::nano>(benchClock::now() - start).count();
+    }
+}
+
+// 蛇形排列的长蛇，蛇头在左下角
+static std::vector<SnakeBody> longSnake(int columns, int rows, int length)
+{
+    std::vector<SnakeBody> body;
+    for (int i = 0; i < length; i++)
+    {
+        int row = i / columns;
+        int column = (row % 2 == 0) ? i % columns : columns - 1 - i % columns;
+        body.push_back(SnakeBody(column, rows - 1 - row));
+    }
+    return body;
+}
+
+int main(int argc, char **argv)
+{
+    std::string jsonPath = argc > 2 && std::string(argv[1]) == "--json" ? argv[2] : "";
+    bool ok = true;
+
+    struct SmallBoard
+    {
+        int columns;
+        int rows;
+        GameMode mode;
+    };
+    const SmallBoard boards[] = {
+        {5, 5, GameMode::Bounded},
+        {6, 6, GameMode::Bounded},
+        {5, 5, GameMode::Unbounded},
+        {6, 6, GameMode::Unbounded},
+    };
+    std::cout << std::fixed << std::setprecision(2);
+    for (const SmallBoard &board : boards)
+    {
+        Accuracy accuracy;
+        compareBoard(board.columns, board.rows, board.mode, 3000, accuracy);
+        double falseSafeRate = accuracy.directions ? 100.0 * accuracy.falseSafe / accuracy.directions : 0.0;
+        double falseTrappedRate = accuracy.directions ? 100.0 * accuracy.falseTrapped / accuracy.directions : 0.0;
+        std::cout << board.columns << "x" << board.rows << (board.mode == GameMode::Bounded ? " bounded  " : " unbounded")
+                  << ": " << accuracy.directions << " 个方向，一致 " << accuracy.safeAgree + accuracy.trappedAgree
+                  << " (走不出来 " << accuracy.trappedAgree << ")，误判为安全 " << accuracy.falseSafe << " ("
+                  << falseSafeRate << "%)，误判为封闭 " << accuracy.falseTrapped << " (" << falseTrappedRate
+                  << "%)，超过穷举上限 " << accuracy.skipped << std::endl;
+        std::cout << "                  每个局面: 判断 " << accuracy.oracleNs / accuracy.positions / 1000.0
+                  << " us，穷举 " << accuracy.exhaustiveNs / accuracy.positions / 1000.0 << " us" << std::endl;
+        if (accuracy.blockedMismatch > 0 || falseSafeRate > 2.0)
+        {
+            std::cerr << "判断结果与穷举搜索的差别过大 (Blocked 不一致 " << accuracy.blockedMismatch << ")" << std::endl;
+            ok = false;
+        }
+    }
+
+    BenchSuite suite;
+    const int BOARD_WIDTH = WINDOW_WIDTH - 10 * GRID_SIZE;
+    const int BOARD_HEIGHT = WINDOW_HEIGHT - 2 * GRID_SIZE;
+    for (GameMode mode : {GameMode::Bounded, GameMode::Unbounded})
+    {
+        Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+        simulation.reset(mode, Difficulty::Easy, MapType::Obstacles, 1);
+        const CellGrid &grid = simulation.getGrid();
+        SafetyOracle oracle(grid);
+        const int cells = grid.getColumns() * grid.getRows();
+        for (int length : {4, 256, cells / 2, cells - 2 * grid.getColumns(), cells - 2})
+        {
+            simulation.setSnakeBody(longSnake(grid.getColumns(), grid.getRows(), length));
+            std::string params = std::string(mode == GameMode::Bounded ? "mode=bounded" : "mode=unbounded") +
+                                 " length=" + std::to_string(length);
+            MoveSafety result[4];
+            suite.run("safety_oracle", params, 2000, [&](int) {
+                oracle.evaluate(simulation, result);
+                benchKeep(static_cast<uint64_t>(result[0]) + static_cast<uint64_t>(result[3]));
+            });
+        }
+    }
+    if (!jsonPath.empty() && !suite.writeJson(jsonPath))
+    {
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
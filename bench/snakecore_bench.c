@@ -0,0 +1,195 @@
+/*
+ * libsnakecore 的基准测试 (C 程序，只通过 snake_core.h 的 C 接口链接共享库)：
+ *   1. 两个种子相同的批次在同样的动作下每一步的观测、奖励和结束标志都相同
+ *   2. 观测是合法的独热编码：每个格子最多属于一个平面，蛇头恰好一个，蛇身 = 蛇长 - 1；u8 与 f32 的观测一致
+ *   3. 只移动、移动 + u8 观测、移动 + f32 观测的吞吐量 (每秒观测数 = 局数 x 步数 / 秒)
+ * 检查失败时返回非零
+ * 用法: snakecore_bench [--games 局数] [--steps 步数]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../snake_core.h"
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* 简单的线性同余随机动作 (大部分时间保持方向) */
+static void randomActions(uint64_t *state, int32_t *actions, int32_t count)
+{
+    for (int32_t i = 0; i < count; i++)
+    {
+        *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint32_t value = (uint32_t)(*state >> 33);
+        actions[i] = value % 8 < 3 ? (int32_t)(value / 8 % 4) : SNAKECORE_ACTION_NONE;
+    }
+}
+
+/* 检查一局的观测 */
+static int checkObservation(const SnakeCoreBatch *batch, int32_t index, const uint8_t *obs, const float *obsFloat)
+{
+    const int32_t cells = snakecore_observation_size(batch) / SNAKECORE_PLANES;
+    int32_t counts[SNAKECORE_PLANES] = {0, 0, 0, 0};
+    for (int32_t cell = 0; cell < cells; cell++)
+    {
+        int sum = 0;
+        for (int plane = 0; plane < SNAKECORE_PLANES; plane++)
+        {
+            uint8_t value = obs[plane * cells + cell];
+            if (value > 1 || obsFloat[plane * cells + cell] != (float)value)
+            {
+                return 0;
+            }
+            sum += value;
+            counts[plane] += value;
+        }
+        if (sum > 1)
+        {
+            return 0;
+        }
+    }
+    int32_t length = 0;
+    snakecore_game_info(batch, index, NULL, &length, NULL);
+    return counts[SNAKECORE_PLANE_HEAD] == 1 && counts[SNAKECORE_PLANE_BODY] == length - 1 &&
+           counts[SNAKECORE_PLANE_FOOD] >= 1;
+}
+
+/* 两个相同的批次对比，并检查每一步的观测 */
+static int verify(const SnakeCoreConfig *config, int32_t games, int steps)
+{
+    SnakeCoreBatch *first = snakecore_create(config, games, NULL);
+    SnakeCoreBatch *second = snakecore_create(config, games, NULL);
+    const size_t size = (size_t)games * snakecore_observation_size(first);
+    uint8_t *obsFirst = malloc(size);
+    uint8_t *obsSecond = malloc(size);
+    float *obsFloat = malloc(size * sizeof(float));
+    int32_t *actions = malloc(games * sizeof(int32_t));
+    float *rewardsFirst = malloc(games * sizeof(float));
+    float *rewardsSecond = malloc(games * sizeof(float));
+    uint8_t *donesFirst = malloc(games);
+    uint8_t *donesSecond = malloc(games);
+    uint64_t state = 7;
+    int ok = 1;
+    long finished = 0;
+    for (int step = 0; step < steps && ok; step++)
+    {
+        randomActions(&state, actions, games);
+        snakecore_step(first, actions, rewardsFirst, donesFirst);
+        snakecore_step(second, actions, rewardsSecond, donesSecond);
+        snakecore_observe_u8(first, obsFirst);
+        snakecore_observe_u8(second, obsSecond);
+        snakecore_observe_f32(first, obsFloat);
+        ok = memcmp(obsFirst, obsSecond, size) == 0 && memcmp(rewardsFirst, rewardsSecond, games * sizeof(float)) == 0 &&
+             memcmp(donesFirst, donesSecond, games) == 0;
+        for (int32_t i = 0; i < games && ok; i++)
+        {
+            size_t offset = (size_t)i * snakecore_observation_size(first);
+            ok = checkObservation(first, i, obsFirst + offset, obsFloat + offset);
+            finished += donesFirst[i] != 0;
+        }
+    }
+    printf("校验: %s 模式 %d 局 x %d 步，结束 %ld 局，%s\n", config->unbounded ? "无边界" : "有边界", games, steps,
+           finished, ok ? "一致" : "不一致");
+    free(obsFirst);
+    free(obsSecond);
+    free(obsFloat);
+    free(actions);
+    free(rewardsFirst);
+    free(rewardsSecond);
+    free(donesFirst);
+    free(donesSecond);
+    snakecore_destroy(first);
+    snakecore_destroy(second);
+    return ok;
+}
+
+/* observe: 0 不观测，1 u8，2 f32 */
+static void throughput(const SnakeCoreConfig *config, int32_t games, int steps, int observe, const char *name)
+{
+    SnakeCoreBatch *batch = snakecore_create(config, games, NULL);
+    const size_t size = (size_t)games * snakecore_observation_size(batch);
+    uint8_t *obs = malloc(size);
+    float *obsFloat = malloc(size * sizeof(float));
+    int32_t *actions = malloc(games * sizeof(int32_t));
+    float *rewards = malloc(games * sizeof(float));
+    uint8_t *dones = malloc(games);
+    uint64_t state = 11;
+    double actionSeconds = 0.0;
+    double start = now();
+    for (int step = 0; step < steps; step++)
+    {
+        double actionStart = now();
+        randomActions(&state, actions, games);
+        actionSeconds += now() - actionStart;
+        snakecore_step(batch, actions, rewards, dones);
+        if (observe == 1)
+        {
+            snakecore_observe_u8(batch, obs);
+        }
+        else if (observe == 2)
+        {
+            snakecore_observe_f32(batch, obsFloat);
+        }
+    }
+    double seconds = now() - start - actionSeconds;
+    double perSecond = (double)games * steps / seconds;
+    printf("  %-16s %10.0f 观测/秒  %8.1f ns/局/步  %8.1f MB/s\n", name, perSecond, 1e9 / perSecond,
+           observe == 0 ? 0.0 : perSecond * snakecore_observation_size(batch) * (observe == 1 ? 1 : 4) / 1e6);
+    free(obs);
+    free(obsFloat);
+    free(actions);
+    free(rewards);
+    free(dones);
+    snakecore_destroy(batch);
+}
+
+int main(int argc, char **argv)
+{
+    int32_t games = 256;
+    int steps = 2000;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        int value = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--games") == 0)
+            games = value > 0 ? value : 1;
+        else if (strcmp(argv[i], "--steps") == 0)
+            steps = value > 0 ? value : 1;
+    }
+    if (snakecore_version() >> 16 != SNAKECORE_VERSION >> 16)
+    {
+        fprintf(stderr, "库的版本 %08x 与头文件 %08x 不兼容\n", snakecore_version(), SNAKECORE_VERSION);
+        return 1;
+    }
+
+    SnakeCoreConfig config;
+    snakecore_default_config(&config);
+    config.maxMoves = 500;
+    config.obstacles = 1;
+    int ok = verify(&config, 32, 3000);
+    config.unbounded = 1;
+    config.foodCount = 5;
+    ok = verify(&config, 32, 3000) && ok;
+
+    SnakeCoreConfig invalid = config;
+    invalid.columns = 4;
+    if (snakecore_create(&invalid, 1, NULL) != NULL || snakecore_create(&config, 0, NULL) != NULL)
+    {
+        fprintf(stderr, "无效的设置没有被拒绝\n");
+        ok = 0;
+    }
+
+    snakecore_default_config(&config);
+    printf("%d 局 x %d 步，%dx%d，每局观测 %d 个元素\n", games, steps, config.columns, config.rows,
+           SNAKECORE_PLANES * config.columns * config.rows);
+    throughput(&config, games, steps, 0, "step");
+    throughput(&config, games, steps, 1, "step + u8");
+    throughput(&config, games, steps, 2, "step + f32");
+    return ok ? 0 : 1;
+}
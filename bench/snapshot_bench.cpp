@@ -0,0 +1,265 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include "../simulation.h"
+
+// 快照/恢复基准测试：蛇身铺满整个游戏区域时保存和恢复一次的耗时
+// 同时检查恢复后继续运行的状态一致，以及字段超出范围、格子不在游戏区域内的快照被拒绝
+
+using benchClock = std::chrono::steady_clock;
+
+// 游戏区域 (像素)，与 Game 相同
+const int BOARD_WIDTH = WINDOW_WIDTH - 10 * GRID_SIZE;
+const int BOARD_HEIGHT = WINDOW_HEIGHT - 2 * GRID_SIZE;
+
+// 执行 iterations 次 op，重复若干轮，返回每次操作耗时 (纳秒) 的中位数
+template <typename Op>
+static double medianNanos(int iterations, Op op)
+{
+    std::vector<double> samples;
+    for (int round = 0; round < 15; round++)
+    {
+        auto start = benchClock::now();
+        for (int i = 0; i < iterations; i++)
+        {
+            op();
+        }
+        samples.push_back(std::chrono::duration<double, std::nano>(benchClock::now() - start).count() / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+// 验证恢复后的游戏与原游戏完全一致：继续用相同的输入运行，每一帧的校验和都必须相同
+static bool verifyRoundTrip()
+{
+    Simulation original(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    // 多个会到期的食物，验证食物和到期定时器的对应关系也能恢复
+    original.setFoodOptions(8, 300);
+    original.reset(GameMode::Unbounded, Difficulty::Hard, MapType::Obstacles, 12345);
+    Random inputs(99);
+    const Direction directions[] = {Direction::Up, Direction::Left, Direction::Down, Direction::Right};
+    for (int tick = 0; tick < 500 && !original.isGameOver(); tick++)
+    {
+        if (inputs.nextInt(4) == 0)
+        {
+            original.addDirectionToQueue(directions[inputs.nextInt(4)]);
+        }
+        original.tick(0.05f);
+    }
+
+    std::vector<uint8_t> snapshot;
+    original.saveSnapshot(snapshot);
+    Simulation restored(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    if (!restored.loadSnapshot(snapshot.data(), snapshot.size()) || restored.checksum() != original.checksum())
+    {
+        return false;
+    }
+    for (int tick = 0; tick < 2000; tick++)
+    {
+        if (inputs.nextInt(4) == 0)
+        {
+            Direction direction = directions[inputs.nextInt(4)];
+            original.addDirectionToQueue(direction);
+            restored.addDirectionToQueue(direction);
+        }
+        original.tick(0.05f);
+        restored.tick(0.05f);
+        if (original.checksum() != restored.checksum())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 快照中的字段偏移 (字节)：文件头 10 字节之后是模式，蛇的方向在速度和累积时间之后
+const size_t MODE_OFFSET = 10;
+const size_t GAME_OVER_OFFSET = 27;
+const size_t DIRECTION_OFFSET = 36;
+const size_t CURRENT_DIRECTION_OFFSET = 37;
+const size_t QUEUE_SIZE_OFFSET = 38;
+
+// 第一个定时器的 payload 的偏移：跳过方向输入缓冲、食物和计时字段
+static size_t firstTimerPayloadOffset(const std::vector<uint8_t> &snapshot, uint16_t &timerCount)
+{
+    size_t offset = QUEUE_SIZE_OFFSET + 1 + snapshot[QUEUE_SIZE_OFFSET] + 2 + 4;
+    uint16_t foodItems;
+    std::memcpy(&foodItems, snapshot.data() + offset, sizeof(foodItems));
+    offset += 2 + 3 * foodItems + 4 + 4 + 8;
+    std::memcpy(&timerCount, snapshot.data() + offset, sizeof(timerCount));
+    return offset + 2 + 4;
+}
+
+// 损坏的快照必须被拒绝，并且不修改已有的状态
+static bool verifyCorrupted()
+{
+    Simulation original(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    original.setFoodOptions(4, 300);
+    original.reset(GameMode::Bounded, Difficulty::Easy, MapType::Obstacles, 777);
+    for (int tick = 0; tick < 20; tick++)
+    {
+        original.tick(0.02f);
+    }
+    // 缓冲中留下输入 (与当前方向相反的会被丢弃)
+    original.addDirectionToQueue(Direction::Left);
+    original.addDirectionToQueue(Direction::Up);
+    std::vector<uint8_t> snapshot;
+    original.saveSnapshot(snapshot);
+    if (snapshot[QUEUE_SIZE_OFFSET] == 0)
+    {
+        return false;
+    }
+
+    struct Corruption
+    {
+        const char *name;
+        size_t offset;
+        uint8_t value;
+    };
+    const Corruption corruptions[] = {
+        {"模式", MODE_OFFSET, 2},
+        {"蛇的方向", DIRECTION_OFFSET, 5},
+        {"当前方向", CURRENT_DIRECTION_OFFSET, static_cast<uint8_t>(Direction::None)},
+        {"缓冲中的方向", QUEUE_SIZE_OFFSET + 1, static_cast<uint8_t>(Direction::None)},
+    };
+    Simulation restored(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    restored.reset(GameMode::Unbounded, Difficulty::Hard, MapType::Empty, 5);
+    const uint32_t before = restored.checksum();
+    bool ok = true;
+    for (const Corruption &corruption : corruptions)
+    {
+        std::vector<uint8_t> corrupted = snapshot;
+        corrupted[corruption.offset] = corruption.value;
+        if (restored.loadSnapshot(corrupted.data(), corrupted.size()) || restored.checksum() != before)
+        {
+            std::cerr << "接受了损坏的快照: " << corruption.name << std::endl;
+            ok = false;
+        }
+    }
+
+    // 定时器的类型和参数：到期时用作特殊效果层数的下标或者食物的格子
+    uint16_t timerCount = 0;
+    size_t payloadOffset = firstTimerPayloadOffset(snapshot, timerCount);
+    if (timerCount == 0)
+    {
+        return false;
+    }
+    struct PayloadCorruption
+    {
+        const char *name;
+        uint32_t payload;
+    };
+    const PayloadCorruption payloads[] = {
+        {"特殊效果的类型", (static_cast<uint32_t>(TimerKind::Effect) << 24) | 7},
+        {"定时器的类型", 2u << 24},
+        {"没有食物的格子", (static_cast<uint32_t>(TimerKind::FoodExpiry) << 24) | 0}, // 外圈上不会有食物
+    };
+    for (const PayloadCorruption &corruption : payloads)
+    {
+        std::vector<uint8_t> corrupted = snapshot;
+        std::memcpy(corrupted.data() + payloadOffset, &corruption.payload, sizeof(corruption.payload));
+        if (restored.loadSnapshot(corrupted.data(), corrupted.size()) || restored.checksum() != before)
+        {
+            std::cerr << "接受了损坏的快照: " << corruption.name << std::endl;
+            ok = false;
+        }
+    }
+
+    // 蛇身和障碍物的格子：快照的最后是障碍物和蛇身 (各自前面是 u16 的个数)，格子 0 在外圈的角上
+    const size_t bodyOffset = snapshot.size() - 2 * original.getSnake().getCells().size();
+    const size_t obstacleOffset = bodyOffset - 2 - 2 * original.getObstacles().size();
+    const Corruption cells[] = {
+        {"外圈上的蛇头", bodyOffset, 0},
+        {"外圈上的蛇身", bodyOffset + 2, 0},
+        {"外圈上的障碍物", obstacleOffset, 0},
+    };
+    for (const Corruption &corruption : cells)
+    {
+        std::vector<uint8_t> corrupted = snapshot;
+        corrupted[corruption.offset] = corruption.value;
+        corrupted[corruption.offset + 1] = 0;
+        if (restored.loadSnapshot(corrupted.data(), corrupted.size()) || restored.checksum() != before)
+        {
+            std::cerr << "接受了损坏的快照: " << corruption.name << std::endl;
+            ok = false;
+        }
+    }
+
+    // 撞墙结束的一局蛇头在外圈上，可以恢复；改成没有结束之后必须被拒绝
+    Simulation crashed(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    crashed.reset(GameMode::Bounded, Difficulty::Easy, MapType::Empty, 777);
+    for (int tick = 0; tick < 10000 && !crashed.isGameOver(); tick++)
+    {
+        crashed.tick(0.02f);
+    }
+    std::vector<uint8_t> wallHit;
+    crashed.saveSnapshot(wallHit);
+    if (!crashed.isGameOver() || crashed.getGrid().isInside(crashed.getSnake().getCells()[0]) ||
+        !restored.loadSnapshot(wallHit.data(), wallHit.size()) || restored.checksum() != crashed.checksum())
+    {
+        std::cerr << "撞墙结束的快照没有恢复" << std::endl;
+        ok = false;
+    }
+    const uint32_t afterCrash = restored.checksum();
+    wallHit[GAME_OVER_OFFSET] = 0;
+    if (restored.loadSnapshot(wallHit.data(), wallHit.size()) || restored.checksum() != afterCrash)
+    {
+        std::cerr << "接受了损坏的快照: 没有结束但蛇头在外圈上" << std::endl;
+        ok = false;
+    }
+    return ok;
+}
+
+int main()
+{
+    if (!verifyRoundTrip())
+    {
+        std::cerr << "快照恢复后状态不一致" << std::endl;
+        return 1;
+    }
+    if (!verifyCorrupted())
+    {
+        return 1;
+    }
+
+    // 构造铺满游戏区域的蛇 (蛇形排列，跳过食物所在的格子)
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    simulation.reset(GameMode::Bounded, Difficulty::Easy, MapType::Obstacles, 1);
+    int width = simulation.getBoardWidth();
+    int height = simulation.getBoardHeight();
+    std::vector<SnakeBody> body;
+    for (int y = 0; y < height; y++)
+    {
+        for (int i = 0; i < width; i++)
+        {
+            int x = (y % 2 == 0) ? i : width - 1 - i;
+            if (simulation.getFoods().find(simulation.getGrid().toCell(x, y)) == nullptr)
+            {
+                body.push_back(SnakeBody(x, y));
+            }
+        }
+    }
+    simulation.setSnakeBody(body);
+
+    std::vector<uint8_t> snapshot;
+    simulation.saveSnapshot(snapshot);
+    Simulation restored(BOARD_WIDTH, BOARD_HEIGHT, 2);
+
+    double saveNanos = medianNanos(2000, [&]() { simulation.saveSnapshot(snapshot); });
+    double loadNanos = medianNanos(2000, [&]() { restored.loadSnapshot(snapshot.data(), snapshot.size()); });
+    if (restored.checksum() != simulation.checksum())
+    {
+        std::cerr << "快照恢复后状态不一致" << std::endl;
+        return 1;
+    }
+
+    std::cout << "board " << width << "x" << height << ", snake length " << body.size()
+              << ", snapshot " << snapshot.size() << " bytes" << std::endl;
+    std::cout << "snapshot: " << saveNanos / 1000.0 << " us" << std::endl;
+    std::cout << "restore:  " << loadNanos / 1000.0 << " us" << std::endl;
+    return 0;
+}
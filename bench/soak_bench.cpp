@@ -0,0 +1,176 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "../board_renderer.h"
+#include "../greedy_bot.h"
+#include "../leader_board.h"
+#include "../render_backend.h"
+#include "../soak_monitor.h"
+
+// 长时间运行监控的基准测试：
+//   1. 构造的样本序列：平稳 (有噪声和预热阶段的增长)、长尾变长 (最后一段的 p99 多出几毫秒，不到掉帧的程度)、
+//      内存泄漏、文件描述符泄漏、纹理泄漏、帧耗时变慢，检查 SoakMonitor 只在后几种情况下报告问题
+//   2. 无界面的长时间运行：与 Game 相同的每局流程 (读排行榜、机器人操作、每帧软件渲染、每秒写存档、
+//      游戏结束时把得分合并到排行榜、重新开始)，按模拟的时间 (每帧 1/30 秒) 采样并打印每小时的趋势
+// 构造的序列判断错误或者无界面运行发现资源持续增长、帧耗时变慢时返回非零
+// 用法: soak_bench [--games 局数]
+
+const int BOARD_WIDTH = WINDOW_WIDTH - 10 * GRID_SIZE;
+const int BOARD_HEIGHT = WINDOW_HEIGHT - 2 * GRID_SIZE;
+const double FRAME_TIME = 1.0 / 30.0;
+// 一局最多的帧数，之后强制结束 (贪心机器人偶尔会一直绕圈)
+const int MAX_GAME_FRAMES = 6000;
+
+// 构造的序列：每个样本之前记录 100 帧，其中 2 帧是 p99 的值
+struct Series
+{
+    const char *name;
+    double rssPerSample;   // 每个样本增长的内存 (字节)
+    int filesEvery;        // 每隔多少个样本多一个文件描述符 (0 表示不变)
+    int texturesEvery;     // 每隔多少个样本多一个纹理
+    double p99Growth;      // 每个样本 p99 增加的毫秒数
+    double p99Step;        // 最后四分之一的样本 p99 增加的毫秒数 (主机变忙，写存档和调度的长尾变长)
+    bool expectHealthy;
+};
+
+static bool checkSeries(const Series &series)
+{
+    const double INTERVAL = 10.0;
+    SoakMonitor monitor(INTERVAL, 60.0);
+    Random random(17);
+    for (int i = 0; i < 80; i++)
+    {
+        double seconds = (i + 1) * INTERVAL;
+        // 预热阶段纹理缓存和内存池在增长
+        bool warmup = seconds < 60.0;
+        double rss = 50e6 + (warmup ? i * 2e6 : 12e6) + random.nextInt(300000) + i * series.rssPerSample;
+        int files = 8 + (random.nextInt(10) == 0 ? 1 : 0) + (series.filesEvery ? i / series.filesEvery : 0);
+        int textures = (warmup ? 4 * i : 24) + (series.texturesEvery ? i / series.texturesEvery : 0);
+        double p99 = 5.0 + random.nextInt(100) / 100.0 + i * series.p99Growth + (i >= 60 ? series.p99Step : 0.0);
+        for (int frame = 0; frame < 100; frame++)
+        {
+            monitor.recordFrame(frame < 98 ? 2.0 + random.nextInt(50) / 100.0 : p99);
+        }
+        monitor.sample(seconds, textures, static_cast<size_t>(rss), files);
+    }
+    SoakVerdict verdict = monitor.analyze();
+    bool ok = verdict.enoughSamples && verdict.isHealthy() == series.expectHealthy;
+    std::cout << "  " << series.name << ": " << (verdict.rssGrowth ? "内存增长 " : "")
+              << (verdict.fileGrowth ? "文件增长 " : "") << (verdict.textureGrowth ? "纹理增长 " : "")
+              << (verdict.latencyDrift ? "帧耗时变慢 " : "") << (verdict.isHealthy() ? "正常 " : "")
+              << (ok ? "(符合预期)" : "(不符合预期)") << std::endl;
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t games = 30;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::string(argv[i]) == "--games")
+        {
+            games = std::max(1, std::atoi(argv[i + 1]));
+        }
+    }
+
+    bool ok = true;
+    std::cout << "构造的样本序列:" << std::endl;
+    const Series series[] = {
+        {"平稳", 0.0, 0, 0, 0.0, 0.0, true},
+        {"长尾变长 (主机变忙)", 0.0, 0, 0, 0.0, 4.5, true},
+        {"内存泄漏", 200000.0, 0, 0, 0.0, 0.0, false},
+        {"文件描述符泄漏", 0.0, 10, 0, 0.0, 0.0, false},
+        {"纹理泄漏", 0.0, 0, 15, 0.0, 0.0, false},
+        {"帧耗时变慢", 0.0, 0, 0, 0.3, 0.0, false},
+    };
+    for (const Series &entry : series)
+    {
+        ok = checkSeries(entry) && ok;
+    }
+
+    // 无界面运行：排行榜和存档写到临时目录
+    const std::string prefix = "/tmp/snake_soak_" + std::to_string(getpid());
+    const std::string recordPath = prefix + ".dat";
+    const std::string savePath = prefix + ".save";
+    LeaderBoard leaderBoard(recordPath, 3);
+    leaderBoard.clear();
+    leaderBoard.write();
+
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    EventBus eventBus;
+    EventBus::Subscription *events = eventBus.subscribe();
+    simulation.setEventBus(&eventBus);
+    SoftwareRenderBackend backend(WINDOW_WIDTH, WINDOW_HEIGHT);
+    BoardRenderer renderer(backend, WINDOW_WIDTH, WINDOW_HEIGHT, BOARD_WIDTH, BOARD_HEIGHT);
+    GreedyBot bot;
+    SoakMonitor monitor(10.0, 60.0);
+    std::vector<uint8_t> saveBuffer;
+
+    using benchClock = std::chrono::steady_clock;
+    auto start = benchClock::now();
+    uint64_t frames = 0;
+    for (uint64_t game = 0; game < games; game++)
+    {
+        leaderBoard.read();
+        renderer.renderStaticLayer(leaderBoard.getScores());
+        GameMode mode = (game & 1) ? GameMode::Unbounded : GameMode::Bounded;
+        Difficulty difficulty = (game & 2) ? Difficulty::Hard : Difficulty::Easy;
+        MapType mapType = (game & 4) ? MapType::Obstacles : MapType::Empty;
+        simulation.reset(mode, difficulty, mapType, game + 1);
+
+        CellIndex lastHead = NO_CELL;
+        bool alive = true;
+        for (int gameFrame = 0; alive && gameFrame < MAX_GAME_FRAMES; gameFrame++)
+        {
+            auto frameStart = benchClock::now();
+            if (simulation.getSnake().getHead() != lastHead)
+            {
+                simulation.addDirectionToQueue(bot.choose(simulation));
+                lastHead = simulation.getSnake().getHead();
+            }
+            alive = simulation.tick(static_cast<float>(FRAME_TIME));
+            GameEvent event;
+            while (events->pop(event))
+            {
+            }
+            renderer.renderFrame(simulation);
+            // 每秒写一次存档 (先写临时文件再重命名)
+            if (alive && frames % 30 == 0)
+            {
+                simulation.saveSnapshot(saveBuffer);
+                std::string tempPath = savePath + ".tmp";
+                std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+                file.write(reinterpret_cast<const char *>(saveBuffer.data()), saveBuffer.size());
+                file.close();
+                std::rename(tempPath.c_str(), savePath.c_str());
+            }
+            frames++;
+            monitor.recordFrame(std::chrono::duration<double, std::milli>(benchClock::now() - frameStart).count());
+            monitor.poll(frames * FRAME_TIME, backend.getLiveTextures());
+        }
+        leaderBoard.submit(simulation.getPoints());
+        std::remove(savePath.c_str());
+        monitor.recordGame();
+    }
+    double seconds = std::chrono::duration<double>(benchClock::now() - start).count();
+    monitor.sample(frames * FRAME_TIME, backend.getLiveTextures(), SoakMonitor::readResidentBytes(),
+                   SoakMonitor::countOpenFiles());
+    std::remove(recordPath.c_str());
+    std::remove((recordPath + ".lock").c_str());
+
+    std::cout << "无界面运行: " << games << " 局, " << frames << " 帧 (模拟 " << frames * FRAME_TIME / 3600.0
+              << " 小时), 实际 " << seconds << " 秒" << std::endl;
+    bool healthy = monitor.report(std::cout);
+    if (!healthy)
+    {
+        std::cerr << "长时间运行发现资源持续增长或帧耗时变慢" << std::endl;
+    }
+    return ok && healthy ? 0 : 1;
+}
@@ -0,0 +1,398 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <cstdlib>
+#include <cctype>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "../simulation.h"
+#include "../board_renderer.h"
+#include "../terminal_backend.h"
+
+// 终端差分输出基准测试
+// 1. 200x60 的终端上贪心机器人玩游戏，统计差分输出和整屏重绘每帧的字节数，
+//    并用一个简单的终端模拟器检查两种输出得到的画面完全相同
+// 2. 通过限速读取的伪终端模拟慢速终端，测量两种输出每秒能显示多少帧
+
+using benchClock = std::chrono::steady_clock;
+
+// 200x60 个字符的终端 (像素)
+const int SCREEN_WIDTH = 100 * GRID_SIZE;
+const int SCREEN_HEIGHT = 60 * GRID_SIZE;
+const int BOARD_WIDTH = SCREEN_WIDTH - 10 * GRID_SIZE;
+const int BOARD_HEIGHT = SCREEN_HEIGHT - 2 * GRID_SIZE;
+const int COLUMNS = SCREEN_WIDTH * 2 / GRID_SIZE;
+const int ROWS = SCREEN_HEIGHT / GRID_SIZE;
+const int FRAMES = 600;
+const float FRAME_TIME = 1.0f / 30.0f;
+
+// 贪心机器人：选择不会立即死亡且离最近的食物最近的方向 (无边界模式)
+static Direction chooseDirection(const Simulation &simulation)
+{
+    const Snake &snake = simulation.getSnake();
+    const CellGrid &grid = simulation.getGrid();
+    const int headX = grid.getX(snake.getHead());
+    const int headY = grid.getY(snake.getHead());
+    int width = simulation.getBoardWidth();
+    int height = simulation.getBoardHeight();
+    const Direction directions[] = {Direction::Up, Direction::Down, Direction::Left, Direction::Right};
+    const int dx[] = {0, 0, -1, 1};
+    const int dy[] = {-1, 1, 0, 0};
+
+    Direction best = snake.getDirection();
+    int bestDistance = -1;
+    for (int i = 0; i < 4; i++)
+    {
+        if ((i ^ 1) == static_cast<int>(snake.getDirection()))
+        {
+            continue;
+        }
+        int x = (headX + dx[i] + width) % width;
+        int y = (headY + dy[i] + height) % height;
+        if (snake.isPartOfSnake(x, y))
+        {
+            continue;
+        }
+        int distance = -1;
+        for (const auto &item : simulation.getFoods().getItems())
+        {
+            int d = std::abs(grid.getX(item.cell) - x) + std::abs(grid.getY(item.cell) - y);
+            if (distance < 0 || d < distance)
+            {
+                distance = d;
+            }
+        }
+        if (bestDistance < 0 || distance < bestDistance)
+        {
+            bestDistance = distance;
+            best = directions[i];
+        }
+    }
+    return best;
+}
+
+// 只支持后端用到的序列 (CUP、CUF、CUB、256 色 SGR) 的终端模拟器
+class ScreenModel
+{
+public:
+    struct Cell
+    {
+        char ch = '\0';
+        int fg = -1;
+        int bg = -1;
+    };
+
+    ScreenModel(int columns, int rows) : mColumns(columns), mRows(rows), mCells(columns * rows) {}
+
+    void feed(const std::string &data)
+    {
+        size_t i = 0;
+        while (i < data.size())
+        {
+            if (data[i] == '\x1b' && i + 1 < data.size() && data[i + 1] == '[')
+            {
+                std::vector<int> params;
+                int value = -1;
+                i += 2;
+                while (i < data.size() && (std::isdigit(static_cast<unsigned char>(data[i])) || data[i] == ';'))
+                {
+                    if (data[i] == ';')
+                    {
+                        params.push_back(value);
+                        value = -1;
+                    }
+                    else
+                    {
+                        value = (value < 0 ? 0 : value * 10) + (data[i] - '0');
+                    }
+                    i++;
+                }
+                params.push_back(value);
+                control(data[i], params);
+                i++;
+            }
+            else
+            {
+                if (mColumn >= mColumns)
+                {
+                    mColumn = 0;
+                    mRow = std::min(mRow + 1, mRows - 1);
+                }
+                mCells[mRow * mColumns + mColumn] = Cell{data[i], mFg, mBg};
+                mColumn++;
+                i++;
+            }
+        }
+    }
+
+    // 两个画面是否相同 (空格不比较前景色)
+    bool sameAs(const ScreenModel &other) const
+    {
+        for (size_t i = 0; i < mCells.size(); i++)
+        {
+            const Cell &a = mCells[i];
+            const Cell &b = other.mCells[i];
+            if (a.ch != b.ch || a.bg != b.bg || (a.ch != ' ' && a.fg != b.fg))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    int mColumns;
+    int mRows;
+    std::vector<Cell> mCells;
+    int mColumn = 0;
+    int mRow = 0;
+    int mFg = -1;
+    int mBg = -1;
+
+    void control(char command, const std::vector<int> &params)
+    {
+        int first = params[0] < 0 ? 1 : params[0];
+        if (command == 'H')
+        {
+            mRow = first - 1;
+            mColumn = (params.size() > 1 && params[1] > 0) ? params[1] - 1 : 0;
+        }
+        else if (command == 'C')
+        {
+            mColumn = std::min(mColumn + first, mColumns - 1);
+        }
+        else if (command == 'D')
+        {
+            mColumn = std::max(mColumn - first, 0);
+        }
+        else if (command == 'm')
+        {
+            for (size_t i = 0; i + 2 < params.size(); i += 3)
+            {
+                if (params[i] == 38)
+                    mFg = params[i + 2];
+                else if (params[i] == 48)
+                    mBg = params[i + 2];
+            }
+        }
+    }
+};
+
+// 统计值：平均值和分位数
+static void printBytes(const char *name, std::vector<size_t> samples)
+{
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (size_t sample : samples)
+    {
+        total += sample;
+    }
+    std::cout << "  " << name << ": avg " << total / samples.size() << ", p50 " << samples[samples.size() / 2]
+              << ", p99 " << samples[samples.size() * 99 / 100] << ", max " << samples.back() << std::endl;
+}
+
+static double average(const std::vector<size_t> &samples)
+{
+    double total = 0.0;
+    for (size_t sample : samples)
+    {
+        total += sample;
+    }
+    return total / samples.size();
+}
+
+// 每帧字节数，并检查差分输出的画面与整屏重绘一致
+static bool measureFrameBytes(double &diffAverage, double &fullAverage)
+{
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    simulation.setFoodOptions(20, 0);
+    simulation.reset(GameMode::Unbounded, Difficulty::Easy, MapType::Empty, 42);
+
+    TerminalRenderBackend diffBackend(COLUMNS, ROWS, -1);
+    TerminalRenderBackend fullBackend(COLUMNS, ROWS, -1);
+    fullBackend.setFullRedraw(true);
+    BoardRenderer diffRenderer(diffBackend, SCREEN_WIDTH, SCREEN_HEIGHT, BOARD_WIDTH, BOARD_HEIGHT);
+    BoardRenderer fullRenderer(fullBackend, SCREEN_WIDTH, SCREEN_HEIGHT, BOARD_WIDTH, BOARD_HEIGHT);
+    diffRenderer.renderStaticLayer(std::vector<int>(3, 0));
+    fullRenderer.renderStaticLayer(std::vector<int>(3, 0));
+    ScreenModel diffScreen(COLUMNS, ROWS);
+    ScreenModel fullScreen(COLUMNS, ROWS);
+
+    std::vector<size_t> diffBytes;
+    std::vector<size_t> fullBytes;
+    std::vector<size_t> changedCells;
+    bool ok = true;
+    for (int frame = 0; frame < FRAMES; frame++)
+    {
+        simulation.addDirectionToQueue(chooseDirection(simulation));
+        if (!simulation.tick(FRAME_TIME))
+        {
+            simulation.reset(GameMode::Unbounded, Difficulty::Easy, MapType::Empty, 42 + frame);
+        }
+        diffRenderer.renderFrame(simulation);
+        fullRenderer.renderFrame(simulation);
+        diffScreen.feed(diffBackend.getOutput());
+        fullScreen.feed(fullBackend.getOutput());
+        if (!diffScreen.sameAs(fullScreen))
+        {
+            std::cerr << "第 " << frame << " 帧差分输出的画面与整屏重绘不同" << std::endl;
+            ok = false;
+            break;
+        }
+        // 第一帧总是输出整个画面，不计入统计
+        if (frame > 0)
+        {
+            diffBytes.push_back(diffBackend.getLastFrameBytes());
+            fullBytes.push_back(fullBackend.getLastFrameBytes());
+            changedCells.push_back(static_cast<size_t>(diffBackend.getLastChangedCells()));
+        }
+    }
+    if (!ok)
+    {
+        return false;
+    }
+
+    std::cout << COLUMNS << "x" << ROWS << " terminal, " << FRAMES << " frames, bytes per frame:" << std::endl;
+    printBytes("diff", diffBytes);
+    printBytes("full redraw", fullBytes);
+    printBytes("changed cells", changedCells);
+    diffAverage = average(diffBytes);
+    fullAverage = average(fullBytes);
+    std::cout << "  diff bytes per changed cell: " << diffAverage / average(changedCells) << std::endl;
+
+    // 差分输出的字节数应该与变化的字符数成正比，远小于整屏重绘
+    double perCell = diffAverage / std::max(1.0, average(changedCells));
+    if (diffAverage * 10 > fullAverage || perCell > 16.0)
+    {
+        std::cerr << "差分输出的字节数过大" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 慢速终端：读取线程按固定速率从伪终端主设备读取，
+// 每帧写完后等待终端读完这一帧，得到每秒能显示的帧数
+static bool measureSlowTerminal(bool fullRedraw, size_t bytesPerSecond, double seconds)
+{
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+    {
+        std::cerr << "无法创建伪终端" << std::endl;
+        return false;
+    }
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    if (slave < 0)
+    {
+        close(master);
+        std::cerr << "无法打开伪终端从设备" << std::endl;
+        return false;
+    }
+    struct termios raw;
+    tcgetattr(slave, &raw);
+    cfmakeraw(&raw);
+    tcsetattr(slave, TCSANOW, &raw);
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> consumed(0);
+    std::thread reader([&]() {
+        char buffer[4096];
+        auto start = benchClock::now();
+        size_t total = 0;
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            double elapsed = std::chrono::duration<double>(benchClock::now() - start).count();
+            size_t allowance = static_cast<size_t>(elapsed * bytesPerSecond) - std::min(total, static_cast<size_t>(elapsed * bytesPerSecond));
+            if (allowance == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            ssize_t count = read(master, buffer, std::min(allowance, sizeof(buffer)));
+            if (count > 0)
+            {
+                total += static_cast<size_t>(count);
+                consumed.store(total, std::memory_order_release);
+            }
+            else
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    });
+
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    simulation.setFoodOptions(20, 0);
+    simulation.reset(GameMode::Unbounded, Difficulty::Easy, MapType::Empty, 7);
+    TerminalRenderBackend backend(COLUMNS, ROWS, slave);
+    backend.setFullRedraw(fullRedraw);
+    BoardRenderer boardRenderer(backend, SCREEN_WIDTH, SCREEN_HEIGHT, BOARD_WIDTH, BOARD_HEIGHT);
+    boardRenderer.renderStaticLayer(std::vector<int>(3, 0));
+
+    // 第一帧输出整个画面，不计入统计
+    size_t produced = 0;
+    auto waitDisplayed = [&]() {
+        while (consumed.load(std::memory_order_acquire) < produced)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    };
+    boardRenderer.renderFrame(simulation);
+    produced += backend.getLastFrameBytes();
+    waitDisplayed();
+
+    int frames = 0;
+    size_t bytes = 0;
+    auto start = benchClock::now();
+    double elapsed = 0.0;
+    while (elapsed < seconds)
+    {
+        simulation.addDirectionToQueue(chooseDirection(simulation));
+        if (!simulation.tick(FRAME_TIME))
+        {
+            simulation.reset(GameMode::Unbounded, Difficulty::Easy, MapType::Empty, 7 + frames);
+        }
+        boardRenderer.renderFrame(simulation);
+        produced += backend.getLastFrameBytes();
+        bytes += backend.getLastFrameBytes();
+        waitDisplayed();
+        frames++;
+        elapsed = std::chrono::duration<double>(benchClock::now() - start).count();
+    }
+
+    stop.store(true);
+    reader.join();
+    close(slave);
+    close(master);
+    std::cout << "  " << (fullRedraw ? "full redraw" : "diff") << " at " << bytesPerSecond << " B/s: "
+              << frames / elapsed << " frames/s, " << bytes / frames << " bytes/frame" << std::endl;
+    return true;
+}
+
+int main()
+{
+    double diffAverage = 0.0;
+    double fullAverage = 0.0;
+    if (!measureFrameBytes(diffAverage, fullAverage))
+    {
+        return 1;
+    }
+
+    // 115200 波特率的串口约 11520 B/s
+    std::cout << "slow pty:" << std::endl;
+    const size_t rates[] = {11520, 1000000};
+    for (size_t rate : rates)
+    {
+        if (!measureSlowTerminal(false, rate, 1.0) || !measureSlowTerminal(true, rate, 1.0))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "../board_renderer.h"
+#include "../simulation_thread.h"
+
+// 模拟线程与渲染分离的测试：人为地让绘制变慢 (每帧固定变慢，或者周期性地卡顿)，
+// 比较原来的单线程循环 (逻辑、绘制和等待依次执行) 与模拟线程的逻辑帧间隔直方图；
+// 同时检查渲染线程读到的每个快照都是完整的 (蛇身连续，逻辑帧编号不倒退)
+// 模拟线程的逻辑帧间隔 p99 超过目标的 1.5 倍，或者读到不完整的快照时返回非零
+
+using benchClock = std::chrono::steady_clock;
+
+const int BOARD_WIDTH = WINDOW_WIDTH - 10 * GRID_SIZE;
+const int BOARD_HEIGHT = WINDOW_HEIGHT - 2 * GRID_SIZE;
+// 逻辑帧率和目标绘制帧率相同，两种循环在不卡顿时的逻辑帧间隔一样
+const int TICK_RATE = 60;
+const double PERIOD_MS = 1000.0 / TICK_RATE;
+const double SECONDS = 3.0;
+
+// 绘制变慢的方式
+struct RenderProfile
+{
+    const char *name;
+    int slowMs;   // 每帧额外的绘制时间
+    int stallMs;  // 周期性卡顿的时长
+    int stallEvery; // 每隔多少帧卡顿一次 (0 表示不卡顿)
+};
+
+static int renderDelay(const RenderProfile &profile, int frame)
+{
+    int delay = profile.slowMs;
+    if (profile.stallEvery > 0 && frame % profile.stallEvery == profile.stallEvery - 1)
+    {
+        delay += profile.stallMs;
+    }
+    return delay;
+}
+
+// 开始一局：无边界模式，蛇沿一列移动，偶尔转向
+static void resetGame(Simulation &simulation, uint64_t seed)
+{
+    simulation.setFoodOptions(20, 0);
+    simulation.reset(GameMode::Unbounded, Difficulty::Easy, MapType::Empty, seed);
+    std::vector<SnakeBody> body;
+    for (int i = 0; i < 20; i++)
+    {
+        body.push_back(SnakeBody(5, 4 + i));
+    }
+    simulation.setSnakeBody(body);
+}
+
+// 机器人：每隔一段时间选择一个与当前方向垂直的方向
+static Direction chooseDirection(Random &random, Direction current)
+{
+    bool vertical = current == Direction::Up || current == Direction::Down;
+    if (vertical)
+    {
+        return random.nextInt(2) ? Direction::Left : Direction::Right;
+    }
+    return random.nextInt(2) ? Direction::Up : Direction::Down;
+}
+
+// 快照是否完整：蛇身相邻的格子在游戏区域中相邻 (无边界模式可以穿过边缘)
+static bool isConsistent(const BoardSnapshot &snapshot)
+{
+    const CellGrid &grid = snapshot.grid;
+    if (snapshot.snake.empty())
+    {
+        return false;
+    }
+    for (size_t i = 1; i < snapshot.snake.size(); i++)
+    {
+        int dx = std::abs(grid.getX(snapshot.snake[i]) - grid.getX(snapshot.snake[i - 1]));
+        int dy = std::abs(grid.getY(snapshot.snake[i]) - grid.getY(snapshot.snake[i - 1]));
+        dx = std::min(dx, grid.getColumns() - dx);
+        dy = std::min(dy, grid.getRows() - dy);
+        if (dx + dy != 1)
+        {
+            // 蛇头撞到自己时最后一个快照里蛇头和身体重叠
+            return snapshot.gameOver && i == 1;
+        }
+    }
+    return true;
+}
+
+struct LoopResult
+{
+    std::vector<double> intervals; // 逻辑帧间隔 (毫秒)
+    int frames = 0;                // 绘制的帧数
+    uint64_t torn = 0;             // 不完整的快照
+    uint64_t backwards = 0;        // 逻辑帧编号倒退
+};
+
+// 原来的单线程循环：逻辑、绘制、等待依次执行，绘制多慢逻辑帧间隔就多长
+static LoopResult runSerialized(const RenderProfile &profile, BoardRenderer &renderer)
+{
+    LoopResult result;
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    uint64_t seed = 1;
+    resetGame(simulation, seed);
+    Random random(3);
+    Direction direction = Direction::Up;
+
+    auto end = benchClock::now() + std::chrono::duration_cast<benchClock::duration>(std::chrono::duration<double>(SECONDS));
+    auto lastFrameTime = benchClock::now();
+    for (int frame = 0; benchClock::now() < end; frame++)
+    {
+        auto currentFrameTime = benchClock::now();
+        float deltaTime = std::chrono::duration<float>(currentFrameTime - lastFrameTime).count();
+        lastFrameTime = currentFrameTime;
+        if (frame > 0)
+        {
+            result.intervals.push_back(deltaTime * 1000.0);
+        }
+
+        if (frame % 40 == 39)
+        {
+            direction = chooseDirection(random, direction);
+            simulation.addDirectionToQueue(direction);
+        }
+        if (!simulation.update(deltaTime))
+        {
+            resetGame(simulation, ++seed);
+            direction = Direction::Up;
+        }
+        renderer.renderFrame(simulation);
+        std::this_thread::sleep_for(std::chrono::milliseconds(renderDelay(profile, frame)));
+        result.frames++;
+
+        float sleepTime = 1.0f / TICK_RATE - std::chrono::duration<float>(benchClock::now() - currentFrameTime).count();
+        if (sleepTime > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::duration<float>(sleepTime));
+        }
+        simulation.updateEffects(deltaTime);
+    }
+    return result;
+}
+
+// 模拟线程按自己的逻辑帧率推进，渲染循环只绘制最新的快照
+static LoopResult runThreaded(const RenderProfile &profile, BoardRenderer &renderer)
+{
+    LoopResult result;
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    uint64_t seed = 1;
+    resetGame(simulation, seed);
+    SimulationThread thread(simulation, TICK_RATE);
+    thread.start();
+    Random random(3);
+    Direction direction = Direction::Up;
+    uint64_t lastTick = 0;
+
+    auto end = benchClock::now() + std::chrono::duration_cast<benchClock::duration>(std::chrono::duration<double>(SECONDS));
+    for (int frame = 0; benchClock::now() < end; frame++)
+    {
+        auto currentFrameTime = benchClock::now();
+        if (frame % 40 == 39)
+        {
+            direction = chooseDirection(random, direction);
+            thread.addDirection(direction, 0);
+        }
+        if (thread.isFinished())
+        {
+            // 游戏结束：停止线程后才能访问 Simulation，重新开始一局
+            thread.stop();
+            resetGame(simulation, ++seed);
+            direction = Direction::Up;
+            thread.start();
+        }
+
+        const BoardSnapshot &snapshot = thread.acquireSnapshot();
+        if (!isConsistent(snapshot))
+        {
+            result.torn++;
+        }
+        if (snapshot.tick < lastTick)
+        {
+            result.backwards++;
+        }
+        lastTick = snapshot.tick;
+        renderer.renderFrame(snapshot);
+        std::this_thread::sleep_for(std::chrono::milliseconds(renderDelay(profile, frame)));
+        result.frames++;
+
+        float sleepTime = 1.0f / TICK_RATE - std::chrono::duration<float>(benchClock::now() - currentFrameTime).count();
+        if (sleepTime > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::duration<float>(sleepTime));
+        }
+    }
+    thread.stop();
+    result.intervals = thread.getTickIntervals();
+    return result;
+}
+
+// 打印逻辑帧间隔的分位数和直方图 (以目标间隔为单位分桶)，返回 p99 (毫秒)
+static double report(const char *name, LoopResult &result)
+{
+    std::vector<double> &sorted = result.intervals;
+    std::sort(sorted.begin(), sorted.end());
+    if (sorted.empty())
+    {
+        std::cout << "  " << name << ": 没有逻辑帧" << std::endl;
+        return 1e9;
+    }
+    auto percentile = [&sorted](double p) {
+        return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+    };
+    const double edges[] = {0.5, 0.9, 1.1, 1.5, 2.0, 4.0};
+    const int BUCKETS = 7;
+    int counts[BUCKETS] = {0};
+    for (double interval : sorted)
+    {
+        int bucket = 0;
+        while (bucket < BUCKETS - 1 && interval >= edges[bucket] * PERIOD_MS)
+        {
+            bucket++;
+        }
+        counts[bucket]++;
+    }
+    std::cout << "  " << std::left << std::setw(8) << name << std::right << " 逻辑帧 " << std::setw(4) << sorted.size()
+              << ", 绘制 " << std::setw(4) << result.frames << " 帧; 间隔 (ms) p50 " << percentile(0.5) << ", p99 "
+              << percentile(0.99) << ", 最大 " << sorted.back() << std::endl;
+    std::cout << "           直方图 (x 目标间隔) <0.5:" << counts[0] << " 0.5-0.9:" << counts[1] << " 0.9-1.1:" << counts[2]
+              << " 1.1-1.5:" << counts[3] << " 1.5-2:" << counts[4] << " 2-4:" << counts[5] << " >=4:" << counts[6]
+              << std::endl;
+    return percentile(0.99);
+}
+
+int main()
+{
+    const RenderProfile profiles[] = {
+        {"绘制不变慢", 0, 0, 0},
+        {"每帧绘制慢 25 ms", 25, 0, 0},
+        {"每 15 帧卡顿 100 ms", 0, 100, 15},
+    };
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "目标逻辑帧间隔 " << PERIOD_MS << " ms，每种情况运行 " << SECONDS << " 秒" << std::endl;
+
+    bool ok = true;
+    SoftwareRenderBackend backend(WINDOW_WIDTH, WINDOW_HEIGHT);
+    BoardRenderer renderer(backend, WINDOW_WIDTH, WINDOW_HEIGHT, BOARD_WIDTH, BOARD_HEIGHT);
+    renderer.renderStaticLayer(std::vector<int>(3, 0));
+    for (const RenderProfile &profile : profiles)
+    {
+        std::cout << profile.name << std::endl;
+        LoopResult serialized = runSerialized(profile, renderer);
+        report("单线程", serialized);
+        LoopResult threaded = runThreaded(profile, renderer);
+        double p99 = report("模拟线程", threaded);
+        if (p99 > 1.5 * PERIOD_MS)
+        {
+            std::cerr << "模拟线程的逻辑帧间隔 p99 " << p99 << " ms 超过目标的 1.5 倍" << std::endl;
+            ok = false;
+        }
+        if (threaded.torn > 0 || threaded.backwards > 0)
+        {
+            std::cerr << "读到不完整的快照 " << threaded.torn << " 次，逻辑帧编号倒退 " << threaded.backwards << " 次"
+                      << std::endl;
+            ok = false;
+        }
+    }
+    return ok ? 0 : 1;
+}
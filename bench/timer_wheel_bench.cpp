@@ -0,0 +1,114 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+
+#include "../timer_wheel.h"
+
+// 时间轮基准测试：大量并发定时器的添加和到期开销，与每帧扫描所有计时器的做法对比
+// 同时检查每个定时器都恰好在预定的帧到期
+
+using benchClock = std::chrono::steady_clock;
+
+static double elapsedNanos(benchClock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(benchClock::now() - start).count();
+}
+
+// 简单的线性同余随机数
+static uint32_t nextRandom(uint32_t &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+int main()
+{
+    const uint32_t maxDelay = 1000; // 10 秒 (与特殊效果的持续时间相同)
+    for (uint32_t count : {1000u, 10000u, 100000u, 1000000u})
+    {
+        // 时间轮：添加 count 个定时器，然后推进到全部到期
+        TimerWheel wheel;
+        std::vector<uint32_t> due(count);
+        uint32_t random = 12345;
+        auto start = benchClock::now();
+        for (uint32_t i = 0; i < count; i++)
+        {
+            due[i] = nextRandom(random) % maxDelay + 1;
+            wheel.schedule(due[i], i);
+        }
+        double scheduleNanos = elapsedNanos(start);
+
+        std::vector<uint32_t> expired;
+        expired.reserve(count);
+        uint64_t wrong = 0;
+        uint32_t ticks = 0;
+        start = benchClock::now();
+        while (wheel.size() > 0)
+        {
+            size_t before = expired.size();
+            wheel.advance(1, expired);
+            ticks++;
+            for (size_t i = before; i < expired.size(); i++)
+            {
+                wrong += (due[expired[i]] != ticks);
+            }
+        }
+        double advanceNanos = elapsedNanos(start);
+        if (wrong != 0 || expired.size() != count)
+        {
+            std::cerr << "定时器到期时间错误: " << wrong << std::endl;
+            return 1;
+        }
+
+        // 对比：每帧扫描并递减所有计时器
+        std::vector<float> timers(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            timers[i] = static_cast<float>(due[i]);
+        }
+        uint64_t naiveExpired = 0;
+        start = benchClock::now();
+        for (uint32_t tick = 0; tick < ticks; tick++)
+        {
+            for (auto &timer : timers)
+            {
+                if (timer > 0.0f)
+                {
+                    timer -= 1.0f;
+                    naiveExpired += (timer <= 0.0f);
+                }
+            }
+        }
+        double naiveNanos = elapsedNanos(start);
+
+        std::cout << "timers " << count << ": schedule " << scheduleNanos / count << " ns/timer, "
+                  << "wheel " << advanceNanos / count << " ns/expiry (" << advanceNanos / ticks / 1000.0
+                  << " us/tick), per-frame scan " << naiveNanos / ticks / 1000.0 << " us/tick"
+                  << " (expired " << naiveExpired << ")" << std::endl;
+    }
+
+    // 到期时间跨越多层的定时器
+    TimerWheel wheel;
+    std::vector<uint32_t> expired;
+    const uint32_t delays[] = {1, 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 300000};
+    for (uint32_t delay : delays)
+    {
+        wheel.schedule(delay, delay);
+    }
+    for (uint32_t tick = 1; tick <= 300000; tick++)
+    {
+        expired.clear();
+        wheel.advance(1, expired);
+        for (uint32_t payload : expired)
+        {
+            if (payload != tick)
+            {
+                std::cerr << "定时器 " << payload << " 在第 " << tick << " 帧到期" << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "multi-level expiry check passed" << std::endl;
+    return 0;
+}
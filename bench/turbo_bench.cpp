@@ -0,0 +1,226 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include "../simulation.h"
+
+// 极高速度下按经过的时间移动的基准测试：
+//   1. 移动次数：蛇在最左边一列 (不会出现食物，速度不变) 一直向上绕行，不同速度和调用频率下
+//      推进 2 秒后的移动次数必须正好是 速度 x 2 (最后一次移动正好落在结束的时刻，检查舍入)；
+//      调用频率包括低于 30 Hz 的锁步对局 (默认 50 毫秒一帧) 和低帧率的观战墙，时间不能被截断
+//   2. 安全阀：速度远超上限时每次调用正好移动上限次，并记录丢弃时间的次数；
+//      设置了一次调用最多推进的时间时，更长的调用只推进上限的时间
+//   3. 每次移动都检查碰撞：有边界模式下向上撞墙，高速时死亡发生在与逐步移动 (advanceMove) 相同的一步
+//   4. 每次移动都检查食物和输入：随机输入下，每次 tick 移动多次与逐步移动到同样的步数结果相同
+//      (蛇身、得分、食物和是否结束)
+//   最后打印高速时每秒模拟的移动次数
+// 任何一项不符合时返回非零
+
+using benchClock = std::chrono::steady_clock;
+
+const int BOARD_WIDTH = WINDOW_WIDTH - 10 * GRID_SIZE;
+const int BOARD_HEIGHT = WINDOW_HEIGHT - 2 * GRID_SIZE;
+
+// 蛇在最左边一列向上绕行，食物只出现在外圈以内，永远吃不到，速度保持不变
+static void setupColumn(Simulation &simulation, float speed)
+{
+    simulation.reset(GameMode::Unbounded, Difficulty::Easy, MapType::Empty, 7);
+    simulation.setSnakeBody({SnakeBody(0, 10), SnakeBody(0, 11)});
+    simulation.setBaseSpeed(speed);
+}
+
+static bool checkMoveCounts()
+{
+    const float speeds[] = {10.0f, 15.0f, 30.0f, 120.0f, 1000.0f, 2500.0f, 10000.0f};
+    const int rates[] = {4, 10, 20, 30, 60, 120, 144, 240};
+    bool ok = true;
+    std::cout << "移动次数 (推进 2 秒):" << std::endl;
+    for (float speed : speeds)
+    {
+        std::cout << "  " << speed << " 格/秒:";
+        for (int rate : rates)
+        {
+            Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+            setupColumn(simulation, speed);
+            simulation.setMaxMovesPerTick(1 << 20);
+            for (int i = 0; i < 2 * rate; i++)
+            {
+                simulation.tick(1.0f / rate);
+            }
+            uint64_t expected = static_cast<uint64_t>(2.0 * speed);
+            bool exact = simulation.getMoveCount() == expected && !simulation.isGameOver() &&
+                         simulation.getThrottledTicks() == 0;
+            std::cout << " " << rate << "Hz=" << simulation.getMoveCount() << (exact ? "" : " (错误)");
+            ok = ok && exact;
+        }
+        std::cout << std::endl;
+    }
+    return ok;
+}
+
+static bool checkSafetyValve()
+{
+    const int RATE = 120;
+    const int LIMIT = 64;
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    setupColumn(simulation, 100000.0f);
+    simulation.setMaxMovesPerTick(LIMIT);
+    for (int i = 0; i < RATE; i++)
+    {
+        simulation.tick(1.0f / RATE);
+    }
+    bool ok = simulation.getMoveCount() == static_cast<uint64_t>(LIMIT * RATE) &&
+              simulation.getThrottledTicks() == static_cast<uint64_t>(RATE);
+    std::cout << "安全阀: 100000 格/秒, 每次最多 " << LIMIT << " 步, " << RATE << " 次调用移动 "
+              << simulation.getMoveCount() << " 步, 丢弃时间 " << simulation.getThrottledTicks() << " 次"
+              << (ok ? "" : " (错误)") << std::endl;
+
+    // 卡顿上限：15 格/秒，每次调用 0.05 秒推进 2 秒，限制为 1/30 秒时只移动 20 步
+    Simulation stalled(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    setupColumn(stalled, 15.0f);
+    stalled.setMaxTickTime(1.0f / 30.0f);
+    for (int i = 0; i < 40; i++)
+    {
+        stalled.tick(0.05f);
+    }
+    bool limited = stalled.getMoveCount() == 20;
+    std::cout << "卡顿上限: 15 格/秒, 每次最多推进 1/30 秒, 40 次 0.05 秒的调用移动 " << stalled.getMoveCount()
+              << " 步" << (limited ? "" : " (错误)") << std::endl;
+    return ok && limited;
+}
+
+static bool checkWallCollision()
+{
+    // 逐步移动到撞墙需要的步数
+    Simulation reference(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    reference.reset(GameMode::Bounded, Difficulty::Easy, MapType::Empty, 3);
+    while (reference.advanceMove())
+    {
+    }
+    bool ok = true;
+    std::cout << "撞墙: 逐步移动 " << reference.getMoveCount() << " 步;";
+    for (float speed : {500.0f, 1000.0f, 5000.0f})
+    {
+        Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+        simulation.reset(GameMode::Bounded, Difficulty::Easy, MapType::Empty, 3);
+        simulation.setBaseSpeed(speed);
+        int ticks = 0;
+        while (simulation.tick(1.0f / 120.0f))
+        {
+            ticks++;
+        }
+        bool same = simulation.getMoveCount() == reference.getMoveCount() && simulation.getHash() == reference.getHash();
+        std::cout << " " << speed << " 格/秒 " << ticks + 1 << " 次调用 " << simulation.getMoveCount() << " 步"
+                  << (same ? "" : " (错误)");
+        ok = ok && same;
+    }
+    std::cout << std::endl;
+    return ok;
+}
+
+// 两局的蛇身、得分、食物和是否结束是否相同 (特殊效果的计时方式不同，不比较)
+static bool samePlay(const Simulation &a, const Simulation &b)
+{
+    if (a.getSnake().getCells() != b.getSnake().getCells() || a.getPoints() != b.getPoints() ||
+        a.isGameOver() != b.isGameOver())
+    {
+        return false;
+    }
+    const std::vector<FoodItem> &foodsA = a.getFoods().getItems();
+    const std::vector<FoodItem> &foodsB = b.getFoods().getItems();
+    if (foodsA.size() != foodsB.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < foodsA.size(); i++)
+    {
+        if (foodsA[i].cell != foodsB[i].cell || foodsA[i].type != foodsB[i].type)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 随机输入下，每次 tick 移动多次与逐步移动 (advanceMove，每次调用移动一步) 到同样的步数结果相同
+static bool checkAgainstSingleMoves(uint64_t &totalMoves)
+{
+    const int GAMES = 200;
+    const int TICKS = 600;
+    const int RATE = 120;
+    Random random(11);
+    int mismatches = 0;
+    totalMoves = 0;
+    for (int game = 0; game < GAMES; game++)
+    {
+        GameMode mode = (game & 1) ? GameMode::Unbounded : GameMode::Bounded;
+        MapType mapType = (game & 2) ? MapType::Obstacles : MapType::Empty;
+        float speed = 200.0f + random.nextInt(2800);
+        Simulation turbo(BOARD_WIDTH, BOARD_HEIGHT, 2);
+        Simulation reference(BOARD_WIDTH, BOARD_HEIGHT, 2);
+        for (Simulation *simulation : {&turbo, &reference})
+        {
+            simulation->setFoodOptions(1 + game % 8, 0);
+            simulation->reset(mode, Difficulty::Easy, mapType, 100 + game);
+            simulation->setBaseSpeed(speed);
+        }
+        for (int tick = 0; tick < TICKS && !turbo.isGameOver(); tick++)
+        {
+            // 输入在这次 tick 的第一次移动时应用，逐步移动也一样
+            if (random.nextInt(4) == 0)
+            {
+                Direction direction = static_cast<Direction>(random.nextInt(4));
+                turbo.addDirectionToQueue(direction);
+                reference.addDirectionToQueue(direction);
+            }
+            turbo.tick(1.0f / RATE);
+            while (reference.getMoveCount() < turbo.getMoveCount() && reference.advanceMove())
+            {
+            }
+            if (reference.getMoveCount() != turbo.getMoveCount() || !samePlay(turbo, reference))
+            {
+                mismatches++;
+                break;
+            }
+        }
+        totalMoves += turbo.getMoveCount();
+    }
+    std::cout << "与逐步移动对比: " << GAMES << " 局, " << totalMoves << " 步, 不一致 " << mismatches << " 局"
+              << std::endl;
+    return mismatches == 0;
+}
+
+// 高速时每秒模拟的移动次数
+static void measureThroughput()
+{
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    setupColumn(simulation, 5000.0f);
+    simulation.setMaxMovesPerTick(1 << 20);
+    auto start = benchClock::now();
+    const int TICKS = 120 * 20;
+    for (int i = 0; i < TICKS; i++)
+    {
+        simulation.tick(1.0f / 120.0f);
+    }
+    double seconds = std::chrono::duration<double>(benchClock::now() - start).count();
+    std::printf("吞吐量: 5000 格/秒推进 %d 秒 (%llu 步) 耗时 %.2f ms, 每秒 %.1f M 步\n", TICKS / 120,
+                static_cast<unsigned long long>(simulation.getMoveCount()), seconds * 1000.0,
+                simulation.getMoveCount() / seconds / 1e6);
+}
+
+int main()
+{
+    bool ok = checkMoveCounts();
+    ok = checkSafetyValve() && ok;
+    ok = checkWallCollision() && ok;
+    uint64_t moves = 0;
+    ok = checkAgainstSingleMoves(moves) && ok;
+    measureThroughput();
+    if (!ok)
+    {
+        std::cerr << "高速移动的结果不正确" << std::endl;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench_harness.h"
+#include "../spectator_wall.h"
+#ifdef SNAKE_RENDER_SDL
+#include "../sdl_render_backend.h"
+#endif
+
+// 观战墙基准测试：1920x1080 的窗口中排列不同数量的对局，
+//   wall_render: 每个对局都是占满大半个游戏区域的长蛇时，绘制一帧的耗时
+//   wall_frame:  机器人操作的对局，推进一帧加绘制一帧的耗时
+// 后端为空后端 (只计数)、离屏软件渲染，以及 SDL 渲染器 (用 make wall_bench_sdl 编译，
+// 在无界面主机上配合 SDL_VIDEODRIVER=dummy 运行)
+// 64 个长蛇对局在软件渲染下一帧 (绘制和推进) 超过 60 FPS 的帧时间时返回非零
+
+const int SCREEN_WIDTH = 1920;
+const int SCREEN_HEIGHT = 1080;
+const int BOARD_WIDTH = WINDOW_WIDTH - 10 * GRID_SIZE;
+const int BOARD_HEIGHT = WINDOW_HEIGHT - 2 * GRID_SIZE;
+const float FRAME_TIME = 1.0f / 60.0f;
+const double FRAME_BUDGET_NS = 1e9 / 60.0;
+
+// 长蛇：从游戏区域底部开始蛇形排列，占满 length 个格子
+static std::vector<SnakeBody> longSnake(int columns, int rows, int length)
+{
+    std::vector<SnakeBody> body;
+    for (int i = 0; i < length; i++)
+    {
+        int row = i / columns;
+        int column = (row % 2 == 0) ? i % columns : columns - 1 - i % columns;
+        body.push_back(SnakeBody(column, rows - 1 - row));
+    }
+    return body;
+}
+
+// 所有对局设置为长蛇 (长度为格子数的 80%)
+static void fillLongSnakes(SpectatorWall &wall)
+{
+    const CellGrid &grid = wall.getGame(0).getGrid();
+    int length = grid.getColumns() * grid.getRows() * 4 / 5;
+    std::vector<SnakeBody> body = longSnake(grid.getColumns(), grid.getRows(), length);
+    for (int i = 0; i < wall.getTiles(); i++)
+    {
+        wall.getGame(i).setSnakeBody(body);
+    }
+}
+
+// 返回长蛇对局绘制加上推进一帧的耗时 (纳秒)
+static double benchBackend(BenchSuite &suite, const char *name, RenderBackend &backend, int tiles)
+{
+    std::string params = std::string("backend=") + name + " tiles=" + std::to_string(tiles);
+    SpectatorWall wall(backend, SCREEN_WIDTH, SCREEN_HEIGHT, tiles, BOARD_WIDTH, BOARD_HEIGHT);
+
+    wall.reset(GameMode::Unbounded, Difficulty::Hard, MapType::Obstacles, 1);
+    fillLongSnakes(wall);
+    backend.resetStats();
+    suite.run("wall_render", params, 20, [&](int) { wall.render(); });
+    double renderNs = suite.getResults().back().medianNs;
+    const RenderStats &stats = backend.getStats();
+    std::cout << "  网格 " << wall.getColumns() << "x" << wall.getRows() << "，格子 " << wall.getCellSize()
+              << " 像素，每帧 " << stats.rects / stats.frames << " 个矩形 / " << stats.rectCalls / stats.frames
+              << " 次批量绘制，每个对局 " << renderNs / tiles / 1000.0 << " us" << std::endl;
+
+    // 机器人操作的对局 (蛇的长度从初始长度开始)，先运行一段时间让对局进入不同的阶段
+    wall.reset(GameMode::Unbounded, Difficulty::Hard, MapType::Obstacles, 1);
+    for (int i = 0; i < 600; i++)
+    {
+        wall.update(FRAME_TIME);
+    }
+    suite.run("wall_frame", params, 20, [&](int) {
+        wall.update(FRAME_TIME);
+        wall.render();
+    });
+    double frameNs = suite.getResults().back().medianNs;
+
+    // 长蛇对局推进一帧的耗时 (多数对局在几次移动内就会结束，只测第一帧)
+    fillLongSnakes(wall);
+    auto begin = std::chrono::steady_clock::now();
+    wall.update(FRAME_TIME);
+    double updateNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "  机器人对局每帧 " << frameNs / 1000.0 << " us，长蛇对局推进一帧 " << updateNs / 1000.0 << " us"
+              << std::endl;
+    return renderNs + updateNs;
+}
+
+int main(int argc, char **argv)
+{
+    std::string jsonPath = argc > 2 && std::string(argv[1]) == "--json" ? argv[2] : "";
+#ifdef SNAKE_RENDER_SDL
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        std::cerr << "SDL 初始化失败: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    SDL_Window *window = SDL_CreateWindow("wall_bench", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                                          SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_HIDDEN);
+    SDL_Renderer *renderer = window ? SDL_CreateRenderer(window, -1, 0) : nullptr;
+    if (renderer == nullptr)
+    {
+        std::cerr << "渲染器创建失败: " << SDL_GetError() << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+#endif
+
+    bool ok = true;
+    BenchSuite suite("", 2, 7);
+    for (int tiles : {16, 36, 64, 100, 144})
+    {
+        NullRenderBackend nullBackend;
+        benchBackend(suite, "null", nullBackend, tiles);
+        SoftwareRenderBackend softwareBackend(SCREEN_WIDTH, SCREEN_HEIGHT);
+        double frameNs = benchBackend(suite, "software", softwareBackend, tiles);
+        if (tiles == 64 && frameNs > FRAME_BUDGET_NS)
+        {
+            std::cerr << "64 个长蛇对局每帧 " << frameNs / 1e6 << " ms，超过 60 FPS 的帧时间" << std::endl;
+            ok = false;
+        }
+#ifdef SNAKE_RENDER_SDL
+        SdlRenderBackend sdlBackend(renderer, nullptr, SCREEN_WIDTH, SCREEN_HEIGHT);
+        benchBackend(suite, "sdl", sdlBackend, tiles);
+#endif
+    }
+
+#ifdef SNAKE_RENDER_SDL
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+#endif
+    if (!jsonPath.empty() && !suite.writeJson(jsonPath))
+    {
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
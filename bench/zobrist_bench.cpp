@@ -0,0 +1,173 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench_harness.h"
+#include "../greedy_bot.h"
+
+// Zobrist 哈希测试：
+//   1. 机器人和随机输入操作的对局 (两种模式、两种移动步骤、有障碍物、食物会到期)，
+//      每个逻辑帧都检查增量更新的哈希与从头计算的结果相同，并且快照恢复后哈希不变
+//   2. 读取哈希、从头计算哈希和计算校验和的耗时 (长蛇)
+// 任何一帧的哈希不一致时返回非零
+
+const int BOARD_WIDTH = WINDOW_WIDTH - 10 * GRID_SIZE;
+const int BOARD_HEIGHT = WINDOW_HEIGHT - 2 * GRID_SIZE;
+const float TICK_TIME = 1.0f / 60.0f;
+
+// 一种对局设置
+struct HashCase
+{
+    GameMode mode;
+    MapType map;
+    bool specialized;
+};
+
+// 检查的统计
+struct HashCoverage
+{
+    uint64_t ticks = 0;
+    uint64_t moves = 0;
+    uint64_t effectTicks = 0; // 有特殊效果生效的逻辑帧
+    uint64_t snapshots = 0;
+    uint64_t games = 0;
+};
+
+// 运行 ticks 个逻辑帧，每帧比较增量哈希和从头计算的哈希，返回是否全部一致
+static bool verifyCase(const HashCase &config, int ticks, HashCoverage &coverage)
+{
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    Simulation restored(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    simulation.setSpecializedStep(config.specialized);
+    simulation.setFoodOptions(6, 400);
+    GreedyBot bot;
+    Random random(7);
+    std::vector<uint8_t> snapshot;
+    uint64_t seed = 1;
+    simulation.reset(config.mode, Difficulty::Hard, config.map, seed);
+    coverage.games++;
+    CellIndex lastHead = simulation.getSnake().getHead();
+
+    for (int tick = 0; tick < ticks; tick++)
+    {
+        // 蛇移动之后让机器人选择方向，偶尔随机转向或暂停，让蛇也会撞到墙壁和自己
+        if (simulation.getSnake().getHead() != lastHead)
+        {
+            lastHead = simulation.getSnake().getHead();
+            int roll = random.nextInt(100);
+            Direction direction = roll < 8 ? static_cast<Direction>(random.nextInt(4)) : bot.choose(simulation);
+            simulation.addDirectionToQueue(direction);
+            coverage.moves++;
+        }
+        if (random.nextInt(2000) == 0)
+        {
+            simulation.togglePause();
+        }
+        if (!simulation.tick(TICK_TIME))
+        {
+            // 撞到之后的最后一个状态也要检查 (蛇头可能越界或与身体重叠)
+            if (simulation.getHash() != simulation.computeHash())
+            {
+                std::cerr << "第 " << tick << " 帧 (游戏结束) 增量哈希与从头计算的结果不同" << std::endl;
+                return false;
+            }
+            simulation.reset(config.mode, Difficulty::Hard, config.map, ++seed);
+            coverage.games++;
+            lastHead = simulation.getSnake().getHead();
+        }
+        coverage.ticks++;
+        for (FoodType type : {FoodType::SpeedUp, FoodType::SlowDown, FoodType::DoublePoints})
+        {
+            if (simulation.getActiveEffects(type) > 0)
+            {
+                coverage.effectTicks++;
+                break;
+            }
+        }
+
+        if (simulation.getHash() != simulation.computeHash())
+        {
+            std::cerr << "第 " << tick << " 帧增量哈希与从头计算的结果不同" << std::endl;
+            return false;
+        }
+        // 快照恢复后从头计算的哈希与原来的增量哈希相同
+        if (tick % 997 == 0)
+        {
+            simulation.saveSnapshot(snapshot);
+            if (!restored.loadSnapshot(snapshot.data(), snapshot.size()) || restored.getHash() != simulation.getHash())
+            {
+                std::cerr << "第 " << tick << " 帧快照恢复后哈希不同" << std::endl;
+                return false;
+            }
+            coverage.snapshots++;
+        }
+    }
+    return true;
+}
+
+// 长蛇：从游戏区域底部开始蛇形排列
+static std::vector<SnakeBody> longSnake(int columns, int rows, int length)
+{
+    std::vector<SnakeBody> body;
+    for (int i = 0; i < length; i++)
+    {
+        int row = i / columns;
+        int column = (row % 2 == 0) ? i % columns : columns - 1 - i % columns;
+        body.push_back(SnakeBody(column, rows - 1 - row));
+    }
+    return body;
+}
+
+int main(int argc, char **argv)
+{
+    std::string jsonPath = argc > 2 && std::string(argv[1]) == "--json" ? argv[2] : "";
+
+    const HashCase cases[] = {
+        {GameMode::Bounded, MapType::Obstacles, true},
+        {GameMode::Bounded, MapType::Empty, false},
+        {GameMode::Unbounded, MapType::Obstacles, true},
+        {GameMode::Unbounded, MapType::Obstacles, false},
+    };
+    HashCoverage coverage;
+    for (const HashCase &config : cases)
+    {
+        if (!verifyCase(config, 200000, coverage))
+        {
+            return 1;
+        }
+    }
+    std::cout << "增量哈希与从头计算一致: " << coverage.ticks << " 个逻辑帧, " << coverage.moves << " 次移动, "
+              << coverage.games << " 局, " << coverage.snapshots << " 次快照恢复, 特殊效果生效的逻辑帧 "
+              << coverage.effectTicks << std::endl;
+    if (coverage.effectTicks == 0)
+    {
+        std::cerr << "测试中没有吃到特殊食物，没有覆盖特殊效果的哈希" << std::endl;
+        return 1;
+    }
+
+    BenchSuite suite;
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    simulation.setFoodOptions(8, 0);
+    simulation.reset(GameMode::Unbounded, Difficulty::Easy, MapType::Obstacles, 1);
+    const CellGrid &grid = simulation.getGrid();
+    for (int length : {4, 256, 896})
+    {
+        simulation.setSnakeBody(longSnake(grid.getColumns(), grid.getRows(), length));
+        std::string params = "length=" + std::to_string(length);
+        suite.run("hash_incremental", params, 100000, [&](int) { benchKeep(simulation.getHash()); });
+        suite.run("hash_recompute", params, 10000, [&](int) { benchKeep(simulation.computeHash()); });
+        suite.run("checksum", params, 100000, [&](int) { benchKeep(simulation.checksum()); });
+    }
+    // 每次移动的耗时 (包括哈希的增量更新)
+    Simulation mover(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    mover.setFoodOptions(8, 0);
+    suite.run("move", "mode=unbounded", 1000,
+              [&]() { mover.reset(GameMode::Unbounded, Difficulty::Easy, MapType::Empty, 1); },
+              [&](int) { mover.update(1.0001f / mover.getSnake().getSpeed()); });
+
+    if (!jsonPath.empty() && !suite.writeJson(jsonPath))
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+#ifndef BOARD_POLICY_H
+#define BOARD_POLICY_H
+
+#include "snake.h"
+#include "cell_grid.h"
+
+// 蛇移动一步的编译期策略：游戏模式 (有边界/穿越边界) 和游戏区域大小 (运行时/编译期常量)
+// Simulation 在开始一局时按模式和区域大小选择一次特化版本，之后每次移动不再判断模式
+
+// 运行时大小的游戏区域：偏移量和是否在区域内都查 CellGrid 的表
+struct DynamicBoard
+{
+    const CellGrid &grid;
+
+    explicit DynamicBoard(const CellGrid &g) : grid(g) {}
+    CellIndex neighbor(CellIndex cell, Direction direction) const { return grid.neighbor(cell, direction); }
+    bool isInside(CellIndex cell) const { return grid.isInside(cell); }
+    CellIndex wrap(CellIndex cell, Direction direction) const { return grid.wrap(cell, direction); }
+};
+
+// 编译期常量大小的游戏区域：偏移量是常量，是否在区域内用常量除法计算，不需要查表
+template <int W, int H>
+struct FixedBoard
+{
+    static constexpr int STRIDE = W + 2;
+
+    explicit FixedBoard(const CellGrid &) {}
+    static CellIndex neighbor(CellIndex cell, Direction direction)
+    {
+        // 按 Direction 的顺序 (上、下、左、右、不动)
+        static constexpr int offsets[] = {-STRIDE, STRIDE, -1, 1, 0};
+        return static_cast<CellIndex>(cell + offsets[static_cast<int>(direction)]);
+    }
+    static bool isInside(CellIndex cell)
+    {
+        return static_cast<unsigned>(cell % STRIDE - 1) < static_cast<unsigned>(W) &&
+               static_cast<unsigned>(cell / STRIDE - 1) < static_cast<unsigned>(H);
+    }
+    static CellIndex wrap(CellIndex cell, Direction direction)
+    {
+        static constexpr int offsets[] = {H * STRIDE, -H * STRIDE, W, -W, 0};
+        return static_cast<CellIndex>(cell + offsets[static_cast<int>(direction)]);
+    }
+};
+
+// 有边界模式：蛇头离开游戏区域即撞墙
+struct BoundedPolicy
+{
+    static const bool WRAPS = false;
+
+    // 把新的蛇头放到游戏区域上，返回是否在区域内
+    template <typename Board>
+    static bool place(const Board &board, CellIndex &cell, Direction)
+    {
+        return board.isInside(cell);
+    }
+};
+
+// 无边界模式：蛇头从一侧离开后从另一侧进入，不会撞墙
+struct WrapPolicy
+{
+    static const bool WRAPS = true;
+
+    template <typename Board>
+    static bool place(const Board &board, CellIndex &cell, Direction direction)
+    {
+        if (!board.isInside(cell))
+        {
+            cell = board.wrap(cell, direction);
+        }
+        return true;
+    }
+};
+
+// 蛇头沿 direction 移动一格后的格子，返回是否在游戏区域内 (无边界模式下总是 true)
+template <typename Mode, typename Board>
+inline bool nextHead(const Board &board, CellIndex head, Direction direction, CellIndex &next)
+{
+    next = board.neighbor(head, direction);
+    return Mode::place(board, next, direction);
+}
+
+#endif
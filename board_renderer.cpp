@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+#include "board_renderer.h"
+
+// 文字颜色 (白色)
+static const RenderColor TEXT_COLOR = {255, 255, 255, 255};
+
+// 构造函数
+BoardRenderer::BoardRenderer(RenderBackend &backend, int screenWidth, int screenHeight, int gameBoardWidth, int gameBoardHeight)
+    : mBackend(backend),
+      mScreenWidth(screenWidth),
+      mScreenHeight(screenHeight),
+      mGameBoardWidth(gameBoardWidth),
+      mGameBoardHeight(gameBoardHeight),
+      mInformationHeight(screenHeight - gameBoardHeight)
+{
+    // 蛇和障碍物最多占满游戏区域，按格子数预留 (加上插值时蛇尾离开的格子)，之后每帧不再扩容
+    mRects.reserve(static_cast<size_t>(gameBoardWidth / GRID_SIZE) * (gameBoardHeight / GRID_SIZE) + 2);
+    mPointsText.reserve(32);
+    mDifficultyText.reserve(32);
+}
+
+// 绘制静态层
+void BoardRenderer::renderStaticLayer(const std::vector<int> &leaderBoard)
+{
+    mBackend.beginStaticLayer();
+    renderGameBoard();
+    renderInformationBoard();
+    renderInstructionBoard();
+    renderLeaderBoard(leaderBoard);
+    mBackend.endStaticLayer();
+}
+
+// 绘制一帧游戏画面
+void BoardRenderer::renderFrame(const Simulation &simulation)
+{
+    mSnapshot.capture(simulation);
+    renderFrame(mSnapshot);
+}
+
+// 绘制一帧快照
+void BoardRenderer::renderFrame(const BoardSnapshot &snapshot)
+{
+    renderFrame(snapshot, 1.0f);
+}
+
+// 绘制一帧快照，蛇按移动进度插值
+void BoardRenderer::renderFrame(const BoardSnapshot &snapshot, float moveProgress)
+{
+    mBackend.setColor({0x00, 0x00, 0x00, 0xFF}); // 设置背景颜色 (黑色)
+    mBackend.clear();                            // 清空渲染器
+
+    // 渲染静态元素
+    mBackend.drawStaticLayer();
+
+    // 只渲染动态元素
+    renderDynamic(snapshot, moveProgress);
+
+    mBackend.present();
+}
+
+// 绘制动态元素
+void BoardRenderer::renderDynamic(const BoardSnapshot &snapshot, float moveProgress)
+{
+    renderObstacles(snapshot);
+    renderSnake(snapshot, moveProgress);
+    renderFood(snapshot);
+    renderPoints(snapshot);
+    renderDifficulty(snapshot);
+}
+
+// 渲染游戏区域
+void BoardRenderer::renderGameBoard()
+{
+    mBackend.setColor({0xFF, 0xFF, 0xFF, 0xFF}); // 设置边框颜色 (白色)
+
+    // 绘制上边框
+    mBackend.drawLine(0, 0, mGameBoardWidth, 0);
+    // 绘制下边框
+    mBackend.drawLine(0, mGameBoardHeight - 1, mGameBoardWidth, mGameBoardHeight - 1);
+    // 绘制左边框
+    mBackend.drawLine(0, 0, 0, mGameBoardHeight);
+    // 绘制右边框
+    mBackend.drawLine(mGameBoardWidth - 1, 0, mGameBoardWidth - 1, mGameBoardHeight);
+}
+
+// 渲染信息面板
+void BoardRenderer::renderInformationBoard()
+{
+    // 使用百分比计算文本位置
+    int x = 0.05 * mScreenWidth;                          // 距离游戏区域左侧 5% 的位置
+    int y = mGameBoardHeight + 0.05 * mInformationHeight; // 距离屏幕顶部 5% 的位置
+    // 渲染文字
+    mBackend.drawText("Welcome to The Snake Game!", x, y, TEXT_COLOR);
+}
+
+// 渲染指令面板
+void BoardRenderer::renderInstructionBoard()
+{
+    // 使用百分比计算文本位置
+    int x = mGameBoardWidth + 0.05 * mScreenWidth; // 距离游戏区域右侧 5% 的位置
+    int y = 0.05 * mScreenHeight;                  // 距离屏幕顶部 5% 的位置
+    int ySpacing = 0.04 * mScreenHeight;           // 行间距为屏幕高度的 5%
+
+    const char *lines[] = {"Manual", "Up / W", "Down / S", "Left / A", "Right / D", "Pause: Space"};
+    for (const char *line : lines)
+    {
+        mBackend.drawText(line, x, y, TEXT_COLOR);
+        y += ySpacing;
+    }
+}
+
+// 渲染排行榜
+void BoardRenderer::renderLeaderBoard(const std::vector<int> &leaderBoard)
+{
+    // 使用百分比计算文本位置
+    int x = mGameBoardWidth + 0.05 * mScreenWidth; // 距离游戏区域右侧 5% 的位置
+    int y = 0.4 * mScreenHeight;                   // 距离屏幕顶部 40% 的位置
+    int ySpacing = 0.04 * mScreenHeight;           // 行间距为屏幕高度的 5%
+
+    mBackend.drawText("Leader Board", x, y, TEXT_COLOR);
+    y += ySpacing;
+
+    // 渲染排行榜数据
+    for (size_t i = 0; i < leaderBoard.size(); i++)
+    {
+        std::string rankText = "#" + std::to_string(i + 1) + ": " + std::to_string(leaderBoard[i]);
+        mBackend.drawText(rankText, x, y, TEXT_COLOR);
+        y += ySpacing;
+    }
+}
+
+// 把格子列表转换成矩形，一次批量绘制
+void BoardRenderer::fillCells(const std::vector<CellIndex> &cells, const CellGrid &grid)
+{
+    mRects.clear();
+    for (CellIndex cell : cells)
+    {
+        mRects.push_back({grid.getX(cell) * GRID_SIZE, grid.getY(cell) * GRID_SIZE, GRID_SIZE, GRID_SIZE});
+    }
+    if (!mRects.empty())
+    {
+        mBackend.fillRects(mRects.data(), static_cast<int>(mRects.size()));
+    }
+}
+
+// 渲染障碍物
+void BoardRenderer::renderObstacles(const BoardSnapshot &snapshot)
+{
+    mBackend.setColor(OBSTACLE_COLOR); // 设置障碍物颜色 (灰色)
+    fillCells(snapshot.obstacles, snapshot.grid);
+}
+
+// 渲染蛇：停在格子上时每节一个格子；插值时蛇身不变，蛇头和蛇尾各画半截格子，仍然一次批量绘制
+void BoardRenderer::renderSnake(const BoardSnapshot &snapshot, float moveProgress)
+{
+    mBackend.setColor(SNAKE_COLOR); // 绿色
+    const std::vector<CellIndex> &snake = snapshot.snake;
+    if (moveProgress >= 1.0f || snake.size() < 2)
+    {
+        fillCells(snake, snapshot.grid);
+        return;
+    }
+    const CellGrid &grid = snapshot.grid;
+    mRects.clear();
+    // 蛇头：从第二节所在的格子进入蛇头的格子
+    int headLength = static_cast<int>(std::max(0.0f, moveProgress) * GRID_SIZE);
+    if (headLength > 0)
+    {
+        mRects.push_back(partialCell(grid, snake[0], snake[1], headLength));
+    }
+    for (size_t i = 1; i < snake.size(); i++)
+    {
+        mRects.push_back({grid.getX(snake[i]) * GRID_SIZE, grid.getY(snake[i]) * GRID_SIZE, GRID_SIZE, GRID_SIZE});
+    }
+    // 蛇尾：离开的格子中靠近现在蛇尾的部分
+    int tailLength = GRID_SIZE - headLength;
+    if (snapshot.vacatedTail != NO_CELL && tailLength > 0)
+    {
+        mRects.push_back(partialCell(grid, snapshot.vacatedTail, snake.back(), tailLength));
+    }
+    mBackend.fillRects(mRects.data(), static_cast<int>(mRects.size()));
+}
+
+// 格子中靠近相邻格子 from 的部分：相差超过一格说明隔着边界绕回，方向相反
+RenderRect BoardRenderer::partialCell(const CellGrid &grid, CellIndex cell, CellIndex from, int length) const
+{
+    int x = grid.getX(cell);
+    int y = grid.getY(cell);
+    int dx = grid.getX(from) - x;
+    int dy = grid.getY(from) - y;
+    dx = dx > 1 ? -1 : (dx < -1 ? 1 : dx);
+    dy = dy > 1 ? -1 : (dy < -1 ? 1 : dy);
+    RenderRect rect = {x * GRID_SIZE, y * GRID_SIZE, GRID_SIZE, GRID_SIZE};
+    if (dx != 0)
+    {
+        rect.w = length;
+        rect.x += dx > 0 ? GRID_SIZE - length : 0;
+    }
+    else if (dy != 0)
+    {
+        rect.h = length;
+        rect.y += dy > 0 ? GRID_SIZE - length : 0;
+    }
+    return rect;
+}
+
+// 渲染食物：按类型分组，每种颜色只绘制一次
+void BoardRenderer::renderFood(const BoardSnapshot &snapshot)
+{
+    // 每种类型都预留全部食物的数量，食物类型的分布变化时不再扩容
+    for (auto &rects : mFoodRects)
+    {
+        rects.clear();
+        rects.reserve(snapshot.foods.size());
+    }
+    const CellGrid &grid = snapshot.grid;
+    for (const auto &item : snapshot.foods)
+    {
+        mFoodRects[static_cast<int>(item.type)].push_back(
+            {grid.getX(item.cell) * GRID_SIZE, grid.getY(item.cell) * GRID_SIZE, GRID_SIZE, GRID_SIZE});
+    }
+
+    // 根据食物类型设置颜色
+    for (int type = 0; type < 4; type++)
+    {
+        if (!mFoodRects[type].empty())
+        {
+            mBackend.setColor(FOOD_COLORS[type]);
+            mBackend.fillRects(mFoodRects[type].data(), static_cast<int>(mFoodRects[type].size()));
+        }
+    }
+}
+
+// 渲染得分
+void BoardRenderer::renderPoints(const BoardSnapshot &snapshot)
+{
+    if (snapshot.points != mShownPoints)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "Points: %d", snapshot.points);
+        mPointsText.assign(buffer);
+        mShownPoints = snapshot.points;
+    }
+
+    // 使用百分比计算文本位置
+    int x = mGameBoardWidth + 0.05 * mScreenWidth; // 距离游戏区域右侧 5% 的位置
+    int y = 0.3 * mScreenHeight;                   // 距离屏幕顶部 15% 的位置
+
+    mBackend.drawText(mPointsText, x, y, TEXT_COLOR);
+}
+
+// 渲染难度
+void BoardRenderer::renderDifficulty(const BoardSnapshot &snapshot)
+{
+    if (snapshot.difficulty != mShownDifficulty)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "Difficulty: %d", snapshot.difficulty);
+        mDifficultyText.assign(buffer);
+        mShownDifficulty = snapshot.difficulty;
+    }
+
+    // 使用百分比计算文本位置
+    int x = mGameBoardWidth + 0.05 * mScreenWidth; // 距离游戏区域右侧 5% 的位置
+    int y = 0.35 * mScreenHeight;                  // 距离屏幕顶部 10% 的位置
+
+    mBackend.drawText(mDifficultyText, x, y, TEXT_COLOR);
+}
@@ -0,0 +1,75 @@
+#ifndef BOARD_RENDERER_H
+#define BOARD_RENDERER_H
+
+#include <string>
+#include <vector>
+
+#include "render_backend.h"
+#include "board_snapshot.h"
+#include "simulation.h"
+
+// 游戏元素的颜色：障碍物、蛇和按 FoodType 排列的食物
+const RenderColor OBSTACLE_COLOR = {0x80, 0x80, 0x80, 0xFF}; // 灰色
+const RenderColor SNAKE_COLOR = {0x00, 0xFF, 0x00, 0xFF};    // 绿色
+const RenderColor FOOD_COLORS[4] = {
+    {0xFF, 0x00, 0x00, 0xFF}, // Normal: 红色
+    {135, 206, 235, 255},     // SpeedUp: 天蓝色
+    {221, 160, 221, 255},     // SlowDown: 亮紫色
+    {0xFF, 0xFF, 0x00, 0xFF}, // DoublePoints: 黄色
+};
+
+// 游戏画面的绘制：边框、说明、排行榜、障碍物、蛇、食物、得分和难度
+// 只通过 RenderBackend 绘制，不依赖 SDL，Game 和基准测试使用同一套绘制代码
+class BoardRenderer
+{
+public:
+    // 屏幕和游戏区域的宽度和高度 (像素)
+    BoardRenderer(RenderBackend &backend, int screenWidth, int screenHeight, int gameBoardWidth, int gameBoardHeight);
+
+    // 把不变的部分 (边框、信息面板、指令面板和排行榜) 绘制到静态层
+    void renderStaticLayer(const std::vector<int> &leaderBoard);
+    // 绘制一帧游戏画面并提交 (先把模拟的状态复制到内部的快照)
+    void renderFrame(const Simulation &simulation);
+    // 绘制模拟线程发布的快照并提交，不访问 Simulation
+    void renderFrame(const BoardSnapshot &snapshot);
+    // 插值绘制：蛇头从上一个格子进入蛇头所在格子的 moveProgress (0 到 1)，蛇尾同样逐渐离开 vacatedTail
+    // 画面比模拟晚最多一次移动，但蛇在两次移动之间连续前进，刷新率高于移动频率时不再一格一格地跳
+    void renderFrame(const BoardSnapshot &snapshot, float moveProgress);
+    // 只绘制动态元素 (障碍物、蛇、食物、得分和难度)，不清空也不提交，用于叠加其他内容
+    void renderDynamic(const BoardSnapshot &snapshot, float moveProgress = 1.0f);
+
+    void renderGameBoard();
+    void renderInformationBoard();
+    void renderInstructionBoard();
+    void renderLeaderBoard(const std::vector<int> &leaderBoard);
+    void renderObstacles(const BoardSnapshot &snapshot);
+    void renderSnake(const BoardSnapshot &snapshot, float moveProgress = 1.0f);
+    void renderFood(const BoardSnapshot &snapshot);
+    void renderPoints(const BoardSnapshot &snapshot);
+    void renderDifficulty(const BoardSnapshot &snapshot);
+
+private:
+    RenderBackend &mBackend;
+    const int mScreenWidth;
+    const int mScreenHeight;
+    const int mGameBoardWidth;
+    const int mGameBoardHeight;
+    const int mInformationHeight;
+    // 每帧复用的矩形缓冲区：蛇和障碍物，以及按食物类型分组的食物
+    std::vector<RenderRect> mRects;
+    std::vector<RenderRect> mFoodRects[4];
+    // 得分和难度的文字，只在数值改变时重新格式化 (长度不超过预留的容量，不分配内存)
+    std::string mPointsText;
+    std::string mDifficultyText;
+    int mShownPoints = -1;
+    int mShownDifficulty = -1;
+    // renderFrame(const Simulation &) 使用的快照
+    BoardSnapshot mSnapshot;
+
+    // 把格子列表转换成矩形，一次批量绘制
+    void fillCells(const std::vector<CellIndex> &cells, const CellGrid &grid);
+    // 格子 cell 中靠近 from 一侧、长度为 length 像素的部分 (from 和 cell 相邻，可以隔着边界绕回)
+    RenderRect partialCell(const CellGrid &grid, CellIndex cell, CellIndex from, int length) const;
+};
+
+#endif
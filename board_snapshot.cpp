@@ -0,0 +1,24 @@
+#include "board_snapshot.h"
+#include "simulation.h"
+
+// 从模拟复制当前状态
+void BoardSnapshot::capture(const Simulation &simulation, uint64_t tickCount)
+{
+    const CellGrid &source = simulation.getGrid();
+    if (grid.getColumns() != source.getColumns() || grid.getRows() != source.getRows())
+    {
+        grid = source;
+        snake.reserve(static_cast<size_t>(grid.getColumns()) * grid.getRows() + 1);
+    }
+    const std::vector<CellIndex> &cells = simulation.getSnake().getCells();
+    snake.assign(cells.begin(), cells.end());
+    obstacles.assign(simulation.getObstacles().begin(), simulation.getObstacles().end());
+    foods.assign(simulation.getFoods().getItems().begin(), simulation.getFoods().getItems().end());
+    points = simulation.getPoints();
+    difficulty = simulation.getDifficulty();
+    gameOver = simulation.isGameOver();
+    tick = tickCount;
+    moveProgress = simulation.getMoveProgress();
+    moveInterval = 1.0f / simulation.getSnake().getSpeed();
+    vacatedTail = simulation.getVacatedTail();
+}
@@ -0,0 +1,36 @@
+#ifndef BOARD_SNAPSHOT_H
+#define BOARD_SNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "cell_grid.h"
+#include "food_manager.h"
+
+class Simulation;
+
+// 绘制一帧游戏画面需要的状态：蛇身、食物、障碍物、得分和难度
+// 模拟线程每个逻辑帧复制一份交给渲染线程，渲染线程只读，不再访问 Simulation
+struct BoardSnapshot
+{
+    CellGrid grid;
+    std::vector<CellIndex> snake; // 第一个是蛇头
+    std::vector<CellIndex> obstacles;
+    std::vector<FoodItem> foods;
+    int points = 0;
+    int difficulty = 0;
+    bool gameOver = false;
+    // 复制时模拟已经执行的逻辑帧数
+    uint64_t tick = 0;
+    // 插值绘制：距离上一次移动的进度 (0 到 1)、移动间隔 (秒) 和上一次移动时蛇尾离开的格子
+    float moveProgress = 1.0f;
+    float moveInterval = 0.0f;
+    CellIndex vacatedTail = NO_CELL;
+    // 复制的时刻 (微秒，SimulationThread::now)，渲染时据此把移动进度推算到绘制的时刻
+    uint64_t time = 0;
+
+    // 从模拟复制当前状态，复用已有的内存 (蛇身按游戏区域的格子数预留)
+    void capture(const Simulation &simulation, uint64_t tickCount = 0);
+};
+
+#endif
@@ -0,0 +1,29 @@
+#include <algorithm>
+
+#include "cell_grid.h"
+
+// 构造函数：计算每个方向的偏移量，标记游戏区域内的格子
+CellGrid::CellGrid(int columns, int rows)
+    : mColumns(columns),
+      mRows(rows),
+      mStride(columns + 2),
+      mCellCount(static_cast<size_t>(columns + 2) * (rows + 2))
+{
+    // 按 Direction 的顺序 (上、下、左、右、不动)
+    const int offsets[] = {-mStride, mStride, -1, 1, 0};
+    // 从上边走出后回到最下面一行，从左边走出后回到最右边一列，以此类推
+    const int wrapOffsets[] = {rows * mStride, -rows * mStride, columns, -columns, 0};
+    for (int i = 0; i < 5; i++)
+    {
+        mOffsets[i] = offsets[i];
+        mWrapOffsets[i] = wrapOffsets[i];
+    }
+
+    std::shared_ptr<std::vector<uint8_t>> inside(new std::vector<uint8_t>(mCellCount, 0));
+    for (int y = 0; y < rows; y++)
+    {
+        std::fill(inside->begin() + toCell(0, y), inside->begin() + toCell(0, y) + columns, 1);
+    }
+    mInsideCells = inside->data();
+    mInside = inside;
+}
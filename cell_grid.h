@@ -0,0 +1,98 @@
+#ifndef CELL_GRID_H
+#define CELL_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 格子编号：(y + 1) * (宽度 + 2) + (x + 1)，四周各留出一圈格子，撞墙后越界一格的蛇头也能表示
+// 默认使用 16 位编号 (宽高各加 2 后的乘积不超过 65536，即最大 254x254)，
+// 编译时定义 SNAKE_WIDE_CELLS 使用 32 位编号以支持更大的游戏区域
+#ifdef SNAKE_WIDE_CELLS
+typedef uint32_t CellIndex;
+#else
+typedef uint16_t CellIndex;
+#endif
+
+// 不表示任何格子的编号：左上角外圈的格子，蛇头和食物都不可能在这里
+const CellIndex NO_CELL = 0;
+
+// 与 snake.h 中的定义相同 (上、下、左、右、不动)
+enum class Direction;
+
+// 游戏区域的格子编号规则：编号与坐标的转换、相邻格子和是否在游戏区域内
+// 复制时共享只读的格子表，Simulation 和 Snake 可以各自持有一份
+class CellGrid
+{
+public:
+    CellGrid(int columns = 0, int rows = 0);
+
+    int getColumns() const { return mColumns; }
+    int getRows() const { return mRows; }
+    int getStride() const { return mStride; }
+    // 包括外圈在内的格子数
+    size_t getCellCount() const { return mCellCount; }
+
+    CellIndex toCell(int x, int y) const
+    {
+        return static_cast<CellIndex>((y + 1) * mStride + x + 1);
+    }
+    int getX(CellIndex cell) const { return cell % mStride - 1; }
+    int getY(CellIndex cell) const { return cell / mStride - 1; }
+
+    // 沿 direction 的相邻格子：加上每个方向的偏移量
+    CellIndex neighbor(CellIndex cell, Direction direction) const
+    {
+        return static_cast<CellIndex>(cell + mOffsets[static_cast<int>(direction)]);
+    }
+    // 沿 direction 刚刚走出游戏区域的格子从另一侧进入后的位置
+    CellIndex wrap(CellIndex cell, Direction direction) const
+    {
+        return static_cast<CellIndex>(cell + mWrapOffsets[static_cast<int>(direction)]);
+    }
+    // 是否在游戏区域内 (不在外圈上)
+    bool isInside(CellIndex cell) const { return mInsideCells[cell] != 0; }
+
+private:
+    int mColumns;
+    int mRows;
+    int mStride;
+    size_t mCellCount;
+    // 按方向的相邻格子偏移量和穿越边界的偏移量
+    int mOffsets[5];
+    int mWrapOffsets[5];
+    // 每个格子是否在游戏区域内，mInsideCells 指向 mInside 的数据
+    std::shared_ptr<const std::vector<uint8_t>> mInside;
+    const uint8_t *mInsideCells;
+};
+
+// 在 count 个格子中查找 cell：每块 32 字节合并比较结果的掩码，块内不提前退出，
+// 编译器 (-O2) 可以把一块编译成几条 SIMD 比较指令
+inline bool containsCell(const CellIndex *cells, size_t count, CellIndex cell)
+{
+    const size_t BLOCK = 32 / sizeof(CellIndex);
+    size_t i = 0;
+    for (; i + BLOCK <= count; i += BLOCK)
+    {
+        CellIndex hits = 0;
+        for (size_t k = 0; k < BLOCK; k++)
+        {
+            hits |= cells[i + k] == cell ? static_cast<CellIndex>(~0u) : 0;
+        }
+        if (hits != 0)
+        {
+            return true;
+        }
+    }
+    for (; i < count; i++)
+    {
+        if (cells[i] == cell)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
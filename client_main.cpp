@@ -0,0 +1,22 @@
+#include <iostream>
+#include <string>
+
+#include "lockstep.h"
+
+// 无界面联机客户端入口
+int main(int argc, char **argv)
+{
+    std::string endpoint = "unix:/tmp/snakegame.sock";
+    if (argc == 3 && std::string(argv[1]) == "--endpoint")
+    {
+        endpoint = argv[2];
+    }
+    else if (argc != 1)
+    {
+        std::cout << "用法: snakeclient [--endpoint unix:/tmp/snake.sock | tcp:7777]" << std::endl;
+        return 1;
+    }
+
+    LockstepClient client(endpoint);
+    return client.run() ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+#include <chrono>
+
+#include "event_bus.h"
+
+// 获取事件类型字符串
+const char *getGameEventName(GameEventType type)
+{
+    switch (type)
+    {
+    case GameEventType::FoodEaten:
+        return "FoodEaten";
+    case GameEventType::EffectStarted:
+        return "EffectStarted";
+    case GameEventType::EffectExpired:
+        return "EffectExpired";
+    case GameEventType::Collision:
+        return "Collision";
+    case GameEventType::LevelUp:
+        return "LevelUp";
+    case GameEventType::GameOver:
+        return "GameOver";
+    case GameEventType::FoodExpired:
+        return "FoodExpired";
+    default:
+        return "Unknown";
+    }
+}
+
+// 添加订阅者
+EventBus::Subscription *EventBus::subscribe()
+{
+    mSubscribers.push_back(std::unique_ptr<Subscription>(new Subscription()));
+    return mSubscribers.back().get();
+}
+
+// 发布事件，订阅者的队列满时丢弃
+void EventBus::publish(const GameEvent &event)
+{
+    mPublished++;
+    for (auto &subscriber : mSubscribers)
+    {
+        if (!subscriber->push(event))
+        {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+uint64_t EventBus::getPublished() const
+{
+    return mPublished;
+}
+
+uint64_t EventBus::getDropped() const
+{
+    return mDropped.load(std::memory_order_relaxed);
+}
+
+// 遥测消费者构造函数，启动后台线程
+EventLogger::EventLogger(EventBus::Subscription *subscription, const std::string &path)
+    : mSubscription(subscription), mFile(path, std::ios::app)
+{
+    mThread = std::thread(&EventLogger::run, this);
+}
+
+// 析构函数，停止后台线程并写出剩余事件
+EventLogger::~EventLogger()
+{
+    mStop.store(true);
+    mThread.join();
+    drain();
+}
+
+// 每 100 毫秒取出一次事件
+void EventLogger::run()
+{
+    while (!mStop.load())
+    {
+        drain();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
+void EventLogger::drain()
+{
+    GameEvent event;
+    bool wrote = false;
+    while (mSubscription->pop(event))
+    {
+        mFile << getGameEventName(event.type) << " x=" << event.x << " y=" << event.y
+              << " food=" << static_cast<int>(event.foodType)
+              << " collision=" << static_cast<int>(event.collision)
+              << " value=" << event.value << '\n';
+        wrote = true;
+    }
+    if (wrote)
+    {
+        mFile.flush();
+    }
+}
@@ -0,0 +1,149 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "snake.h"
+
+// 游戏事件类型
+enum class GameEventType : uint8_t
+{
+    FoodEaten,     // 吃到食物，value 为吃完之后的得分
+    EffectStarted, // 特殊效果开始，foodType 为效果对应的食物类型
+    EffectExpired, // 特殊效果结束
+    Collision,     // 发生碰撞，collision 为碰撞类型
+    LevelUp,       // 难度等级提升，value 为新的等级
+    GameOver,      // 游戏结束，value 为最终得分
+    FoodExpired    // 食物到期消失，位置和 foodType 为消失的食物
+};
+
+// 碰撞类型
+enum class CollisionType : uint8_t
+{
+    None,
+    Wall,
+    Self,
+    Obstacle
+};
+
+// 游戏事件，按值传递，体积保持在 16 字节以内
+struct GameEvent
+{
+    GameEventType type;
+    FoodType foodType = FoodType::Normal;
+    CollisionType collision = CollisionType::None;
+    int16_t x = 0; // 事件发生的位置 (蛇头或食物所在的格子)
+    int16_t y = 0;
+    int32_t value = 0;
+};
+
+// 获取事件类型字符串
+const char *getGameEventName(GameEventType type);
+
+// 单生产者单消费者无锁环形队列
+// 生产者和消费者各自缓存对方的下标，只有在看起来满/空时才读取对方的原子变量
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity 必须是 2 的幂");
+
+public:
+    // 生产者调用，队列已满时立即返回 false
+    bool push(const T &value)
+    {
+        size_t head = mHead.load(std::memory_order_relaxed);
+        if (head - mCachedTail >= Capacity)
+        {
+            mCachedTail = mTail.load(std::memory_order_acquire);
+            if (head - mCachedTail >= Capacity)
+            {
+                return false;
+            }
+        }
+        mBuffer[head & (Capacity - 1)] = value;
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者调用，队列为空时返回 false
+    bool pop(T &value)
+    {
+        size_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail == mCachedHead)
+        {
+            mCachedHead = mHead.load(std::memory_order_acquire);
+            if (tail == mCachedHead)
+            {
+                return false;
+            }
+        }
+        value = mBuffer[tail & (Capacity - 1)];
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 当前元素数量 (近似值)
+    size_t size() const
+    {
+        return mHead.load(std::memory_order_acquire) - mTail.load(std::memory_order_acquire);
+    }
+
+private:
+    // 生产者和消费者的数据放在不同的缓存行，避免伪共享
+    alignas(64) std::atomic<size_t> mHead{0};
+    size_t mCachedTail = 0;
+    alignas(64) std::atomic<size_t> mTail{0};
+    size_t mCachedHead = 0;
+    alignas(64) T mBuffer[Capacity];
+};
+
+// 游戏事件总线：模拟线程发布事件，每个订阅者有自己的 SPSC 队列
+// 发布永远不会阻塞，订阅者的队列满时丢弃事件并计数
+class EventBus
+{
+public:
+    // 每个订阅者队列的容量
+    static const size_t QUEUE_CAPACITY = 1024;
+    typedef SpscRing<GameEvent, QUEUE_CAPACITY> Subscription;
+
+    // 添加订阅者，必须在开始发布之前调用
+    Subscription *subscribe();
+    // 发布事件 (只能在一个线程中调用)
+    void publish(const GameEvent &event);
+
+    uint64_t getPublished() const;
+    uint64_t getDropped() const;
+
+private:
+    std::vector<std::unique_ptr<Subscription>> mSubscribers;
+    uint64_t mPublished = 0;
+    std::atomic<uint64_t> mDropped{0};
+};
+
+// 遥测消费者：在自己的线程中定期取出事件并写入日志文件
+class EventLogger
+{
+public:
+    EventLogger(EventBus::Subscription *subscription, const std::string &path);
+    ~EventLogger();
+
+private:
+    EventBus::Subscription *mSubscription;
+    std::ofstream mFile;
+    std::atomic<bool> mStop{false};
+    std::thread mThread;
+
+    void run();
+    void drain();
+    EventLogger(const EventLogger &) = delete;
+    EventLogger &operator=(const EventLogger &) = delete;
+};
+
+#endif
@@ -0,0 +1,93 @@
+#include <algorithm>
+
+#include "food_manager.h"
+
+// 设置游戏区域大小：外圈的格子标记为不能放食物
+void FoodManager::resize(const CellGrid &grid)
+{
+    if (grid.getColumns() == mColumns && grid.getRows() == mRows)
+    {
+        clear();
+        return;
+    }
+    mColumns = grid.getColumns();
+    mRows = grid.getRows();
+    mCells.assign(grid.getCellCount(), EMPTY);
+    // 外圈：第一行和最后一行，以及每一行的第一个和最后一个格子
+    std::fill(mCells.begin(), mCells.begin() + grid.getStride(), OUTSIDE);
+    std::fill(mCells.end() - grid.getStride(), mCells.end(), OUTSIDE);
+    for (int y = 0; y < mRows; y++)
+    {
+        mCells[grid.toCell(-1, y)] = OUTSIDE;
+        mCells[grid.toCell(mColumns, y)] = OUTSIDE;
+    }
+    mItems.clear();
+}
+
+// 清空所有食物，只重置有食物的格子
+void FoodManager::clear()
+{
+    for (const auto &item : mItems)
+    {
+        mCells[item.cell] = EMPTY;
+    }
+    mItems.clear();
+}
+
+// 添加食物
+bool FoodManager::add(CellIndex cell, FoodType type, TimerWheel::TimerId timer)
+{
+    if (cell >= mCells.size() || mCells[cell] != EMPTY)
+    {
+        return false;
+    }
+    mCells[cell] = static_cast<int32_t>(mItems.size());
+    mItems.push_back({cell, type, timer});
+    return true;
+}
+
+// 查找格子上的食物
+const FoodItem *FoodManager::find(CellIndex cell) const
+{
+    if (cell >= mCells.size() || mCells[cell] < 0)
+    {
+        return nullptr;
+    }
+    return &mItems[mCells[cell]];
+}
+
+// 删除格子上的食物：用最后一个食物填补空位
+bool FoodManager::remove(CellIndex cell, FoodItem &removed)
+{
+    if (cell >= mCells.size() || mCells[cell] < 0)
+    {
+        return false;
+    }
+    int32_t index = mCells[cell];
+    removed = mItems[index];
+    const FoodItem &last = mItems.back();
+    mCells[last.cell] = index;
+    mItems[index] = last;
+    mItems.pop_back();
+    mCells[cell] = EMPTY;
+    return true;
+}
+
+// 设置到期定时器
+void FoodManager::setTimer(CellIndex cell, TimerWheel::TimerId timer)
+{
+    if (cell < mCells.size() && mCells[cell] >= 0)
+    {
+        mItems[mCells[cell]].timer = timer;
+    }
+}
+
+const std::vector<FoodItem> &FoodManager::getItems() const
+{
+    return mItems;
+}
+
+size_t FoodManager::size() const
+{
+    return mItems.size();
+}
@@ -0,0 +1,52 @@
+#ifndef FOOD_MANAGER_H
+#define FOOD_MANAGER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "snake.h"
+#include "cell_grid.h"
+#include "timer_wheel.h"
+
+// 一个食物：所在的格子和类型，以及到期定时器 (没有寿命时为 INVALID_TIMER)
+struct FoodItem
+{
+    CellIndex cell;
+    FoodType type;
+    TimerWheel::TimerId timer;
+};
+
+// 食物管理类：同时管理任意数量的食物
+// 食物紧凑地保存在数组中，另有一张按格子编号索引的表，查找、添加和删除都是 O(1)
+class FoodManager
+{
+public:
+    // 按游戏区域的格子编号规则设置大小并清空所有食物
+    void resize(const CellGrid &grid);
+    // 清空所有食物
+    void clear();
+    // 添加食物，格子不在游戏区域内或已经有食物时返回 false
+    bool add(CellIndex cell, FoodType type, TimerWheel::TimerId timer = TimerWheel::INVALID_TIMER);
+    // 查找格子上的食物，没有食物 (或不在游戏区域内) 时返回 nullptr
+    const FoodItem *find(CellIndex cell) const;
+    // 删除格子上的食物，被删除的食物写入 removed
+    bool remove(CellIndex cell, FoodItem &removed);
+    // 设置格子上食物的到期定时器
+    void setTimer(CellIndex cell, TimerWheel::TimerId timer);
+    // 所有食物 (顺序不固定)
+    const std::vector<FoodItem> &getItems() const;
+    size_t size() const;
+
+private:
+    // 表中的特殊值：格子上没有食物，格子在外圈上 (不能放食物)
+    static constexpr int32_t EMPTY = -1;
+    static constexpr int32_t OUTSIDE = -2;
+    // 每个格子上食物在 mItems 中的下标
+    std::vector<int32_t> mCells;
+    // 当前表对应的游戏区域大小，大小不变时 resize 只清空食物
+    int mColumns = 0;
+    int mRows = 0;
+    std::vector<FoodItem> mItems;
+};
+
+#endif
@@ -0,0 +1,222 @@
+#include <chrono>
+
+#include "frame_capture.h"
+
+// 构造函数：分配缓冲池，所有缓冲区一开始都是空闲的
+FrameCapture::FrameCapture(int width, int height, int fps, CaptureFormat format, int poolSize)
+    : mWidth(width), mHeight(height), mFps(fps), mFormat(format)
+{
+    if (poolSize < 1)
+    {
+        poolSize = 1;
+    }
+    else if (poolSize > MAX_POOL_SIZE)
+    {
+        poolSize = MAX_POOL_SIZE;
+    }
+    mBuffers.resize(poolSize);
+    for (int i = 0; i < poolSize; i++)
+    {
+        mBuffers[i].resize(static_cast<size_t>(getPitch()) * height);
+        mFreeBuffers.push(i);
+    }
+}
+
+// 析构函数
+FrameCapture::~FrameCapture()
+{
+    stop();
+}
+
+// 打开文件并启动写入线程
+bool FrameCapture::start(const std::string &path)
+{
+    if (mRunning)
+    {
+        return false;
+    }
+    mFile.open(path, std::ios::binary | std::ios::trunc);
+    if (!mFile.is_open())
+    {
+        return false;
+    }
+    if (mFormat == CaptureFormat::Y4m)
+    {
+        mFile << "YUV4MPEG2 W" << mWidth << " H" << mHeight << " F" << mFps << ":1 Ip A1:1 C444\n";
+        mConverted.resize(static_cast<size_t>(mWidth) * mHeight * 3);
+    }
+    mStop.store(false);
+    mRunning = true;
+    mThread = std::thread(&FrameCapture::run, this);
+    return true;
+}
+
+// 写完已经提交的帧，停止写入线程并关闭文件
+void FrameCapture::stop()
+{
+    if (!mRunning)
+    {
+        return;
+    }
+    mStop.store(true);
+    mThread.join();
+    mFile.close();
+    mRunning = false;
+}
+
+// 取一个空闲缓冲区，没有空闲缓冲区时丢弃这一帧
+uint8_t *FrameCapture::acquireFrame()
+{
+    if (mAcquired < 0 && !mFreeBuffers.pop(mAcquired))
+    {
+        mAcquired = -1;
+        mDropped++;
+        return nullptr;
+    }
+    return mBuffers[mAcquired].data();
+}
+
+// 提交缓冲区，交给写入线程
+void FrameCapture::submitFrame()
+{
+    if (mAcquired < 0)
+    {
+        return;
+    }
+    // 待写入队列的容量不小于缓冲池，一定能放下
+    mFilledBuffers.push(mAcquired);
+    mAcquired = -1;
+    mCaptured++;
+}
+
+// 复制一帧 ARGB8888 画面
+bool FrameCapture::captureArgb(const uint32_t *pixels)
+{
+    uint8_t *out = acquireFrame();
+    if (out == nullptr)
+    {
+        return false;
+    }
+    size_t count = static_cast<size_t>(mWidth) * mHeight;
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t pixel = pixels[i];
+        out[0] = static_cast<uint8_t>(pixel >> 16);
+        out[1] = static_cast<uint8_t>(pixel >> 8);
+        out[2] = static_cast<uint8_t>(pixel);
+        out += 3;
+    }
+    submitFrame();
+    return true;
+}
+
+// 写入线程：有待写入的帧时一直写，空闲时短暂休眠
+void FrameCapture::run()
+{
+    while (!mStop.load())
+    {
+        if (drain() == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    drain();
+    mFile.flush();
+}
+
+int FrameCapture::drain()
+{
+    int frames = 0;
+    int index;
+    while (mFilledBuffers.pop(index))
+    {
+        writeFrame(mBuffers[index]);
+        mFreeBuffers.push(index);
+        frames++;
+    }
+    return frames;
+}
+
+// 转换格式并写出一帧 (在写入线程中执行)
+void FrameCapture::writeFrame(const std::vector<uint8_t> &rgb)
+{
+    if (mFailed.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    if (mFormat == CaptureFormat::Y4m)
+    {
+        // BT.601 RGB 转 YUV，三个平面依次存放
+        size_t count = static_cast<size_t>(mWidth) * mHeight;
+        uint8_t *yPlane = mConverted.data();
+        uint8_t *uPlane = yPlane + count;
+        uint8_t *vPlane = uPlane + count;
+        for (size_t i = 0; i < count; i++)
+        {
+            int r = rgb[i * 3];
+            int g = rgb[i * 3 + 1];
+            int b = rgb[i * 3 + 2];
+            yPlane[i] = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+            uPlane[i] = static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            vPlane[i] = static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+        mFile << "FRAME\n";
+        mFile.write(reinterpret_cast<const char *>(mConverted.data()), mConverted.size());
+    }
+    else
+    {
+        mFile.write(reinterpret_cast<const char *>(rgb.data()), rgb.size());
+    }
+    if (!mFile)
+    {
+        mFailed.store(true);
+        return;
+    }
+    mWritten.fetch_add(1, std::memory_order_relaxed);
+}
+
+int FrameCapture::getWidth() const
+{
+    return mWidth;
+}
+
+int FrameCapture::getHeight() const
+{
+    return mHeight;
+}
+
+int FrameCapture::getPitch() const
+{
+    return mWidth * 3;
+}
+
+uint64_t FrameCapture::getCaptured() const
+{
+    return mCaptured;
+}
+
+uint64_t FrameCapture::getDropped() const
+{
+    return mDropped;
+}
+
+uint64_t FrameCapture::getWritten() const
+{
+    return mWritten.load();
+}
+
+bool FrameCapture::hasFailed() const
+{
+    return mFailed.load();
+}
+
+// 根据扩展名选择格式
+CaptureFormat FrameCapture::formatFromPath(const std::string &path)
+{
+    const std::string extension = ".y4m";
+    if (path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0)
+    {
+        return CaptureFormat::Y4m;
+    }
+    return CaptureFormat::RawRgb;
+}
@@ -0,0 +1,88 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "event_bus.h"
+
+// 录像文件格式
+enum class CaptureFormat
+{
+    Y4m,   // YUV4MPEG2 (4:4:4)，大多数播放器和 ffmpeg 可以直接打开
+    RawRgb // 没有文件头的 RGB24 帧序列
+};
+
+// 异步录像：渲染线程把提交的画面读回到缓冲池中的一个缓冲区，交给写入线程转换格式并写入磁盘
+// 渲染线程从不等待磁盘：缓冲池用完 (写入线程跟不上) 时这一帧直接丢弃并计数
+// 空闲缓冲区和待写入的缓冲区各用一个 SPSC 队列传递，缓冲区在两个线程之间循环使用，不再分配内存
+class FrameCapture
+{
+public:
+    static const int MAX_POOL_SIZE = 16;
+
+    // 画面的宽度和高度 (像素)、帧率 (写入 Y4M 文件头)、格式和缓冲池大小
+    FrameCapture(int width, int height, int fps, CaptureFormat format, int poolSize = 8);
+    ~FrameCapture();
+
+    // 打开文件并启动写入线程
+    bool start(const std::string &path);
+    // 写完已经提交的帧，停止写入线程并关闭文件
+    void stop();
+
+    // 取一个空闲缓冲区 (RGB24，每行 getPitch() 字节)，没有空闲缓冲区时返回 nullptr 并计为丢帧
+    uint8_t *acquireFrame();
+    // 提交 acquireFrame 取得的缓冲区
+    void submitFrame();
+    // 复制一帧 ARGB8888 画面 (软件渲染后端使用)
+    bool captureArgb(const uint32_t *pixels);
+
+    int getWidth() const;
+    int getHeight() const;
+    int getPitch() const;
+    // 提交的帧数、丢弃的帧数、已写入的帧数
+    uint64_t getCaptured() const;
+    uint64_t getDropped() const;
+    uint64_t getWritten() const;
+    // 写入是否出错
+    bool hasFailed() const;
+
+    // 根据扩展名选择格式：.y4m 为 Y4M，其他为 RGB24
+    static CaptureFormat formatFromPath(const std::string &path);
+
+private:
+    typedef SpscRing<int, MAX_POOL_SIZE> IndexQueue;
+
+    const int mWidth;
+    const int mHeight;
+    const int mFps;
+    const CaptureFormat mFormat;
+    std::vector<std::vector<uint8_t>> mBuffers;
+    IndexQueue mFreeBuffers;   // 写入线程 -> 渲染线程
+    IndexQueue mFilledBuffers; // 渲染线程 -> 写入线程
+    int mAcquired = -1;        // 渲染线程当前持有的缓冲区
+
+    std::ofstream mFile;
+    std::vector<uint8_t> mConverted; // 写入线程转换格式用的缓冲区
+    std::thread mThread;
+    std::atomic<bool> mStop{false};
+    bool mRunning = false;
+
+    uint64_t mCaptured = 0;
+    uint64_t mDropped = 0;
+    std::atomic<uint64_t> mWritten{0};
+    std::atomic<bool> mFailed{false};
+
+    void run();
+    // 写出所有待写入的帧，返回写出的帧数
+    int drain();
+    void writeFrame(const std::vector<uint8_t> &rgb);
+    FrameCapture(const FrameCapture &) = delete;
+    FrameCapture &operator=(const FrameCapture &) = delete;
+};
+
+#endif
@@ -8,9 +8,17 @@
 
 #include <fstream>
 #include <algorithm>
+#include <ctime>
+#include <cstdlib>
 
 #include "game.h"
 
+// SDL 的毫秒时钟 (换算成微秒)，与 SDL 事件时间戳使用同一个时钟
+static uint64_t sdlMicroseconds()
+{
+    return static_cast<uint64_t>(SDL_GetTicks()) * 1000;
+}
+
 // 构造函数
 Game::Game() : font(nullptr), mScreenWidth(WINDOW_WIDTH), mScreenHeight(WINDOW_HEIGHT) // 设置窗口高度
 {
@@ -39,12 +47,74 @@ Game::Game() : font(nullptr), mScreenWidth(WINDOW_WIDTH), mScreenHeight(WINDOW_H
         closeSDL();
         throw std::runtime_error("音乐加载失败");
     }
+    // 加载音效，输出格式不支持时只播放音乐
+    mPtrSoundEffects.reset(new SdlSoundEffects());
+    if (!mPtrSoundEffects->start())
+    {
+        std::cerr << "音效不可用" << std::endl;
+        mPtrSoundEffects.reset();
+    }
     // 计算游戏区域大小
     mGameBoardWidth = mScreenWidth - mInstructionWidth;
     mGameBoardHeight = mScreenHeight - mInformationHeight;
+    // 所有绘制都经过渲染后端
+    mPtrRenderBackend.reset(new SdlRenderBackend(renderer, font, mScreenWidth, mScreenHeight));
+    mPtrBoardRenderer.reset(new BoardRenderer(*mPtrRenderBackend, mScreenWidth, mScreenHeight, mGameBoardWidth, mGameBoardHeight));
+    // 录像：.y4m 文件写 Y4M，其他文件写 RGB24，写入线程跟不上时丢帧而不拖慢游戏
+    if (const char *capturePath = std::getenv("SNAKE_CAPTURE"))
+    {
+        mPtrFrameCapture.reset(new FrameCapture(mScreenWidth, mScreenHeight, 30, FrameCapture::formatFromPath(capturePath)));
+        if (mPtrFrameCapture->start(capturePath))
+        {
+            mPtrRenderBackend->setFrameCapture(mPtrFrameCapture.get());
+        }
+        else
+        {
+            std::cerr << "无法创建录像文件: " << capturePath << std::endl;
+            mPtrFrameCapture.reset();
+        }
+    }
+    // 创建游戏模拟对象
+    mPtrSimulation.reset(new Simulation(mGameBoardWidth, mGameBoardHeight, mInitialSnakeLength));
+    // 订阅游戏事件，所有订阅都必须在模拟开始发布之前完成
+    mGameEvents = mEventBus.subscribe();
+    if (const char *eventLogPath = std::getenv("SNAKE_EVENT_LOG"))
+    {
+        mEventLogger.reset(new EventLogger(mEventBus.subscribe(), eventLogPath));
+    }
+    mPtrSimulation->setEventBus(&mEventBus);
+    mLatencyReport = std::getenv("SNAKE_LATENCY_REPORT") != nullptr;
+    // 同时存在的食物数量和食物寿命 (秒)，默认只有一个永不消失的食物
+    const char *foodCount = std::getenv("SNAKE_FOOD_COUNT");
+    const char *foodLifetime = std::getenv("SNAKE_FOOD_LIFETIME");
+    mPtrSimulation->setFoodOptions(foodCount ? std::atoi(foodCount) : 1,
+                                   foodLifetime ? static_cast<uint32_t>(std::atof(foodLifetime) / EFFECT_TICK_SECONDS) : 0);
+    // 模拟线程每秒复制一次存档，程序崩溃后可以继续
+    mPtrSimulationThread.reset(new SimulationThread(*mPtrSimulation, mTickRate));
+    mPtrSimulationThread->setClock(&sdlMicroseconds);
+    mPtrSimulationThread->setSaveInterval(1.0f);
+    if (const char *slowRender = std::getenv("SNAKE_SLOW_RENDER_MS"))
+    {
+        mSlowRenderMs = std::max(0, std::atoi(slowRender));
+    }
+    mFrameReport = std::getenv("SNAKE_FRAME_REPORT") != nullptr;
+    if (const char *speed = std::getenv("SNAKE_SPEED"))
+    {
+        mSpeedOverride = std::max(0.0f, static_cast<float>(std::atof(speed)));
+    }
+    // 长时间运行：机器人操作，预热 (纹理缓存填满等) 至少 1 分钟
+    if (const char *soak = std::getenv("SNAKE_SOAK"))
+    {
+        mSoakGames = std::strtoull(soak, nullptr, 10);
+        const char *sampleInterval = std::getenv("SNAKE_SOAK_SAMPLE");
+        double interval = sampleInterval ? std::max(0.1, std::atof(sampleInterval)) : 10.0;
+        mPtrSoakMonitor.reset(new SoakMonitor(interval, std::max(60.0, 6.0 * interval)));
+        mPtrSimulationThread->setAutopilot(&Game::soakAutopilot, this);
+        mSoakStart = SimulationThread::now();
+    }
 
     // 初始化排行榜
-    mLeaderBoard.assign(mNumLeaders, 0);
+    mLeaderBoard.clear();
 }
 
 // 析构函数
@@ -68,8 +138,12 @@ bool Game::initSDL()
         SDL_Quit(); //  如果 SDL_ttf 初始化失败，则需要关闭 SDL
         return false;
     }
-    // 初始化 SDL_mixer
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0)
+    // 初始化 SDL_mixer，缓冲区越小音效的延迟越低，但音频回调更频繁
+    if (const char *audioBuffer = std::getenv("SNAKE_AUDIO_BUFFER"))
+    {
+        mAudioBufferFrames = std::max(64, std::min(8192, std::atoi(audioBuffer)));
+    }
+    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, mAudioBufferFrames) < 0)
     {
         std::cerr << "SDL_mixer 初始化失败: " << Mix_GetError() << std::endl;
         SDL_DestroyWindow(window);
@@ -99,12 +173,41 @@ bool Game::initSDL()
         return false;
     }
 
+    // 目标帧率：按窗口所在显示器的刷新率绘制
+    SDL_DisplayMode displayMode;
+    if (const char *fps = std::getenv("SNAKE_FPS"))
+    {
+        mTargetFps = std::max(0, std::atoi(fps));
+    }
+    else if (SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(window), &displayMode) == 0 &&
+             displayMode.refresh_rate > 0)
+    {
+        mTargetFps = displayMode.refresh_rate;
+    }
+
     return true;
 }
 
 // 关闭 SDL
 void Game::closeSDL()
 {
+    // 模拟线程访问的对象都要在它停止之后才能释放
+    if (mPtrSimulationThread)
+    {
+        mPtrSimulationThread->stop();
+    }
+    // 写完录像
+    if (mPtrFrameCapture)
+    {
+        mPtrRenderBackend->setFrameCapture(nullptr);
+        mPtrFrameCapture->stop();
+        std::cout << "录像: 写入 " << mPtrFrameCapture->getWritten() << " 帧，丢弃 " << mPtrFrameCapture->getDropped() << " 帧"
+                  << (mPtrFrameCapture->hasFailed() ? " (写入出错)" : "") << std::endl;
+        mPtrFrameCapture.reset();
+    }
+    // 渲染后端持有的纹理要在销毁渲染器之前释放
+    mPtrBoardRenderer.reset();
+    mPtrRenderBackend.reset();
 
     // 释放字体资源
     if (font != nullptr)
@@ -129,6 +232,16 @@ void Game::closeSDL()
 
     // 退出 SDL_ttf
     TTF_Quit();
+    // 停止音效回调，释放音效
+    if (mPtrSoundEffects)
+    {
+        mPtrSoundEffects->stop();
+        if (mLatencyReport)
+        {
+            reportAudioLatency();
+        }
+        mPtrSoundEffects.reset();
+    }
     // Stop the music
     Mix_HaltMusic();
 
@@ -137,115 +250,23 @@ void Game::closeSDL()
     mBackgroundMusic = nullptr;
 
     // Quit SDL_mixer
+    Mix_CloseAudio();
     Mix_Quit();
     // 退出 SDL
     SDL_Quit();
 }
 // 函数用于渲染文字
-void Game::renderText(const std::string &text, int x, int y, SDL_Color color) const
-{
-    SDL_Surface *surface = TTF_RenderText_Solid(font, text.c_str(), color);
-    if (surface == nullptr)
-    {
-        std::cerr << "Failed to create text surface! SDL_ttf Error: " << TTF_GetError() << std::endl;
-        return;
-    }
-
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture == nullptr)
-    {
-        std::cerr << "Failed to create text texture! SDL Error: " << SDL_GetError() << std::endl;
-        SDL_FreeSurface(surface);
-        return;
-    }
-
-    SDL_Rect dstRect = {x, y, surface->w, surface->h};
-    SDL_RenderCopy(renderer, texture, nullptr, &dstRect);
-
-    SDL_FreeSurface(surface);
-    SDL_DestroyTexture(texture);
-}
-// 渲染游戏区域
-void Game::renderGameBoard() const
+void Game::renderText(const std::string &text, int x, int y, RenderColor color) const
 {
-    SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF); // 设置边框颜色 (白色)
-
-    // 绘制上边框
-    SDL_RenderDrawLine(renderer, 0, 0, mGameBoardWidth, 0);
-    // 绘制下边框
-    SDL_RenderDrawLine(renderer, 0, mGameBoardHeight - 1, mGameBoardWidth, mGameBoardHeight - 1);
-    // 绘制左边框
-    SDL_RenderDrawLine(renderer, 0, 0, 0, mGameBoardHeight);
-    // 绘制右边框
-    SDL_RenderDrawLine(renderer, mGameBoardWidth - 1, 0, mGameBoardWidth - 1, mGameBoardHeight);
-}
-// 渲染信息面板
-void Game::renderInformationBoard() const
-{
-
-    // 设置文字颜色 (例如，白色)
-    SDL_Color textColor = {255, 255, 255, 255};
-    // 使用百分比计算文本位置
-    int x = 0.05 * mScreenWidth;                          // 距离游戏区域左侧 5% 的位置
-    int y = mGameBoardHeight + 0.05 * mInformationHeight; // 距离屏幕顶部 5% 的位置
-    // 渲染文字
-    renderText("Welcome to The Snake Game!", x, y, textColor);
-}
-// 渲染指令面板
-void Game::renderInstructionBoard() const
-{
-    SDL_Color textColor = {255, 255, 255, 255};
-
-    // 使用百分比计算文本位置
-    int x = mGameBoardWidth + 0.05 * mScreenWidth; // 距离游戏区域右侧 5% 的位置
-    int y = 0.05 * mScreenHeight;                  // 距离屏幕顶部 5% 的位置
-    int ySpacing = 0.04 * mScreenHeight;           // 行间距为屏幕高度的 5%
-
-    renderText("Manual", x, y, textColor);
-    y += ySpacing;
-
-    renderText("Up / W", x, y, textColor);
-    y += ySpacing;
-
-    renderText("Down / S", x, y, textColor);
-    y += ySpacing;
-
-    renderText("Left / A", x, y, textColor);
-    y += ySpacing;
-
-    renderText("Right / D", x, y, textColor);
-    y += ySpacing;
-    renderText("Pause: Space", x, y, textColor);
-    y += ySpacing;
+    mPtrRenderBackend->drawText(text, x, y, color);
 }
 //  辅助函数：获取文字宽度
 int Game::getTextWidth(const std::string &text) const
 {
-    int w;
-    TTF_SizeText(font, text.c_str(), &w, nullptr);
+    int w, h;
+    mPtrRenderBackend->getTextSize(text, w, h);
     return w;
 }
-// 渲染排行榜
-void Game::renderLeaderBoard() const
-{
-    SDL_Color textColor = {255, 255, 255, 255};
-
-    // 使用百分比计算文本位置
-    int x = mGameBoardWidth + 0.05 * mScreenWidth; // 距离游戏区域右侧 5% 的位置
-    int y = 0.4 * mScreenHeight;                   // 距离屏幕顶部 40% 的位置
-    int ySpacing = 0.04 * mScreenHeight;           // 行间距为屏幕高度的 5%
-
-    renderText("Leader Board", x, y, textColor);
-    y += ySpacing;
-
-    // 渲染排行榜数据
-    for (int i = 0; i < mNumLeaders; i++)
-    {
-        std::string rankText = "#" + std::to_string(i + 1) + ": " + std::to_string(mLeaderBoard[i]);
-        renderText(rankText, x, y, textColor);
-        y += ySpacing;
-    }
-}
 // 处理开始菜单按键事件
 void Game::handleStartMenuEvents(const SDL_Event &e)
 {
@@ -292,6 +313,14 @@ void Game::handleStartMenuEvents(const SDL_Event &e)
             initializeGame(); // 在开始游戏时才初始化游戏
         }
         break;
+    case SDLK_r:
+        // 继续上次保存的游戏
+        if (mHasSavedGame && loadGame())
+        {
+            isStartMenu = false;
+            return;
+        }
+        break;
     }
     renderStartMenu(); // 重新渲染菜单界面
 }
@@ -305,6 +334,20 @@ void Game::handleEvents()
         {
         case SDLK_ESCAPE:
         case SDL_QUIT:
+            // 游戏进行中退出时保存进度，下次启动可以继续 (先停止模拟线程)
+            // 已经结束的一局 (GameOver 事件可能还没有处理，也可能被丢弃) 记录得分，不保存
+            if (!isStartMenu)
+            {
+                mPtrSimulationThread->stop();
+                if (mPtrSimulation->isGameOver())
+                {
+                    finishGame();
+                }
+                else
+                {
+                    saveGame();
+                }
+            }
             isRunning = false;
             break;
         case SDL_KEYDOWN:
@@ -314,26 +357,28 @@ void Game::handleEvents()
             }
             else
             {
+                // SDL 事件时间戳 (毫秒)，与 SDL_GetTicks 使用同一个时钟
+                uint64_t timestamp = static_cast<uint64_t>(e.key.timestamp) * 1000;
                 switch (e.key.keysym.sym)
                 {
                 case SDLK_UP:
                 case SDLK_w:
-                    addDirectionToQueue(Direction::Up);
+                    mPtrSimulationThread->addDirection(Direction::Up, timestamp);
                     break;
                 case SDLK_DOWN:
                 case SDLK_s:
-                    addDirectionToQueue(Direction::Down);
+                    mPtrSimulationThread->addDirection(Direction::Down, timestamp);
                     break;
                 case SDLK_LEFT:
                 case SDLK_a:
-                    addDirectionToQueue(Direction::Left);
+                    mPtrSimulationThread->addDirection(Direction::Left, timestamp);
                     break;
                 case SDLK_RIGHT:
                 case SDLK_d:
-                    addDirectionToQueue(Direction::Right);
+                    mPtrSimulationThread->addDirection(Direction::Right, timestamp);
                     break;
                 case SDLK_SPACE:
-                    togglePause();
+                    mPtrSimulationThread->togglePause();
                     break;
                 default:
                     break;
@@ -388,42 +433,25 @@ std::string Game::getMapTypeString(MapType type) const
 }
 
 // 渲染居中显示的文本
-void Game::renderCenteredText(const std::string &text, float xPercent, float yPercent, SDL_Color color) const
+void Game::renderCenteredText(const std::string &text, float xPercent, float yPercent, RenderColor color) const
 {
     int x = static_cast<int>(mScreenWidth * xPercent);  //  将百分比转换为像素坐标
     int y = static_cast<int>(mScreenHeight * yPercent); //  将百分比转换为像素坐标
 
-    SDL_Surface *surface = TTF_RenderText_Solid(font, text.c_str(), color);
-    if (surface == nullptr)
-    {
-        std::cerr << "无法创建文本曲面: " << TTF_GetError() << std::endl;
-        return;
-    }
-
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture == nullptr)
-    {
-        std::cerr << "无法创建文本纹理: " << SDL_GetError() << std::endl;
-        SDL_FreeSurface(surface);
-        return;
-    }
-
-    SDL_Rect dstRect = {x - surface->w / 2, y - surface->h / 2, surface->w, surface->h}; // 居中
-    SDL_RenderCopy(renderer, texture, nullptr, &dstRect);
-
-    SDL_FreeSurface(surface);
-    SDL_DestroyTexture(texture);
+    int w, h;
+    mPtrRenderBackend->getTextSize(text, w, h);
+    renderText(text, x - w / 2, y - h / 2, color); // 居中
 }
 // 颜色定义
-SDL_Color textColor = {255, 255, 255, 255};      // 白色
-SDL_Color selectedColor = {0, 255, 0, 255};      // 绿色
-SDL_Color highlightColor = {255, 255, 0, 255};   // 黄色
-SDL_Color selectedRowBgColor = {0, 100, 0, 255}; // 深绿色
+RenderColor textColor = {255, 255, 255, 255};      // 白色
+RenderColor selectedColor = {0, 255, 0, 255};      // 绿色
+RenderColor highlightColor = {255, 255, 0, 255};   // 黄色
+RenderColor selectedRowBgColor = {0, 100, 0, 255}; // 深绿色
 void Game::renderStartMenu()
 {
     // 1. 渲染背景
-    SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF); // 设置背景颜色 (黑色)
-    SDL_RenderClear(renderer);                                // 清空渲染器
+    mPtrRenderBackend->setColor({0x00, 0x00, 0x00, 0xFF}); // 设置背景颜色 (黑色)
+    mPtrRenderBackend->clear();                            // 清空渲染器
 
     // 2. 渲染标题
     renderCenteredText("Snake Game", 0.5f, 0.25f, textColor); // 水平垂直居中
@@ -452,9 +480,16 @@ void Game::renderStartMenu()
 
     // 开始游戏
     renderCenteredText("Start Game", 0.5f, optionY, (selectedOption == 3) ? highlightColor : textColor);
+    optionY += optionSpacing;
+
+    // 存档提示
+    if (mHasSavedGame)
+    {
+        renderCenteredText("Press R to resume saved game", 0.5f, optionY, textColor);
+    }
 
     // 4. 更新屏幕
-    SDL_RenderPresent(renderer);
+    mPtrRenderBackend->present();
 }
 
 // 渲染单个菜单选项
@@ -463,7 +498,7 @@ void Game::renderStartMenuOption(const std::string &text, float xPercent, float
     int x = static_cast<int>(mScreenWidth * xPercent);
     int y = static_cast<int>(mScreenHeight * yPercent);
 
-    SDL_Color color = (isSelected) ? highlightColor : textColor; //  已选选项为黄色，未选选项为白色
+    RenderColor color = (isSelected) ? highlightColor : textColor; //  已选选项为黄色，未选选项为白色
 
     if (isCurrent)
     { //  当前选中的选项，添加箭头
@@ -485,8 +520,8 @@ bool Game::renderRestartMenu()
     int selectedIndex = 0;
 
     // 颜色定义
-    SDL_Color textColor = {255, 255, 255, 255};    // 白色
-    SDL_Color highlightColor = {255, 255, 0, 255}; // 黄色
+    RenderColor textColor = {255, 255, 255, 255};    // 白色
+    RenderColor highlightColor = {255, 255, 0, 255}; // 黄色
 
     // 处理玩家输入
     SDL_Event e;
@@ -524,9 +559,8 @@ bool Game::renderRestartMenu()
         }
 
         // 渲染游戏结束界面
-        SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xCC);
-        SDL_Rect overlayRect = {0, 0, mScreenWidth, mScreenHeight};
-        SDL_RenderFillRect(renderer, &overlayRect);
+        mPtrRenderBackend->setColor({0x00, 0x00, 0x00, 0xCC});
+        mPtrRenderBackend->fillRect({0, 0, mScreenWidth, mScreenHeight});
 
         // 使用百分比计算文本位置
         int centerX = mScreenWidth / 2;
@@ -537,18 +571,26 @@ bool Game::renderRestartMenu()
         renderText("Game Over", centerX - getTextWidth("Game Over") / 2, centerY - 0.1 * mScreenHeight, textColor);
 
         // 渲染最终得分
-        std::string scoreText = "Your Final Score: " + std::to_string(mPoints);
+        std::string scoreText = "Your Final Score: " + std::to_string(mPtrSimulation->getPoints());
         renderText(scoreText, centerX - getTextWidth(scoreText) / 2, centerY, textColor);
 
         // 渲染菜单选项
         for (size_t i = 0; i < menuItems.size(); ++i)
         {
-            SDL_Color currentColor = (i == selectedIndex) ? highlightColor : textColor;
+            RenderColor currentColor = (i == selectedIndex) ? highlightColor : textColor;
             renderText(menuItems[i], centerX - getTextWidth(menuItems[i]) / 2, centerY + 0.1 * mScreenHeight + i * ySpacing, currentColor);
         }
 
         // 更新屏幕以显示菜单
-        SDL_RenderPresent(renderer);
+        mPtrRenderBackend->present();
+
+        // 长时间运行：画出一帧菜单之后自动选择，达到局数时退出
+        if (mPtrSoakMonitor)
+        {
+            bool restart = mSoakGames == 0 || mPtrSoakMonitor->getGames() < mSoakGames;
+            isRunning = restart;
+            return restart;
+        }
 
         SDL_Delay(10); // 防止 CPU 占用过高
     }
@@ -556,262 +598,26 @@ bool Game::renderRestartMenu()
     return false;
 }
 
-// 渲染得分
-void Game::renderPoints() const
-{
-    SDL_Color textColor = {255, 255, 255, 255};
-    std::string pointsText = "Points: " + std::to_string(mPoints);
-
-    // 使用百分比计算文本位置
-    int x = mGameBoardWidth + 0.05 * mScreenWidth; // 距离游戏区域右侧 5% 的位置
-    int y = 0.3 * mScreenHeight;                   // 距离屏幕顶部 15% 的位置
-
-    renderText(pointsText, x, y, textColor);
-}
-
-// 渲染难度
-void Game::renderDifficulty() const
-{
-    SDL_Color textColor = {255, 255, 255, 255};
-    std::string difficultyText = "Difficulty: " + std::to_string(mDifficulty);
-
-    // 使用百分比计算文本位置
-    int x = mGameBoardWidth + 0.05 * mScreenWidth; // 距离游戏区域右侧 5% 的位置
-    int y = 0.35 * mScreenHeight;                  // 距离屏幕顶部 10% 的位置
-
-    renderText(difficultyText, x, y, textColor);
-}
 // 初始化游戏
 void Game::initializeGame()
 {
-    // // 清空障碍物列表
-    obstacles.clear();
-
-    // 分配内存创建新的蛇对象
-    this->mPtrSnake.reset(new Snake(this->mGameBoardWidth, this->mGameBoardHeight, this->mInitialSnakeLength, this->gameMode));
-    this->mPtrSnake->initializeSnake(); // 初始化蛇
-
-    // 根据难度设置蛇的初始速度
-    switch (difficulty)
+    // 按照菜单中的设置开始新的一局，使用当前时间作为随机数种子
+    mPtrSimulation->reset(gameMode, difficulty, mapType, static_cast<uint64_t>(std::time(nullptr)));
+    if (mSpeedOverride > 0.0f)
     {
-    case Difficulty::Easy:
-        mPtrSnake->setSpeed(15.0f);
-        break;
-    case Difficulty::Hard:
-        mPtrSnake->setSpeed(30.0f);
-        break;
+        mPtrSimulation->setBaseSpeed(mSpeedOverride);
     }
-    // 根据地图类型设置障碍物
-
-    switch (mapType)
-    {
-    case MapType::Empty:
-        // obstacles.clear();
-        break;
-    case MapType::Obstacles:
-        //  添加障碍物
-        for (int i = 0; i < 5; i++)
-        {
-            obstacles.push_back(SnakeBody(5, i));
-        }
-        obstacles.push_back(SnakeBody(10, 15));
-        // ... 添加更多障碍物
-        break;
-    }
-    // 初始化游戏得分
-    this->mPoints = 0;
-    // 在随机位置生成食物
-    this->createRamdomFood();
-    // 让蛇感知到食物
-    this->mPtrSnake->senseFood(this->mFood);
     // 其他初始化操作
     this->mDelay = this->mBaseDelay;
-    this->renderDifficulty(); // 渲染难度
-    this->renderPoints();     // 渲染得分
-    this->renderFood();       // 渲染食物
-    renderObstacles();
-}
-
-// 创建随机食物
-void Game::createRamdomFood()
-{
-    int foodX, foodY;
-    do
-    {
-        foodX = rand() % (mGameBoardWidth / GRID_SIZE - 2) + 1;
-        foodY = rand() % (mGameBoardHeight / GRID_SIZE - 2) + 1;
-    } while (mPtrSnake->isPartOfSnake(foodX, foodY));
-
-    mFood = SnakeBody(foodX, foodY);
-
-    // 随机选择食物类型
-    int foodType = rand() % 4; //  生成 0 到 3 之间的随机数
-    switch (foodType)
-    {
-    case 0:
-        mFood.setFoodType(FoodType::Normal);
-        break;
-    case 1:
-        mFood.setFoodType(FoodType::SpeedUp);
-        break;
-    case 2:
-        mFood.setFoodType(FoodType::SlowDown);
-        break;
-    case 3:
-        mFood.setFoodType(FoodType::DoublePoints);
-        break;
-    }
-}
-void Game::renderObstacles() const
-{
-    SDL_SetRenderDrawColor(renderer, 0x80, 0x80, 0x80, 0xFF); // 设置障碍物颜色 (灰色)
-    for (const auto &obstacle : obstacles)
-    {
-        SDL_Rect obstacleRect = {
-            obstacle.getX() * GRID_SIZE,
-            obstacle.getY() * GRID_SIZE,
-            GRID_SIZE,
-            GRID_SIZE};
-        SDL_RenderFillRect(renderer, &obstacleRect);
-    }
-}
-// 渲染食物
-void Game::renderFood() const
-{
-    SDL_Rect foodRect = {
-        mFood.getX() * GRID_SIZE,
-        mFood.getY() * GRID_SIZE,
-        GRID_SIZE,
-        GRID_SIZE};
-
-    // 根据食物类型设置颜色
-    switch (mFood.getFoodType())
-    {
-    case FoodType::Normal:
-        SDL_SetRenderDrawColor(renderer, 0xFF, 0x00, 0x00, 0xFF); //  红色
-        break;
-    case FoodType::SpeedUp:
-        SDL_SetRenderDrawColor(renderer, 135, 206, 235, 255); // 天蓝色
-        break;
-    case FoodType::SlowDown:
-        SDL_SetRenderDrawColor(renderer, 221, 160, 221, 255); // 亮紫色
-        break;
-    case FoodType::DoublePoints:
-        SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0x00, 0xFF); //  黄色
-        break;
-    }
-
-    SDL_RenderFillRect(renderer, &foodRect);
-}
-// 渲染蛇
-void Game::renderSnake() const
-{
-    // 获取蛇身信息
-    const std::vector<SnakeBody> &snake = mPtrSnake->getSnake();
-
-    // 使用常量 GRID_SIZE 渲染蛇身
-    SDL_SetRenderDrawColor(renderer, 0x00, 0xFF, 0x00, 0xFF); // 绿色
-    for (const auto &snakePart : snake)
-    {
-        SDL_Rect snakePartRect = {
-            snakePart.getX() * GRID_SIZE,
-            snakePart.getY() * GRID_SIZE,
-            GRID_SIZE,
-            GRID_SIZE};
-        SDL_RenderFillRect(renderer, &snakePartRect);
-    }
-}
-
-void Game::addDirectionToQueue(Direction newDirection)
-{
-    if (mDirectionQueue.size() < MAX_QUEUE_SIZE && isValidDirection(newDirection))
-    {
-        mDirectionQueue.push(newDirection);
-    }
 }
 
-bool Game::isValidDirection(Direction newDirection)
-{
-    if (mDirectionQueue.empty())
-    {
-        return newDirection != getOppositeDirection(mCurrentDirection);
-    }
-    return newDirection != getOppositeDirection(mDirectionQueue.back());
-}
-
-Direction Game::getOppositeDirection(Direction dir)
-{
-    switch (dir)
-    {
-    case Direction::Up:
-        return Direction::Down;
-    case Direction::Down:
-        return Direction::Up;
-    case Direction::Left:
-        return Direction::Right;
-    case Direction::Right:
-        return Direction::Left;
-    default:
-        return Direction::None;
-    }
-}
-
-void Game::togglePause()
-{
-    if (mPtrSnake->getDirection() == Direction::None)
-    {
-        mPtrSnake->changeDirection(mCurrentDirection);
-    }
-    else
-    {
-        mCurrentDirection = mPtrSnake->getDirection();
-        mPtrSnake->changeDirection(Direction::None);
-    }
-}
-
-void Game::updateSnakeDirection()
-{
-    if (!mDirectionQueue.empty())
-    {
-        Direction newDirection = mDirectionQueue.front();
-        mDirectionQueue.pop();
-
-        if (isValidDirection(newDirection))
-        {
-            mPtrSnake->changeDirection(newDirection);
-            mCurrentDirection = newDirection;
-        }
-    }
-}
-// 调整游戏延时
-void Game::adjustDelay()
-{
-    mDifficulty = mPoints / 5;
-    if (mPoints % 5 == 0)
-    {
-        mPtrSnake->setSpeed(mPtrSnake->getSpeed() + 0.5f); //  每增加 5 分，蛇的速度增加 0.5
-    }
-}
-
-// 运行游戏逻辑
-
 void Game::runGame()
 {
     // 初始化计时器
     using clock = std::chrono::steady_clock;
-    auto lastFrameTime = clock::now();
-    auto lastLogicUpdateTime = lastFrameTime;
-
-    // 创建静态元素的纹理
-    SDL_Texture *staticElementsTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, mScreenWidth, mScreenHeight);
-
-    // 渲染静态元素到纹理
-    SDL_SetRenderTarget(renderer, staticElementsTexture);
-    renderGameBoard();
-    renderInformationBoard();
-    renderInstructionBoard();
-    renderLeaderBoard();
-    SDL_SetRenderTarget(renderer, nullptr);
+
+    // 渲染静态元素到静态层
+    mPtrBoardRenderer->renderStaticLayer(mLeaderBoard.getScores());
     // Start playing background music
     if (Mix_PlayMusic(mBackgroundMusic, -1) == -1)
     {
@@ -819,159 +625,190 @@ void Game::runGame()
     }
     // 显示开始菜单
     isStartMenu = true;
+    mHasSavedGame = std::ifstream(mSaveFilePath, std::ios::binary).good();
     renderStartMenu();
-    // 游戏主循环
+    // 长时间运行：不等待菜单，按局数轮流使用两种模式、两种难度和两种地图
+    if (mPtrSoakMonitor)
+    {
+        uint64_t games = mPtrSoakMonitor->getGames();
+        gameMode = (games & 1) ? GameMode::Unbounded : GameMode::Bounded;
+        difficulty = (games & 2) ? Difficulty::Hard : Difficulty::Easy;
+        mapType = (games & 4) ? MapType::Obstacles : MapType::Empty;
+        isStartMenu = false;
+        initializeGame();
+    }
+    // 游戏主循环 (渲染线程)：游戏逻辑在模拟线程中按自己的逻辑帧率推进，这里只处理输入、事件和绘制
+    clock::time_point lastFrameTime;
+    mFrameIntervals.clear();
+    mFrameWork.clear();
     while (isRunning)
     {
-        // 1. 计算帧时间
+        // 1. 记录帧开始时间
         auto currentFrameTime = clock::now();
-        float deltaTime = std::chrono::duration<float>(currentFrameTime - lastFrameTime).count();
-        lastFrameTime = currentFrameTime;
 
-        // 2. 处理键盘输入
+        // 2. 处理键盘输入 (方向和暂停发送给模拟线程)
         handleEvents();
+        // 退出时模拟线程已经停止并保存了进度，不能再启动它 (会继续推进，覆盖或删除刚才的存档)
+        if (!isRunning)
+        {
+            break;
+        }
         // 3. 如果在开始菜单界面，则不进行游戏逻辑更新和渲染
         if (isStartMenu)
         {
             continue; //  直接进入下一轮循环
         }
-        // 4. 更新游戏逻辑 (每秒 20 次)
-        if (std::chrono::duration<float>(currentFrameTime - lastLogicUpdateTime).count() >= 0.05f)
+        // 4. 离开开始菜单时 (新游戏或者恢复存档) 启动模拟线程
+        if (!mPtrSimulationThread->isRunning())
         {
-            lastLogicUpdateTime = currentFrameTime;
-            updateSnakeDirection(); // Add this line to update the snake's direction
-            mPtrSnake->update(deltaTime);
-
-            // 检查是否需要移动蛇
-            if (mPtrSnake->getAccumulatedTime() >= 1.0f / mPtrSnake->getSpeed())
+            mPtrSimulationThread->start();
+        }
+        AppliedInput applied;
+        while (mPtrSimulationThread->takeAppliedInput(applied))
+        {
+            if (mLatencyReport && applied.timestamp > 0)
             {
-                mPtrSnake->resetAccumulatedTime(); // 重置累积时间
-                                                   // 检查蛇是否处于暂停状态
-                if (mPtrSnake->getDirection() != Direction::None)
-                {
-                    // 移动蛇
-                    bool moveSuccess = mPtrSnake->moveFoward();
-
-                    // 检查蛇是否吃到了食物
-                    if (moveSuccess)
-                    {
-                        switch (mFood.getFoodType())
-                        {
-                        case FoodType::Normal:
-                            mPoints++;
-                            break;
-                        case FoodType::SpeedUp:
-                        {
-                            float originalSpeed = mPtrSnake->getSpeed();
-                            mPtrSnake->setSpeed(originalSpeed + 5.0f); //  增加速度 5.0f
-                            speedUpTimer = 10.0f;                      //  设置加速持续时间为 10 秒
-                            speedUpOriginalSpeed = originalSpeed;      //  保存原始速度
-                            break;
-                        }
-                        case FoodType::SlowDown:
-                        {
-                            float originalSpeed = mPtrSnake->getSpeed();
-                            mPtrSnake->setSpeed(originalSpeed * 0.8f); //  降低速度为原来的 0.8 倍
-                            slowDownTimer = 10.0f;                     //  设置减速持续时间为 10 秒
-                            slowDownOriginalSpeed = originalSpeed;     //  保存原始速度
-                            break;
-                        }
-                        case FoodType::DoublePoints:
-                            doublePointsTimer = 10.0f; //  设置得分翻倍持续时间为 10 秒
-                            break;
-                        }
-
-                        //  如果得分翻倍，则获得 2 分
-                        if (doublePointsTimer > 0.0f)
-                        {
-                            mPoints += 2;
-                        }
-                        else
-                        {
-                            mPoints++;
-                        }
-
-                        adjustDelay();
-                        createRamdomFood();
-                        // 蛇感知食物
-                        this->mPtrSnake->senseFood(this->mFood);
-                    }
-
-                    // 检查蛇是否撞到障碍物
-                    if (mPtrSnake->checkCollision())
-                    {
-                        isRunning = false;
-                        break; // 游戏结束
-                    }
-                    // 检查与障碍物的碰撞
-                    for (const auto &obstacle : obstacles)
-                    {
-                        if (mPtrSnake->getSnakebody()[0] == obstacle)
-                        {
-                            isRunning = false;
-                            break; // 游戏结束
-                        }
-                    }
-                }
+                mMoveLatencies.push_back((static_cast<double>(applied.appliedTime) - applied.timestamp) / 1000.0);
+                mPendingPresents.push_back(applied);
             }
         }
 
-        // 5. 渲染游戏画面
-        SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF); // 设置背景颜色 (黑色)
-        SDL_RenderClear(renderer);                                // 清空渲染器
-
-        // 渲染静态元素
-        SDL_RenderCopy(renderer, staticElementsTexture, nullptr, nullptr);
-
-        // 只渲染动态元素
-        renderObstacles();
-        renderSnake();
-        renderFood();
-        renderPoints();
-        renderDifficulty();
+        // 处理游戏事件 (音效)
+        handleGameEvents();
+        // 一局是否结束以模拟线程的状态为准：事件队列满时会丢弃事件，GameOver 事件可能丢失
+        if (mPtrSimulationThread->isFinished())
+        {
+            finishGame();
+            isRunning = false;
+            break; // 游戏结束
+        }
 
-        // 6. 更新屏幕
-        SDL_RenderPresent(renderer);
+        // 模拟线程每秒复制一次存档，在这里写入文件
+        if (mPtrSimulationThread->takeSaveSnapshot(mSaveBuffer))
+        {
+            writeSaveFile(mSaveBuffer);
+        }
 
-        // 7. 控制游戏速度 (目标帧率 30 FPS)
-        float targetFrameTime = 1.0f / 30.0f;
-        float sleepTime = targetFrameTime - deltaTime;
-        if (sleepTime > 0)
+        // 5. 渲染最新发布的快照 (静态层和动态元素) 并更新屏幕
+        // 快照复制之后又过去了一段时间，把移动进度推算到现在，蛇在两次移动之间连续前进
+        const BoardSnapshot &snapshot = mPtrSimulationThread->acquireSnapshot();
+        float moveProgress = snapshot.moveProgress;
+        if (moveProgress < 1.0f && snapshot.moveInterval > 0.0f)
         {
-            SDL_Delay(static_cast<Uint32>(sleepTime * 1000.0f));
+            float elapsed = (SimulationThread::now() - snapshot.time) / 1e6f;
+            moveProgress = std::min(1.0f, moveProgress + elapsed / snapshot.moveInterval);
         }
-        // 更新加速计时器
-        if (speedUpTimer > 0.0f)
+        mPtrBoardRenderer->renderFrame(snapshot, moveProgress);
+        if (mSlowRenderMs > 0)
         {
-            speedUpTimer -= deltaTime;
-            if (speedUpTimer <= 0.0f)
+            SDL_Delay(static_cast<Uint32>(mSlowRenderMs));
+        }
+        // 画面包含了移动的逻辑帧之后，输入才算显示出来
+        size_t kept = 0;
+        for (const AppliedInput &pending : mPendingPresents)
+        {
+            if (pending.tick <= snapshot.tick)
             {
-                // 加速效果结束，恢复原始速度
-                mPtrSnake->setSpeed(speedUpOriginalSpeed);
+                mPresentLatencies.push_back((SDL_GetTicks() * 1000.0 - pending.timestamp) / 1000.0);
             }
+            else
+            {
+                mPendingPresents[kept++] = pending;
+            }
+        }
+        mPendingPresents.resize(kept);
+        double frameWork = std::chrono::duration<double, std::milli>(clock::now() - currentFrameTime).count();
+        if (mPtrSoakMonitor)
+        {
+            recordSoakFrame(frameWork);
         }
+        if (mFrameReport && mFrameWork.size() < MAX_FRAME_SAMPLES)
+        {
+            mFrameWork.push_back(frameWork);
+            if (lastFrameTime != clock::time_point())
+            {
+                mFrameIntervals.push_back(
+                    std::chrono::duration<double, std::milli>(currentFrameTime - lastFrameTime).count());
+            }
+        }
+        lastFrameTime = currentFrameTime;
 
-        // 更新减速计时器
-        if (slowDownTimer > 0.0f)
+        // 6. 控制帧率 (目标为显示器的刷新率)，只减去本帧的处理时间，绘制变慢只会降低帧率，不影响逻辑帧
+        // SDL_Delay 的精度是毫秒，先等到目标时刻之前 1 毫秒，剩下的时间让出 CPU
+        if (mTargetFps > 0)
         {
-            slowDownTimer -= deltaTime;
-            if (slowDownTimer <= 0.0f)
+            auto frameEnd = currentFrameTime + std::chrono::microseconds(1000000 / mTargetFps);
+            auto sleepMs = std::chrono::duration_cast<std::chrono::milliseconds>(frameEnd - clock::now()).count();
+            if (sleepMs > 1)
             {
-                // 减速效果结束，恢复原始速度
-                mPtrSnake->setSpeed(slowDownOriginalSpeed);
+                SDL_Delay(static_cast<Uint32>(sleepMs - 1));
+            }
+            while (clock::now() < frameEnd)
+            {
+                std::this_thread::yield();
             }
         }
+    }
+    mPtrSimulationThread->stop();
 
-        // 更新得分翻倍计时器
-        if (doublePointsTimer > 0.0f)
+    if (mLatencyReport)
+    {
+        reportInputLatency();
+        reportTickIntervals();
+    }
+    if (mFrameReport)
+    {
+        reportFrameTimes();
+    }
+}
+// 处理模拟发布的游戏事件：事件只用于音效，一局是否结束由 runGame 根据模拟线程的状态判断
+void Game::handleGameEvents()
+{
+    GameEvent event;
+    while (mGameEvents->pop(event))
+    {
+        if (mPtrSoundEffects)
         {
-            doublePointsTimer -= deltaTime;
+            switch (event.type)
+            {
+            case GameEventType::FoodEaten:
+                // 特殊食物的音效由 EffectStarted 播放
+                if (event.foodType == FoodType::Normal)
+                {
+                    mPtrSoundEffects->play(SoundEffect::Eat);
+                }
+                break;
+            case GameEventType::EffectStarted:
+                mPtrSoundEffects->play(SoundEffect::PowerUp);
+                break;
+            case GameEventType::FoodExpired:
+                mPtrSoundEffects->play(SoundEffect::Expire);
+                break;
+            case GameEventType::GameOver:
+                mPtrSoundEffects->play(SoundEffect::Death);
+                break;
+            default:
+                break;
+            }
         }
     }
+}
 
-    // 清理资源
-    SDL_DestroyTexture(staticElementsTexture);
+// 一局结束
+void Game::finishGame()
+{
+    // 模拟线程在游戏结束后不再推进，停止之后才能读取得分；停止之前发布的事件 (例如结束的音效) 也处理掉
+    mPtrSimulationThread->stop();
+    handleGameEvents();
+    // 把得分合并到排行榜文件 (其他进程同时提交的得分不会丢失)，存档失效
+    updateLeaderBoard();
+    removeSavedGame();
+    if (mPtrSoakMonitor)
+    {
+        mPtrSoakMonitor->recordGame();
+    }
 }
+
 // 开始游戏
 void Game::startGame()
 {
@@ -980,88 +817,203 @@ void Game::startGame()
         // 加载排行榜
         readLeaderBoard();
 
-        // 运行游戏
+        // 运行游戏 (游戏结束时在 finishGame 中把得分合并到排行榜文件)
         runGame();
 
-        // 更新排行榜
-        updateLeaderBoard();
-
-        // 保存排行榜
-        writeLeaderBoard();
-
         // 显示重新开始菜单
         if (!renderRestartMenu())
         {
             break; // 退出游戏
         }
     }
+    if (mPtrSoakMonitor)
+    {
+        reportSoak();
+    }
+}
+
+int Game::getExitCode() const
+{
+    return mSoakHealthy ? 0 : 1;
 }
 
 // 从文件加载排行榜信息
 bool Game::readLeaderBoard()
 {
-    std::fstream fhand(mRecordBoardFilePath, fhand.binary | fhand.in);
+    return mLeaderBoard.read();
+}
+
+// 更新排行榜信息：在文件锁内读取最新的排行榜、插入得分并写回
+bool Game::updateLeaderBoard()
+{
+    return mLeaderBoard.submit(this->mPtrSimulation->getPoints());
+}
+
+// 将排行榜信息写入文件
+bool Game::writeLeaderBoard()
+{
+    return mLeaderBoard.write();
+}
+
+// 把当前游戏保存到存档文件
+bool Game::saveGame()
+{
+    std::vector<uint8_t> snapshot;
+    mPtrSimulation->saveSnapshot(snapshot);
+    return writeSaveFile(snapshot);
+}
+
+// 写入存档文件
+bool Game::writeSaveFile(const std::vector<uint8_t> &snapshot)
+{
+    // 先写入临时文件再重命名，避免写到一半时崩溃留下损坏的存档
+    std::string tempPath = mSaveFilePath + ".tmp";
+    std::fstream fhand(tempPath, fhand.binary | fhand.trunc | fhand.out);
     if (!fhand.is_open())
     {
         return false;
     }
+    fhand.write(reinterpret_cast<const char *>(snapshot.data()), snapshot.size());
+    fhand.close();
+    if (!fhand)
+    {
+        return false;
+    }
+    return std::rename(tempPath.c_str(), mSaveFilePath.c_str()) == 0;
+}
 
-    int temp;
-    int i = 0;
-    while (!fhand.eof() && i < mNumLeaders)
+// 从存档文件恢复游戏
+bool Game::loadGame()
+{
+    std::fstream fhand(mSaveFilePath, fhand.binary | fhand.in);
+    if (!fhand.is_open())
     {
-        fhand.read(reinterpret_cast<char *>(&temp), sizeof(temp));
-        mLeaderBoard[i] = temp;
-        i++;
+        return false;
     }
+    std::vector<uint8_t> snapshot((std::istreambuf_iterator<char>(fhand)), std::istreambuf_iterator<char>());
     fhand.close();
+    if (!mPtrSimulation->loadSnapshot(snapshot.data(), snapshot.size()) || mPtrSimulation->isGameOver())
+    {
+        return false;
+    }
+    this->mDelay = this->mBaseDelay;
     return true;
 }
 
-// 更新排行榜信息
-bool Game::updateLeaderBoard()
+// 删除存档文件
+void Game::removeSavedGame()
 {
-    // 初始化更新标志为false
-    bool updated = false;
-    // 获取玩家当前得分
-    int newScore = this->mPoints;
-    // 遍历排行榜数据
-    for (int i = 0; i < this->mNumLeaders; i++)
+    std::remove(mSaveFilePath.c_str());
+    mHasSavedGame = false;
+}
+
+// 打印输入延迟的分位数
+void Game::reportInputLatency() const
+{
+    const std::vector<double> *samples[] = {&mMoveLatencies, &mPresentLatencies};
+    const char *names[] = {"按键到移动", "按键到画面"};
+    for (int i = 0; i < 2; i++)
     {
-        // 如果当前排行榜数据大于或等于玩家得分，则跳过
-        if (this->mLeaderBoard[i] >= this->mPoints)
+        std::vector<double> sorted = *samples[i];
+        if (sorted.empty())
         {
             continue;
         }
-        // 将玩家得分插入到排行榜中，并将原有数据向下移动
-        int oldScore = this->mLeaderBoard[i];
-        this->mLeaderBoard[i] = newScore;
-        newScore = oldScore;
-        // 设置更新标志为true
-        updated = true;
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&sorted](double p) {
+            return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+        };
+        std::cout << names[i] << "延迟 (ms): 样本 " << sorted.size() << ", p50 " << percentile(0.5)
+                  << ", p90 " << percentile(0.9) << ", p99 " << percentile(0.99)
+                  << ", 最大 " << sorted.back() << std::endl;
     }
-    // 返回更新标志
-    return updated;
 }
 
-// 将排行榜信息写入文件
-bool Game::writeLeaderBoard()
+// 打印逻辑帧间隔的分位数
+void Game::reportTickIntervals() const
 {
-    // 以二进制写模式打开排行榜文件，并清空文件内容
-    std::fstream fhand(this->mRecordBoardFilePath, fhand.binary | fhand.trunc | fhand.out);
-    // 如果打开文件失败，则返回false
-    if (!fhand.is_open())
+    std::vector<double> sorted = mPtrSimulationThread->getTickIntervals();
+    if (sorted.empty())
     {
-        return false;
+        return;
     }
-    // 将排行榜数据写入文件
-    for (int i = 0; i < this->mNumLeaders; i++)
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double p) {
+        return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+    };
+    std::cout << "逻辑帧间隔 (ms，目标 " << 1000.0 / mPtrSimulationThread->getTickRate() << "): 样本 " << sorted.size()
+              << ", p50 " << percentile(0.5) << ", p99 " << percentile(0.99) << ", 最大 " << sorted.back()
+              << ", 重新计时 " << mPtrSimulationThread->getResyncs() << " 次" << std::endl;
+}
+
+// 打印帧间隔和每帧处理时间的分位数
+void Game::reportFrameTimes() const
+{
+    if (mFrameIntervals.empty())
     {
-        fhand.write(reinterpret_cast<char *>(&this->mLeaderBoard[i]), sizeof(this->mLeaderBoard[i]));
-        ;
+        return;
     }
-    // 关闭文件
-    fhand.close();
-    // 返回true表示写入成功
-    return true;
-}
\ No newline at end of file
+    auto report = [](const char *name, std::vector<double> sorted) {
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&sorted](double p) {
+            return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+        };
+        std::cout << name << ": 样本 " << sorted.size() << ", p50 " << percentile(0.5) << ", p99 " << percentile(0.99)
+                  << ", 最大 " << sorted.back() << std::endl;
+    };
+    double total = 0.0;
+    for (double interval : mFrameIntervals)
+    {
+        total += interval;
+    }
+    std::cout << "帧率: 目标 " << mTargetFps << " FPS, 平均 " << 1000.0 * mFrameIntervals.size() / total << " FPS"
+              << std::endl;
+    report("帧间隔 (ms)", mFrameIntervals);
+    report("每帧处理时间 (ms)", mFrameWork);
+}
+
+// 打印音效触发延迟的分位数和混音的 CPU 开销
+void Game::reportAudioLatency() const
+{
+    const SoundMixer *mixer = mPtrSoundEffects->getMixer();
+    std::vector<double> sorted = mixer->getLatencies();
+    double bufferMs = 1000.0 * mAudioBufferFrames / mixer->getSampleRate();
+    std::cout << "音效: 缓冲区 " << mAudioBufferFrames << " 帧 (" << bufferMs << " ms), 触发 " << mixer->getTriggered()
+              << ", 丢弃 " << mixer->getDropped() << ", 混音每次回调 " << mixer->getMixNanoseconds() / 1000.0
+              << " us, CPU " << mixer->getCpuLoad() * 100.0 << "%" << std::endl;
+    if (sorted.empty())
+    {
+        return;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double p) {
+        return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+    };
+    std::cout << "触发到音频回调延迟 (ms): 样本 " << sorted.size() << ", p50 " << percentile(0.5)
+              << ", p90 " << percentile(0.9) << ", p99 " << percentile(0.99)
+              << ", 最大 " << sorted.back() << std::endl;
+}
+
+// 长时间运行：贪心机器人选择方向 (在模拟线程中调用，mSoakBot 没有状态)
+Direction Game::soakAutopilot(const Simulation &simulation, void *context)
+{
+    return static_cast<Game *>(context)->mSoakBot.choose(simulation);
+}
+
+// 长时间运行：帧耗时只包括处理输入、事件和绘制，不包括控制帧率的等待
+void Game::recordSoakFrame(double milliseconds)
+{
+    mPtrSoakMonitor->recordFrame(milliseconds);
+    double seconds = (SimulationThread::now() - mSoakStart) / 1e6;
+    mPtrSoakMonitor->poll(seconds, mPtrRenderBackend->getLiveTextures());
+}
+
+// 长时间运行：最后采样一次，打印每小时的趋势和判断结果
+void Game::reportSoak()
+{
+    double seconds = (SimulationThread::now() - mSoakStart) / 1e6;
+    mPtrSoakMonitor->sample(seconds, mPtrRenderBackend->getLiveTextures(), SoakMonitor::readResidentBytes(),
+                            SoakMonitor::countOpenFiles());
+    std::cout << "长时间运行: " << mPtrSoakMonitor->getGames() << " 局, " << seconds / 3600.0 << " 小时" << std::endl;
+    mSoakHealthy = mPtrSoakMonitor->report(std::cout);
+}
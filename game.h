@@ -8,6 +8,17 @@
 #include <memory>
 
 #include "snake.h"
+#include "simulation.h"
+#include "simulation_thread.h"
+#include "event_bus.h"
+#include "render_backend.h"
+#include "sdl_render_backend.h"
+#include "board_renderer.h"
+#include "frame_capture.h"
+#include "sdl_sound_effects.h"
+#include "leader_board.h"
+#include "greedy_bot.h"
+#include "soak_monitor.h"
 #include "constants.h"
 #include <SDL2/SDL_ttf.h> // 包含 SDL_ttf 头文件
 #include <SDL2/SDL_mixer.h>
@@ -41,18 +52,22 @@ public:
   void updateLeadBoard();
   // 从文件加载排行榜信息
   bool readLeaderBoard();
-  // 更新排行榜信息
+  // 把得分合并到排行榜文件 (多个进程可以共用同一个排行榜)
   bool updateLeaderBoard();
   // 将排行榜信息写入文件
   bool writeLeaderBoard();
+  // 把当前游戏保存到存档文件 (退出时和游戏过程中定期保存)
+  bool saveGame();
+  // 从存档文件恢复游戏
+  bool loadGame();
+  // 删除存档文件
+  void removeSavedGame();
 
   // 初始化游戏
   void initializeGame();
   // 运行游戏逻辑
   void runGame();
 
-  // 创建随机食物
-  void createRamdomFood();
   void handleStartMenuEvents(const SDL_Event &e);
   void renderStartMenuOption(const std::string &text, float xPercent, float yPercent, bool isSelected, bool isCurrent);
   //  获取游戏模式字符串
@@ -67,37 +82,26 @@ public:
   void startGame();
   // 渲染游戏结束界面，并询问玩家是否重新开始游戏
   bool renderRestartMenu();
-  // 调整游戏延时
-  void adjustDelay();
+  // 进程的退出码：长时间运行发现资源持续增长或帧耗时变慢时为 1
+  int getExitCode() const;
 
 private:
   // 字体
   TTF_Font *font;
   // 音乐
   Mix_Music *mBackgroundMusic;
-  SDL_Texture *staticElementsTexture;
+  // 音效 (吃到食物、特殊效果、食物消失、游戏结束)
+  std::unique_ptr<SdlSoundEffects> mPtrSoundEffects;
+  // 音频缓冲区大小 (帧)，设置环境变量 SNAKE_AUDIO_BUFFER 时使用它的值
+  // 默认 256 帧 (44.1 kHz 下约 5.8 毫秒)，音效在触发后的下一次音频回调开始播放
+  int mAudioBufferFrames = 256;
 
   GameMode gameMode = GameMode::Bounded;    //  游戏模式，默认为有边界模式
   Difficulty difficulty = Difficulty::Easy; //  游戏难度，默认为简单模式
   MapType mapType = MapType::Empty;         //  地图类型，默认为无障碍地图
   bool isStartMenu = true;                  //  是否在开始菜单界面
   int selectedOption = 0;                   //  当前选中的选项
-  std::vector<SnakeBody> obstacles;         //  障碍物列表
-
-  std::queue<Direction> mDirectionQueue;
-  const int MAX_QUEUE_SIZE = 3; // Maximum number of buffered inputs
-  Direction mCurrentDirection;
-  void addDirectionToQueue(Direction newDirection);
-  bool isValidDirection(Direction newDirection);
-  Direction getOppositeDirection(Direction dir);
-  void togglePause();
-  void updateSnakeDirection();
 
-  float speedUpTimer = 0.0f;          // 加速计时器
-  float speedUpOriginalSpeed = 0.0f;  // 加速前的原始速度
-  float slowDownTimer = 0.0f;         // 减速计时器
-  float slowDownOriginalSpeed = 0.0f; // 减速前的原始速度
-  float doublePointsTimer = 0.0f;     // 得分翻倍计时器
   // 屏幕宽度和高度
   int mScreenWidth;
   int mScreenHeight;
@@ -113,24 +117,66 @@ private:
   SDL_Renderer *renderer = nullptr;
   // 蛇的初始长度
   const int mInitialSnakeLength = 2;
-  // 蛇对象指针
-  std::unique_ptr<Snake> mPtrSnake;
-  // 食物信息
-  SnakeBody mFood;
-  // 玩家得分
-  int mPoints = 0;
-  // 游戏难度
-  int mDifficulty = 0;
+  // 游戏模拟对象指针 (蛇、食物、障碍物、得分和特殊效果)
+  std::unique_ptr<Simulation> mPtrSimulation;
+  // 模拟线程：游戏进行中由它独占 mPtrSimulation，主线程只绘制它发布的快照
+  // 游戏结束或退出时先停止，之后主线程才能访问 mPtrSimulation (排行榜和存档)
+  std::unique_ptr<SimulationThread> mPtrSimulationThread;
+  // 每秒的逻辑帧数
+  const int mTickRate = 120;
+  // 人为地让每帧的绘制慢这么多毫秒 (设置环境变量 SNAKE_SLOW_RENDER_MS 时使用)，用于检查逻辑帧不受影响
+  int mSlowRenderMs = 0;
+  // 目标帧率：默认使用显示器的刷新率 (取不到时 60)，设置环境变量 SNAKE_FPS 时使用它，0 表示不限制
+  // 绘制与蛇的移动频率无关，蛇在两次移动之间按移动进度插值
+  int mTargetFps = 60;
+  // 蛇的基础速度 (格子/秒，设置环境变量 SNAKE_SPEED 时使用，0 表示按难度)，模拟每个逻辑帧按经过的时间移动多次
+  float mSpeedOverride = 0.0f;
+  // 帧耗时报告 (设置环境变量 SNAKE_FRAME_REPORT 时启用)，单位毫秒
+  // 相邻两帧开始时刻的间隔，以及每帧处理输入、事件和绘制的时间 (不含控制帧率的等待)
+  static const size_t MAX_FRAME_SAMPLES = 1 << 20;
+  bool mFrameReport = false;
+  std::vector<double> mFrameIntervals;
+  std::vector<double> mFrameWork;
+  // 定期存档用的缓冲区
+  std::vector<uint8_t> mSaveBuffer;
+  // 游戏事件总线，以及主循环自己的订阅
+  EventBus mEventBus;
+  EventBus::Subscription *mGameEvents = nullptr;
+  // 遥测日志 (设置环境变量 SNAKE_EVENT_LOG 时启用)
+  std::unique_ptr<EventLogger> mEventLogger;
+  // 输入延迟测量 (设置环境变量 SNAKE_LATENCY_REPORT 时启用)，单位毫秒
+  // 按键到蛇移动，以及按键到移动后的画面提交
+  bool mLatencyReport = false;
+  std::vector<double> mMoveLatencies;
+  std::vector<double> mPresentLatencies;
+  std::vector<AppliedInput> mPendingPresents;
+  // 长时间运行 (设置环境变量 SNAKE_SOAK 为局数时启用，0 表示一直运行到关闭窗口)：
+  // 跳过菜单，由贪心机器人在模拟线程中操作，游戏结束后自动重新开始 (轮流使用各种模式、难度和地图)，
+  // 每隔 SNAKE_SOAK_SAMPLE 秒 (默认 10) 采样内存、文件描述符、纹理和帧耗时，退出时打印每小时的趋势
+  std::unique_ptr<SoakMonitor> mPtrSoakMonitor;
+  uint64_t mSoakGames = 0;
+  uint64_t mSoakStart = 0; // 开始时间 (微秒)
+  GreedyBot mSoakBot;
+  bool mSoakHealthy = true;
+  // 渲染后端和游戏画面的绘制
+  std::unique_ptr<RenderBackend> mPtrRenderBackend;
+  std::unique_ptr<BoardRenderer> mPtrBoardRenderer;
+  // 录像 (设置环境变量 SNAKE_CAPTURE 为输出文件时启用)
+  std::unique_ptr<FrameCapture> mPtrFrameCapture;
   // 游戏延时的基本值
   int mBaseDelay = 100;
   // 游戏延时
   int mDelay;
   // 排行榜文件路径
   const std::string mRecordBoardFilePath = "record.dat";
-  // 排行榜数据
-  std::vector<int> mLeaderBoard;
   // 排行榜最大记录数量
   const int mNumLeaders = 3;
+  // 排行榜数据
+  LeaderBoard mLeaderBoard{mRecordBoardFilePath, mNumLeaders};
+  // 存档文件路径
+  const std::string mSaveFilePath = "save.dat";
+  // 是否存在可以恢复的存档
+  bool mHasSavedGame = false;
   bool isRunning = true;                   //  控制游戏循环的标志变量
   bool keyPressed = false;                 //  记录按键是否已经被按下的标志变量
   Direction lastDirection = Direction::Up; //  记录蛇暂停前的移动方向，默认为 Up
@@ -138,22 +184,33 @@ private:
   Game(const Game &) = delete;
   Game &operator=(const Game &) = delete;
 
-  // 渲染函数声明
-  void renderText(const std::string &text, int x, int y, SDL_Color color) const;
-  void renderCenteredText(const std::string &text, float xPercent, float yPercent, SDL_Color color) const;
+  // 渲染函数声明 (菜单文字，游戏画面由 BoardRenderer 绘制)
+  void renderText(const std::string &text, int x, int y, RenderColor color) const;
+  void renderCenteredText(const std::string &text, float xPercent, float yPercent, RenderColor color) const;
   int getTextWidth(const std::string &text) const;
-  void renderGameBoard() const;
-  void renderInformationBoard() const;
-  void renderInstructionBoard() const;
-  void renderLeaderBoard() const;
-  void renderFood() const;
-  void renderSnake() const;
-  void renderPoints() const;
-  void renderDifficulty() const;
-  void renderObstacles() const;
 
   // 处理 SDL 事件
   void handleEvents();
+  // 处理模拟发布的游戏事件 (播放音效)
+  void handleGameEvents();
+  // 一局结束：停止模拟线程，把得分合并到排行榜文件，删除存档
+  void finishGame();
+  // 写入存档文件
+  bool writeSaveFile(const std::vector<uint8_t> &snapshot);
+  // 打印输入延迟的分位数
+  void reportInputLatency() const;
+  // 打印逻辑帧间隔的分位数
+  void reportTickIntervals() const;
+  // 打印帧间隔和每帧处理时间的分位数
+  void reportFrameTimes() const;
+  // 打印音效触发延迟的分位数和混音的 CPU 开销
+  void reportAudioLatency() const;
+  // 长时间运行：模拟线程中的自动操作
+  static Direction soakAutopilot(const Simulation &simulation, void *context);
+  // 长时间运行：记录一帧的耗时并按间隔采样
+  void recordSoakFrame(double milliseconds);
+  // 长时间运行：最后采样一次并打印趋势
+  void reportSoak();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+#include "greedy_bot.h"
+
+// 选择下一次移动的方向
+Direction GreedyBot::choose(const Simulation &simulation) const
+{
+    const Snake &snake = simulation.getSnake();
+    Direction current = snake.getDirection();
+    if (current == Direction::None)
+    {
+        return current;
+    }
+    const Direction directions[4] = {Direction::Up, Direction::Down, Direction::Left, Direction::Right};
+    const Direction opposite[4] = {Direction::Down, Direction::Up, Direction::Right, Direction::Left};
+
+    Direction best = current;
+    int bestScore = INT_MAX;
+    for (int i = 0; i < 4; i++)
+    {
+        // 不能掉头
+        if (opposite[i] == current)
+        {
+            continue;
+        }
+        CellIndex next;
+        if (!nextCell(simulation, directions[i], next) || !isSafe(simulation, next))
+        {
+            continue;
+        }
+        int score = INT_MAX - 1;
+        for (const FoodItem &food : simulation.getFoods().getItems())
+        {
+            score = std::min(score, distance(simulation, next, food.cell));
+        }
+        // 距离相同时保持当前方向
+        if (score < bestScore || (score == bestScore && directions[i] == current))
+        {
+            best = directions[i];
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+// 蛇头沿 direction 移动一步后的格子
+bool GreedyBot::nextCell(const Simulation &simulation, Direction direction, CellIndex &cell) const
+{
+    const CellGrid &grid = simulation.getGrid();
+    cell = grid.neighbor(simulation.getSnake().getHead(), direction);
+    if (!grid.isInside(cell))
+    {
+        if (simulation.getGameMode() == GameMode::Bounded)
+        {
+            return false;
+        }
+        cell = grid.wrap(cell, direction);
+    }
+    return true;
+}
+
+// 下一步走到 cell 是否安全
+bool GreedyBot::isSafe(const Simulation &simulation, CellIndex cell) const
+{
+    const std::vector<CellIndex> &body = simulation.getSnake().getCells();
+    if (containsCell(body.data(), body.size() - 1, cell))
+    {
+        return false;
+    }
+    const std::vector<CellIndex> &obstacles = simulation.getObstacles();
+    return !containsCell(obstacles.data(), obstacles.size(), cell);
+}
+
+// 两个格子的曼哈顿距离
+int GreedyBot::distance(const Simulation &simulation, CellIndex a, CellIndex b) const
+{
+    const CellGrid &grid = simulation.getGrid();
+    int dx = std::abs(grid.getX(a) - grid.getX(b));
+    int dy = std::abs(grid.getY(a) - grid.getY(b));
+    if (simulation.getGameMode() == GameMode::Unbounded)
+    {
+        dx = std::min(dx, grid.getColumns() - dx);
+        dy = std::min(dy, grid.getRows() - dy);
+    }
+    return dx + dy;
+}
@@ -0,0 +1,23 @@
+#ifndef GREEDY_BOT_H
+#define GREEDY_BOT_H
+
+#include "simulation.h"
+
+// 简单的贪心机器人：在下一步不会撞到墙壁、自身或障碍物的方向中，选择离最近的食物最近的一个
+// 只看一步，不考虑之后会不会被困住；用于观战墙的自动对局和作为其他机器人的对比基准
+class GreedyBot
+{
+public:
+    // 在蛇每次移动之后调用，返回下一次移动的方向 (没有安全的方向时保持当前方向)
+    Direction choose(const Simulation &simulation) const;
+    // 蛇头沿 direction 移动一步后的格子 (无边界模式穿过边缘)，有边界模式下撞墙时返回 false
+    bool nextCell(const Simulation &simulation, Direction direction, CellIndex &cell) const;
+    // 下一步走到 cell 是否安全 (蛇尾这一步会离开，不算障碍)
+    bool isSafe(const Simulation &simulation, CellIndex cell) const;
+
+private:
+    // 两个格子的距离，无边界模式可以穿过边缘
+    int distance(const Simulation &simulation, CellIndex a, CellIndex b) const;
+};
+
+#endif
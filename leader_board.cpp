@@ -0,0 +1,193 @@
+#include <cerrno>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include "leader_board.h"
+
+// 构造函数
+LeaderBoard::LeaderBoard(const std::string &path, int numLeaders) : mFilePath(path), mScores(numLeaders, 0)
+{
+}
+
+// 析构函数，关闭锁文件
+LeaderBoard::~LeaderBoard()
+{
+    if (mLockFd >= 0)
+    {
+        close(mLockFd);
+    }
+}
+
+// 从文件加载排行榜信息
+bool LeaderBoard::read()
+{
+    return readFile(mScores);
+}
+
+// 读取文件：文件只会被重命名替换，不会被改写，打开之后读到的总是同一个完整的版本
+bool LeaderBoard::readFile(std::vector<int> &scores) const
+{
+    int fd = open(mFilePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+    std::vector<int> loaded(scores.size(), 0);
+    const size_t bytes = loaded.size() * sizeof(int);
+    size_t done = 0;
+    while (done < bytes)
+    {
+        ssize_t count = ::read(fd, reinterpret_cast<char *>(loaded.data()) + done, bytes - done);
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count <= 0)
+        {
+            break;
+        }
+        done += static_cast<size_t>(count);
+    }
+    close(fd);
+    // 只使用完整的记录
+    for (size_t i = 0; i < done / sizeof(int); i++)
+    {
+        scores[i] = loaded[i];
+    }
+    return true;
+}
+
+// 更新排行榜信息
+bool LeaderBoard::update(int newScore)
+{
+    // 初始化更新标志为false
+    bool updated = false;
+    // 遍历排行榜数据
+    for (size_t i = 0; i < mScores.size(); i++)
+    {
+        // 如果当前排行榜数据大于或等于玩家得分，则跳过
+        if (mScores[i] >= newScore)
+        {
+            continue;
+        }
+        // 将玩家得分插入到排行榜中，并将原有数据向下移动
+        int oldScore = mScores[i];
+        mScores[i] = newScore;
+        newScore = oldScore;
+        // 设置更新标志为true
+        updated = true;
+    }
+    // 返回更新标志
+    return updated;
+}
+
+// 合并新的得分：锁内读取最新的文件，其他进程在这期间提交的得分不会丢失
+bool LeaderBoard::submit(int newScore, bool *changed)
+{
+    if (changed != nullptr)
+    {
+        *changed = false;
+    }
+    if (!lock())
+    {
+        return false;
+    }
+    // 文件不存在时从空的排行榜开始
+    clear();
+    readFile(mScores);
+    bool updated = update(newScore);
+    bool ok = !updated || writeFile(mScores);
+    unlock();
+    if (changed != nullptr)
+    {
+        *changed = updated && ok;
+    }
+    return ok;
+}
+
+// 将排行榜信息写入文件
+bool LeaderBoard::write() const
+{
+    if (!lock())
+    {
+        return false;
+    }
+    bool ok = writeFile(mScores);
+    unlock();
+    return ok;
+}
+
+// 先写临时文件再重命名：读取的进程要么读到旧的文件，要么读到新的文件，不会读到写了一半的内容
+bool LeaderBoard::writeFile(const std::vector<int> &scores) const
+{
+    // 只有持有锁的进程写临时文件，使用固定的名字
+    const std::string tempPath = mFilePath + ".tmp";
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+    const char *data = reinterpret_cast<const char *>(scores.data());
+    const size_t bytes = scores.size() * sizeof(int);
+    size_t done = 0;
+    while (done < bytes)
+    {
+        ssize_t count = ::write(fd, data + done, bytes - done);
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count <= 0)
+        {
+            break;
+        }
+        done += static_cast<size_t>(count);
+    }
+    bool ok = close(fd) == 0 && done == bytes;
+    if (!ok)
+    {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return std::rename(tempPath.c_str(), mFilePath.c_str()) == 0;
+}
+
+// 锁文件的排他锁，被其他进程持有时等待
+bool LeaderBoard::lock() const
+{
+    if (mLockFd < 0)
+    {
+        const std::string lockPath = mFilePath + ".lock";
+        mLockFd = open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (mLockFd < 0)
+        {
+            return false;
+        }
+    }
+    while (flock(mLockFd, LOCK_EX) != 0)
+    {
+        if (errno != EINTR)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LeaderBoard::unlock() const
+{
+    flock(mLockFd, LOCK_UN);
+}
+
+void LeaderBoard::clear()
+{
+    mScores.assign(mScores.size(), 0);
+}
+
+const std::vector<int> &LeaderBoard::getScores() const
+{
+    return mScores;
+}
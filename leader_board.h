@@ -0,0 +1,53 @@
+#ifndef LEADER_BOARD_H
+#define LEADER_BOARD_H
+
+#include <string>
+#include <vector>
+
+// 排行榜：保存最高的若干个得分，按从高到低排列，文件格式为依次存放的 int
+// 不依赖 SDL，游戏、终端版和基准测试共用
+// 多个进程可以共用同一个排行榜文件：写入时先写临时文件再重命名，文件的每个版本写好之后不再改变，
+// 读取不需要加锁，总是读到某一个完整的版本；修改文件的操作 (submit、write) 持有旁边的锁文件 (路径加 ".lock")
+// 的排他锁 (flock)，submit 在锁内重新读取文件再插入得分，不会覆盖其他进程同时提交的得分
+class LeaderBoard
+{
+public:
+    // 排行榜文件路径和记录数量
+    LeaderBoard(const std::string &path, int numLeaders);
+    ~LeaderBoard();
+
+    // 从文件加载排行榜
+    bool read();
+    // 插入新的得分 (只修改内存中的排行榜)，排行榜发生变化时返回 true
+    bool update(int newScore);
+    // 把新的得分合并到文件中的排行榜：加锁，读取文件中最新的排行榜，插入得分，写入 (排行榜没有变化时不写)，解锁
+    // 之后 getScores 返回合并后的排行榜；changed 不为空时设置排行榜是否发生了变化。加锁或读写失败时返回 false
+    bool submit(int newScore, bool *changed = nullptr);
+    // 用内存中的排行榜覆盖文件 (加锁，用于清空排行榜)
+    bool write() const;
+    // 清空排行榜 (所有记录为 0)
+    void clear();
+
+    const std::vector<int> &getScores() const;
+
+private:
+    // 排行榜文件路径
+    const std::string mFilePath;
+    // 排行榜数据
+    std::vector<int> mScores;
+    // 锁文件的描述符，第一次修改文件时打开 (flock 的锁属于打开的文件，fork 之后子进程应该创建自己的 LeaderBoard)
+    mutable int mLockFd = -1;
+
+    // 读取文件中的排行榜到 scores (文件较短时其余为 0)
+    bool readFile(std::vector<int> &scores) const;
+    // 写入临时文件再重命名 (调用者持有锁)
+    bool writeFile(const std::vector<int> &scores) const;
+    // 锁文件的排他锁
+    bool lock() const;
+    void unlock() const;
+
+    LeaderBoard(const LeaderBoard &) = delete;
+    LeaderBoard &operator=(const LeaderBoard &) = delete;
+};
+
+#endif
@@ -0,0 +1,910 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "lockstep.h"
+
+// 当前时间 (微秒，单调时钟)
+uint64_t nowMicros()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// 小端序写入
+static void putU8(std::vector<uint8_t> &out, uint8_t value)
+{
+    out.push_back(value);
+}
+
+static void putU16(std::vector<uint8_t> &out, uint16_t value)
+{
+    out.push_back(value & 0xFF);
+    out.push_back(value >> 8);
+}
+
+static void putU32(std::vector<uint8_t> &out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        out.push_back((value >> (i * 8)) & 0xFF);
+    }
+}
+
+static void putU64(std::vector<uint8_t> &out, uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        out.push_back((value >> (i * 8)) & 0xFF);
+    }
+}
+
+// 小端序读取，越界时 ok 置为 false
+class ByteReader
+{
+public:
+    explicit ByteReader(const std::vector<uint8_t> &data) : mData(data) {}
+
+    uint64_t read(int bytes)
+    {
+        if (mPos + bytes > mData.size())
+        {
+            ok = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; i++)
+        {
+            value |= static_cast<uint64_t>(mData[mPos++]) << (i * 8);
+        }
+        return value;
+    }
+    uint8_t u8() { return static_cast<uint8_t>(read(1)); }
+    uint16_t u16() { return static_cast<uint16_t>(read(2)); }
+    uint32_t u32() { return static_cast<uint32_t>(read(4)); }
+    uint64_t u64() { return read(8); }
+
+    bool ok = true;
+
+private:
+    const std::vector<uint8_t> &mData;
+    size_t mPos = 0;
+};
+
+// 百分位数 (输入已排序)
+static double percentile(const std::vector<double> &sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+    return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+}
+
+// 对局构造函数：每个玩家一局游戏
+LockstepMatch::LockstepMatch(const LockstepConfig &config) : mConfig(config)
+{
+    for (int i = 0; i < config.players; i++)
+    {
+        std::unique_ptr<Simulation> simulation(new Simulation(config.boardWidth, config.boardHeight, 2));
+        simulation->reset(config.gameMode, config.difficulty, config.mapType, config.seed);
+        mSimulations.push_back(std::move(simulation));
+    }
+}
+
+// 应用一帧的输入并推进所有游戏
+void LockstepMatch::step(const uint8_t *inputs, uint32_t *checksums)
+{
+    float deltaTime = mConfig.tickMillis / 1000.0f;
+    for (int i = 0; i < mConfig.players; i++)
+    {
+        Simulation &simulation = *mSimulations[i];
+        if (!simulation.isGameOver())
+        {
+            if (inputs[i] != NO_INPUT)
+            {
+                simulation.addDirectionToQueue(static_cast<Direction>(inputs[i]));
+            }
+            simulation.tick(deltaTime);
+        }
+        checksums[i] = simulation.checksum();
+    }
+}
+
+bool LockstepMatch::isFinished() const
+{
+    for (const auto &simulation : mSimulations)
+    {
+        if (!simulation->isGameOver())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int LockstepMatch::getPlayers() const
+{
+    return mConfig.players;
+}
+
+const Simulation &LockstepMatch::getSimulation(int player) const
+{
+    return *mSimulations[player];
+}
+
+// 连接构造函数，套接字设置为非阻塞
+Connection::Connection(int fd) : mFd(fd)
+{
+    fcntl(mFd, F_SETFL, fcntl(mFd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+Connection::~Connection()
+{
+    if (mFd >= 0)
+    {
+        close(mFd);
+    }
+}
+
+int Connection::getFd() const
+{
+    return mFd;
+}
+
+bool Connection::sendMessage(const std::vector<uint8_t> &message)
+{
+    if (message.size() > 0xFFFF)
+    {
+        return false;
+    }
+    putU16(mOutput, static_cast<uint16_t>(message.size()));
+    mOutput.insert(mOutput.end(), message.begin(), message.end());
+    return flush();
+}
+
+bool Connection::flush()
+{
+    size_t offset = 0;
+    while (offset < mOutput.size())
+    {
+        ssize_t n = send(mFd, mOutput.data() + offset, mOutput.size() - offset, MSG_NOSIGNAL);
+        if (n > 0)
+        {
+            offset += n;
+            mBytesSent += n;
+        }
+        else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+        else if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    mOutput.erase(mOutput.begin(), mOutput.begin() + offset);
+    return true;
+}
+
+bool Connection::hasPendingOutput() const
+{
+    return !mOutput.empty();
+}
+
+bool Connection::readAvailable()
+{
+    uint8_t buffer[4096];
+    while (true)
+    {
+        ssize_t n = recv(mFd, buffer, sizeof(buffer), 0);
+        if (n > 0)
+        {
+            mInput.insert(mInput.end(), buffer, buffer + n);
+            mBytesReceived += n;
+        }
+        else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return true;
+        }
+        else if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else
+        {
+            return false; // 连接关闭或出错
+        }
+    }
+}
+
+bool Connection::popMessage(std::vector<uint8_t> &message)
+{
+    if (mInput.size() < 2)
+    {
+        return false;
+    }
+    size_t length = mInput[0] | (mInput[1] << 8);
+    if (mInput.size() < 2 + length)
+    {
+        return false;
+    }
+    message.assign(mInput.begin() + 2, mInput.begin() + 2 + length);
+    mInput.erase(mInput.begin(), mInput.begin() + 2 + length);
+    return true;
+}
+
+uint64_t Connection::getBytesSent() const
+{
+    return mBytesSent;
+}
+
+uint64_t Connection::getBytesReceived() const
+{
+    return mBytesReceived;
+}
+
+// 解析 TCP 地址，默认使用本机回环地址
+static bool resolveTcp(const std::string &address, sockaddr_in &result)
+{
+    std::string host = "127.0.0.1";
+    std::string port = address;
+    size_t colon = address.rfind(':');
+    if (colon != std::string::npos)
+    {
+        host = address.substr(0, colon);
+        port = address.substr(colon + 1);
+    }
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *info = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &info) != 0 || info == nullptr)
+    {
+        return false;
+    }
+    std::memcpy(&result, info->ai_addr, sizeof(result));
+    freeaddrinfo(info);
+    return true;
+}
+
+// 解析 UNIX 套接字地址
+static bool resolveUnix(const std::string &path, sockaddr_un &result)
+{
+    std::memset(&result, 0, sizeof(result));
+    result.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(result.sun_path))
+    {
+        return false;
+    }
+    std::strcpy(result.sun_path, path.c_str());
+    return true;
+}
+
+int listenEndpoint(const std::string &endpoint)
+{
+    int fd = -1;
+    if (endpoint.compare(0, 5, "unix:") == 0)
+    {
+        sockaddr_un address;
+        if (!resolveUnix(endpoint.substr(5), address))
+        {
+            return -1;
+        }
+        unlink(address.sun_path);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+        {
+            std::cerr << "无法绑定地址 " << endpoint << ": " << std::strerror(errno) << std::endl;
+            if (fd >= 0)
+                close(fd);
+            return -1;
+        }
+    }
+    else if (endpoint.compare(0, 4, "tcp:") == 0)
+    {
+        sockaddr_in address;
+        if (!resolveTcp(endpoint.substr(4), address))
+        {
+            return -1;
+        }
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+        {
+            std::cerr << "无法绑定地址 " << endpoint << ": " << std::strerror(errno) << std::endl;
+            if (fd >= 0)
+                close(fd);
+            return -1;
+        }
+    }
+    else
+    {
+        std::cerr << "未知的地址格式: " << endpoint << std::endl;
+        return -1;
+    }
+    if (listen(fd, MAX_PLAYERS) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// 接受连接并关闭 Nagle 算法，减少小消息的延迟
+int acceptConnection(int listenFd)
+{
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd >= 0)
+    {
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay)); // UNIX 套接字上会失败，忽略
+    }
+    return fd;
+}
+
+// 连接服务器，服务器尚未启动时最多重试 5 秒
+int connectEndpoint(const std::string &endpoint)
+{
+    for (int attempt = 0; attempt < 100; attempt++)
+    {
+        int fd = -1;
+        int result = -1;
+        if (endpoint.compare(0, 5, "unix:") == 0)
+        {
+            sockaddr_un address;
+            if (!resolveUnix(endpoint.substr(5), address))
+            {
+                return -1;
+            }
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            result = connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+        }
+        else if (endpoint.compare(0, 4, "tcp:") == 0)
+        {
+            sockaddr_in address;
+            if (!resolveTcp(endpoint.substr(4), address))
+            {
+                return -1;
+            }
+            fd = socket(AF_INET, SOCK_STREAM, 0);
+            result = connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        else
+        {
+            std::cerr << "未知的地址格式: " << endpoint << std::endl;
+            return -1;
+        }
+        if (result == 0)
+        {
+            return fd;
+        }
+        close(fd);
+        usleep(50 * 1000);
+    }
+    std::cerr << "无法连接服务器 " << endpoint << ": " << std::strerror(errno) << std::endl;
+    return -1;
+}
+
+// 服务器构造函数
+LockstepServer::LockstepServer(const LockstepConfig &config, const std::string &endpoint)
+    : mConfig(config), mEndpoint(endpoint)
+{
+    mConfig.players = std::max(MIN_PLAYERS, std::min(mConfig.players, MAX_PLAYERS));
+    mConfig.batchTicks = std::max(1, std::min(mConfig.batchTicks, MAX_BATCH_TICKS));
+    mConfig.inputDelay = std::max(0, mConfig.inputDelay);
+}
+
+// 等待所有玩家加入，并向每个玩家发送编号和对局参数
+bool LockstepServer::acceptPlayers(int listenFd)
+{
+    while (static_cast<int>(mClients.size()) < mConfig.players)
+    {
+        int fd = acceptConnection(listenFd);
+        if (fd < 0)
+        {
+            return false;
+        }
+        Client client;
+        client.connection.reset(new Connection(fd));
+        mClients.push_back(std::move(client));
+        std::cout << "玩家 " << mClients.size() - 1 << " 已连接" << std::endl;
+    }
+
+    // 等待每个客户端的 Hello 消息
+    for (size_t i = 0; i < mClients.size(); i++)
+    {
+        Connection &connection = *mClients[i].connection;
+        std::vector<uint8_t> message;
+        bool received = false;
+        while (!received)
+        {
+            pollfd pfd = {connection.getFd(), POLLIN, 0};
+            if (poll(&pfd, 1, 5000) <= 0)
+            {
+                return false;
+            }
+            bool open = connection.readAvailable();
+            received = connection.popMessage(message);
+            if (!open && !received)
+            {
+                return false;
+            }
+        }
+        if (message.empty() || message[0] != static_cast<uint8_t>(MessageType::Hello))
+        {
+            return false;
+        }
+
+        std::vector<uint8_t> welcome;
+        putU8(welcome, static_cast<uint8_t>(MessageType::Welcome));
+        putU8(welcome, static_cast<uint8_t>(i));
+        putU8(welcome, static_cast<uint8_t>(mConfig.players));
+        putU16(welcome, static_cast<uint16_t>(mConfig.inputDelay));
+        putU16(welcome, static_cast<uint16_t>(mConfig.batchTicks));
+        putU16(welcome, static_cast<uint16_t>(mConfig.tickMillis));
+        putU32(welcome, static_cast<uint32_t>(mConfig.maxTicks));
+        putU64(welcome, mConfig.seed);
+        putU8(welcome, static_cast<uint8_t>(mConfig.gameMode));
+        putU8(welcome, static_cast<uint8_t>(mConfig.difficulty));
+        putU8(welcome, static_cast<uint8_t>(mConfig.mapType));
+        connection.sendMessage(welcome);
+    }
+    return true;
+}
+
+// 接收输入，最多等待 timeoutMillis 毫秒
+void LockstepServer::receiveInputs(int timeoutMillis)
+{
+    std::vector<pollfd> pfds;
+    for (const auto &client : mClients)
+    {
+        short events = POLLIN;
+        if (client.connection->hasPendingOutput())
+        {
+            events |= POLLOUT;
+        }
+        pfds.push_back({client.connected ? client.connection->getFd() : -1, events, 0});
+    }
+    if (poll(pfds.data(), pfds.size(), timeoutMillis) <= 0)
+    {
+        return;
+    }
+
+    std::vector<uint8_t> message;
+    for (size_t i = 0; i < mClients.size(); i++)
+    {
+        Client &client = mClients[i];
+        if (!client.connected || pfds[i].revents == 0)
+        {
+            continue;
+        }
+        if (pfds[i].revents & POLLOUT)
+        {
+            client.connection->flush();
+        }
+        if (!client.connection->readAvailable())
+        {
+            client.connected = false;
+            std::cout << "玩家 " << i << " 已断开" << std::endl;
+        }
+        while (client.connection->popMessage(message))
+        {
+            ByteReader reader(message);
+            if (reader.u8() != static_cast<uint8_t>(MessageType::Input))
+            {
+                continue;
+            }
+            PendingInput input;
+            input.tick = reader.u32();
+            input.direction = reader.u8();
+            input.sendTime = reader.u64();
+            if (!reader.ok || input.direction > static_cast<uint8_t>(Direction::Right))
+            {
+                continue;
+            }
+            client.inputs++;
+            // 错过目标帧的输入在下一帧生效
+            if (input.tick < mTick)
+            {
+                client.late++;
+                input.tick = mTick;
+            }
+            client.pending.push_back(input);
+        }
+    }
+}
+
+// 向每个客户端发送一批逻辑帧
+void LockstepServer::broadcastFrames(const std::vector<LockstepFrame> &frames)
+{
+    for (auto &client : mClients)
+    {
+        if (!client.connected)
+        {
+            continue;
+        }
+        std::vector<uint8_t> message;
+        putU8(message, static_cast<uint8_t>(MessageType::Frames));
+        putU8(message, static_cast<uint8_t>(frames.size()));
+        putU64(message, client.echoTime);
+        for (const auto &frame : frames)
+        {
+            putU32(message, frame.tick);
+            for (int i = 0; i < mConfig.players; i++)
+            {
+                putU8(message, frame.inputs[i]);
+            }
+            for (int i = 0; i < mConfig.players; i++)
+            {
+                putU32(message, frame.checksums[i]);
+            }
+        }
+        client.echoTime = 0;
+        client.connected = client.connection->sendMessage(message);
+    }
+}
+
+// 发送最终得分
+void LockstepServer::broadcastFinish(const LockstepMatch &match)
+{
+    std::vector<uint8_t> message;
+    putU8(message, static_cast<uint8_t>(MessageType::Finish));
+    putU8(message, static_cast<uint8_t>(mConfig.players));
+    for (int i = 0; i < mConfig.players; i++)
+    {
+        putU32(message, static_cast<uint32_t>(match.getSimulation(i).getPoints()));
+    }
+    for (auto &client : mClients)
+    {
+        if (client.connected)
+        {
+            client.connection->sendMessage(message);
+        }
+    }
+}
+
+// 运行整场对局
+bool LockstepServer::run()
+{
+    int listenFd = listenEndpoint(mEndpoint);
+    if (listenFd < 0)
+    {
+        return false;
+    }
+    std::cout << "等待 " << mConfig.players << " 名玩家连接 " << mEndpoint << std::endl;
+    bool accepted = acceptPlayers(listenFd);
+    close(listenFd);
+    if (!accepted)
+    {
+        std::cerr << "玩家加入失败" << std::endl;
+        return false;
+    }
+
+    LockstepMatch match(mConfig);
+    std::vector<LockstepFrame> batch;
+    uint64_t start = nowMicros();
+    uint64_t tickMicros = static_cast<uint64_t>(mConfig.tickMillis) * 1000;
+    while (true)
+    {
+        // 在下一帧到期之前接收输入
+        uint64_t due = start + mTick * tickMicros;
+        uint64_t now;
+        while ((now = nowMicros()) < due)
+        {
+            receiveInputs(static_cast<int>((due - now + 999) / 1000));
+        }
+        receiveInputs(0);
+
+        // 收集每个玩家在这一帧生效的输入 (每帧最多一个)
+        LockstepFrame frame;
+        frame.tick = mTick;
+        for (int i = 0; i < mConfig.players; i++)
+        {
+            Client &client = mClients[i];
+            frame.inputs[i] = NO_INPUT;
+            if (!client.pending.empty() && client.pending.front().tick <= mTick)
+            {
+                frame.inputs[i] = client.pending.front().direction;
+                client.echoTime = client.pending.front().sendTime;
+                client.pending.pop_front();
+            }
+        }
+        match.step(frame.inputs, frame.checksums);
+        batch.push_back(frame);
+        mTick++;
+
+        bool anyConnected = false;
+        for (const auto &client : mClients)
+        {
+            anyConnected = anyConnected || client.connected;
+        }
+        bool finished = match.isFinished() || mTick >= static_cast<uint32_t>(mConfig.maxTicks) || !anyConnected;
+        if (static_cast<int>(batch.size()) >= mConfig.batchTicks || finished)
+        {
+            broadcastFrames(batch);
+            batch.clear();
+        }
+        if (finished)
+        {
+            broadcastFinish(match);
+            break;
+        }
+    }
+    double seconds = (nowMicros() - start) / 1e6;
+
+    // 把剩余数据发送出去
+    uint64_t deadline = nowMicros() + 1000000;
+    bool pending = true;
+    while (pending && nowMicros() < deadline)
+    {
+        pending = false;
+        for (auto &client : mClients)
+        {
+            if (client.connected && client.connection->hasPendingOutput())
+            {
+                client.connection->flush();
+                pending = true;
+            }
+        }
+        if (pending)
+        {
+            usleep(1000);
+        }
+    }
+
+    for (int i = 0; i < mConfig.players; i++)
+    {
+        std::cout << "玩家 " << i << " 得分: " << match.getSimulation(i).getPoints() << std::endl;
+    }
+    report(seconds);
+    return true;
+}
+
+// 输出每个客户端的带宽统计
+void LockstepServer::report(double seconds) const
+{
+    std::cout << "对局结束: " << mTick << " 帧, " << seconds << " 秒, 输入延迟 " << mConfig.inputDelay
+              << " 帧, 每批 " << mConfig.batchTicks << " 帧" << std::endl;
+    for (size_t i = 0; i < mClients.size(); i++)
+    {
+        const Client &client = mClients[i];
+        double sent = client.connection->getBytesSent();
+        double received = client.connection->getBytesReceived();
+        std::cout << "玩家 " << i << ": 输入 " << client.inputs << " (迟到 " << client.late << "), 发送 "
+                  << sent << " B (" << sent / seconds << " B/s), 接收 " << received << " B ("
+                  << received / seconds << " B/s)" << std::endl;
+    }
+}
+
+// 客户端构造函数
+LockstepClient::LockstepClient(const std::string &endpoint) : mEndpoint(endpoint)
+{
+}
+
+// 简单的贪心策略：选择不会立即死亡且离最近的食物最近的方向
+Direction LockstepClient::chooseDirection(const Simulation &simulation) const
+{
+    const Snake &snake = simulation.getSnake();
+    const CellGrid &grid = simulation.getGrid();
+    const int headX = grid.getX(snake.getHead());
+    const int headY = grid.getY(snake.getHead());
+    const std::vector<FoodItem> &foods = simulation.getFoods().getItems();
+    int width = simulation.getBoardWidth();
+    int height = simulation.getBoardHeight();
+    const Direction directions[] = {Direction::Up, Direction::Down, Direction::Left, Direction::Right};
+    const int dx[] = {0, 0, -1, 1};
+    const int dy[] = {-1, 1, 0, 0};
+
+    Direction best = snake.getDirection();
+    int bestDistance = -1;
+    for (int i = 0; i < 4; i++)
+    {
+        // 不能直接掉头
+        if ((i ^ 1) == static_cast<int>(snake.getDirection()))
+        {
+            continue;
+        }
+        int x = headX + dx[i];
+        int y = headY + dy[i];
+        if (mConfig.gameMode == GameMode::Unbounded)
+        {
+            x = (x + width) % width;
+            y = (y + height) % height;
+        }
+        else if (x < 0 || x >= width || y < 0 || y >= height)
+        {
+            continue;
+        }
+        CellIndex cell = grid.toCell(x, y);
+        if (snake.isPartOfSnake(cell))
+        {
+            continue;
+        }
+        const std::vector<CellIndex> &obstacles = simulation.getObstacles();
+        if (containsCell(obstacles.data(), obstacles.size(), cell))
+        {
+            continue;
+        }
+        // 离最近的食物的距离
+        int distance = -1;
+        for (const auto &item : foods)
+        {
+            int d = std::abs(grid.getX(item.cell) - x) + std::abs(grid.getY(item.cell) - y);
+            if (distance < 0 || d < distance)
+            {
+                distance = d;
+            }
+        }
+        if (bestDistance < 0 || distance < bestDistance)
+        {
+            bestDistance = distance;
+            best = directions[i];
+        }
+    }
+    return best;
+}
+
+// 加入对局并运行到结束
+bool LockstepClient::run()
+{
+    int fd = connectEndpoint(mEndpoint);
+    if (fd < 0)
+    {
+        return false;
+    }
+    Connection connection(fd);
+    std::vector<uint8_t> hello;
+    putU8(hello, static_cast<uint8_t>(MessageType::Hello));
+    connection.sendMessage(hello);
+
+    std::unique_ptr<LockstepMatch> match;
+    std::vector<uint8_t> message;
+    uint64_t start = nowMicros();
+    uint32_t lastTick = 0;
+    uint32_t lastSentTick = 0;
+    uint8_t lastSent = NO_INPUT;
+    bool finished = false;
+    while (!finished)
+    {
+        pollfd pfd = {fd, static_cast<short>(POLLIN | (connection.hasPendingOutput() ? POLLOUT : 0)), 0};
+        if (poll(&pfd, 1, 5000) <= 0)
+        {
+            std::cerr << "等待服务器超时" << std::endl;
+            return false;
+        }
+        if (pfd.revents & POLLOUT)
+        {
+            connection.flush();
+        }
+        bool open = connection.readAvailable();
+        while (connection.popMessage(message))
+        {
+            ByteReader reader(message);
+            MessageType type = static_cast<MessageType>(reader.u8());
+            if (type == MessageType::Welcome)
+            {
+                mPlayerId = reader.u8();
+                mConfig.players = reader.u8();
+                mConfig.inputDelay = reader.u16();
+                mConfig.batchTicks = reader.u16();
+                mConfig.tickMillis = reader.u16();
+                mConfig.maxTicks = reader.u32();
+                mConfig.seed = reader.u64();
+                mConfig.gameMode = static_cast<GameMode>(reader.u8());
+                mConfig.difficulty = static_cast<Difficulty>(reader.u8());
+                mConfig.mapType = static_cast<MapType>(reader.u8());
+                match.reset(new LockstepMatch(mConfig));
+                start = nowMicros();
+                std::cout << "加入对局，玩家编号 " << mPlayerId << " / " << mConfig.players << std::endl;
+            }
+            else if (type == MessageType::Frames && match)
+            {
+                int count = reader.u8();
+                uint64_t echoTime = reader.u64();
+                if (echoTime != 0)
+                {
+                    mLatencies.push_back((nowMicros() - echoTime) / 1000.0);
+                }
+                for (int f = 0; f < count; f++)
+                {
+                    uint8_t inputs[MAX_PLAYERS];
+                    uint32_t expected[MAX_PLAYERS];
+                    uint32_t local[MAX_PLAYERS];
+                    lastTick = reader.u32();
+                    for (int i = 0; i < mConfig.players; i++)
+                    {
+                        inputs[i] = reader.u8();
+                    }
+                    for (int i = 0; i < mConfig.players; i++)
+                    {
+                        expected[i] = reader.u32();
+                    }
+                    if (!reader.ok)
+                    {
+                        return false;
+                    }
+                    match->step(inputs, local);
+                    for (int i = 0; i < mConfig.players; i++)
+                    {
+                        if (local[i] != expected[i])
+                        {
+                            mDesyncs++;
+                            std::cerr << "状态不一致: 帧 " << lastTick << " 玩家 " << i << std::endl;
+                        }
+                    }
+                    mFrames++;
+                }
+
+                // 根据最新状态决定输入，目标帧为当前帧加上输入延迟
+                const Simulation &simulation = match->getSimulation(mPlayerId);
+                if (!simulation.isGameOver())
+                {
+                    Direction direction = chooseDirection(simulation);
+                    uint8_t value = static_cast<uint8_t>(direction);
+                    bool stale = lastTick > lastSentTick + mConfig.inputDelay + mConfig.batchTicks;
+                    if (direction != simulation.getSnake().getDirection() && (value != lastSent || stale))
+                    {
+                        std::vector<uint8_t> input;
+                        putU8(input, static_cast<uint8_t>(MessageType::Input));
+                        putU32(input, lastTick + 1 + mConfig.inputDelay);
+                        putU8(input, value);
+                        putU64(input, nowMicros());
+                        connection.sendMessage(input);
+                        lastSent = value;
+                        lastSentTick = lastTick;
+                    }
+                }
+            }
+            else if (type == MessageType::Finish)
+            {
+                int players = reader.u8();
+                for (int i = 0; i < players; i++)
+                {
+                    std::cout << "玩家 " << i << " 得分: " << reader.u32() << std::endl;
+                }
+                finished = true;
+            }
+        }
+        if (!open && !finished)
+        {
+            std::cerr << "服务器断开连接" << std::endl;
+            return false;
+        }
+    }
+    report(connection, (nowMicros() - start) / 1e6);
+    return mDesyncs == 0;
+}
+
+// 输出延迟和带宽统计
+void LockstepClient::report(const Connection &connection, double seconds) const
+{
+    std::vector<double> sorted = mLatencies;
+    std::sort(sorted.begin(), sorted.end());
+    std::cout << "玩家 " << mPlayerId << ": " << mFrames << " 帧, 状态不一致 " << mDesyncs << " 次" << std::endl;
+    std::cout << "输入确认延迟 (ms): 样本 " << sorted.size() << ", p50 " << percentile(sorted, 0.5)
+              << ", p90 " << percentile(sorted, 0.9) << ", p99 " << percentile(sorted, 0.99)
+              << ", 最大 " << (sorted.empty() ? 0.0 : sorted.back()) << std::endl;
+    std::cout << "带宽: 发送 " << connection.getBytesSent() << " B (" << connection.getBytesSent() / seconds
+              << " B/s), 接收 " << connection.getBytesReceived() << " B ("
+              << connection.getBytesReceived() / seconds << " B/s)" << std::endl;
+}
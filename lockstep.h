@@ -0,0 +1,169 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+
+#include "simulation.h"
+
+// 支持的玩家数量
+const int MIN_PLAYERS = 2;
+const int MAX_PLAYERS = 8;
+// 每条广播消息最多合并的逻辑帧数 (帧数用一个字节发送)
+const int MAX_BATCH_TICKS = 255;
+// 某一逻辑帧没有输入
+const uint8_t NO_INPUT = 0xFF;
+
+// 联机对战参数
+struct LockstepConfig
+{
+    int players = 2;                          // 玩家数量 (2-8)
+    int inputDelay = 2;                       // 输入延迟 (逻辑帧)，客户端的输入最早在这么多帧之后生效
+    int batchTicks = 1;                       // 每条广播消息合并的逻辑帧数 (1-255)
+    int tickMillis = 50;                      // 逻辑帧间隔 (毫秒)，与 runGame 的逻辑更新频率相同
+    int maxTicks = 6000;                      // 对局最长帧数
+    uint64_t seed = 1;                        // 随机数种子，所有玩家使用相同的食物序列
+    GameMode gameMode = GameMode::Bounded;    // 游戏模式
+    Difficulty difficulty = Difficulty::Easy; // 游戏难度
+    MapType mapType = MapType::Empty;         // 地图类型
+    // 游戏区域宽度和高度 (像素)，与 Game 的游戏区域相同
+    int boardWidth = WINDOW_WIDTH - 10 * GRID_SIZE;
+    int boardHeight = WINDOW_HEIGHT - 2 * GRID_SIZE;
+};
+
+// 消息类型
+enum class MessageType : uint8_t
+{
+    Hello = 1,   // 客户端 -> 服务器：请求加入
+    Welcome = 2, // 服务器 -> 客户端：玩家编号和对局参数
+    Input = 3,   // 客户端 -> 服务器：某一帧的方向输入
+    Frames = 4,  // 服务器 -> 客户端：若干逻辑帧的全部输入和校验和
+    Finish = 5   // 服务器 -> 客户端：对局结束和最终得分
+};
+
+// 一个逻辑帧：所有玩家在该帧的输入，以及执行该帧之后每局游戏的校验和
+struct LockstepFrame
+{
+    uint32_t tick = 0;
+    uint8_t inputs[MAX_PLAYERS];
+    uint32_t checksums[MAX_PLAYERS];
+};
+
+// 一场对局：每个玩家各自一局游戏，种子和设置都相同
+// 服务器和所有客户端都运行同一个 LockstepMatch，只交换输入
+class LockstepMatch
+{
+public:
+    LockstepMatch(const LockstepConfig &config);
+    // 应用一帧的输入并推进所有游戏，把校验和写入 checksums
+    void step(const uint8_t *inputs, uint32_t *checksums);
+    // 是否所有玩家的游戏都已经结束
+    bool isFinished() const;
+    int getPlayers() const;
+    const Simulation &getSimulation(int player) const;
+
+private:
+    LockstepConfig mConfig;
+    std::vector<std::unique_ptr<Simulation>> mSimulations;
+};
+
+// 基于流式套接字的连接，消息格式为 [u16 长度][内容]，非阻塞收发
+class Connection
+{
+public:
+    explicit Connection(int fd);
+    ~Connection();
+    int getFd() const;
+    // 把消息放入发送缓冲并尽量立即发送
+    bool sendMessage(const std::vector<uint8_t> &message);
+    // 发送缓冲中剩余的数据
+    bool flush();
+    bool hasPendingOutput() const;
+    // 读取所有可读数据，连接关闭或出错时返回 false
+    bool readAvailable();
+    // 取出一条完整的消息
+    bool popMessage(std::vector<uint8_t> &message);
+    uint64_t getBytesSent() const;
+    uint64_t getBytesReceived() const;
+
+private:
+    int mFd;
+    std::vector<uint8_t> mInput;
+    std::vector<uint8_t> mOutput;
+    uint64_t mBytesSent = 0;
+    uint64_t mBytesReceived = 0;
+    Connection(const Connection &) = delete;
+    Connection &operator=(const Connection &) = delete;
+};
+
+// 监听/连接地址："unix:/path/to/socket"、"tcp:端口" (本机回环) 或 "tcp:主机:端口"
+int listenEndpoint(const std::string &endpoint);
+int acceptConnection(int listenFd);
+int connectEndpoint(const std::string &endpoint);
+
+// 权威服务器：收集每个玩家每一帧的方向输入，按固定帧率推进对局并广播
+class LockstepServer
+{
+public:
+    LockstepServer(const LockstepConfig &config, const std::string &endpoint);
+    // 等待所有玩家加入并运行整场对局，返回 false 表示出错
+    bool run();
+
+private:
+    // 尚未生效的输入
+    struct PendingInput
+    {
+        uint32_t tick;
+        uint8_t direction;
+        uint64_t sendTime;
+    };
+    // 每个客户端的状态和统计
+    struct Client
+    {
+        std::unique_ptr<Connection> connection;
+        std::deque<PendingInput> pending;
+        uint64_t echoTime = 0; // 本批次中最近一个生效输入的发送时间
+        uint64_t inputs = 0;   // 收到的输入数量
+        uint64_t late = 0;     // 到达时已经错过目标帧的输入数量
+        bool connected = true;
+    };
+
+    LockstepConfig mConfig;
+    std::string mEndpoint;
+    std::vector<Client> mClients;
+    uint32_t mTick = 0;
+
+    bool acceptPlayers(int listenFd);
+    void receiveInputs(int timeoutMillis);
+    void broadcastFrames(const std::vector<LockstepFrame> &frames);
+    void broadcastFinish(const LockstepMatch &match);
+    void report(double seconds) const;
+};
+
+// 无界面客户端：运行本地的对局副本，验证每帧的校验和，并用简单的贪心策略产生输入
+class LockstepClient
+{
+public:
+    explicit LockstepClient(const std::string &endpoint);
+    // 加入对局并运行到结束，返回 false 表示出错或出现状态不一致
+    bool run();
+
+private:
+    std::string mEndpoint;
+    int mPlayerId = 0;
+    LockstepConfig mConfig;
+    std::vector<double> mLatencies; // 输入从发送到被服务器确认的时间 (毫秒)
+    uint64_t mDesyncs = 0;
+    uint64_t mFrames = 0;
+
+    Direction chooseDirection(const Simulation &simulation) const;
+    void report(const Connection &connection, double seconds) const;
+};
+
+// 当前时间 (微秒，单调时钟)
+uint64_t nowMicros();
+
+#endif
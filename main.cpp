@@ -7,4 +7,5 @@ int main(int argc, char** argv)
     Game game;
     // 启动游戏
     game.startGame();
+    return game.getExitCode();
 }
\ No newline at end of file
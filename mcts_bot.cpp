@@ -0,0 +1,434 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "mcts_bot.h"
+
+// 单调时钟 (纳秒)
+static int64_t nowNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static uint64_t nextSeed(Random &random)
+{
+    return (static_cast<uint64_t>(random.next()) << 32) | random.next();
+}
+
+// 与 direction 相反的方向
+static Direction opposite(Direction direction)
+{
+    const Direction opposites[5] = {Direction::Down, Direction::Up, Direction::Right, Direction::Left, Direction::None};
+    return opposites[static_cast<int>(direction)];
+}
+
+// 吃到食物的得分按移动次数折扣，越早吃到越好
+static const float FOOD_DISCOUNT = 0.95f;
+
+// 构造函数：创建复制局面用的 Simulation 和搜索线程
+MctsBot::MctsBot(const Simulation &prototype, const MctsConfig &config)
+    : mConfig(config),
+      mThreads(config.threads > 0 ? std::min(config.threads, availableCores()) : availableCores()),
+      mNodes(std::max(4, config.maxNodes))
+{
+    const int width = prototype.getBoardWidth() * GRID_SIZE;
+    const int height = prototype.getBoardHeight() * GRID_SIZE;
+    this->mRootState.reset(new Simulation(width, height, prototype.getSnake().getLength()));
+    this->mRootState->copyFrom(prototype);
+    Random seeds(config.seed);
+    this->mWorkers.resize(mThreads);
+    for (Worker &worker : mWorkers)
+    {
+        worker.state.reset(new Simulation(width, height, prototype.getSnake().getLength()));
+        worker.state->copyFrom(prototype);
+        worker.random.seed(nextSeed(seeds));
+    }
+    resetTree();
+    // 第 0 个 Worker 由调用 choose 的线程使用
+    for (int i = 1; i < mThreads; i++)
+    {
+        mThreadPool.push_back(std::thread(&MctsBot::threadMain, this, i));
+    }
+}
+
+// 析构函数：通知搜索线程退出
+MctsBot::~MctsBot()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQuit = true;
+    }
+    mStart.notify_all();
+    for (std::thread &thread : mThreadPool)
+    {
+        thread.join();
+    }
+}
+
+const MctsStats &MctsBot::getStats() const
+{
+    return mStats;
+}
+
+int MctsBot::getThreads() const
+{
+    return mThreads;
+}
+
+// 可以使用的核数：容器或 taskset 限制的核数可能少于硬件的核数，超过可用核数的搜索线程会被抢占，
+// 被抢占的线程在截止时间之后才能完成，拖长决策时间
+int MctsBot::availableCores()
+{
+    int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+#ifdef __linux__
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        cores = std::min(cores, std::max(1, CPU_COUNT(&set)));
+    }
+#endif
+    return cores;
+}
+
+// 选择下一次移动的方向
+Direction MctsBot::choose(const Simulation &simulation)
+{
+    Direction current = simulation.getSnake().getDirection();
+    if (current == Direction::None || simulation.isGameOver())
+    {
+        return current;
+    }
+    int64_t start = nowNanos();
+    updateRoot(simulation);
+    mStats.reusedVisits = mNodes[mRoot].visits.load(std::memory_order_relaxed);
+    mRootState->copyFrom(simulation);
+    for (Worker &worker : mWorkers)
+    {
+        worker.rollouts = 0;
+    }
+
+    // 唤醒搜索线程，调用线程也参与搜索，到截止时间后等待所有线程完成
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mDeadline = start + static_cast<int64_t>(mConfig.budgetMicros) * 1000;
+        mRunning = mThreads - 1;
+        mGeneration++;
+    }
+    mStart.notify_all();
+    search(mWorkers[0]);
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [this]() { return mRunning == 0; });
+    }
+
+    // 选择访问次数最多的子节点，根还没有展开时 (时间上限太短) 退回贪心策略
+    Direction best = Direction::None;
+    uint32_t bestVisits = 0;
+    Node &root = mNodes[mRoot];
+    if (root.state.load(std::memory_order_acquire) == 2)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            int32_t child = root.children[i].load(std::memory_order_relaxed);
+            if (child >= 0 && mNodes[child].visits.load(std::memory_order_relaxed) > bestVisits)
+            {
+                best = static_cast<Direction>(i);
+                bestVisits = mNodes[child].visits.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    if (best == Direction::None)
+    {
+        best = mGreedy.choose(simulation);
+    }
+    mLastChoice = best;
+    if (!mGreedy.nextCell(simulation, best, mExpectedHead))
+    {
+        mExpectedHead = NO_CELL;
+    }
+
+    mStats.rollouts = 0;
+    for (const Worker &worker : mWorkers)
+    {
+        mStats.rollouts += worker.rollouts;
+    }
+    mStats.nodes = std::min(mNodeCount.load(std::memory_order_relaxed), static_cast<int32_t>(mNodes.size()));
+    mStats.seconds = (nowNanos() - start) / 1e9;
+    mStats.threads = mThreads;
+    return best;
+}
+
+// 搜索线程：等待新的一代开始
+void MctsBot::threadMain(int index)
+{
+    uint64_t generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mStart.wait(lock, [this, generation]() { return mQuit || mGeneration != generation; });
+            if (mQuit)
+            {
+                return;
+            }
+            generation = mGeneration;
+        }
+        search(mWorkers[index]);
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mRunning--;
+        }
+        mDone.notify_one();
+    }
+}
+
+// 在截止时间之前反复模拟，每次模拟之前和模拟中都检查时间，到期时放弃的模拟不计数
+void MctsBot::search(Worker &worker)
+{
+    while (nowNanos() < mDeadline)
+    {
+        if (iterate(worker))
+        {
+            worker.rollouts++;
+        }
+    }
+}
+
+bool MctsBot::expired(int depth) const
+{
+    return depth % DEADLINE_CHECK_MOVES == 0 && nowNanos() >= mDeadline;
+}
+
+// 一次模拟
+bool MctsBot::iterate(Worker &worker)
+{
+    Simulation &state = *worker.state;
+    state.copyFrom(*mRootState);
+    // 之后生成的食物对机器人是未知的，每次模拟抽样一种可能
+    state.reseedRandom(nextSeed(worker.random));
+
+    int32_t path[MAX_PATH];
+    int pathLength = 0;
+    int32_t index = mRoot;
+    path[pathLength++] = index;
+    mNodes[index].virtualLoss.fetch_add(1, std::memory_order_relaxed);
+
+    int depth = 0;
+    float foodScore = 0.0f;
+    float discount = 1.0f;
+    bool alive = true;
+    bool aborted = false;
+    // 选择：沿着已经展开的节点向下，每一步按 UCT 选择方向并在复制的局面中移动
+    while (alive && depth < mConfig.rolloutMoves && pathLength < MAX_PATH)
+    {
+        if (depth > 0 && expired(depth))
+        {
+            aborted = true;
+            break;
+        }
+        Node &node = mNodes[index];
+        Direction current = state.getSnake().getDirection();
+        uint8_t expected = 0;
+        // 访问过一次的叶子才展开，根总是展开
+        if (node.state.load(std::memory_order_acquire) == 0 &&
+            (index == mRoot || node.visits.load(std::memory_order_relaxed) > 0) &&
+            node.state.compare_exchange_strong(expected, 1, std::memory_order_acq_rel))
+        {
+            expand(node, current);
+        }
+        if (node.state.load(std::memory_order_acquire) != 2)
+        {
+            break;
+        }
+        int choice = select(node, current);
+        if (choice < 0)
+        {
+            break;
+        }
+        int length = state.getSnake().getLength();
+        state.addDirectionToQueue(static_cast<Direction>(choice));
+        alive = state.advanceMove();
+        depth++;
+        discount *= FOOD_DISCOUNT;
+        if (state.getSnake().getLength() > length)
+        {
+            foodScore += discount;
+        }
+        index = node.children[choice].load(std::memory_order_acquire);
+        path[pathLength++] = index;
+        mNodes[index].virtualLoss.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    float reward = aborted ? -1.0f : rollout(worker, depth, foodScore, discount, alive);
+    aborted = reward < 0.0f;
+
+    // 回传：去掉虚拟损失，加上这一次的访问和得分 (放弃的模拟只去掉虚拟损失)
+    uint64_t value = aborted ? 0 : static_cast<uint64_t>(reward * VALUE_SCALE);
+    for (int i = 0; i < pathLength; i++)
+    {
+        Node &node = mNodes[path[i]];
+        if (!aborted)
+        {
+            node.value.fetch_add(value, std::memory_order_relaxed);
+            node.visits.fetch_add(1, std::memory_order_relaxed);
+        }
+        node.virtualLoss.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return !aborted;
+}
+
+// 随机模拟：大多数时候按贪心策略移动，其余时候随机选择一个安全的方向
+// 得分 = 0.6 * 存活的比例 + 0.4 * 吃到的食物 (按移动次数折扣，两个封顶)
+float MctsBot::rollout(Worker &worker, int depth, float foodScore, float discount, bool alive)
+{
+    Simulation &state = *worker.state;
+    const Direction directions[4] = {Direction::Up, Direction::Down, Direction::Left, Direction::Right};
+    while (alive && depth < mConfig.rolloutMoves)
+    {
+        if (expired(depth))
+        {
+            return -1.0f;
+        }
+        Direction current = state.getSnake().getDirection();
+        Direction direction;
+        if (worker.random.nextInt(1000) < static_cast<int>(mConfig.rolloutGreedy * 1000))
+        {
+            direction = mGreedy.choose(state);
+        }
+        else
+        {
+            Direction safe[3];
+            int count = 0;
+            for (Direction candidate : directions)
+            {
+                CellIndex cell;
+                if (candidate != opposite(current) && mGreedy.nextCell(state, candidate, cell) &&
+                    mGreedy.isSafe(state, cell))
+                {
+                    safe[count++] = candidate;
+                }
+            }
+            direction = count > 0 ? safe[worker.random.nextInt(count)] : current;
+        }
+        int length = state.getSnake().getLength();
+        state.addDirectionToQueue(direction);
+        alive = state.advanceMove();
+        depth++;
+        discount *= FOOD_DISCOUNT;
+        if (state.getSnake().getLength() > length)
+        {
+            foodScore += discount;
+        }
+    }
+    float survival = alive ? 1.0f : static_cast<float>(depth) / mConfig.rolloutMoves;
+    return 0.6f * survival + 0.4f * std::min(1.0f, foodScore / 2.0f);
+}
+
+// UCT：平均得分加上探索项，虚拟损失算作得分为 0 的访问；没有访问过的子节点优先
+int MctsBot::select(const Node &node, Direction current) const
+{
+    double parentVisits = node.visits.load(std::memory_order_relaxed) + node.virtualLoss.load(std::memory_order_relaxed);
+    double logParent = std::log(std::max(1.0, parentVisits));
+    int best = -1;
+    double bestScore = -1.0;
+    for (int i = 0; i < 4; i++)
+    {
+        int32_t child = node.children[i].load(std::memory_order_relaxed);
+        if (child < 0 || static_cast<Direction>(i) == opposite(current))
+        {
+            continue;
+        }
+        const Node &candidate = mNodes[child];
+        double visits = candidate.visits.load(std::memory_order_relaxed) +
+                        candidate.virtualLoss.load(std::memory_order_relaxed);
+        if (visits == 0)
+        {
+            return i;
+        }
+        double mean = candidate.value.load(std::memory_order_relaxed) / static_cast<double>(VALUE_SCALE) / visits;
+        double score = mean + mConfig.exploration * std::sqrt(logParent / visits);
+        if (score > bestScore)
+        {
+            best = i;
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+// 展开：为每个不掉头的方向创建子节点，节点池用完时保持未展开
+void MctsBot::expand(Node &node, Direction current)
+{
+    int32_t children[4] = {-1, -1, -1, -1};
+    for (int i = 0; i < 4; i++)
+    {
+        if (static_cast<Direction>(i) == opposite(current))
+        {
+            continue;
+        }
+        children[i] = allocateNode();
+        if (children[i] < 0)
+        {
+            node.state.store(0, std::memory_order_release);
+            return;
+        }
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        node.children[i].store(children[i], std::memory_order_relaxed);
+    }
+    node.state.store(2, std::memory_order_release);
+}
+
+// 从节点池中取出一个节点，池用完时返回 -1
+int32_t MctsBot::allocateNode()
+{
+    int32_t index = mNodeCount.fetch_add(1, std::memory_order_relaxed);
+    if (index >= static_cast<int32_t>(mNodes.size()))
+    {
+        return -1;
+    }
+    Node &node = mNodes[index];
+    for (int i = 0; i < 4; i++)
+    {
+        node.children[i].store(-1, std::memory_order_relaxed);
+    }
+    node.visits.store(0, std::memory_order_relaxed);
+    node.virtualLoss.store(0, std::memory_order_relaxed);
+    node.value.store(0, std::memory_order_relaxed);
+    node.state.store(0, std::memory_order_relaxed);
+    return index;
+}
+
+// 清空树
+void MctsBot::resetTree()
+{
+    mNodeCount.store(0, std::memory_order_relaxed);
+    mRoot = allocateNode();
+}
+
+// 蛇按上一次选择的方向移动了一步时，以对应的子节点为新的根；否则 (或节点池用了一半以上) 清空树
+// 子树之外的节点不回收，节点池用了一半以上时清空，保证新的一次搜索有足够的节点
+void MctsBot::updateRoot(const Simulation &simulation)
+{
+    const Node &root = mNodes[mRoot];
+    int32_t child = -1;
+    if (mLastChoice != Direction::None && root.state.load(std::memory_order_acquire) == 2 &&
+        simulation.getSnake().getHead() == mExpectedHead)
+    {
+        child = root.children[static_cast<int>(mLastChoice)].load(std::memory_order_relaxed);
+    }
+    mLastChoice = Direction::None;
+    if (child >= 0 && mNodeCount.load(std::memory_order_relaxed) < static_cast<int32_t>(mNodes.size() / 2))
+    {
+        mRoot = child;
+    }
+    else
+    {
+        resetTree();
+    }
+}
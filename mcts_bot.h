@@ -0,0 +1,131 @@
+#ifndef MCTS_BOT_H
+#define MCTS_BOT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "greedy_bot.h"
+#include "simulation.h"
+
+// 搜索参数
+struct MctsConfig
+{
+    int threads = 0;            // 搜索线程数 (包括调用 choose 的线程)，0 表示按可用的 CPU 核数，不超过可用的核数
+    int budgetMicros = 2000;    // 每次决策的时间上限 (微秒)
+    int rolloutMoves = 40;      // 从根开始每次模拟的最大移动次数 (树内加上随机模拟)
+    int maxNodes = 1 << 18;     // 节点池大小，用完之后不再展开
+    float exploration = 0.7f;   // UCT 的探索系数
+    float rolloutGreedy = 0.85f; // 随机模拟中按贪心策略移动的概率，其余随机转向
+    uint64_t seed = 1;
+};
+
+// 一次决策的统计
+struct MctsStats
+{
+    uint64_t rollouts = 0;     // 本次决策完成的模拟次数
+    uint64_t reusedVisits = 0; // 从上一次搜索继承的根节点访问次数
+    int nodes = 0;             // 节点池中已经使用的节点数
+    double seconds = 0.0;      // 本次决策的耗时
+    int threads = 0;
+};
+
+// 蒙特卡洛树搜索机器人：每次移动之后从当前局面出发，在时间上限内反复模拟之后的几十步，选择访问次数最多的方向
+// 食物的位置和种类由 Simulation 的随机数决定，机器人不应该知道：每次模拟都给复制的局面换一个随机数种子，
+// 树的节点只对应移动序列 (open-loop)，同一个节点下不同的模拟看到不同的食物，节点的平均得分就是对随机食物的期望；
+// 随机模拟按移动推进 (advanceMove)，加速、减速效果的到期时间也随之推算
+// 多个线程共享一棵树，节点的统计是原子变量，选择路径时加上虚拟损失 (virtual loss) 避免所有线程挤在同一条路径上
+// 选中方向之后保留对应的子树，蛇按这个方向移动了一步时下一次决策从子树继续搜索
+class MctsBot
+{
+public:
+    explicit MctsBot(const Simulation &prototype, const MctsConfig &config = MctsConfig());
+    ~MctsBot();
+
+    // 在蛇每次移动之后调用，返回下一次移动的方向；最多使用 budgetMicros 的时间
+    // (模拟中每隔 DEADLINE_CHECK_MOVES 次移动检查一次截止时间，超出不到这么多次移动的时间)
+    Direction choose(const Simulation &simulation);
+    // 最近一次决策的统计
+    const MctsStats &getStats() const;
+    int getThreads() const;
+    // 本进程可以使用的 CPU 核数 (考虑 CPU 亲和性)
+    static int availableCores();
+
+private:
+    // 树的节点：对应从根开始的一个移动序列，children 按 Direction 保存子节点的下标 (-1 表示没有)
+    struct Node
+    {
+        std::atomic<int32_t> children[4];
+        std::atomic<uint32_t> visits;
+        std::atomic<int32_t> virtualLoss;
+        std::atomic<uint64_t> value; // 得分之和，定点数 (VALUE_SCALE 为 1.0)
+        std::atomic<uint8_t> state;  // 0 未展开，1 正在展开，2 已展开
+    };
+    static const uint64_t VALUE_SCALE = 1 << 20;
+    // 路径的最大长度
+    static const int MAX_PATH = 256;
+    // 模拟中每隔这么多次移动检查一次截止时间，到期时放弃这一次模拟
+    static const int DEADLINE_CHECK_MOVES = 4;
+
+    // 每个搜索线程的复制局面和随机数
+    struct Worker
+    {
+        std::unique_ptr<Simulation> state;
+        Random random;
+        uint64_t rollouts = 0;
+    };
+
+    const MctsConfig mConfig;
+    const int mThreads;
+    GreedyBot mGreedy;
+
+    // 节点池和根
+    std::vector<Node> mNodes;
+    std::atomic<int32_t> mNodeCount{0};
+    int32_t mRoot = -1;
+    // 上一次选择的方向和预期的蛇头位置，用于判断能否复用子树
+    Direction mLastChoice = Direction::None;
+    CellIndex mExpectedHead = NO_CELL;
+
+    // 当前决策的根局面
+    std::unique_ptr<Simulation> mRootState;
+    std::vector<Worker> mWorkers;
+    MctsStats mStats;
+
+    // 搜索线程：每一代 (一次决策) 开始时唤醒，到截止时间后报告完成
+    std::vector<std::thread> mThreadPool;
+    std::mutex mMutex;
+    std::condition_variable mStart;
+    std::condition_variable mDone;
+    uint64_t mGeneration = 0;
+    int mRunning = 0;
+    bool mQuit = false;
+    int64_t mDeadline = 0; // 截止时间 (steady_clock 纳秒)
+
+    void threadMain(int index);
+    // 在截止时间之前反复模拟
+    void search(Worker &worker);
+    // 一次模拟：选择、展开、随机模拟和回传，到截止时间放弃时返回 false
+    bool iterate(Worker &worker);
+    // 从树内的最后一步继续随机模拟，返回这一次模拟的得分 [0, 1]，到截止时间放弃时返回负数
+    float rollout(Worker &worker, int depth, float foodScore, float discount, bool alive);
+    // 第 depth 次移动之前是否已经过了截止时间 (每隔 DEADLINE_CHECK_MOVES 次移动读取一次时钟)
+    bool expired(int depth) const;
+    // 按 UCT 选择方向 (包括虚拟损失)，没有合法的子节点时返回 -1
+    int select(const Node &node, Direction current) const;
+    void expand(Node &node, Direction current);
+    int32_t allocateNode();
+    // 清空树，只保留一个新的根
+    void resetTree();
+    // 根据上一次的选择和当前局面，复用子树或清空树
+    void updateRoot(const Simulation &simulation);
+
+    MctsBot(const MctsBot &) = delete;
+    MctsBot &operator=(const MctsBot &) = delete;
+};
+
+#endif
@@ -0,0 +1,475 @@
+#include <algorithm>
+#include <tuple>
+
+#include "reference_simulation.h"
+
+// 规则中的常量 (与 Simulation 相同，在这里重新写出)
+static const float EFFECT_TICK = 0.01f;        // 计时单位 (秒)
+static const uint32_t EFFECT_DURATION = 1000;  // 特殊效果持续的计时单位
+static const uint64_t MAX_DELAY = (1 << 24) - 1; // 最长的定时
+static const float MOVE_EPSILON = 1e-5f;       // 只差这么一点就到移动的时刻时也移动
+static const size_t MAX_QUEUE = 3;             // 方向输入缓冲的容量
+
+// 构造函数
+ReferenceSimulation::ReferenceSimulation(int gameBoardWidth, int gameBoardHeight, int initialSnakeLength)
+    : mColumns(gameBoardWidth / GRID_SIZE),
+      mRows(gameBoardHeight / GRID_SIZE),
+      mInitialSnakeLength(initialSnakeLength)
+{
+}
+
+void ReferenceSimulation::setFoodOptions(int count, uint32_t lifetimeTicks)
+{
+    mFoodCount = count < 1 ? 1 : count;
+    mFoodLifetime = lifetimeTicks;
+}
+
+// 开始新的一局：蛇在游戏区域中心，向下延伸，方向向上
+void ReferenceSimulation::reset(GameMode mode, Difficulty difficulty, MapType mapType, uint64_t seed)
+{
+    mGameMode = mode;
+    mRandom.seed(seed);
+    mBody.clear();
+    for (int i = 0; i < mInitialSnakeLength; i++)
+    {
+        mBody.push_back(Cell(mColumns / 2, mRows / 2 + i));
+    }
+    mDirection = Direction::Up;
+    mAccumulatedTime = 0.0f;
+    mDirectionQueue.clear();
+    mCurrentDirection = Direction::Up;
+    mMoveCount = 0;
+
+    mBaseSpeed = difficulty == Difficulty::Hard ? 30.0f : 15.0f;
+    mObstacles.clear();
+    if (mapType == MapType::Obstacles)
+    {
+        for (int i = 0; i < 5; i++)
+        {
+            mObstacles.push_back(Cell(5, i));
+        }
+        mObstacles.push_back(Cell(10, 15));
+    }
+
+    mEffects.clear();
+    mEffectAccumulator = 0.0f;
+    mNow = 0;
+    updateSpeed();
+
+    mPoints = 0;
+    mDifficulty = 0;
+    mGameOver = false;
+    mFoods.clear();
+    spawnFood();
+}
+
+void ReferenceSimulation::setBaseSpeed(float speed)
+{
+    mBaseSpeed = std::max(speed, 0.1f);
+    updateSpeed();
+}
+
+void ReferenceSimulation::setMaxMovesPerTick(int moves)
+{
+    mMaxMovesPerTick = std::max(1, moves);
+}
+
+void ReferenceSimulation::setMaxTickTime(float seconds)
+{
+    mMaxTickTime = std::max(0.0f, seconds);
+}
+
+Direction ReferenceSimulation::opposite(Direction direction)
+{
+    switch (direction)
+    {
+    case Direction::Up:
+        return Direction::Down;
+    case Direction::Down:
+        return Direction::Up;
+    case Direction::Left:
+        return Direction::Right;
+    case Direction::Right:
+        return Direction::Left;
+    default:
+        return Direction::None;
+    }
+}
+
+void ReferenceSimulation::changeDirection(Direction newDirection)
+{
+    if (mDirection == Direction::None || newDirection != opposite(mDirection))
+    {
+        mDirection = newDirection;
+    }
+}
+
+// 缓冲最多 3 个输入，与缓冲中最后一个输入 (缓冲为空时与当前方向) 相反的输入被丢弃
+void ReferenceSimulation::addDirectionToQueue(Direction newDirection)
+{
+    Direction last = mDirectionQueue.empty() ? mCurrentDirection : mDirectionQueue.back();
+    if (mDirectionQueue.size() < MAX_QUEUE && newDirection != opposite(last))
+    {
+        mDirectionQueue.push_back(newDirection);
+    }
+}
+
+void ReferenceSimulation::togglePause()
+{
+    if (mDirection == Direction::None)
+    {
+        changeDirection(mCurrentDirection);
+    }
+    else
+    {
+        mCurrentDirection = mDirection;
+        changeDirection(Direction::None);
+    }
+}
+
+bool ReferenceSimulation::isPartOfSnake(const Cell &cell) const
+{
+    for (const Cell &part : mBody)
+    {
+        if (part == cell)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ReferenceSimulation::isFood(const Cell &cell) const
+{
+    for (const Food &food : mFoods)
+    {
+        if (food.cell == cell)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 创建随机食物：随机数的使用顺序就是规则的一部分
+bool ReferenceSimulation::createRamdomFood()
+{
+    Cell cell;
+    bool found = false;
+    for (int attempt = 0; attempt < 64 && !found; attempt++)
+    {
+        int foodX = mRandom.nextInt(mColumns - 2) + 1;
+        int foodY = mRandom.nextInt(mRows - 2) + 1;
+        cell = Cell(foodX, foodY);
+        found = !isPartOfSnake(cell) && !isFood(cell);
+    }
+    if (!found)
+    {
+        const int cells = (mColumns - 2) * (mRows - 2);
+        const int start = mRandom.nextInt(cells);
+        for (int i = 0; i < cells && !found; i++)
+        {
+            int index = (start + i) % cells;
+            cell = Cell(index % (mColumns - 2) + 1, index / (mColumns - 2) + 1);
+            found = !isPartOfSnake(cell) && !isFood(cell);
+        }
+    }
+    if (!found)
+    {
+        return false;
+    }
+    FoodType type = static_cast<FoodType>(mRandom.nextInt(4));
+    mFoods.push_back({cell, type, mFoodLifetime > 0 ? deadline(mFoodLifetime) : 0});
+    return true;
+}
+
+void ReferenceSimulation::spawnFood()
+{
+    while (static_cast<int>(mFoods.size()) < mFoodCount && createRamdomFood())
+    {
+    }
+}
+
+uint64_t ReferenceSimulation::deadline(uint32_t delayTicks) const
+{
+    return mNow + std::min<uint64_t>(std::max<uint32_t>(delayTicks, 1), MAX_DELAY);
+}
+
+// 吃掉第 index 个食物
+void ReferenceSimulation::eatFood(size_t index)
+{
+    Food food = mFoods[index];
+    mFoods.erase(mFoods.begin() + index);
+    if (food.type == FoodType::Normal)
+    {
+        mPoints++;
+    }
+    else
+    {
+        mEffects.push_back({food.type, deadline(EFFECT_DURATION)});
+        updateSpeed();
+    }
+    mPoints += getActiveEffects(FoodType::DoublePoints) > 0 ? 2 : 1;
+
+    mDifficulty = mPoints / 5;
+    if (mPoints % 5 == 0)
+    {
+        mBaseSpeed += 0.5f;
+        updateSpeed();
+    }
+    spawnFood();
+}
+
+// 速度 = (基础速度 + 5 * 加速层数) * 0.8 ^ 减速层数
+void ReferenceSimulation::updateSpeed()
+{
+    float speed = mBaseSpeed + 5.0f * getActiveEffects(FoodType::SpeedUp);
+    for (int i = 0; i < getActiveEffects(FoodType::SlowDown); i++)
+    {
+        speed *= 0.8f;
+    }
+    mSpeed = speed;
+}
+
+// 推进计时：先推进到最后一个计时单位，再按顺序处理这期间到期的特殊效果和食物
+void ReferenceSimulation::updateEffects(float deltaTime)
+{
+    mEffectAccumulator += deltaTime;
+    uint32_t ticks = static_cast<uint32_t>(mEffectAccumulator / EFFECT_TICK);
+    if (ticks == 0)
+    {
+        return;
+    }
+    mEffectAccumulator -= ticks * EFFECT_TICK;
+    mNow += ticks;
+
+    // (到期时间, 0 = 特殊效果 / 1 = 食物, 类型或行, 列)
+    std::vector<std::tuple<uint64_t, int, int, int>> expired;
+    for (const Effect &effect : mEffects)
+    {
+        if (effect.expires <= mNow)
+        {
+            expired.push_back(std::make_tuple(effect.expires, 0, static_cast<int>(effect.type), 0));
+        }
+    }
+    for (const Food &food : mFoods)
+    {
+        if (food.expires != 0 && food.expires <= mNow)
+        {
+            expired.push_back(std::make_tuple(food.expires, 1, food.cell.second, food.cell.first));
+        }
+    }
+    std::sort(expired.begin(), expired.end());
+
+    for (const auto &timer : expired)
+    {
+        if (std::get<1>(timer) == 0)
+        {
+            // 去掉一层这种效果
+            for (size_t i = 0; i < mEffects.size(); i++)
+            {
+                if (mEffects[i].expires <= mNow && static_cast<int>(mEffects[i].type) == std::get<2>(timer))
+                {
+                    mEffects.erase(mEffects.begin() + i);
+                    break;
+                }
+            }
+            updateSpeed();
+            continue;
+        }
+        Cell cell(std::get<3>(timer), std::get<2>(timer));
+        for (size_t i = 0; i < mFoods.size(); i++)
+        {
+            if (mFoods[i].cell == cell)
+            {
+                mFoods.erase(mFoods.begin() + i);
+                spawnFood();
+                break;
+            }
+        }
+    }
+}
+
+// 应用一个方向输入，移动一步，先吃食物再检查碰撞
+bool ReferenceSimulation::move()
+{
+    if (!mDirectionQueue.empty())
+    {
+        Direction input = mDirectionQueue.front();
+        mDirectionQueue.pop_front();
+        if (input != opposite(mCurrentDirection))
+        {
+            changeDirection(input);
+            mCurrentDirection = input;
+        }
+    }
+    int dx = 0;
+    int dy = 0;
+    switch (mDirection)
+    {
+    case Direction::Up:
+        dy = -1;
+        break;
+    case Direction::Down:
+        dy = 1;
+        break;
+    case Direction::Left:
+        dx = -1;
+        break;
+    case Direction::Right:
+        dx = 1;
+        break;
+    case Direction::None:
+        return true; // 暂停
+    }
+    mMoveCount++;
+
+    // 新蛇头：无边界模式从另一侧进入
+    Cell head(mBody.front().first + dx, mBody.front().second + dy);
+    if (mGameMode == GameMode::Unbounded)
+    {
+        head.first = (head.first % mColumns + mColumns) % mColumns;
+        head.second = (head.second % mRows + mRows) % mRows;
+    }
+
+    size_t eaten = mFoods.size();
+    for (size_t i = 0; i < mFoods.size(); i++)
+    {
+        if (mFoods[i].cell == head)
+        {
+            eaten = i;
+            break;
+        }
+    }
+    mBody.push_front(head);
+    if (eaten < mFoods.size())
+    {
+        eatFood(eaten);
+    }
+    else
+    {
+        mBody.pop_back();
+    }
+
+    bool hitWall = head.first < 0 || head.first >= mColumns || head.second < 0 || head.second >= mRows;
+    bool hitSelf = std::find(mBody.begin() + 1, mBody.end(), head) != mBody.end();
+    bool hitObstacle = std::find(mObstacles.begin(), mObstacles.end(), head) != mObstacles.end();
+    if (hitWall || hitSelf || hitObstacle)
+    {
+        mGameOver = true;
+        return false;
+    }
+    return true;
+}
+
+// 按经过的时间移动，特殊效果计时推进到每次移动的时刻
+bool ReferenceSimulation::tick(float deltaTime)
+{
+    if (mGameOver)
+    {
+        return false;
+    }
+    // 设置了上限时更长的卡顿只推进上限的时间，否则全部推进；剩余时间用 double (一次移动几千步时 float 的误差太大)
+    double remaining = std::max(deltaTime, 0.0f);
+    if (mMaxTickTime > 0.0f && remaining > mMaxTickTime)
+    {
+        remaining = mMaxTickTime;
+    }
+    int moves = 0;
+    while (true)
+    {
+        const float moveInterval = 1.0f / mSpeed;
+        const float accumulated = mAccumulatedTime;
+        if (accumulated + remaining + MOVE_EPSILON < moveInterval)
+        {
+            break;
+        }
+        if (moves >= mMaxMovesPerTick)
+        {
+            // 一次最多移动的次数：丢弃多余的时间
+            mThrottledTicks++;
+            mAccumulatedTime = std::min(static_cast<float>(accumulated + remaining), moveInterval);
+            updateEffects(static_cast<float>(remaining));
+            return true;
+        }
+        float untilMove = std::min(std::max(moveInterval - accumulated, 0.0f), static_cast<float>(remaining));
+        remaining -= untilMove;
+        // 等待期间特殊效果到期改变了速度：按新的速度重新计算移动的时刻
+        const float speed = mSpeed;
+        updateEffects(untilMove);
+        if (mSpeed != speed)
+        {
+            mAccumulatedTime = accumulated + untilMove;
+            continue;
+        }
+        mAccumulatedTime = accumulated + untilMove - moveInterval;
+        moves++;
+        if (!move())
+        {
+            return false;
+        }
+    }
+    mAccumulatedTime = static_cast<float>(mAccumulatedTime + remaining);
+    updateEffects(static_cast<float>(remaining));
+    return true;
+}
+
+bool ReferenceSimulation::isGameOver() const
+{
+    return mGameOver;
+}
+
+const std::deque<ReferenceSimulation::Cell> &ReferenceSimulation::getBody() const
+{
+    return mBody;
+}
+
+Direction ReferenceSimulation::getDirection() const
+{
+    return mDirection;
+}
+
+float ReferenceSimulation::getSpeed() const
+{
+    return mSpeed;
+}
+
+float ReferenceSimulation::getAccumulatedTime() const
+{
+    return mAccumulatedTime;
+}
+
+const std::vector<ReferenceSimulation::Food> &ReferenceSimulation::getFoods() const
+{
+    return mFoods;
+}
+
+int ReferenceSimulation::getPoints() const
+{
+    return mPoints;
+}
+
+int ReferenceSimulation::getDifficulty() const
+{
+    return mDifficulty;
+}
+
+int ReferenceSimulation::getActiveEffects(FoodType type) const
+{
+    int count = 0;
+    for (const Effect &effect : mEffects)
+    {
+        count += effect.type == type ? 1 : 0;
+    }
+    return count;
+}
+
+uint64_t ReferenceSimulation::getMoveCount() const
+{
+    return mMoveCount;
+}
+
+uint64_t ReferenceSimulation::getThrottledTicks() const
+{
+    return mThrottledTicks;
+}
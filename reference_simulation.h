@@ -0,0 +1,120 @@
+#ifndef REFERENCE_SIMULATION_H
+#define REFERENCE_SIMULATION_H
+
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "snake.h"      // 模式、难度、地图、方向和食物类型的枚举
+#include "simulation.h" // Random：随机数的使用顺序是规则的一部分，参考模型只与 Simulation 共用它
+
+// 参考模型：用最直接的写法实现与 Simulation 相同的游戏规则，用于差分测试
+// 不使用 Simulation 和 Snake 中任何优化过的实现：蛇身是坐标 (x, y) 的双端队列，新蛇头按方向加减坐标、
+// 无边界模式取模绕回，撞墙、撞到自己、障碍物和食物都逐个比较坐标；食物和特殊效果是普通的数组，
+// 到期时间直接保存在元素中 (没有格子编号、查表、SIMD 扫描、哈希、时间轮和特化的移动步骤)
+// 规则的定义以这里为准：Simulation 的任何优化都不能改变 tick 之后的状态
+//   - 食物在外圈以内随机放置：先随机尝试 64 次，再从随机位置开始顺序查找，然后随机选择类型
+//   - 吃到食物时蛇身增长，普通食物多得 1 分，特殊食物开始一层效果；得分翻倍时得 2 分，否则得 1 分；
+//     每 5 分升一级，基础速度增加 0.5；然后补充食物；吃到食物之后才检查碰撞
+//   - 特殊效果和有寿命的食物按计时单位到期，同一次推进中到期的按到期时间处理，同一时刻到期的
+//     先处理特殊效果 (按类型)，再按行、列处理食物；推进结束之后才处理，新的定时从推进之后的时刻开始计算
+//   - 按经过的时间移动：每次移动之前读取速度，特殊效果计时推进到移动的时刻 (浮点运算的顺序也是规则的一部分)
+class ReferenceSimulation
+{
+public:
+    // 格子坐标 (x, y)
+    typedef std::pair<int, int> Cell;
+
+    // 游戏区域宽度和高度 (像素) 和蛇的初始长度，与 Simulation 相同
+    ReferenceSimulation(int gameBoardWidth, int gameBoardHeight, int initialSnakeLength);
+
+    void setFoodOptions(int count, uint32_t lifetimeTicks);
+    void reset(GameMode mode, Difficulty difficulty, MapType mapType, uint64_t seed);
+    void setBaseSpeed(float speed);
+    void setMaxMovesPerTick(int moves);
+    // 一次 tick 最多推进的时间 (秒)，0 表示不限制
+    void setMaxTickTime(float seconds);
+
+    void addDirectionToQueue(Direction newDirection);
+    void togglePause();
+    // 一个逻辑帧，返回 false 表示游戏结束
+    bool tick(float deltaTime);
+
+    // 一个食物
+    struct Food
+    {
+        Cell cell;
+        FoodType type;
+        uint64_t expires; // 到期的计时单位，0 表示永不消失
+    };
+
+    bool isGameOver() const;
+    // 蛇身，第一个是蛇头 (撞墙时蛇头在游戏区域外一格)
+    const std::deque<Cell> &getBody() const;
+    Direction getDirection() const;
+    float getSpeed() const;
+    float getAccumulatedTime() const;
+    const std::vector<Food> &getFoods() const;
+    int getPoints() const;
+    int getDifficulty() const;
+    int getActiveEffects(FoodType type) const;
+    uint64_t getMoveCount() const;
+    uint64_t getThrottledTicks() const;
+
+private:
+    // 游戏区域宽度和高度 (格子)
+    const int mColumns;
+    const int mRows;
+    const int mInitialSnakeLength;
+
+    GameMode mGameMode = GameMode::Bounded;
+    Random mRandom;
+    std::deque<Cell> mBody;
+    Direction mDirection = Direction::Up;
+    float mSpeed = 15.0f;
+    float mAccumulatedTime = 0.0f;
+    std::vector<Cell> mObstacles;
+    std::vector<Food> mFoods;
+    int mFoodCount = 1;
+    uint32_t mFoodLifetime = 0;
+
+    // 方向输入缓冲
+    std::deque<Direction> mDirectionQueue;
+    Direction mCurrentDirection = Direction::Up;
+
+    // 特殊效果：每一层一个到期时间
+    struct Effect
+    {
+        FoodType type;
+        uint64_t expires;
+    };
+    std::vector<Effect> mEffects;
+    float mBaseSpeed = 15.0f;
+    float mEffectAccumulator = 0.0f;
+    uint64_t mNow = 0;
+
+    int mPoints = 0;
+    int mDifficulty = 0;
+    bool mGameOver = false;
+    int mMaxMovesPerTick = 64;
+    float mMaxTickTime = 0.0f;
+    uint64_t mThrottledTicks = 0;
+    uint64_t mMoveCount = 0;
+
+    static Direction opposite(Direction direction);
+    // 蛇自己的转向规则：不能直接掉头，暂停时可以转向任何方向
+    void changeDirection(Direction newDirection);
+    bool isPartOfSnake(const Cell &cell) const;
+    bool isFood(const Cell &cell) const;
+    bool createRamdomFood();
+    void spawnFood();
+    // 从现在开始 delayTicks 个计时单位之后的时刻
+    uint64_t deadline(uint32_t delayTicks) const;
+    void eatFood(size_t index);
+    void updateSpeed();
+    void updateEffects(float deltaTime);
+    bool move();
+};
+
+#endif
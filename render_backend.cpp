@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "render_backend.h"
+#include "frame_capture.h"
+
+// 默认实现：颜色相同的连续矩形合并成一次 fillRects
+void RenderBackend::fillColoredRects(const RenderRect *rects, const RenderColor *colors, int count)
+{
+    int begin = 0;
+    while (begin < count)
+    {
+        RenderColor color = colors[begin];
+        int end = begin + 1;
+        while (end < count && colors[end].r == color.r && colors[end].g == color.g && colors[end].b == color.b &&
+               colors[end].a == color.a)
+        {
+            end++;
+        }
+        setColor(color);
+        fillRects(rects + begin, end - begin);
+        begin = end;
+    }
+}
+
+// 空后端：只统计图元
+void NullRenderBackend::setColor(RenderColor)
+{
+}
+
+void NullRenderBackend::clear()
+{
+    mStats.clears++;
+}
+
+void NullRenderBackend::fillRects(const RenderRect *, int count)
+{
+    mStats.rects += count;
+    mStats.rectCalls++;
+}
+
+void NullRenderBackend::fillColoredRects(const RenderRect *, const RenderColor *, int count)
+{
+    mStats.rects += count;
+    mStats.rectCalls++;
+}
+
+void NullRenderBackend::drawLine(int, int, int, int)
+{
+    mStats.lines++;
+}
+
+void NullRenderBackend::drawText(const std::string &, int, int, RenderColor)
+{
+    mStats.texts++;
+}
+
+void NullRenderBackend::getTextSize(const std::string &text, int &width, int &height)
+{
+    width = static_cast<int>(text.size()) * SoftwareRenderBackend::GLYPH_WIDTH;
+    height = SoftwareRenderBackend::GLYPH_HEIGHT;
+}
+
+void NullRenderBackend::beginStaticLayer()
+{
+}
+
+void NullRenderBackend::endStaticLayer()
+{
+}
+
+void NullRenderBackend::drawStaticLayer()
+{
+    mStats.staticLayers++;
+}
+
+void NullRenderBackend::present()
+{
+    mStats.frames++;
+}
+
+// 软件渲染构造函数
+SoftwareRenderBackend::SoftwareRenderBackend(int width, int height)
+    : mWidth(width), mHeight(height),
+      mPixels(static_cast<size_t>(width) * height, 0xFF000000),
+      mPresented(static_cast<size_t>(width) * height, 0xFF000000),
+      mStaticLayer(static_cast<size_t>(width) * height, 0xFF000000)
+{
+}
+
+void SoftwareRenderBackend::setColor(RenderColor color)
+{
+    mColor = (static_cast<uint32_t>(color.a) << 24) | (static_cast<uint32_t>(color.r) << 16) |
+             (static_cast<uint32_t>(color.g) << 8) | color.b;
+}
+
+void SoftwareRenderBackend::clear()
+{
+    std::fill(mPixels.begin(), mPixels.end(), mColor);
+    mStats.clears++;
+}
+
+// 填充矩形，超出画面的部分被裁剪掉
+void SoftwareRenderBackend::fill(int x, int y, int w, int h, uint32_t color)
+{
+    int left = std::max(x, 0);
+    int top = std::max(y, 0);
+    int right = std::min(x + w, mWidth);
+    int bottom = std::min(y + h, mHeight);
+    for (int row = top; row < bottom; row++)
+    {
+        uint32_t *line = mPixels.data() + static_cast<size_t>(row) * mWidth;
+        std::fill(line + left, line + std::max(left, right), color);
+    }
+}
+
+void SoftwareRenderBackend::fillRects(const RenderRect *rects, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        fill(rects[i].x, rects[i].y, rects[i].w, rects[i].h, mColor);
+    }
+    mStats.rects += count;
+    mStats.rectCalls++;
+}
+
+void SoftwareRenderBackend::fillColoredRects(const RenderRect *rects, const RenderColor *colors, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        uint32_t argb = (static_cast<uint32_t>(colors[i].a) << 24) | (static_cast<uint32_t>(colors[i].r) << 16) |
+                        (static_cast<uint32_t>(colors[i].g) << 8) | colors[i].b;
+        fill(rects[i].x, rects[i].y, rects[i].w, rects[i].h, argb);
+    }
+    mStats.rects += count;
+    mStats.rectCalls++;
+}
+
+// 只支持水平线和竖直线 (游戏中只画边框)
+void SoftwareRenderBackend::drawLine(int x1, int y1, int x2, int y2)
+{
+    if (y1 == y2)
+    {
+        fill(std::min(x1, x2), y1, std::abs(x2 - x1) + 1, 1, mColor);
+    }
+    else if (x1 == x2)
+    {
+        fill(x1, std::min(y1, y2), 1, std::abs(y2 - y1) + 1, mColor);
+    }
+    mStats.lines++;
+}
+
+// 每个字符画一个比字符格子略小的方块
+void SoftwareRenderBackend::drawText(const std::string &text, int x, int y, RenderColor color)
+{
+    uint32_t argb = (static_cast<uint32_t>(color.a) << 24) | (static_cast<uint32_t>(color.r) << 16) |
+                    (static_cast<uint32_t>(color.g) << 8) | color.b;
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        if (text[i] != ' ')
+        {
+            fill(x + static_cast<int>(i) * GLYPH_WIDTH + 1, y + 2, GLYPH_WIDTH - 2, GLYPH_HEIGHT - 4, argb);
+        }
+    }
+    mStats.texts++;
+}
+
+void SoftwareRenderBackend::getTextSize(const std::string &text, int &width, int &height)
+{
+    width = static_cast<int>(text.size()) * GLYPH_WIDTH;
+    height = GLYPH_HEIGHT;
+}
+
+// 开始绘制静态层：之后的绘制画到静态层上
+void SoftwareRenderBackend::beginStaticLayer()
+{
+    mPixels.swap(mStaticLayer);
+    std::fill(mPixels.begin(), mPixels.end(), 0xFF000000);
+    mRecordingStatic = true;
+}
+
+void SoftwareRenderBackend::endStaticLayer()
+{
+    if (mRecordingStatic)
+    {
+        mPixels.swap(mStaticLayer);
+        mRecordingStatic = false;
+    }
+}
+
+void SoftwareRenderBackend::drawStaticLayer()
+{
+    std::copy(mStaticLayer.begin(), mStaticLayer.end(), mPixels.begin());
+    mStats.staticLayers++;
+}
+
+// 提交：交换绘制缓冲区和显示缓冲区
+void SoftwareRenderBackend::present()
+{
+    mPixels.swap(mPresented);
+    if (mCapture != nullptr)
+    {
+        mCapture->captureArgb(mPresented.data());
+    }
+    mStats.frames++;
+}
+
+int SoftwareRenderBackend::getWidth() const
+{
+    return mWidth;
+}
+
+int SoftwareRenderBackend::getHeight() const
+{
+    return mHeight;
+}
+
+const std::vector<uint32_t> &SoftwareRenderBackend::getPixels() const
+{
+    return mPresented;
+}
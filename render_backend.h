@@ -0,0 +1,156 @@
+#ifndef RENDER_BACKEND_H
+#define RENDER_BACKEND_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 颜色和矩形，与 SDL_Color / SDL_Rect 的布局相同，但不依赖 SDL
+struct RenderColor
+{
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t a;
+};
+
+struct RenderRect
+{
+    int x;
+    int y;
+    int w;
+    int h;
+};
+
+class FrameCapture;
+
+// 提交的绘制图元统计
+struct RenderStats
+{
+    uint64_t frames = 0;
+    uint64_t clears = 0;
+    uint64_t rects = 0;     // 填充的矩形数量
+    uint64_t rectCalls = 0; // 填充矩形的调用次数 (批量调用算一次)
+    uint64_t lines = 0;
+    uint64_t texts = 0;
+    uint64_t staticLayers = 0;
+};
+
+// 渲染后端接口：游戏画面的所有绘制都经过这里
+// 实现有 SDL 渲染器 (sdl_render_backend.h)、只计数的空后端和离屏软件渲染
+class RenderBackend
+{
+public:
+    virtual ~RenderBackend() {}
+
+    // 设置之后绘制使用的颜色
+    virtual void setColor(RenderColor color) = 0;
+    // 用当前颜色清空画面
+    virtual void clear() = 0;
+    // 用当前颜色填充多个矩形
+    virtual void fillRects(const RenderRect *rects, int count) = 0;
+    void fillRect(const RenderRect &rect)
+    {
+        fillRects(&rect, 1);
+    }
+    // 填充多个各自带颜色的矩形，一次批量提交 (之后的当前颜色不确定)
+    // 默认实现把颜色相同的连续矩形合并成一次 fillRects
+    virtual void fillColoredRects(const RenderRect *rects, const RenderColor *colors, int count);
+    // 用当前颜色画线 (水平或竖直)
+    virtual void drawLine(int x1, int y1, int x2, int y2) = 0;
+    // 在 (x, y) 处绘制文字 (左上角)
+    virtual void drawText(const std::string &text, int x, int y, RenderColor color) = 0;
+    // 文字的宽度和高度 (像素)
+    virtual void getTextSize(const std::string &text, int &width, int &height) = 0;
+
+    // 静态层：begin 和 end 之间的绘制保存下来，之后每帧用 drawStaticLayer 一次画出
+    virtual void beginStaticLayer() = 0;
+    virtual void endStaticLayer() = 0;
+    virtual void drawStaticLayer() = 0;
+
+    // 提交一帧
+    virtual void present() = 0;
+
+    const RenderStats &getStats() const
+    {
+        return mStats;
+    }
+    void resetStats()
+    {
+        mStats = RenderStats();
+    }
+    // 录像：之后每次提交时把画面交给 capture (大小必须与画面相同)，nullptr 表示停止录像
+    void setFrameCapture(FrameCapture *capture)
+    {
+        mCapture = capture;
+    }
+    // 后端当前持有的纹理数量 (只有 SDL 后端使用纹理)，用于长时间运行时检查纹理泄漏
+    int getLiveTextures() const
+    {
+        return mLiveTextures;
+    }
+
+protected:
+    RenderStats mStats;
+    FrameCapture *mCapture = nullptr;
+    int mLiveTextures = 0;
+};
+
+// 空后端：不绘制任何东西，只统计图元，用于单独测量模拟和提交绘制命令的开销
+class NullRenderBackend : public RenderBackend
+{
+public:
+    void setColor(RenderColor color) override;
+    void clear() override;
+    void fillRects(const RenderRect *rects, int count) override;
+    void fillColoredRects(const RenderRect *rects, const RenderColor *colors, int count) override;
+    void drawLine(int x1, int y1, int x2, int y2) override;
+    void drawText(const std::string &text, int x, int y, RenderColor color) override;
+    void getTextSize(const std::string &text, int &width, int &height) override;
+    void beginStaticLayer() override;
+    void endStaticLayer() override;
+    void drawStaticLayer() override;
+    void present() override;
+};
+
+// 离屏软件渲染：画到内存中的 ARGB8888 像素缓冲区，不需要窗口和显卡
+// 没有字体，文字按每个字符一个实心方块绘制
+class SoftwareRenderBackend : public RenderBackend
+{
+public:
+    static const int GLYPH_WIDTH = 10;
+    static const int GLYPH_HEIGHT = 20;
+
+    SoftwareRenderBackend(int width, int height);
+
+    void setColor(RenderColor color) override;
+    void clear() override;
+    void fillRects(const RenderRect *rects, int count) override;
+    void fillColoredRects(const RenderRect *rects, const RenderColor *colors, int count) override;
+    void drawLine(int x1, int y1, int x2, int y2) override;
+    void drawText(const std::string &text, int x, int y, RenderColor color) override;
+    void getTextSize(const std::string &text, int &width, int &height) override;
+    void beginStaticLayer() override;
+    void endStaticLayer() override;
+    void drawStaticLayer() override;
+    void present() override;
+
+    int getWidth() const;
+    int getHeight() const;
+    // 最近一次提交的画面
+    const std::vector<uint32_t> &getPixels() const;
+
+private:
+    int mWidth;
+    int mHeight;
+    uint32_t mColor = 0xFF000000;
+    std::vector<uint32_t> mPixels;      // 正在绘制的画面
+    std::vector<uint32_t> mPresented;   // 已经提交的画面
+    std::vector<uint32_t> mStaticLayer; // 静态层
+    bool mRecordingStatic = false;
+
+    // 填充一个矩形 (裁剪到画面范围内)
+    void fill(int x, int y, int w, int h, uint32_t color);
+};
+
+#endif
@@ -0,0 +1,261 @@
+#include <algorithm>
+
+#include "safety_oracle.h"
+
+// 构造函数：按格子数分配位棋盘，标记游戏区域内的格子和四条边
+SafetyOracle::SafetyOracle(const CellGrid &grid)
+    : mGrid(grid),
+      mWords((grid.getCellCount() + 63) / 64),
+      mInside(mWords, 0),
+      mFirstColumn(mWords, 0),
+      mLastColumn(mWords, 0),
+      mFirstRow(mWords, 0),
+      mLastRow(mWords, 0),
+      mBlocked(mWords, 0),
+      mBody(mWords, 0),
+      mFree(mWords, 0),
+      mRegion(mWords, 0),
+      mNext(mWords, 0),
+      mShifted(mWords, 0),
+      mFreeTime(grid.getCellCount(), 0)
+{
+    const int columns = grid.getColumns();
+    const int rows = grid.getRows();
+    for (int y = 0; y < rows; y++)
+    {
+        for (int x = 0; x < columns; x++)
+        {
+            setBit(mInside, grid.toCell(x, y));
+        }
+        setBit(mFirstColumn, grid.toCell(0, y));
+        setBit(mLastColumn, grid.toCell(columns - 1, y));
+    }
+    for (int x = 0; x < columns; x++)
+    {
+        setBit(mFirstRow, grid.toCell(x, 0));
+        setBit(mLastRow, grid.toCell(x, rows - 1));
+    }
+}
+
+// 判断四个方向
+void SafetyOracle::evaluate(const Simulation &simulation, MoveSafety result[4])
+{
+    prepare(simulation);
+    for (int i = 0; i < 4; i++)
+    {
+        result[i] = evaluateDirection(simulation, static_cast<Direction>(i));
+    }
+}
+
+// 判断单个方向
+MoveSafety SafetyOracle::evaluate(const Simulation &simulation, Direction direction)
+{
+    prepare(simulation);
+    return evaluateDirection(simulation, direction);
+}
+
+int SafetyOracle::getRegionSize(Direction direction) const
+{
+    return mRegionSizes[static_cast<int>(direction)];
+}
+
+// 蛇身和障碍物的位棋盘 (撞墙后越界的蛇头不在游戏区域内，不需要标记)
+void SafetyOracle::prepare(const Simulation &simulation)
+{
+    std::fill(mBlocked.begin(), mBlocked.end(), 0);
+    std::fill(mBody.begin(), mBody.end(), 0);
+    for (CellIndex cell : simulation.getSnake().getCells())
+    {
+        setBit(mBody, cell);
+    }
+    for (CellIndex cell : simulation.getObstacles())
+    {
+        setBit(mBlocked, cell);
+    }
+    for (size_t i = 0; i < mWords; i++)
+    {
+        mBody[i] &= mInside[i];
+        mBlocked[i] |= mBody[i];
+    }
+    mFreeTimeValid = false;
+}
+
+// 蛇身第 i 节 (蛇头为第 0 节) 还有 长度 - 1 - i 节在它后面
+void SafetyOracle::computeFreeTimes(const Simulation &simulation)
+{
+    const std::vector<CellIndex> &body = simulation.getSnake().getCells();
+    const int length = static_cast<int>(body.size());
+    for (int i = length - 1; i >= 0; i--)
+    {
+        mFreeTime[body[i]] = static_cast<uint16_t>(std::min(length - 1 - i, 0xFFFF));
+    }
+    mFreeTimeValid = true;
+}
+
+// 判断一个方向
+MoveSafety SafetyOracle::evaluateDirection(const Simulation &simulation, Direction direction)
+{
+    const int index = static_cast<int>(direction);
+    mRegionSizes[index] = 0;
+    const Snake &snake = simulation.getSnake();
+    const std::vector<CellIndex> &body = snake.getCells();
+    const Direction opposites[5] = {Direction::Down, Direction::Up, Direction::Right, Direction::Left, Direction::None};
+    const bool wraps = simulation.getGameMode() == GameMode::Unbounded;
+    if (direction == Direction::None || direction == opposites[static_cast<int>(snake.getDirection())])
+    {
+        return MoveSafety::Blocked;
+    }
+    if (!mGrid.isInside(snake.getHead()))
+    {
+        return MoveSafety::Blocked;
+    }
+    CellIndex next = mGrid.neighbor(snake.getHead(), direction);
+    if (!mGrid.isInside(next))
+    {
+        if (!wraps)
+        {
+            return MoveSafety::Blocked;
+        }
+        next = mGrid.wrap(next, direction);
+    }
+
+    // 吃到食物时蛇尾这一步不动；没吃到时可以走进蛇尾的格子
+    const bool grows = simulation.getFoods().find(next) != nullptr;
+    const CellIndex tail = body.back();
+    const int length = static_cast<int>(body.size()) + (grows ? 1 : 0);
+    if (testBit(mBlocked, next) && (grows || next != tail))
+    {
+        return MoveSafety::Blocked;
+    }
+
+    // 移动之后的空格子：蛇尾让出 (没吃到食物时)，蛇头占据 next
+    for (size_t i = 0; i < mWords; i++)
+    {
+        mFree[i] = mInside[i] & ~mBlocked[i];
+    }
+    if (!grows)
+    {
+        setBit(mFree, tail);
+    }
+    clearBit(mFree, next);
+
+    // 洪水填充：每一轮向四个方向扩展一格，区域不再变大或者已经不小于蛇长时停止
+    std::fill(mRegion.begin(), mRegion.end(), 0);
+    setBit(mRegion, next);
+    int count = 0;
+    while (true)
+    {
+        expand(mRegion, mNext, wraps);
+        int grown = 0;
+        for (size_t i = 0; i < mWords; i++)
+        {
+            mNext[i] = (mNext[i] & mFree[i]) | (mRegion[i] & mFree[i]);
+            grown += __builtin_popcountll(mNext[i]);
+        }
+        mRegion.swap(mNext);
+        if (grown == count)
+        {
+            break;
+        }
+        count = grown;
+        // 蛇头可以走 count 步，第 count + 1 步能走进自己刚离开的 next 时 (count + 1 >= 长度) 总是安全
+        if (count + 1 >= length)
+        {
+            mRegionSizes[index] = count;
+            return MoveSafety::Safe;
+        }
+    }
+    mRegionSizes[index] = count;
+
+    // 区域太小：找区域边界上最早让出的蛇身，蛇头在区域里走 count 步之后的下一步能走进它就是安全的
+    // 移动之后原来的第 i 节变成第 i + 1 节，在第 长度 - 1 - i 次移动时成为蛇尾，这一次移动可以走进去
+    if (!mFreeTimeValid)
+    {
+        computeFreeTimes(simulation);
+    }
+    setBit(mRegion, next);
+    expand(mRegion, mNext, wraps);
+    int earliest = length; // next 自己
+    for (size_t i = 0; i < mWords; i++)
+    {
+        uint64_t border = mNext[i] & mBody[i];
+        while (border != 0)
+        {
+            CellIndex cell = static_cast<CellIndex>(i * 64 + __builtin_ctzll(border));
+            border &= border - 1;
+            if (cell == next || (!grows && cell == tail))
+            {
+                continue;
+            }
+            earliest = std::min(earliest, mFreeTime[cell] + (grows ? 1 : 0));
+        }
+    }
+    return earliest <= count + 1 ? MoveSafety::Safe : MoveSafety::Trapped;
+}
+
+// 向四个方向扩展一格；无边界模式下第一列/最后一列、第一行/最后一行的格子另外移到对面
+void SafetyOracle::expand(const std::vector<uint64_t> &region, std::vector<uint64_t> &next, bool wraps)
+{
+    const long stride = mGrid.getStride();
+    std::fill(next.begin(), next.end(), 0);
+    orShifted(next, region, nullptr, 1);
+    orShifted(next, region, nullptr, -1);
+    orShifted(next, region, nullptr, stride);
+    orShifted(next, region, nullptr, -stride);
+    if (wraps)
+    {
+        const long columns = mGrid.getColumns();
+        const long rows = mGrid.getRows();
+        orShifted(next, region, &mLastColumn, -(columns - 1));
+        orShifted(next, region, &mFirstColumn, columns - 1);
+        orShifted(next, region, &mLastRow, -(rows - 1) * stride);
+        orShifted(next, region, &mFirstRow, (rows - 1) * stride);
+    }
+}
+
+// dst |= (src & mask) 移动 shift 位
+void SafetyOracle::orShifted(std::vector<uint64_t> &dst, const std::vector<uint64_t> &src,
+                             const std::vector<uint64_t> *mask, long shift)
+{
+    const uint64_t *source = src.data();
+    if (mask != nullptr)
+    {
+        for (size_t i = 0; i < mWords; i++)
+        {
+            mShifted[i] = src[i] & (*mask)[i];
+        }
+        source = mShifted.data();
+    }
+    const long words = static_cast<long>(mWords);
+    const long wordShift = (shift >= 0 ? shift : -shift) / 64;
+    const int bitShift = static_cast<int>((shift >= 0 ? shift : -shift) % 64);
+    for (long i = 0; i < words; i++)
+    {
+        uint64_t value = 0;
+        if (shift >= 0)
+        {
+            long j = i - wordShift;
+            if (j >= 0)
+            {
+                value = source[j] << bitShift;
+                if (bitShift != 0 && j >= 1)
+                {
+                    value |= source[j - 1] >> (64 - bitShift);
+                }
+            }
+        }
+        else
+        {
+            long j = i + wordShift;
+            if (j < words)
+            {
+                value = source[j] >> bitShift;
+                if (bitShift != 0 && j + 1 < words)
+                {
+                    value |= source[j + 1] << (64 - bitShift);
+                }
+            }
+        }
+        dst[i] |= value;
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef SAFETY_ORACLE_H
+#define SAFETY_ORACLE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "simulation.h"
+
+// 一个方向的安全程度
+enum class MoveSafety : uint8_t
+{
+    Blocked, // 下一步就会撞到墙壁、自身或障碍物 (或者是掉头)
+    Trapped, // 下一步不会撞，但蛇头进入了一个封闭的区域，蛇尾让出空间之前就会无路可走
+    Safe     // 蛇头所在的区域足够大，或者在走满这个区域之前能追上让出来的蛇身
+};
+
+// 蛇尾可达性判断：对四个方向分别判断这一步是否会把蛇头封进出不去的区域
+// 从蛇头的下一个格子出发，在位棋盘 (每个格子一位，与 CellIndex 的编号相同) 上做洪水填充，得到蛇头能到达的空格子 A 个；
+// 移动之后蛇身第 j 节 (蛇头为第 0 节) 在第 长度 - j 次移动时成为蛇尾，这一次移动可以走进去；
+// 区域边界上最早让出的蛇身不晚于第 A + 1 次移动时，蛇头可以在区域里绕圈等到它让出来
+// (移动之后蛇头所在的格子在第 长度 次移动时让出，所以 A + 1 不小于蛇长时总是安全)
+// 这是近似的判断：区域的形状可能让蛇头走不满 A 个格子，基准测试 safety_bench 与小区域上的穷举搜索对比准确率
+// 位棋盘和每个格子的让出时间都是预先分配的缓冲区，判断时不分配内存；同一个 SafetyOracle 不能在多个线程中同时使用
+class SafetyOracle
+{
+public:
+    // 按游戏区域的格子编号规则分配位棋盘
+    explicit SafetyOracle(const CellGrid &grid);
+
+    // 判断四个方向 (按 Direction 的顺序) 的安全程度
+    // 蛇暂停时不排除掉头的方向，掉头走进的是蛇身的第二节，同样是 Blocked (长度为 2 时除外)
+    void evaluate(const Simulation &simulation, MoveSafety result[4]);
+    // 单个方向
+    MoveSafety evaluate(const Simulation &simulation, Direction direction);
+
+    // 最近一次判断中每个方向的区域大小 (Blocked 时为 0，区域足够大时填充提前结束，是不小于蛇长减一的某个值)
+    int getRegionSize(Direction direction) const;
+
+private:
+    const CellGrid mGrid;
+    const size_t mWords;
+    // 游戏区域内的格子，以及第一列、最后一列、第一行、最后一行 (无边界模式穿过边缘)
+    std::vector<uint64_t> mInside;
+    std::vector<uint64_t> mFirstColumn;
+    std::vector<uint64_t> mLastColumn;
+    std::vector<uint64_t> mFirstRow;
+    std::vector<uint64_t> mLastRow;
+    // 判断时使用的缓冲区
+    std::vector<uint64_t> mBlocked; // 蛇身和障碍物
+    std::vector<uint64_t> mBody;    // 蛇身
+    std::vector<uint64_t> mFree;
+    std::vector<uint64_t> mRegion;
+    std::vector<uint64_t> mNext;
+    std::vector<uint64_t> mShifted;
+    // 每个格子上的蛇身在多少次移动之后让出 (只有需要时才计算)
+    std::vector<uint16_t> mFreeTime;
+    bool mFreeTimeValid = false;
+    int mRegionSizes[4] = {0, 0, 0, 0};
+
+    // 准备一次判断：蛇身和障碍物的位棋盘
+    void prepare(const Simulation &simulation);
+    MoveSafety evaluateDirection(const Simulation &simulation, Direction direction);
+    // 计算蛇身每一节的让出时间
+    void computeFreeTimes(const Simulation &simulation);
+    // next = region 向四个方向扩展一格 (无边界模式穿过边缘)
+    void expand(const std::vector<uint64_t> &region, std::vector<uint64_t> &next, bool wraps);
+    // dst |= (src & mask) 移动 shift 位 (正数向高位，负数向低位)
+    void orShifted(std::vector<uint64_t> &dst, const std::vector<uint64_t> &src, const std::vector<uint64_t> *mask,
+                   long shift);
+
+    static void setBit(std::vector<uint64_t> &bits, CellIndex cell)
+    {
+        bits[cell >> 6] |= 1ULL << (cell & 63);
+    }
+    static void clearBit(std::vector<uint64_t> &bits, CellIndex cell)
+    {
+        bits[cell >> 6] &= ~(1ULL << (cell & 63));
+    }
+    static bool testBit(const std::vector<uint64_t> &bits, CellIndex cell)
+    {
+        return (bits[cell >> 6] >> (cell & 63)) & 1;
+    }
+};
+
+#endif
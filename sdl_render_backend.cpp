@@ -0,0 +1,213 @@
+#include <iostream>
+
+#include "sdl_render_backend.h"
+#include "frame_capture.h"
+
+// RenderRect 和 SDL_Rect 的布局相同，可以直接传给 SDL
+static_assert(sizeof(RenderRect) == sizeof(SDL_Rect), "RenderRect 必须与 SDL_Rect 布局相同");
+
+// 构造函数
+SdlRenderBackend::SdlRenderBackend(SDL_Renderer *renderer, TTF_Font *font, int width, int height)
+    : mRenderer(renderer), mFont(font), mWidth(width), mHeight(height)
+{
+    mTextCache.reserve(TEXT_CACHE_SIZE);
+}
+
+// 析构函数，释放静态层和文字纹理
+SdlRenderBackend::~SdlRenderBackend()
+{
+    if (mStaticLayer != nullptr)
+    {
+        SDL_DestroyTexture(mStaticLayer);
+        mLiveTextures--;
+    }
+    for (CachedText &entry : mTextCache)
+    {
+        SDL_DestroyTexture(entry.texture);
+        mLiveTextures--;
+    }
+}
+
+void SdlRenderBackend::setColor(RenderColor color)
+{
+    SDL_SetRenderDrawColor(mRenderer, color.r, color.g, color.b, color.a);
+}
+
+void SdlRenderBackend::clear()
+{
+    SDL_RenderClear(mRenderer);
+    mStats.clears++;
+}
+
+void SdlRenderBackend::fillRects(const RenderRect *rects, int count)
+{
+    SDL_RenderFillRects(mRenderer, reinterpret_cast<const SDL_Rect *>(rects), count);
+    mStats.rects += count;
+    mStats.rectCalls++;
+}
+
+// 带颜色的矩形：SDL 2.0.18 之后转换成三角形，用一次 SDL_RenderGeometry 提交
+void SdlRenderBackend::fillColoredRects(const RenderRect *rects, const RenderColor *colors, int count)
+{
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    mVertices.resize(static_cast<size_t>(count) * 4);
+    mIndices.resize(static_cast<size_t>(count) * 6);
+    for (int i = 0; i < count; i++)
+    {
+        SDL_Color color = {colors[i].r, colors[i].g, colors[i].b, colors[i].a};
+        float left = static_cast<float>(rects[i].x);
+        float top = static_cast<float>(rects[i].y);
+        float right = left + rects[i].w;
+        float bottom = top + rects[i].h;
+        SDL_Vertex *vertex = &mVertices[i * 4];
+        vertex[0] = {{left, top}, color, {0.0f, 0.0f}};
+        vertex[1] = {{right, top}, color, {0.0f, 0.0f}};
+        vertex[2] = {{right, bottom}, color, {0.0f, 0.0f}};
+        vertex[3] = {{left, bottom}, color, {0.0f, 0.0f}};
+        int *index = &mIndices[i * 6];
+        index[0] = i * 4;
+        index[1] = i * 4 + 1;
+        index[2] = i * 4 + 2;
+        index[3] = i * 4;
+        index[4] = i * 4 + 2;
+        index[5] = i * 4 + 3;
+    }
+    SDL_RenderGeometry(mRenderer, nullptr, mVertices.data(), count * 4, mIndices.data(), count * 6);
+    mStats.rects += count;
+    mStats.rectCalls++;
+#else
+    RenderBackend::fillColoredRects(rects, colors, count);
+#endif
+}
+
+void SdlRenderBackend::drawLine(int x1, int y1, int x2, int y2)
+{
+    SDL_RenderDrawLine(mRenderer, x1, y1, x2, y2);
+    mStats.lines++;
+}
+
+// 取得文字的纹理：先查缓存，没有时渲染并放入缓存
+SdlRenderBackend::CachedText *SdlRenderBackend::getTextTexture(const std::string &text, RenderColor color)
+{
+    mTextClock++;
+    CachedText *oldest = nullptr;
+    for (CachedText &entry : mTextCache)
+    {
+        if (entry.text == text && entry.color.r == color.r && entry.color.g == color.g &&
+            entry.color.b == color.b && entry.color.a == color.a)
+        {
+            entry.lastUsed = mTextClock;
+            return &entry;
+        }
+        if (oldest == nullptr || entry.lastUsed < oldest->lastUsed)
+        {
+            oldest = &entry;
+        }
+    }
+
+    SDL_Color sdlColor = {color.r, color.g, color.b, color.a};
+    SDL_Surface *surface = TTF_RenderText_Solid(mFont, text.c_str(), sdlColor);
+    if (surface == nullptr)
+    {
+        std::cerr << "Failed to create text surface! SDL_ttf Error: " << TTF_GetError() << std::endl;
+        return nullptr;
+    }
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(mRenderer, surface);
+    int width = surface->w;
+    int height = surface->h;
+    SDL_FreeSurface(surface);
+    if (texture == nullptr)
+    {
+        std::cerr << "Failed to create text texture! SDL Error: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+    mLiveTextures++;
+
+    CachedText *entry = oldest;
+    if (mTextCache.size() < TEXT_CACHE_SIZE)
+    {
+        mTextCache.push_back(CachedText());
+        entry = &mTextCache.back();
+    }
+    else
+    {
+        SDL_DestroyTexture(entry->texture);
+        mLiveTextures--;
+    }
+    entry->text.assign(text);
+    entry->color = color;
+    entry->texture = texture;
+    entry->width = width;
+    entry->height = height;
+    entry->lastUsed = mTextClock;
+    return entry;
+}
+
+// 渲染文字：使用缓存的纹理，文字不变时每帧不再创建表面和纹理
+void SdlRenderBackend::drawText(const std::string &text, int x, int y, RenderColor color)
+{
+    mStats.texts++;
+    if (mFont == nullptr)
+    {
+        return;
+    }
+    CachedText *entry = getTextTexture(text, color);
+    if (entry == nullptr)
+    {
+        return;
+    }
+    SDL_Rect dstRect = {x, y, entry->width, entry->height};
+    SDL_RenderCopy(mRenderer, entry->texture, nullptr, &dstRect);
+}
+
+void SdlRenderBackend::getTextSize(const std::string &text, int &width, int &height)
+{
+    width = 0;
+    height = 0;
+    if (mFont != nullptr)
+    {
+        TTF_SizeText(mFont, text.c_str(), &width, &height);
+    }
+}
+
+// 开始绘制静态层：把渲染目标切换到静态层纹理
+void SdlRenderBackend::beginStaticLayer()
+{
+    if (mStaticLayer == nullptr)
+    {
+        mStaticLayer = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, mWidth, mHeight);
+        mLiveTextures += mStaticLayer != nullptr ? 1 : 0;
+    }
+    SDL_SetRenderTarget(mRenderer, mStaticLayer);
+    SDL_SetRenderDrawColor(mRenderer, 0x00, 0x00, 0x00, 0xFF);
+    SDL_RenderClear(mRenderer);
+}
+
+void SdlRenderBackend::endStaticLayer()
+{
+    SDL_SetRenderTarget(mRenderer, nullptr);
+}
+
+void SdlRenderBackend::drawStaticLayer()
+{
+    if (mStaticLayer != nullptr)
+    {
+        SDL_RenderCopy(mRenderer, mStaticLayer, nullptr, nullptr);
+    }
+    mStats.staticLayers++;
+}
+
+void SdlRenderBackend::present()
+{
+    // 录像：提交之前把画面读回到空闲缓冲区，没有空闲缓冲区时跳过读回
+    if (mCapture != nullptr)
+    {
+        uint8_t *pixels = mCapture->acquireFrame();
+        if (pixels != nullptr && SDL_RenderReadPixels(mRenderer, nullptr, SDL_PIXELFORMAT_RGB24, pixels, mCapture->getPitch()) == 0)
+        {
+            mCapture->submitFrame();
+        }
+    }
+    SDL_RenderPresent(mRenderer);
+    mStats.frames++;
+}
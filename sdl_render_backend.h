@@ -0,0 +1,62 @@
+#ifndef SDL_RENDER_BACKEND_H
+#define SDL_RENDER_BACKEND_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <string>
+#include <vector>
+
+#include "render_backend.h"
+
+// SDL 渲染器后端：渲染器和字体由调用者创建和释放，静态层是一张渲染目标纹理
+// 字体为空时不绘制文字 (例如在 SDL_VIDEODRIVER=dummy 的无界面主机上做基准测试)
+class SdlRenderBackend : public RenderBackend
+{
+public:
+    SdlRenderBackend(SDL_Renderer *renderer, TTF_Font *font, int width, int height);
+    ~SdlRenderBackend();
+
+    void setColor(RenderColor color) override;
+    void clear() override;
+    void fillRects(const RenderRect *rects, int count) override;
+    void fillColoredRects(const RenderRect *rects, const RenderColor *colors, int count) override;
+    void drawLine(int x1, int y1, int x2, int y2) override;
+    void drawText(const std::string &text, int x, int y, RenderColor color) override;
+    void getTextSize(const std::string &text, int &width, int &height) override;
+    void beginStaticLayer() override;
+    void endStaticLayer() override;
+    void drawStaticLayer() override;
+    void present() override;
+
+private:
+    SDL_Renderer *mRenderer;
+    TTF_Font *mFont;
+    int mWidth;
+    int mHeight;
+    SDL_Texture *mStaticLayer = nullptr;
+    // 带颜色的矩形转换成的三角形 (每个矩形 4 个顶点、6 个下标)，每帧复用
+    std::vector<SDL_Vertex> mVertices;
+    std::vector<int> mIndices;
+
+    // 文字纹理缓存：文字和颜色相同时复用纹理，只在文字改变时重新渲染，满时替换最久没有使用的一项
+    static const size_t TEXT_CACHE_SIZE = 48;
+    struct CachedText
+    {
+        std::string text;
+        RenderColor color;
+        SDL_Texture *texture;
+        int width;
+        int height;
+        uint64_t lastUsed;
+    };
+    std::vector<CachedText> mTextCache;
+    uint64_t mTextClock = 0;
+    // 取得文字的纹理，渲染失败时返回 nullptr
+    CachedText *getTextTexture(const std::string &text, RenderColor color);
+
+    SdlRenderBackend(const SdlRenderBackend &) = delete;
+    SdlRenderBackend &operator=(const SdlRenderBackend &) = delete;
+};
+
+#endif
@@ -0,0 +1,88 @@
+#include <cstdint>
+#include <iostream>
+
+#include "sdl_sound_effects.h"
+
+// 音效文件，按 SoundEffect 的顺序
+static const char *SOUND_FILES[SOUND_EFFECT_COUNT] = {"sfx_eat.wav", "sfx_powerup.wav", "sfx_expire.wav", "sfx_death.wav"};
+
+SdlSoundEffects::SdlSoundEffects()
+{
+}
+
+SdlSoundEffects::~SdlSoundEffects()
+{
+    stop();
+}
+
+// 按输出格式加载音效并注册后期混音回调
+bool SdlSoundEffects::start()
+{
+    int frequency = 0;
+    Uint16 format = 0;
+    int channels = 0;
+    if (Mix_QuerySpec(&frequency, &format, &channels) == 0 || format != MIX_DEFAULT_FORMAT)
+    {
+        return false;
+    }
+    mPtrMixer.reset(new SoundMixer(frequency, channels));
+    mPtrMixer->synthesize();
+    for (int i = 0; i < SOUND_EFFECT_COUNT; i++)
+    {
+        // Mix_LoadWAV 把文件转换成输出格式，之后直接引用它的采样
+        mChunks[i] = Mix_LoadWAV(SOUND_FILES[i]);
+        if (mChunks[i] != nullptr)
+        {
+            mPtrMixer->setSamples(static_cast<SoundEffect>(i), reinterpret_cast<const int16_t *>(mChunks[i]->abuf),
+                                  mChunks[i]->alen / (sizeof(int16_t) * channels));
+        }
+    }
+    if (Mix_RegisterEffect(MIX_CHANNEL_POST, &SdlSoundEffects::postMix, nullptr, this) == 0)
+    {
+        std::cerr << "音效回调注册失败: " << Mix_GetError() << std::endl;
+        stop();
+        return false;
+    }
+    mRegistered = true;
+    return true;
+}
+
+// 注销回调 (返回后音频线程不再调用 postMix)，然后释放音效
+void SdlSoundEffects::stop()
+{
+    if (mRegistered)
+    {
+        Mix_UnregisterEffect(MIX_CHANNEL_POST, &SdlSoundEffects::postMix);
+        mRegistered = false;
+    }
+    for (int i = 0; i < SOUND_EFFECT_COUNT; i++)
+    {
+        if (mChunks[i] != nullptr)
+        {
+            if (mPtrMixer)
+            {
+                mPtrMixer->setSamples(static_cast<SoundEffect>(i), nullptr, 0);
+            }
+            Mix_FreeChunk(mChunks[i]);
+            mChunks[i] = nullptr;
+        }
+    }
+}
+
+// 触发音效
+bool SdlSoundEffects::play(SoundEffect effect)
+{
+    return mRegistered && mPtrMixer->trigger(effect);
+}
+
+const SoundMixer *SdlSoundEffects::getMixer() const
+{
+    return mPtrMixer.get();
+}
+
+// 音频线程中的后期混音回调，stream 为输出格式 (16 位有符号交错采样)
+void SdlSoundEffects::postMix(int, void *stream, int length, void *userData)
+{
+    SoundMixer *mixer = static_cast<SdlSoundEffects *>(userData)->mPtrMixer.get();
+    mixer->mix(static_cast<int16_t *>(stream), length / (sizeof(int16_t) * mixer->getChannels()));
+}
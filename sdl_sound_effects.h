@@ -0,0 +1,37 @@
+#ifndef SDL_SOUND_EFFECTS_H
+#define SDL_SOUND_EFFECTS_H
+
+#include <memory>
+
+#include <SDL2/SDL_mixer.h>
+
+#include "sound_mixer.h"
+
+// SDL_mixer 的音效输出：SoundMixer 注册为 SDL_mixer 的后期混音回调，在音频线程中叠加到音乐之上
+// 音效文件 (sfx_eat.wav 等) 存在时用 Mix_LoadWAV 解码为输出格式一次，保存在 Mix_Chunk 池中，
+// 否则使用合成的音效；游戏线程触发音效时只写入无锁队列，不调用 Mix_PlayChannel (它要加音频锁)
+class SdlSoundEffects
+{
+public:
+    SdlSoundEffects();
+    ~SdlSoundEffects();
+
+    // 在 Mix_OpenAudio 之后调用：按输出格式加载音效并注册回调，输出格式不是 16 位时返回 false
+    bool start();
+    // 注销回调并释放音效，在 Mix_CloseAudio 之前调用
+    void stop();
+    // 游戏线程调用
+    bool play(SoundEffect effect);
+    const SoundMixer *getMixer() const;
+
+private:
+    std::unique_ptr<SoundMixer> mPtrMixer;
+    Mix_Chunk *mChunks[SOUND_EFFECT_COUNT] = {nullptr};
+    bool mRegistered = false;
+
+    static void postMix(int channel, void *stream, int length, void *userData);
+    SdlSoundEffects(const SdlSoundEffects &) = delete;
+    SdlSoundEffects &operator=(const SdlSoundEffects &) = delete;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include "lockstep.h"
+
+// 打印用法
+static void printUsage()
+{
+    std::cout << "用法: snakeserver [--endpoint unix:/tmp/snake.sock | tcp:7777] [--players 2-8]\n"
+                 "                  [--delay 帧] [--batch 1-255] [--tick-ms 毫秒] [--max-ticks 帧] [--seed 种子]\n"
+                 "                  [--mode bounded|unbounded] [--difficulty easy|hard] [--map empty|obstacles]"
+              << std::endl;
+}
+
+// 无界面联机服务器入口
+int main(int argc, char **argv)
+{
+    LockstepConfig config;
+    std::string endpoint = "unix:/tmp/snakegame.sock";
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        std::string value = (i + 1 < argc) ? argv[i + 1] : "";
+        if (arg == "--endpoint")
+            endpoint = value;
+        else if (arg == "--players")
+            config.players = std::atoi(value.c_str());
+        else if (arg == "--delay")
+            config.inputDelay = std::atoi(value.c_str());
+        else if (arg == "--batch")
+            config.batchTicks = std::atoi(value.c_str());
+        else if (arg == "--tick-ms")
+            config.tickMillis = std::atoi(value.c_str());
+        else if (arg == "--max-ticks")
+            config.maxTicks = std::atoi(value.c_str());
+        else if (arg == "--seed")
+            config.seed = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--mode")
+            config.gameMode = (value == "unbounded") ? GameMode::Unbounded : GameMode::Bounded;
+        else if (arg == "--difficulty")
+            config.difficulty = (value == "hard") ? Difficulty::Hard : Difficulty::Easy;
+        else if (arg == "--map")
+            config.mapType = (value == "obstacles") ? MapType::Obstacles : MapType::Empty;
+        else
+        {
+            printUsage();
+            return 1;
+        }
+        i++;
+    }
+
+    LockstepServer server(config, endpoint);
+    return server.run() ? 0 : 1;
+}
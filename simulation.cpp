@@ -0,0 +1,1280 @@
+#include <algorithm>
+#include <cstring>
+
+#include "simulation.h"
+#include "board_policy.h"
+#include "zobrist.h"
+
+// 随机数发生器构造函数
+Random::Random(uint64_t seed)
+{
+    this->seed(seed);
+}
+
+// 设置随机数种子 (状态不能为 0)
+void Random::seed(uint64_t seed)
+{
+    mState = seed ? seed : 0x9E3779B97F4A7C15ULL;
+}
+
+// xorshift64* 算法
+uint32_t Random::next()
+{
+    mState ^= mState >> 12;
+    mState ^= mState << 25;
+    mState ^= mState >> 27;
+    return static_cast<uint32_t>((mState * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+// 生成 [0, bound) 之间的随机整数
+int Random::nextInt(int bound)
+{
+    return static_cast<int>(next() % static_cast<uint32_t>(bound));
+}
+
+uint64_t Random::getState() const
+{
+    return mState;
+}
+
+void Random::setState(uint64_t state)
+{
+    mState = state;
+}
+
+// 构造函数
+Simulation::Simulation(int gameBoardWidth, int gameBoardHeight, int initialSnakeLength)
+    : mGameBoardWidth(gameBoardWidth),
+      mGameBoardHeight(gameBoardHeight),
+      mBoardColumns(gameBoardWidth / GRID_SIZE),
+      mBoardRows(gameBoardHeight / GRID_SIZE),
+      mGrid(mBoardColumns, mBoardRows),
+      mInitialSnakeLength(initialSnakeLength)
+{
+    // 蛇对象只创建一次，每局开始时重新初始化
+    this->mPtrSnake.reset(new Snake(this->mGrid, this->mInitialSnakeLength, mGameMode));
+}
+
+// 开始新的一局
+void Simulation::reset(GameMode mode, Difficulty difficulty, MapType mapType, uint64_t seed)
+{
+    this->mGameMode = mode;
+    this->mRandom.seed(seed);
+
+    // 清空障碍物列表和输入缓冲
+    mObstacles.clear();
+    mQueueHead = 0;
+    mQueueSize = 0;
+    mCurrentDirection = Direction::Up;
+    mHasAppliedInput = false;
+    mMoved = false;
+    mVacatedTail = NO_CELL;
+    mMoveCount = 0;
+
+    // 重新初始化蛇 (复用蛇身的内存)
+    this->mPtrSnake->reset(mode);
+    selectStep();
+
+    // 根据难度设置蛇的初始速度
+    switch (difficulty)
+    {
+    case Difficulty::Easy:
+        mBaseSpeed = 15.0f;
+        break;
+    case Difficulty::Hard:
+        mBaseSpeed = 30.0f;
+        break;
+    }
+    // 根据地图类型设置障碍物
+    switch (mapType)
+    {
+    case MapType::Empty:
+        break;
+    case MapType::Obstacles:
+        //  添加障碍物
+        for (int i = 0; i < 5; i++)
+        {
+            mObstacles.push_back(mGrid.toCell(5, i));
+        }
+        mObstacles.push_back(mGrid.toCell(10, 15));
+        // ... 添加更多障碍物
+        break;
+    }
+
+    // 清空特殊效果，预留定时器节点 (食物寿命和特殊效果)，避免游戏过程中扩容
+    mTimers.clear();
+    mTimers.reserve(mFoodCount + TIMER_RESERVE);
+    mExpiredTimers.reserve(mFoodCount + TIMER_RESERVE);
+    for (int &count : mActiveEffects)
+    {
+        count = 0;
+    }
+    mEffectAccumulator = 0.0f;
+    updateSpeed();
+
+    // 初始化游戏得分
+    this->mPoints = 0;
+    this->mDifficulty = 0;
+    this->mGameOver = false;
+    // 在随机位置生成食物
+    mFoods.resize(mGrid);
+    this->spawnFood();
+    mHash = computeHash();
+}
+
+void Simulation::addDirectionToQueue(Direction newDirection, uint64_t timestamp)
+{
+    if (mQueueSize < MAX_QUEUE_SIZE && isValidDirection(newDirection))
+    {
+        mDirectionQueue[(mQueueHead + mQueueSize) % MAX_QUEUE_SIZE] = {newDirection, timestamp};
+        mQueueSize++;
+    }
+}
+
+bool Simulation::isValidDirection(Direction newDirection)
+{
+    if (mQueueSize == 0)
+    {
+        return newDirection != getOppositeDirection(mCurrentDirection);
+    }
+    const DirectionInput &last = mDirectionQueue[(mQueueHead + mQueueSize - 1) % MAX_QUEUE_SIZE];
+    return newDirection != getOppositeDirection(last.direction);
+}
+
+Direction Simulation::getOppositeDirection(Direction dir)
+{
+    switch (dir)
+    {
+    case Direction::Up:
+        return Direction::Down;
+    case Direction::Down:
+        return Direction::Up;
+    case Direction::Left:
+        return Direction::Right;
+    case Direction::Right:
+        return Direction::Left;
+    default:
+        return Direction::None;
+    }
+}
+
+void Simulation::togglePause()
+{
+    Direction previous = mPtrSnake->getDirection();
+    if (mPtrSnake->getDirection() == Direction::None)
+    {
+        mPtrSnake->changeDirection(mCurrentDirection);
+    }
+    else
+    {
+        mCurrentDirection = mPtrSnake->getDirection();
+        mPtrSnake->changeDirection(Direction::None);
+    }
+    hashDirection(previous);
+}
+
+void Simulation::updateSnakeDirection()
+{
+    if (mQueueSize > 0)
+    {
+        DirectionInput input = mDirectionQueue[mQueueHead];
+        mQueueHead = (mQueueHead + 1) % MAX_QUEUE_SIZE;
+        mQueueSize--;
+
+        // 与蛇当前的方向比较，而不是与缓冲中更晚的输入比较
+        if (input.direction != getOppositeDirection(mCurrentDirection))
+        {
+            Direction previous = mPtrSnake->getDirection();
+            mPtrSnake->changeDirection(input.direction);
+            hashDirection(previous);
+            mCurrentDirection = input.direction;
+            mAppliedInputTime = input.timestamp;
+            mHasAppliedInput = true;
+        }
+    }
+}
+
+// 取出最近一次应用的输入的时间戳
+bool Simulation::takeAppliedInput(uint64_t &timestamp)
+{
+    if (!mHasAppliedInput)
+    {
+        return false;
+    }
+    timestamp = mAppliedInputTime;
+    mHasAppliedInput = false;
+    return true;
+}
+
+// 调整游戏难度
+void Simulation::adjustDelay()
+{
+    int level = mPoints / 5;
+    if (level > mDifficulty)
+    {
+        publish(GameEventType::LevelUp, mPtrSnake->getHead(), level);
+    }
+    mDifficulty = level;
+    if (mPoints % 5 == 0)
+    {
+        mBaseSpeed += 0.5f; //  每增加 5 分，蛇的速度增加 0.5
+        updateSpeed();
+    }
+}
+
+// 设置食物数量和寿命
+void Simulation::setFoodOptions(int count, uint32_t lifetimeTicks)
+{
+    mFoodCount = count < 1 ? 1 : count;
+    mFoodLifetime = lifetimeTicks;
+}
+
+// 创建随机食物
+bool Simulation::createRamdomFood()
+{
+    const int width = getBoardWidth();
+    const int height = getBoardHeight();
+    CellIndex cell = NO_CELL;
+    bool found = false;
+    // 先随机尝试，食物很多或蛇很长时再从随机位置开始顺序查找空格子
+    for (int attempt = 0; attempt < 64 && !found; attempt++)
+    {
+        int foodX = mRandom.nextInt(width - 2) + 1;
+        int foodY = mRandom.nextInt(height - 2) + 1;
+        cell = mGrid.toCell(foodX, foodY);
+        found = !mPtrSnake->isPartOfSnake(cell) && mFoods.find(cell) == nullptr;
+    }
+    if (!found)
+    {
+        const int cells = (width - 2) * (height - 2);
+        const int start = mRandom.nextInt(cells);
+        for (int i = 0; i < cells && !found; i++)
+        {
+            int index = (start + i) % cells;
+            cell = mGrid.toCell(index % (width - 2) + 1, index / (width - 2) + 1);
+            found = !mPtrSnake->isPartOfSnake(cell) && mFoods.find(cell) == nullptr;
+        }
+    }
+    if (!found)
+    {
+        return false;
+    }
+
+    // 随机选择食物类型
+    FoodType type = FoodType::Normal;
+    int foodType = mRandom.nextInt(4); //  生成 0 到 3 之间的随机数
+    switch (foodType)
+    {
+    case 0:
+        type = FoodType::Normal;
+        break;
+    case 1:
+        type = FoodType::SpeedUp;
+        break;
+    case 2:
+        type = FoodType::SlowDown;
+        break;
+    case 3:
+        type = FoodType::DoublePoints;
+        break;
+    }
+
+    // 有寿命的食物添加一个到期定时器
+    TimerWheel::TimerId timer = TimerWheel::INVALID_TIMER;
+    if (mFoodLifetime > 0)
+    {
+        uint32_t payload = (static_cast<uint32_t>(TimerKind::FoodExpiry) << 24) | static_cast<uint32_t>(cell);
+        timer = mTimers.schedule(mFoodLifetime, payload);
+    }
+    addFood(cell, type, timer);
+    return true;
+}
+
+// 补充食物
+void Simulation::spawnFood()
+{
+    while (static_cast<int>(mFoods.size()) < mFoodCount)
+    {
+        if (!createRamdomFood())
+        {
+            break;
+        }
+    }
+}
+
+// 添加食物
+void Simulation::addFood(CellIndex cell, FoodType type, TimerWheel::TimerId timer)
+{
+    if (mFoods.add(cell, type, timer))
+    {
+        mHash ^= zobristFood(cell, type);
+    }
+}
+
+// 删除食物
+bool Simulation::removeFood(CellIndex cell, FoodItem &removed)
+{
+    if (!mFoods.remove(cell, removed))
+    {
+        return false;
+    }
+    mHash ^= zobristFood(removed.cell, removed.type);
+    return true;
+}
+
+// 吃到食物后的效果和得分
+void Simulation::applyFood(const FoodItem &food)
+{
+    if (food.type != FoodType::Normal)
+    {
+        publish(GameEventType::EffectStarted, food.cell, 0, food.type);
+    }
+    switch (food.type)
+    {
+    case FoodType::Normal:
+        mPoints++;
+        break;
+    case FoodType::SpeedUp:      //  增加速度 5.0f，持续 10 秒
+    case FoodType::SlowDown:     //  降低速度为原来的 0.8 倍，持续 10 秒
+    case FoodType::DoublePoints: //  得分翻倍，持续 10 秒
+        startEffect(food.type);
+        break;
+    }
+
+    //  如果得分翻倍，则获得 2 分
+    if (mActiveEffects[static_cast<int>(FoodType::DoublePoints)] > 0)
+    {
+        mPoints += 2;
+    }
+    else
+    {
+        mPoints++;
+    }
+
+    publish(GameEventType::FoodEaten, food.cell, mPoints, food.type);
+    adjustDelay();
+    spawnFood();
+}
+
+// 蛇移动一步后更新哈希 (蛇头移动到新的格子后调用)
+void Simulation::hashMove(CellIndex oldHead, CellIndex oldTail, bool grew)
+{
+    CellIndex newHead = mPtrSnake->getHead();
+    mHash ^= zobristHead(oldHead) ^ zobristHead(newHead) ^ zobristBody(newHead);
+    if (!grew)
+    {
+        mHash ^= zobristBody(oldTail);
+    }
+}
+
+// 方向没有改变时两个键相同，异或的结果为 0
+void Simulation::hashDirection(Direction previous)
+{
+    mHash ^= zobristDirection(previous) ^ zobristDirection(mPtrSnake->getDirection());
+}
+
+// 检查蛇头是否撞到障碍物
+bool Simulation::hitObstacle() const
+{
+    return containsCell(mObstacles.data(), mObstacles.size(), mPtrSnake->getHead());
+}
+
+// 检查碰撞类型 (与 Snake::checkCollision 的顺序相同，先检查墙壁)
+CollisionType Simulation::checkCollision()
+{
+    if (mPtrSnake->hitWall())
+    {
+        return CollisionType::Wall;
+    }
+    if (mPtrSnake->hitSelf())
+    {
+        return CollisionType::Self;
+    }
+    if (hitObstacle())
+    {
+        return CollisionType::Obstacle;
+    }
+    return CollisionType::None;
+}
+
+// 发布事件
+void Simulation::publish(GameEventType type, CellIndex position, int32_t value, FoodType foodType, CollisionType collision)
+{
+    if (mEventBus == nullptr)
+    {
+        return;
+    }
+    GameEvent event;
+    event.type = type;
+    event.foodType = foodType;
+    event.collision = collision;
+    event.x = static_cast<int16_t>(mGrid.getX(position));
+    event.y = static_cast<int16_t>(mGrid.getY(position));
+    event.value = value;
+    mEventBus->publish(event);
+}
+
+// 更新游戏逻辑
+bool Simulation::update(float deltaTime)
+{
+    return advance(deltaTime, false);
+}
+
+// 浮点误差：剩余时间只差这么一点就到移动的时刻时也移动，移动次数不会因为舍入少一次
+static const float MOVE_TIME_EPSILON = 1e-5f;
+
+// 按经过的时间移动：每次移动之前重新读取速度 (吃到食物或者效果到期都会改变速度)，
+// 累积时间在每次移动时减去一个移动间隔，剩余的时间留给下一次调用，移动节奏不受调用频率影响
+bool Simulation::advance(float deltaTime, bool effects)
+{
+    if (mGameOver)
+    {
+        return false;
+    }
+    // 剩余时间用 double：一次调用移动几千步时 float 的逐次减法误差会超过 MOVE_TIME_EPSILON，少移动一步
+    double remaining = std::max(deltaTime, 0.0f);
+    if (mMaxTickTime > 0.0f)
+    {
+        remaining = std::min(remaining, static_cast<double>(mMaxTickTime));
+    }
+    int moves = 0;
+    while (true)
+    {
+        const float moveInterval = 1.0f / mPtrSnake->getSpeed();
+        const float accumulated = mPtrSnake->getAccumulatedTime();
+        if (accumulated + remaining + MOVE_TIME_EPSILON < moveInterval)
+        {
+            break;
+        }
+        if (moves >= mMaxMovesPerTick)
+        {
+            // 安全阀：速度太快时不再追赶，丢弃多余的时间
+            mThrottledTicks++;
+            mPtrSnake->setAccumulatedTime(std::min(static_cast<float>(accumulated + remaining), moveInterval));
+            if (effects)
+            {
+                updateEffects(static_cast<float>(remaining));
+            }
+            return true;
+        }
+        // 推进到这次移动的时刻 (速度变快时累积时间可能已经超过了移动间隔)
+        // 因为误差提前一点移动时累积时间略小于 0，下一次移动仍然按原来的节奏，误差不会积累
+        float untilMove = std::min(std::max(moveInterval - accumulated, 0.0f), static_cast<float>(remaining));
+        remaining -= untilMove;
+        if (effects)
+        {
+            // 等待期间特殊效果到期改变了速度：按新的速度重新计算这次移动的时刻
+            const float speed = mPtrSnake->getSpeed();
+            updateEffects(untilMove);
+            if (mPtrSnake->getSpeed() != speed)
+            {
+                mPtrSnake->setAccumulatedTime(accumulated + untilMove);
+                continue;
+            }
+        }
+        mPtrSnake->setAccumulatedTime(accumulated + untilMove - moveInterval);
+        moves++;
+        if (!move())
+        {
+            return false;
+        }
+    }
+    mPtrSnake->setAccumulatedTime(static_cast<float>(mPtrSnake->getAccumulatedTime() + remaining));
+    if (effects)
+    {
+        updateEffects(static_cast<float>(remaining));
+    }
+    return true;
+}
+
+// 应用方向输入并移动一步
+bool Simulation::move()
+{
+    // 到了移动的时刻才从输入缓冲中取出方向，连续的按键会分别作用于之后的几次移动
+    updateSnakeDirection();
+    // 检查蛇是否处于暂停状态
+    mMoved = mPtrSnake->getDirection() != Direction::None;
+    if (mMoved)
+    {
+        mMoveCount++;
+        // 移动蛇并检查蛇是否撞到墙壁、自身或障碍物
+        CollisionType collision = (this->*mStep)();
+        if (collision != CollisionType::None)
+        {
+            CellIndex head = mPtrSnake->getHead();
+            publish(GameEventType::Collision, head, 0, FoodType::Normal, collision);
+            publish(GameEventType::GameOver, head, mPoints);
+            mGameOver = true;
+            return false; // 游戏结束
+        }
+    }
+    return true;
+}
+
+// 立即移动一步，特殊效果计时按这一步的时间前进 (速度在移动之前读取)
+bool Simulation::advanceMove()
+{
+    if (mGameOver)
+    {
+        return false;
+    }
+    const float moveInterval = 1.0f / mPtrSnake->getSpeed();
+    bool alive = move();
+    updateEffects(moveInterval);
+    return alive;
+}
+
+// 吃掉格子上的食物
+void Simulation::eatFood(CellIndex cell)
+{
+    FoodItem eaten;
+    removeFood(cell, eaten);
+    mTimers.cancel(eaten.timer);
+    applyFood(eaten);
+}
+
+// 通用版本的移动步骤
+CollisionType Simulation::stepGeneric()
+{
+    // 按格子查找蛇头下一个位置上的食物，让蛇只感知这一个食物
+    CellIndex newHead = mPtrSnake->createNewHead();
+    const FoodItem *item = mFoods.find(newHead);
+    mPtrSnake->senseFood(item ? item->cell : NO_CELL);
+
+    // 移动蛇，检查蛇是否吃到了食物
+    CellIndex oldHead = mPtrSnake->getHead();
+    CellIndex oldTail = mPtrSnake->getCells().back();
+    bool grew = mPtrSnake->moveFoward();
+    hashMove(oldHead, oldTail, grew);
+    mVacatedTail = grew ? NO_CELL : oldTail;
+    if (grew)
+    {
+        eatFood(newHead);
+    }
+    return checkCollision();
+}
+
+// 特化版本的移动步骤：与通用版本的结果完全相同，但不再判断模式，区域大小可以是编译期常量
+template <typename Mode, typename Board>
+CollisionType Simulation::stepSpecialized()
+{
+    const Board board(mGrid);
+    CellIndex newHead;
+    bool inside = nextHead<Mode>(board, mPtrSnake->getHead(), mPtrSnake->getDirection(), newHead);
+    // 外圈的格子上不会有食物
+    const FoodItem *item = mFoods.find(newHead);
+    mPtrSnake->senseFood(item ? item->cell : NO_CELL);
+    CellIndex oldHead = mPtrSnake->getHead();
+    CellIndex oldTail = mPtrSnake->getCells().back();
+    bool grew = mPtrSnake->moveTo(newHead);
+    hashMove(oldHead, oldTail, grew);
+    mVacatedTail = grew ? NO_CELL : oldTail;
+    if (grew)
+    {
+        eatFood(newHead);
+    }
+    if (!inside)
+    {
+        return CollisionType::Wall;
+    }
+    if (mPtrSnake->hitSelf())
+    {
+        return CollisionType::Self;
+    }
+    if (hitObstacle())
+    {
+        return CollisionType::Obstacle;
+    }
+    return CollisionType::None;
+}
+
+// 按区域大小选择特化版本：默认窗口的游戏区域和 64x64 使用编译期常量
+template <typename Mode>
+void Simulation::selectBoardStep()
+{
+    const int w = mBoardColumns;
+    const int h = mBoardRows;
+    if (w == 40 && h == 28)
+    {
+        mStep = &Simulation::stepSpecialized<Mode, FixedBoard<40, 28>>;
+        mStepName = Mode::WRAPS ? "wrap/fixed 40x28" : "bounded/fixed 40x28";
+    }
+    else if (w == 64 && h == 64)
+    {
+        mStep = &Simulation::stepSpecialized<Mode, FixedBoard<64, 64>>;
+        mStepName = Mode::WRAPS ? "wrap/fixed 64x64" : "bounded/fixed 64x64";
+    }
+    else
+    {
+        mStep = &Simulation::stepSpecialized<Mode, DynamicBoard>;
+        mStepName = Mode::WRAPS ? "wrap/dynamic" : "bounded/dynamic";
+    }
+}
+
+// 开始一局时选择移动步骤
+void Simulation::selectStep()
+{
+    if (!mSpecializedStep)
+    {
+        mStep = &Simulation::stepGeneric;
+        mStepName = "generic";
+    }
+    else if (mGameMode == GameMode::Bounded)
+    {
+        selectBoardStep<BoundedPolicy>();
+    }
+    else
+    {
+        selectBoardStep<WrapPolicy>();
+    }
+}
+
+void Simulation::setSpecializedStep(bool enabled)
+{
+    mSpecializedStep = enabled;
+}
+
+const char *Simulation::getStepName() const
+{
+    return mStepName;
+}
+
+// 添加特殊效果，到期时间由时间轮管理
+void Simulation::startEffect(FoodType type)
+{
+    changeEffect(type, 1);
+    uint32_t payload = (static_cast<uint32_t>(TimerKind::Effect) << 24) | static_cast<uint32_t>(type);
+    mTimers.schedule(EFFECT_DURATION_TICKS, payload);
+    updateSpeed();
+}
+
+// 处理到期的定时器
+void Simulation::onTimerExpired(uint32_t payload)
+{
+    TimerKind kind = static_cast<TimerKind>(payload >> 24);
+    switch (kind)
+    {
+    case TimerKind::Effect:
+    {
+        FoodType type = static_cast<FoodType>(payload & 0xFFFFFF);
+        changeEffect(type, -1);
+        updateSpeed();
+        publish(GameEventType::EffectExpired, mPtrSnake->getHead(), 0, type);
+        break;
+    }
+    case TimerKind::FoodExpiry:
+    {
+        CellIndex cell = static_cast<CellIndex>(payload & 0xFFFFFF);
+        FoodItem expired;
+        if (removeFood(cell, expired))
+        {
+            publish(GameEventType::FoodExpired, expired.cell, 0, expired.type);
+            spawnFood();
+        }
+        break;
+    }
+    }
+}
+
+// 改变特殊效果的层数：异或掉旧层数的键，异或上新层数的键
+void Simulation::changeEffect(FoodType type, int delta)
+{
+    int &count = mActiveEffects[static_cast<int>(type)];
+    mHash ^= zobristEffect(type, count);
+    count += delta;
+    mHash ^= zobristEffect(type, count);
+}
+
+// 根据基础速度和生效的特殊效果计算蛇的速度
+void Simulation::updateSpeed()
+{
+    float speed = mBaseSpeed + 5.0f * mActiveEffects[static_cast<int>(FoodType::SpeedUp)];
+    for (int i = 0; i < mActiveEffects[static_cast<int>(FoodType::SlowDown)]; i++)
+    {
+        speed *= 0.8f;
+    }
+    mPtrSnake->setSpeed(speed);
+}
+
+// 更新特殊效果计时器：把经过的时间换算成计时单位，推进时间轮
+void Simulation::updateEffects(float deltaTime)
+{
+    mEffectAccumulator += deltaTime;
+    uint32_t ticks = static_cast<uint32_t>(mEffectAccumulator / EFFECT_TICK_SECONDS);
+    if (ticks == 0)
+    {
+        return;
+    }
+    mEffectAccumulator -= ticks * EFFECT_TICK_SECONDS;
+
+    mExpiredTimers.clear();
+    mTimers.advance(ticks, mExpiredTimers);
+    for (uint32_t payload : mExpiredTimers)
+    {
+        onTimerExpired(payload);
+    }
+}
+
+// 无界面模式下的一个完整逻辑帧
+bool Simulation::tick(float deltaTime)
+{
+    return advance(deltaTime, true);
+}
+
+void Simulation::setMaxMovesPerTick(int moves)
+{
+    mMaxMovesPerTick = std::max(1, moves);
+}
+
+int Simulation::getMaxMovesPerTick() const
+{
+    return mMaxMovesPerTick;
+}
+
+void Simulation::setMaxTickTime(float seconds)
+{
+    mMaxTickTime = std::max(0.0f, seconds);
+}
+
+float Simulation::getMaxTickTime() const
+{
+    return mMaxTickTime;
+}
+
+uint64_t Simulation::getThrottledTicks() const
+{
+    return mThrottledTicks;
+}
+
+uint64_t Simulation::getMoveCount() const
+{
+    return mMoveCount;
+}
+
+// 设置基础速度并重新计算包括特殊效果在内的速度
+void Simulation::setBaseSpeed(float speed)
+{
+    mBaseSpeed = std::max(speed, 0.1f);
+    updateSpeed();
+}
+
+// FNV-1a 校验和
+static uint32_t fnvMix(uint32_t hash, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        hash ^= (value >> (i * 8)) & 0xFF;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t floatBits(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// 当前状态的校验和：Zobrist 哈希加上哈希不包括的标量 (速度、计时、得分和随机数状态)
+uint32_t Simulation::checksum() const
+{
+    uint32_t hash = 2166136261u;
+    hash = fnvMix(hash, static_cast<uint32_t>(mHash));
+    hash = fnvMix(hash, static_cast<uint32_t>(mHash >> 32));
+    hash = fnvMix(hash, static_cast<uint32_t>(mPtrSnake->getLength()));
+    hash = fnvMix(hash, floatBits(mPtrSnake->getSpeed()));
+    hash = fnvMix(hash, floatBits(mPtrSnake->getAccumulatedTime()));
+    hash = fnvMix(hash, static_cast<uint32_t>(mPoints));
+    hash = fnvMix(hash, floatBits(mBaseSpeed));
+    hash = fnvMix(hash, floatBits(mEffectAccumulator));
+    hash = fnvMix(hash, static_cast<uint32_t>(mTimers.getNow()));
+    hash = fnvMix(hash, static_cast<uint32_t>(mRandom.getState()));
+    hash = fnvMix(hash, mGameOver ? 1u : 0u);
+    return hash;
+}
+
+uint64_t Simulation::getHash() const
+{
+    return mHash;
+}
+
+// 从头计算哈希：与增量更新使用同样的键，蛇身中重复的格子 (撞到自己) 也按出现的次数异或
+uint64_t Simulation::computeHash() const
+{
+    uint64_t hash = 0;
+    for (CellIndex cell : mPtrSnake->getCells())
+    {
+        hash ^= zobristBody(cell);
+    }
+    hash ^= zobristHead(mPtrSnake->getHead());
+    hash ^= zobristDirection(mPtrSnake->getDirection());
+    for (const auto &item : mFoods.getItems())
+    {
+        hash ^= zobristFood(item.cell, item.type);
+    }
+    for (CellIndex obstacle : mObstacles)
+    {
+        hash ^= zobristObstacle(obstacle);
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        hash ^= zobristEffect(static_cast<FoodType>(i), mActiveEffects[i]);
+    }
+    return hash;
+}
+
+// 快照文件头标识 "SNKS"
+static const uint32_t SNAPSHOT_MAGIC = 0x534B4E53;
+
+// 按小端序写入一个值 (目标平台均为小端序，直接复制内存)
+template <typename T>
+static void writeValue(uint8_t *&cursor, T value)
+{
+    std::memcpy(cursor, &value, sizeof(T));
+    cursor += sizeof(T);
+}
+
+// 读取一个值，数据不足时返回 false
+template <typename T>
+static bool readValue(const uint8_t *&cursor, const uint8_t *end, T &value)
+{
+    if (end - cursor < static_cast<ptrdiff_t>(sizeof(T)))
+    {
+        return false;
+    }
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+// 把快照写入 out
+void Simulation::saveSnapshot(std::vector<uint8_t> &out) const
+{
+    // 格子编号与 CellIndex 相同：四周各留出一格，用于表示撞墙后越界的蛇头
+    const std::vector<CellIndex> &body = mPtrSnake->getCells();
+    size_t size = 4 + 2 + 2 + 2 + 1 + 8 + 4 + 4 + 1 + 4 + 4 + 1 + 1 + 1 + mQueueSize + 2 + 4 + 2 + 3 * mFoods.size() + 4 + 4 + 8 + 2 + 8 * mTimers.size() + 2 + 2 * mObstacles.size() + 2 + 2 * body.size();
+    out.resize(size);
+    uint8_t *cursor = out.data();
+
+    writeValue<uint32_t>(cursor, SNAPSHOT_MAGIC);
+    writeValue<uint16_t>(cursor, SNAPSHOT_VERSION);
+    writeValue<uint16_t>(cursor, static_cast<uint16_t>(getBoardWidth()));
+    writeValue<uint16_t>(cursor, static_cast<uint16_t>(getBoardHeight()));
+    writeValue<uint8_t>(cursor, static_cast<uint8_t>(mGameMode));
+    writeValue<uint64_t>(cursor, mRandom.getState());
+    writeValue<int32_t>(cursor, mPoints);
+    writeValue<int32_t>(cursor, mDifficulty);
+    writeValue<uint8_t>(cursor, mGameOver ? 1 : 0);
+
+    // 蛇的速度、累积时间和方向
+    writeValue<float>(cursor, mPtrSnake->getSpeed());
+    writeValue<float>(cursor, mPtrSnake->getAccumulatedTime());
+    writeValue<uint8_t>(cursor, static_cast<uint8_t>(mPtrSnake->getDirection()));
+    writeValue<uint8_t>(cursor, static_cast<uint8_t>(mCurrentDirection));
+
+    // 方向输入缓冲
+    writeValue<uint8_t>(cursor, static_cast<uint8_t>(mQueueSize));
+    for (int i = 0; i < mQueueSize; i++)
+    {
+        writeValue<uint8_t>(cursor, static_cast<uint8_t>(mDirectionQueue[(mQueueHead + i) % MAX_QUEUE_SIZE].direction));
+    }
+
+    // 食物数量、寿命和每个食物 (格子编号和类型)，到期定时器随定时器一起保存
+    writeValue<uint16_t>(cursor, static_cast<uint16_t>(mFoodCount));
+    writeValue<uint32_t>(cursor, mFoodLifetime);
+    writeValue<uint16_t>(cursor, static_cast<uint16_t>(mFoods.size()));
+    for (const auto &item : mFoods.getItems())
+    {
+        writeValue<uint16_t>(cursor, static_cast<uint16_t>(item.cell));
+        writeValue<uint8_t>(cursor, static_cast<uint8_t>(item.type));
+    }
+
+    // 基础速度和定时器 (剩余帧数和 payload)
+    writeValue<float>(cursor, mBaseSpeed);
+    writeValue<float>(cursor, mEffectAccumulator);
+    writeValue<uint64_t>(cursor, mTimers.getNow());
+    writeValue<uint16_t>(cursor, static_cast<uint16_t>(mTimers.size()));
+    mTimers.forEach([&cursor](uint32_t remaining, uint32_t payload) {
+        writeValue<uint32_t>(cursor, remaining);
+        writeValue<uint32_t>(cursor, payload);
+    });
+
+    // 障碍物和蛇身
+    writeValue<uint16_t>(cursor, static_cast<uint16_t>(mObstacles.size()));
+    for (CellIndex obstacle : mObstacles)
+    {
+        writeValue<uint16_t>(cursor, static_cast<uint16_t>(obstacle));
+    }
+    writeValue<uint16_t>(cursor, static_cast<uint16_t>(body.size()));
+    for (CellIndex part : body)
+    {
+        writeValue<uint16_t>(cursor, static_cast<uint16_t>(part));
+    }
+}
+
+// 快照中的 count 个 u16 格子编号是否都在游戏区域内 (allowBorder 为 true 时可以在外圈上)
+bool Simulation::validCells(const uint8_t *cells, int count, int stride, bool allowBorder) const
+{
+    for (int i = 0; i < count; i++)
+    {
+        uint16_t cell;
+        std::memcpy(&cell, cells + stride * i, sizeof(cell));
+        if (cell >= mGrid.getCellCount() || (!allowBorder && !mGrid.isInside(cell)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 从快照恢复
+bool Simulation::loadSnapshot(const uint8_t *data, size_t size)
+{
+    const uint8_t *cursor = data;
+    const uint8_t *end = data + size;
+
+    uint32_t magic;
+    uint16_t version, width, height;
+    if (!readValue(cursor, end, magic) || !readValue(cursor, end, version) ||
+        !readValue(cursor, end, width) || !readValue(cursor, end, height))
+    {
+        return false;
+    }
+    if (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION ||
+        width != getBoardWidth() || height != getBoardHeight())
+    {
+        return false;
+    }
+
+    uint8_t mode, gameOver, direction, currentDirection, queueSize;
+    uint64_t randomState;
+    int32_t points, difficulty;
+    float speed, accumulatedTime;
+    uint16_t foodCount, foodItems, obstacleCount, bodyLength;
+    uint32_t foodLifetime;
+    float baseSpeed, effectAccumulator;
+    uint64_t timerNow;
+    uint16_t timerCount;
+    uint8_t queue[MAX_QUEUE_SIZE];
+    bool ok = readValue(cursor, end, mode) && readValue(cursor, end, randomState) &&
+              readValue(cursor, end, points) && readValue(cursor, end, difficulty) &&
+              readValue(cursor, end, gameOver) && readValue(cursor, end, speed) &&
+              readValue(cursor, end, accumulatedTime) && readValue(cursor, end, direction) &&
+              readValue(cursor, end, currentDirection) && readValue(cursor, end, queueSize) &&
+              queueSize <= MAX_QUEUE_SIZE;
+    for (int i = 0; ok && i < queueSize; i++)
+    {
+        ok = readValue(cursor, end, queue[i]);
+    }
+    ok = ok && readValue(cursor, end, foodCount) && readValue(cursor, end, foodLifetime) &&
+         readValue(cursor, end, foodItems);
+    if (!ok || end - cursor < 3 * foodItems)
+    {
+        return false;
+    }
+    const uint8_t *foodData = cursor;
+    cursor += 3 * foodItems;
+    ok = readValue(cursor, end, baseSpeed) && readValue(cursor, end, effectAccumulator) &&
+         readValue(cursor, end, timerNow) && readValue(cursor, end, timerCount);
+    if (!ok || end - cursor < 8 * timerCount)
+    {
+        return false;
+    }
+    const uint8_t *timerData = cursor;
+    cursor += 8 * timerCount;
+    ok = readValue(cursor, end, obstacleCount);
+    if (!ok || end - cursor < 2 * obstacleCount + 2)
+    {
+        return false;
+    }
+    const uint8_t *obstacleCells = cursor;
+    cursor += 2 * obstacleCount;
+    readValue(cursor, end, bodyLength);
+    if (end - cursor != 2 * bodyLength || bodyLength == 0)
+    {
+        return false;
+    }
+    const uint8_t *bodyCells = cursor;
+    // 蛇身、障碍物和食物的格子编号直接用于查表和计算蛇头，必须在游戏区域内；
+    // 只有已经结束的一局蛇头可以在外圈上 (有边界模式撞墙时蛇头在游戏区域外一格)
+    if (!validCells(bodyCells, 1, 2, gameOver != 0) || !validCells(bodyCells + 2, bodyLength - 1, 2, false) ||
+        !validCells(obstacleCells, obstacleCount, 2, false) || !validCells(foodData, foodItems, 3, false))
+    {
+        return false;
+    }
+    // 枚举值必须在范围内：方向用于查相邻格子的偏移量和哈希键，模式决定移动步骤
+    // 蛇的方向可以是 None (暂停)，当前方向和缓冲中的输入只会是四个方向之一
+    if (mode > static_cast<uint8_t>(GameMode::Unbounded) || direction > static_cast<uint8_t>(Direction::None) ||
+        currentDirection > static_cast<uint8_t>(Direction::Right))
+    {
+        return false;
+    }
+    for (int i = 0; i < queueSize; i++)
+    {
+        if (queue[i] > static_cast<uint8_t>(Direction::Right))
+        {
+            return false;
+        }
+    }
+    // 定时器的参数到期时直接用作下标：特殊效果必须是四种食物类型之一，食物到期的格子上必须有食物
+    for (int i = 0; i < timerCount; i++)
+    {
+        uint32_t payload;
+        std::memcpy(&payload, timerData + 8 * i + 4, sizeof(payload));
+        uint32_t kind = payload >> 24;
+        uint32_t argument = payload & 0xFFFFFF;
+        if (kind == static_cast<uint32_t>(TimerKind::Effect))
+        {
+            if (argument > static_cast<uint32_t>(FoodType::DoublePoints))
+            {
+                return false;
+            }
+        }
+        else if (kind == static_cast<uint32_t>(TimerKind::FoodExpiry))
+        {
+            bool hasFood = false;
+            for (int j = 0; j < foodItems && !hasFood; j++)
+            {
+                uint16_t cell;
+                std::memcpy(&cell, foodData + 3 * j, sizeof(cell));
+                hasFood = cell == argument;
+            }
+            if (!hasFood)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    // 数据完整，开始恢复
+    GameMode gameMode = static_cast<GameMode>(mode);
+    if (gameMode != mGameMode)
+    {
+        mPtrSnake->reset(gameMode);
+    }
+    mGameMode = gameMode;
+    selectStep();
+    mRandom.setState(randomState);
+    mPoints = points;
+    mDifficulty = difficulty;
+    mGameOver = gameOver != 0;
+
+    mPtrSnake->setSpeed(speed);
+    mPtrSnake->setAccumulatedTime(accumulatedTime);
+    mPtrSnake->setDirection(static_cast<Direction>(direction));
+    mCurrentDirection = static_cast<Direction>(currentDirection);
+    mQueueHead = 0;
+    mQueueSize = queueSize;
+    for (int i = 0; i < queueSize; i++)
+    {
+        mDirectionQueue[i] = {static_cast<Direction>(queue[i]), 0};
+    }
+    mHasAppliedInput = false;
+    mMoved = false;
+    mVacatedTail = NO_CELL;
+
+    mFoodCount = foodCount;
+    mFoodLifetime = foodLifetime;
+    mFoods.resize(mGrid);
+    for (int i = 0; i < foodItems; i++)
+    {
+        uint16_t cell;
+        std::memcpy(&cell, foodData + 3 * i, sizeof(cell));
+        mFoods.add(cell, static_cast<FoodType>(foodData[3 * i + 2] & 3));
+    }
+    // 重建时间轮，生效层数由定时器推算
+    mBaseSpeed = baseSpeed;
+    mEffectAccumulator = effectAccumulator;
+    mTimers.clear();
+    mTimers.setNow(timerNow);
+    for (int &count : mActiveEffects)
+    {
+        count = 0;
+    }
+    for (int i = 0; i < timerCount; i++)
+    {
+        uint32_t remaining, payload;
+        std::memcpy(&remaining, timerData + 8 * i, sizeof(remaining));
+        std::memcpy(&payload, timerData + 8 * i + 4, sizeof(payload));
+        TimerWheel::TimerId timer = mTimers.schedule(remaining, payload);
+        uint32_t argument = payload & 0xFFFFFF;
+        switch (static_cast<TimerKind>(payload >> 24))
+        {
+        case TimerKind::Effect:
+            mActiveEffects[argument]++;
+            break;
+        case TimerKind::FoodExpiry:
+            // 定时器编号重新分配，需要重新关联到食物上
+            mFoods.setTimer(static_cast<CellIndex>(argument), timer);
+            break;
+        }
+    }
+
+    mObstacles.resize(obstacleCount);
+    for (int i = 0; i < obstacleCount; i++)
+    {
+        uint16_t cell;
+        std::memcpy(&cell, obstacleCells + 2 * i, sizeof(cell));
+        mObstacles[i] = cell;
+    }
+    // 先解码到复用的缓冲区，避免每次恢复都分配内存
+    mSnapshotBody.resize(bodyLength);
+    for (int i = 0; i < bodyLength; i++)
+    {
+        uint16_t cell;
+        std::memcpy(&cell, bodyCells + 2 * i, sizeof(cell));
+        mSnapshotBody[i] = cell;
+    }
+    mPtrSnake->setCells(mSnapshotBody);
+    mHash = computeHash();
+    return true;
+}
+
+// 直接设置蛇身
+void Simulation::setSnakeBody(const std::vector<SnakeBody> &body)
+{
+    mPtrSnake->setBody(body);
+    mHash = computeHash();
+    mMoved = false;
+    mVacatedTail = NO_CELL;
+}
+
+// 复制另一局的完整状态，事件总线保持不变
+bool Simulation::copyFrom(const Simulation &other)
+{
+    if (other.mBoardColumns != mBoardColumns || other.mBoardRows != mBoardRows)
+    {
+        return false;
+    }
+    if (this == &other)
+    {
+        return true;
+    }
+    mGameMode = other.mGameMode;
+    mRandom = other.mRandom;
+    mPtrSnake->copyFrom(*other.mPtrSnake);
+    mObstacles.assign(other.mObstacles.begin(), other.mObstacles.end());
+    mFoods = other.mFoods;
+    mFoodCount = other.mFoodCount;
+    mFoodLifetime = other.mFoodLifetime;
+
+    for (int i = 0; i < MAX_QUEUE_SIZE; i++)
+    {
+        mDirectionQueue[i] = other.mDirectionQueue[i];
+    }
+    mQueueHead = other.mQueueHead;
+    mQueueSize = other.mQueueSize;
+    mCurrentDirection = other.mCurrentDirection;
+    mAppliedInputTime = other.mAppliedInputTime;
+    mHasAppliedInput = other.mHasAppliedInput;
+    mMoved = other.mMoved;
+    mVacatedTail = other.mVacatedTail;
+    mMaxMovesPerTick = other.mMaxMovesPerTick;
+    mMaxTickTime = other.mMaxTickTime;
+    mMoveCount = other.mMoveCount;
+
+    mStep = other.mStep;
+    mStepName = other.mStepName;
+    mSpecializedStep = other.mSpecializedStep;
+
+    mTimers = other.mTimers;
+    mBaseSpeed = other.mBaseSpeed;
+    for (int i = 0; i < 4; i++)
+    {
+        mActiveEffects[i] = other.mActiveEffects[i];
+    }
+    mEffectAccumulator = other.mEffectAccumulator;
+    mExpiredTimers.reserve(other.mExpiredTimers.capacity());
+
+    mPoints = other.mPoints;
+    mDifficulty = other.mDifficulty;
+    mGameOver = other.mGameOver;
+    mHash = other.mHash;
+    return true;
+}
+
+void Simulation::reseedRandom(uint64_t seed)
+{
+    mRandom.seed(seed);
+}
+
+// 设置事件总线
+void Simulation::setEventBus(EventBus *eventBus)
+{
+    mEventBus = eventBus;
+}
+
+bool Simulation::isGameOver() const
+{
+    return mGameOver;
+}
+
+GameMode Simulation::getGameMode() const
+{
+    return mGameMode;
+}
+
+const Snake &Simulation::getSnake() const
+{
+    return *mPtrSnake;
+}
+
+const FoodManager &Simulation::getFoods() const
+{
+    return mFoods;
+}
+
+const std::vector<CellIndex> &Simulation::getObstacles() const
+{
+    return mObstacles;
+}
+
+const CellGrid &Simulation::getGrid() const
+{
+    return mGrid;
+}
+
+int Simulation::getPoints() const
+{
+    return mPoints;
+}
+
+int Simulation::getDifficulty() const
+{
+    return mDifficulty;
+}
+
+int Simulation::getBoardWidth() const
+{
+    return mBoardColumns;
+}
+
+int Simulation::getBoardHeight() const
+{
+    return mBoardRows;
+}
+
+int Simulation::getActiveEffects(FoodType type) const
+{
+    return mActiveEffects[static_cast<int>(type)];
+}
+
+// 累积时间在每次移动时减去一个移动间隔，剩下的就是距离上一次移动的时间
+float Simulation::getMoveProgress() const
+{
+    if (mGameOver || !mMoved || mPtrSnake->getDirection() == Direction::None)
+    {
+        return 1.0f;
+    }
+    return std::min(1.0f, std::max(0.0f, mPtrSnake->getAccumulatedTime() * mPtrSnake->getSpeed()));
+}
+
+CellIndex Simulation::getVacatedTail() const
+{
+    return mVacatedTail;
+}
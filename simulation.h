@@ -0,0 +1,278 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "snake.h"
+#include "cell_grid.h"
+#include "event_bus.h"
+#include "timer_wheel.h"
+#include "food_manager.h"
+#include "constants.h"
+
+// 可复制状态的伪随机数发生器 (xorshift64*)
+// 相同的种子总是产生相同的食物序列，用于联机同步和回放
+class Random
+{
+public:
+    explicit Random(uint64_t seed = 1);
+    // 设置随机数种子
+    void seed(uint64_t seed);
+    // 生成 32 位随机数
+    uint32_t next();
+    // 生成 [0, bound) 之间的随机整数
+    int nextInt(int bound);
+    // 获取/恢复内部状态
+    uint64_t getState() const;
+    void setState(uint64_t state);
+
+private:
+    uint64_t mState;
+};
+
+// 快照格式版本，快照布局改变时递增
+const uint16_t SNAPSHOT_VERSION = 4;
+
+// 特殊效果计时的时间单位 (秒) 和持续时间 (帧)
+const float EFFECT_TICK_SECONDS = 0.01f;
+const uint32_t EFFECT_DURATION_TICKS = 1000; // 10 秒
+
+// 定时器类型，保存在定时器 payload 的高 8 位，低 24 位是参数
+enum class TimerKind : uint8_t
+{
+    Effect = 0,    // 特殊效果到期，参数为 FoodType
+    FoodExpiry = 1 // 食物到期消失，参数为格子编号 (CellIndex)
+};
+
+// 方向输入，带有按键发生的时间戳 (微秒，时钟由调用者决定，0 表示没有时间戳)
+struct DirectionInput
+{
+    Direction direction;
+    uint64_t timestamp;
+};
+
+// 游戏模拟类，负责与渲染无关的游戏逻辑：蛇、食物、障碍物、得分和特殊效果
+// 不依赖 SDL，可以在无界面的服务器、机器人和基准测试中使用
+class Simulation
+{
+public:
+    // 游戏区域宽度和高度 (像素)，与 Snake 的构造函数保持一致
+    // 包括外圈在内的格子数不能超过 CellIndex 能表示的范围 (16 位编号最大 254x254)
+    Simulation(int gameBoardWidth, int gameBoardHeight, int initialSnakeLength);
+
+    // 按照给定的设置和随机种子开始新的一局
+    // 蛇、食物表、定时器和输入缓冲在整个 Simulation 的生命周期内复用，第一局之后重新开始不再分配内存
+    void reset(GameMode mode, Difficulty difficulty, MapType mapType, uint64_t seed);
+
+    // 方向输入缓冲，timestamp 为按键发生的时间，用于测量输入延迟
+    void addDirectionToQueue(Direction newDirection, uint64_t timestamp = 0);
+    // 从输入缓冲中取出一个方向并应用到蛇上
+    // update 在蛇每次移动之前调用，按键在到达之后的第一次移动生效，每次移动应用一个输入
+    void updateSnakeDirection();
+    // 取出最近一次移动所应用的输入的时间戳，每个输入只返回一次，没有时返回 false
+    bool takeAppliedInput(uint64_t &timestamp);
+    // 暂停/继续
+    void togglePause();
+
+    // 一次 update 或 tick 最多移动的次数 (安全阀)，超过时丢弃多余的时间 (最多保留一次移动的时间)
+    static const int DEFAULT_MAX_MOVES_PER_TICK = 64;
+    // 按实际经过的时间推进的前端建议的卡顿上限 (秒)：远大于一帧，只截断进程被挂起之类的卡顿
+    static constexpr float STALL_TICK_TIME = 0.25f;
+
+    // 更新游戏逻辑 (累积时间，按经过的时间移动蛇)，返回 false 表示游戏结束
+    // 经过的时间足够移动几次就移动几次，每次移动都应用输入、检查碰撞和食物，速度可以远高于调用频率
+    bool update(float deltaTime);
+    // 更新特殊效果计时器
+    void updateEffects(float deltaTime);
+    // 无界面模式下的一个完整逻辑帧：移动 (包括应用方向输入) 和效果计时
+    // 与 update 相同地按经过的时间移动多次，特殊效果计时按每次移动的时刻分段前进，效果到期后的移动使用新的速度
+    bool tick(float deltaTime);
+    // 设置一次 update 或 tick 最多移动的次数 (至少 1)
+    void setMaxMovesPerTick(int moves);
+    int getMaxMovesPerTick() const;
+    // 设置一次 update 或 tick 最多推进的时间 (秒)，更长的卡顿当作暂停；0 表示不限制 (默认)
+    // 固定步长和锁步的调用者给出的就是逻辑时间，不能截断，只有按实际经过的时间推进的前端才打开
+    void setMaxTickTime(float seconds);
+    float getMaxTickTime() const;
+    // 因为达到最多移动次数而丢弃时间的次数
+    uint64_t getThrottledTicks() const;
+    // 这一局蛇实际移动的次数 (暂停时不计)
+    uint64_t getMoveCount() const;
+    // 设置不含特殊效果的基础速度 (格子/秒)，之后升级仍然在它的基础上增加，用于极高速度的测试和 SNAKE_SPEED
+    void setBaseSpeed(float speed);
+    // 不等待累积时间，立即移动一步 (包括应用方向输入)，特殊效果计时前进这一步的时间 (1 / 速度)
+    // 用于机器人搜索中按移动推进复制的状态
+    bool advanceMove();
+
+    // 设置同时存在的食物数量和食物寿命 (计时单位，0 表示永不消失)，在 reset 之前调用
+    void setFoodOptions(int count, uint32_t lifetimeTicks);
+    // 在随机的空格子上创建一个食物，没有空格子时返回 false
+    bool createRamdomFood();
+    // 补充食物，直到达到设置的数量
+    void spawnFood();
+    // 调整游戏难度
+    void adjustDelay();
+
+    // 当前状态的校验和，用于联机同步时检测状态不一致
+    // 蛇身、食物、障碍物和特殊效果由 Zobrist 哈希代表，其余的是几个标量，计算是 O(1)
+    uint32_t checksum() const;
+    // 状态的 Zobrist 哈希 (蛇身、蛇头、方向、食物、障碍物和特殊效果层数，见 zobrist.h)
+    // 每次移动、添加/删除食物、特殊效果和方向改变时增量更新，可以用作机器人搜索的置换表键
+    uint64_t getHash() const;
+    // 从头计算哈希 (遍历蛇身、食物和障碍物)，用于验证增量更新的结果
+    uint64_t computeHash() const;
+
+    // 把完整的游戏状态写入紧凑的二进制快照 (带版本号，小端序)
+    // 格子以 u16 编号保存 (与 CellIndex 的编号规则相同)，蛇头越界一格 (撞墙) 时也能表示
+    void saveSnapshot(std::vector<uint8_t> &out) const;
+    // 从快照恢复游戏状态，版本或游戏区域尺寸不匹配时返回 false 且不修改状态
+    bool loadSnapshot(const uint8_t *data, size_t size);
+    // 直接设置蛇身 (用于基准测试构造长蛇)
+    void setSnakeBody(const std::vector<SnakeBody> &body);
+    // 复制另一局的完整状态 (不包括事件总线)，游戏区域大小不同时返回 false 且不修改状态
+    // 比快照便宜：各个数组直接复制，容量足够时不分配内存，用于机器人搜索复制当前局面
+    bool copyFrom(const Simulation &other);
+    // 重新设置随机数种子，只改变之后生成的食物；机器人搜索中用来模拟未知的食物位置
+    void reseedRandom(uint64_t seed);
+    // 设置事件总线，吃到食物、特殊效果、升级、碰撞和游戏结束时发布事件 (可以为空)
+    void setEventBus(EventBus *eventBus);
+
+    bool isGameOver() const;
+    GameMode getGameMode() const;
+    const Snake &getSnake() const;
+    const FoodManager &getFoods() const;
+    const std::vector<CellIndex> &getObstacles() const;
+    // 格子编号规则，用于把蛇身、食物和障碍物的格子编号转换成坐标
+    const CellGrid &getGrid() const;
+    int getPoints() const;
+    int getDifficulty() const;
+    int getBoardWidth() const;
+    int getBoardHeight() const;
+    // 某种特殊效果当前叠加的层数
+    int getActiveEffects(FoodType type) const;
+    // 距离上一次移动经过的时间占移动间隔的比例 (0 到 1)，用于在两个格子之间插值绘制蛇头和蛇尾
+    // 还没有移动过、暂停或者游戏结束时为 1 (蛇停在格子上)
+    float getMoveProgress() const;
+    // 上一次移动时蛇尾离开的格子，蛇增长了或者还没有移动过时为 NO_CELL
+    CellIndex getVacatedTail() const;
+
+    // 是否使用按模式和区域大小特化的移动步骤 (默认使用)，关闭后使用通用版本，用于基准测试对比
+    // 在下一次 reset 或 loadSnapshot 时生效
+    void setSpecializedStep(bool enabled);
+    // 当前使用的移动步骤的名字
+    const char *getStepName() const;
+
+private:
+    // 游戏区域宽度和高度 (像素)
+    const int mGameBoardWidth;
+    const int mGameBoardHeight;
+    // 游戏区域宽度和高度 (格子)
+    const int mBoardColumns;
+    const int mBoardRows;
+    // 格子编号规则
+    const CellGrid mGrid;
+    // 蛇的初始长度
+    const int mInitialSnakeLength;
+
+    GameMode mGameMode = GameMode::Bounded;
+    Random mRandom;
+    std::unique_ptr<Snake> mPtrSnake;
+    std::vector<CellIndex> mObstacles;
+    // 食物：按格子索引，蛇头查找食物是 O(1)
+    FoodManager mFoods;
+    int mFoodCount = 1;
+    uint32_t mFoodLifetime = 0;
+
+    // 方向输入缓冲：固定容量的环形队列，不分配内存
+    static const int MAX_QUEUE_SIZE = 3; // Maximum number of buffered inputs
+    DirectionInput mDirectionQueue[MAX_QUEUE_SIZE];
+    int mQueueHead = 0; // 最早的输入
+    int mQueueSize = 0;
+    Direction mCurrentDirection = Direction::Up;
+    // 最近一次移动所应用的输入的时间戳
+    uint64_t mAppliedInputTime = 0;
+    bool mHasAppliedInput = false;
+    bool isValidDirection(Direction newDirection);
+    Direction getOppositeDirection(Direction dir);
+
+    // 添加和删除食物，同时更新哈希
+    void addFood(CellIndex cell, FoodType type, TimerWheel::TimerId timer = TimerWheel::INVALID_TIMER);
+    bool removeFood(CellIndex cell, FoodItem &removed);
+    // 吃到食物后的效果和得分
+    void applyFood(const FoodItem &food);
+    // 吃掉格子上的食物
+    void eatFood(CellIndex cell);
+
+    // 蛇移动一步并返回碰撞类型，开始一局时按模式和区域大小选择一次
+    typedef CollisionType (Simulation::*StepFunction)();
+    StepFunction mStep = nullptr;
+    const char *mStepName = "";
+    bool mSpecializedStep = true;
+    void selectStep();
+    template <typename Mode>
+    void selectBoardStep();
+    // 通用版本：每次移动都判断模式
+    CollisionType stepGeneric();
+    // 特化版本：模式和区域大小是模板参数 (board_policy.h)
+    template <typename Mode, typename Board>
+    CollisionType stepSpecialized();
+    // 蛇移动一步后更新哈希：蛇头移动到新的格子，没有增长时蛇尾离开 oldTail
+    void hashMove(CellIndex oldHead, CellIndex oldTail, bool grew);
+    // 蛇的方向可能改变之后更新哈希
+    void hashDirection(Direction previous);
+    // 应用方向输入并移动一步，检查碰撞，返回 false 表示游戏结束
+    bool move();
+    // 检查蛇头是否撞到障碍物
+    bool hitObstacle() const;
+    // 检查碰撞类型
+    CollisionType checkCollision();
+    // 发布事件
+    void publish(GameEventType type, CellIndex position, int32_t value = 0,
+                 FoodType foodType = FoodType::Normal, CollisionType collision = CollisionType::None);
+    EventBus *mEventBus = nullptr;
+
+    // 特殊效果：每次吃到特殊食物都添加一个独立的定时器，效果可以叠加
+    // 蛇的速度 = (基础速度 + 5 * 加速层数) * 0.8 ^ 减速层数
+    TimerWheel mTimers;
+    // 除食物寿命之外预留的定时器数量 (同时生效的特殊效果)
+    static const int TIMER_RESERVE = 256;
+    float mBaseSpeed = 15.0f;           // 不含特殊效果的速度 (难度和升级)
+    int mActiveEffects[4] = {0};        // 按 FoodType 统计的生效层数
+    float mEffectAccumulator = 0.0f;    // 不足一个计时单位的剩余时间
+    std::vector<uint32_t> mExpiredTimers;
+    // 添加特殊效果
+    void startEffect(FoodType type);
+    // 改变特殊效果的层数，同时更新哈希
+    void changeEffect(FoodType type, int delta);
+    // 处理到期的定时器
+    void onTimerExpired(uint32_t payload);
+    // 根据基础速度和生效的特殊效果计算蛇的速度
+    void updateSpeed();
+
+    // 玩家得分
+    int mPoints = 0;
+    // 游戏难度等级
+    int mDifficulty = 0;
+    // 游戏是否已经结束
+    bool mGameOver = false;
+    // 增量更新的 Zobrist 哈希，开始一局、恢复快照和直接设置蛇身时从头计算
+    uint64_t mHash = 0;
+    // 上一次 move 是否移动了蛇，以及蛇尾离开的格子 (插值绘制使用)
+    bool mMoved = false;
+    CellIndex mVacatedTail = NO_CELL;
+    // 按经过的时间移动：一次最多移动的次数、达到上限的次数和实际移动的次数
+    int mMaxMovesPerTick = DEFAULT_MAX_MOVES_PER_TICK;
+    float mMaxTickTime = 0.0f;
+    uint64_t mThrottledTicks = 0;
+    uint64_t mMoveCount = 0;
+    // update 和 tick 的实现：effects 为 true 时特殊效果计时在每次移动之前推进到移动的时刻
+    bool advance(float deltaTime, bool effects);
+    // 快照中每隔 stride 字节一个的格子编号是否有效：allowBorder 为 false 时必须在游戏区域内，否则可以在外圈上
+    bool validCells(const uint8_t *cells, int count, int stride, bool allowBorder) const;
+    // 恢复快照时解码蛇身用的缓冲区
+    std::vector<CellIndex> mSnapshotBody;
+};
+
+#endif
@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <chrono>
+
+#include "simulation_thread.h"
+
+// 构造函数
+SimulationThread::SimulationThread(Simulation &simulation, int tickRate)
+    : mSimulation(simulation), mTickRate(std::max(1, tickRate)), mIntervals(MAX_INTERVAL_SAMPLES)
+{
+}
+
+// 析构函数
+SimulationThread::~SimulationThread()
+{
+    stop();
+}
+
+void SimulationThread::setClock(Clock clock)
+{
+    mClock = clock;
+}
+
+void SimulationThread::setAutopilot(Autopilot autopilot, void *context)
+{
+    mAutopilot = autopilot;
+    mAutopilotContext = context;
+}
+
+void SimulationThread::setSaveInterval(float seconds)
+{
+    mSaveInterval = seconds;
+}
+
+// 发布当前状态并启动线程
+bool SimulationThread::start()
+{
+    if (mRunning)
+    {
+        return false;
+    }
+    // 三个缓冲区都先复制一次当前状态，之后的复制不再分配内存，渲染线程在第一个逻辑帧之前也有画面
+    uint64_t ticks = mTicks.load(std::memory_order_relaxed);
+    for (int i = 0; i < 3; i++)
+    {
+        mSnapshots.getBuffer(i).capture(mSimulation, ticks);
+        mSnapshots.getBuffer(i).time = now();
+    }
+    mSnapshots.publish();
+    mStop.store(false);
+    mFinished.store(false);
+    mRunning = true;
+    mThread = std::thread(&SimulationThread::run, this);
+    return true;
+}
+
+// 停止并等待线程结束
+void SimulationThread::stop()
+{
+    if (!mRunning)
+    {
+        return;
+    }
+    mStop.store(true);
+    mThread.join();
+    mRunning = false;
+    // 丢弃还没有应用的命令，下一次 start 不会应用上一局的按键
+    SimulationCommand command;
+    while (mCommands.pop(command))
+    {
+    }
+}
+
+bool SimulationThread::isRunning() const
+{
+    return mRunning;
+}
+
+bool SimulationThread::isFinished() const
+{
+    return mFinished.load(std::memory_order_acquire);
+}
+
+// 发送方向命令
+bool SimulationThread::addDirection(Direction direction, uint64_t timestamp)
+{
+    return mCommands.push({SimulationCommand::Turn, direction, timestamp});
+}
+
+// 发送暂停命令
+bool SimulationThread::togglePause()
+{
+    return mCommands.push({SimulationCommand::TogglePause, Direction::None, 0});
+}
+
+bool SimulationThread::takeAppliedInput(AppliedInput &input)
+{
+    return mAppliedInputs.pop(input);
+}
+
+// 取得最新发布的快照
+const BoardSnapshot &SimulationThread::acquireSnapshot()
+{
+    mSnapshots.update();
+    return mSnapshots.getReadBuffer();
+}
+
+// 取出最近复制的存档
+bool SimulationThread::takeSaveSnapshot(std::vector<uint8_t> &out)
+{
+    std::lock_guard<std::mutex> lock(mSaveMutex);
+    if (!mHasSave)
+    {
+        return false;
+    }
+    // 交换而不是复制，两个缓冲区交替使用
+    out.swap(mSaveBuffer);
+    mHasSave = false;
+    return true;
+}
+
+// 相邻两个逻辑帧开始时刻的间隔 (毫秒)
+std::vector<double> SimulationThread::getTickIntervals() const
+{
+    size_t count = mIntervalCount.load(std::memory_order_acquire);
+    std::vector<double> intervals(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        intervals[i] = mIntervals[i] / 1000.0;
+    }
+    return intervals;
+}
+
+uint64_t SimulationThread::getTicks() const
+{
+    return mTicks.load(std::memory_order_relaxed);
+}
+
+uint64_t SimulationThread::getResyncs() const
+{
+    return mResyncs.load(std::memory_order_relaxed);
+}
+
+int SimulationThread::getTickRate() const
+{
+    return mTickRate;
+}
+
+// 取出并应用输入命令
+void SimulationThread::applyCommands()
+{
+    SimulationCommand command;
+    while (mCommands.pop(command))
+    {
+        switch (command.type)
+        {
+        case SimulationCommand::Turn:
+            mSimulation.addDirectionToQueue(command.direction, command.timestamp);
+            break;
+        case SimulationCommand::TogglePause:
+            mSimulation.togglePause();
+            break;
+        }
+    }
+}
+
+// 模拟线程：按固定间隔推进一个逻辑帧并发布快照
+void SimulationThread::run()
+{
+    using clock = std::chrono::steady_clock;
+    const auto period = std::chrono::nanoseconds(1000000000LL / mTickRate);
+    const float deltaTime = 1.0f / mTickRate;
+    const uint64_t saveTicks = static_cast<uint64_t>(mSaveInterval * mTickRate);
+
+    auto next = clock::now() + period;
+    auto previous = clock::time_point();
+    uint64_t ticksSinceSave = 0;
+    CellIndex lastHead = NO_CELL;
+    while (!mStop.load(std::memory_order_relaxed))
+    {
+        std::this_thread::sleep_until(next);
+        auto begin = clock::now();
+        if (previous != clock::time_point())
+        {
+            size_t count = mIntervalCount.load(std::memory_order_relaxed);
+            if (count < MAX_INTERVAL_SAMPLES)
+            {
+                auto interval = std::chrono::duration_cast<std::chrono::microseconds>(begin - previous).count();
+                mIntervals[count] = static_cast<uint32_t>(std::min<int64_t>(interval, UINT32_MAX));
+                mIntervalCount.store(count + 1, std::memory_order_release);
+            }
+        }
+        previous = begin;
+
+        applyCommands();
+        // 自动操作：蛇头移动到新的格子之后才选择下一个方向，每次移动最多一个输入
+        if (mAutopilot != nullptr && mSimulation.getSnake().getHead() != lastHead)
+        {
+            mSimulation.addDirectionToQueue(mAutopilot(mSimulation, mAutopilotContext));
+            lastHead = mSimulation.getSnake().getHead();
+        }
+        bool alive = mSimulation.tick(deltaTime);
+        uint64_t tick = mTicks.fetch_add(1, std::memory_order_relaxed) + 1;
+        uint64_t inputTime;
+        if (mSimulation.takeAppliedInput(inputTime))
+        {
+            mAppliedInputs.push({inputTime, mClock(), tick});
+        }
+
+        // 写入自己的缓冲区后发布，渲染线程不会读到写了一半的快照
+        mSnapshots.getWriteBuffer().capture(mSimulation, tick);
+        mSnapshots.getWriteBuffer().time = now();
+        mSnapshots.publish();
+
+        // 游戏结束的状态不需要存档
+        if (alive && saveTicks > 0 && ++ticksSinceSave >= saveTicks && mSaveMutex.try_lock())
+        {
+            mSimulation.saveSnapshot(mSaveBuffer);
+            mHasSave = true;
+            mSaveMutex.unlock();
+            ticksSinceSave = 0;
+        }
+
+        if (!alive)
+        {
+            // 最后一个快照带有 gameOver，之后不再推进
+            mFinished.store(true, std::memory_order_release);
+            break;
+        }
+
+        // 按计划时刻推进，偶尔的延迟在之后的逻辑帧中追回；落后太多 (例如进程被挂起) 时重新计时
+        next += period;
+        if (clock::now() - next > MAX_CATCH_UP_TICKS * period)
+        {
+            next = clock::now();
+            mResyncs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+// 单调时钟 (微秒)
+uint64_t SimulationThread::now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
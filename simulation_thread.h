@@ -0,0 +1,131 @@
+#ifndef SIMULATION_THREAD_H
+#define SIMULATION_THREAD_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "board_snapshot.h"
+#include "event_bus.h"
+#include "simulation.h"
+#include "triple_buffer.h"
+
+// 发给模拟线程的输入命令
+struct SimulationCommand
+{
+    enum Type : uint8_t
+    {
+        Turn,       // 改变方向
+        TogglePause // 暂停/继续
+    };
+    Type type;
+    Direction direction;
+    uint64_t timestamp; // 按键发生的时间 (微秒)
+};
+
+// 模拟线程应用了一个输入
+struct AppliedInput
+{
+    uint64_t timestamp;   // 按键发生的时间 (微秒)
+    uint64_t appliedTime; // 蛇按这个输入移动的时间 (微秒，与 timestamp 使用同一个时钟)
+    uint64_t tick;        // 移动发生在第几个逻辑帧，画面显示这个逻辑帧时输入才可见
+};
+
+// 在独立的线程中按固定的逻辑帧率推进 Simulation，渲染再慢也不会推迟逻辑帧
+// 每个逻辑帧之后把蛇身、食物、障碍物和得分复制到三缓冲中发布，渲染线程总是绘制最新的完整快照
+// 输入命令和应用输入的记录各用一个 SPSC 队列传递，游戏事件仍然经过 EventBus (发布者是模拟线程)
+// 线程运行期间只有模拟线程访问 Simulation，其他线程只能在 stop 之后访问
+class SimulationThread
+{
+public:
+    // 保存的逻辑帧间隔样本数，超过后不再记录
+    static const size_t MAX_INTERVAL_SAMPLES = 1 << 16;
+    // 落后超过这么多个逻辑帧时放弃追赶，从当前时刻重新计时
+    static const int MAX_CATCH_UP_TICKS = 5;
+
+    // 时钟函数 (微秒)，输入的时间戳和应用时间使用它
+    typedef uint64_t (*Clock)();
+    // 自动操作：蛇每次移动之后在模拟线程中调用，返回下一次移动的方向 (context 是设置时给出的指针)
+    typedef Direction (*Autopilot)(const Simulation &simulation, void *context);
+
+    // tickRate 为每秒的逻辑帧数，每个逻辑帧用固定的时间步长推进模拟
+    SimulationThread(Simulation &simulation, int tickRate = 120);
+    ~SimulationThread();
+
+    // 设置输入时间戳的时钟 (默认 steady_clock)，在 start 之前调用
+    void setClock(Clock clock);
+    // 每隔多少秒复制一次存档 (0 表示不复制)，在 start 之前调用
+    void setSaveInterval(float seconds);
+    // 设置自动操作 (nullptr 表示由输入命令操作)，用于无人值守的长时间运行，在 start 之前调用
+    void setAutopilot(Autopilot autopilot, void *context);
+
+    // 发布当前状态并启动线程，返回 false 表示线程已经在运行
+    bool start();
+    // 停止并等待线程结束，之后可以在调用线程中访问 Simulation
+    void stop();
+    bool isRunning() const;
+    // 模拟线程是否因为游戏结束而停止了推进
+    bool isFinished() const;
+
+    // 主线程：发送方向和暂停命令，队列已满时返回 false
+    bool addDirection(Direction direction, uint64_t timestamp);
+    bool togglePause();
+    // 主线程：取出模拟线程应用了的输入，没有时返回 false
+    bool takeAppliedInput(AppliedInput &input);
+
+    // 渲染线程：取得最新发布的快照，引用在下一次调用之前有效
+    const BoardSnapshot &acquireSnapshot();
+    // 主线程：取出模拟线程最近复制的存档，没有新存档时返回 false
+    bool takeSaveSnapshot(std::vector<uint8_t> &out);
+
+    // 统计 (线程停止之后读取的值是完整的)
+    // 相邻两个逻辑帧开始时刻的间隔 (毫秒)
+    std::vector<double> getTickIntervals() const;
+    uint64_t getTicks() const;
+    // 因为落后太多而重新计时的次数
+    uint64_t getResyncs() const;
+    int getTickRate() const;
+
+    // 单调时钟 (微秒)
+    static uint64_t now();
+
+private:
+    Simulation &mSimulation;
+    const int mTickRate;
+    Clock mClock = &SimulationThread::now;
+    float mSaveInterval = 0.0f;
+    Autopilot mAutopilot = nullptr;
+    void *mAutopilotContext = nullptr;
+
+    std::thread mThread;
+    std::atomic<bool> mStop{false};
+    std::atomic<bool> mFinished{false};
+    bool mRunning = false;
+
+    SpscRing<SimulationCommand, 64> mCommands;      // 主线程 -> 模拟线程
+    SpscRing<AppliedInput, 64> mAppliedInputs;      // 模拟线程 -> 主线程
+    TripleBuffer<BoardSnapshot> mSnapshots;         // 模拟线程 -> 渲染线程
+
+    // 存档：模拟线程只在能立即拿到锁时复制，不会等待主线程写文件
+    std::mutex mSaveMutex;
+    std::vector<uint8_t> mSaveBuffer;
+    bool mHasSave = false;
+
+    // 统计
+    std::atomic<uint64_t> mTicks{0};
+    std::atomic<uint64_t> mResyncs{0};
+    // 间隔样本 (微秒) 只追加不覆盖，mIntervalCount 发布已经写好的样本数
+    std::vector<uint32_t> mIntervals;
+    std::atomic<size_t> mIntervalCount{0};
+
+    void run();
+    // 取出并应用输入命令
+    void applyCommands();
+
+    SimulationThread(const SimulationThread &) = delete;
+    SimulationThread &operator=(const SimulationThread &) = delete;
+};
+
+#endif
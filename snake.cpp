@@ -1,32 +1,32 @@
 #include <string>
 #include <cstdlib>
 #include <ctime>
-#include <SDL2/SDL.h> //  添加 SDL 头文件
+#include <algorithm>
 #include "snake.h"
 #include "constants.h"
-// 蛇身体部位类
+// 格子坐标
 SnakeBody::SnakeBody()
 {
 }
 
-// 蛇身体部位类构造函数，初始化蛇身体部位的坐标
+// 构造函数，初始化格子坐标
 SnakeBody::SnakeBody(int x, int y) : mX(x), mY(y)
 {
 }
 
-// 获取蛇身体部位的横坐标
+// 获取横坐标
 int SnakeBody::getX() const
 {
     return mX;
 }
 
-// 获取蛇身体部位的纵坐标
+// 获取纵坐标
 int SnakeBody::getY() const
 {
     return mY;
 }
 
-// 重载 == 运算符，用于比较两个蛇身体部位是否相同
+// 重载 == 运算符，用于比较两个坐标是否相同
 bool SnakeBody::operator==(const SnakeBody &snakeBody) const
 {
     // 比较两个 SnakeBody 对象的横坐标和纵坐标是否相同
@@ -37,7 +37,8 @@ bool SnakeBody::operator==(const SnakeBody &snakeBody) const
 Snake::Snake(int gameBoardWidth, int gameBoardHeight, int initialSnakeLength)
     : mGameBoardWidth(gameBoardWidth / GRID_SIZE),
       mGameBoardHeight(gameBoardHeight / GRID_SIZE),
-      mInitialSnakeLength(initialSnakeLength)
+      mInitialSnakeLength(initialSnakeLength),
+      mGrid(mGameBoardWidth, mGameBoardHeight)
 {
     // 初始化蛇
     this->initializeSnake();
@@ -48,6 +49,20 @@ Snake::Snake(int gameBoardWidth, int gameBoardHeight, int initialSnakeLength, Ga
     : mGameBoardWidth(gameBoardWidth / GRID_SIZE),
       mGameBoardHeight(gameBoardHeight / GRID_SIZE),
       mInitialSnakeLength(initialSnakeLength),
+      mGrid(mGameBoardWidth, mGameBoardHeight),
+      gameMode(mode)
+{
+    // 初始化蛇
+    this->initializeSnake();
+    // 设置随机数种子
+    this->setRandomSeed();
+}
+
+Snake::Snake(const CellGrid &grid, int initialSnakeLength, GameMode mode)
+    : mGameBoardWidth(grid.getColumns()),
+      mGameBoardHeight(grid.getRows()),
+      mInitialSnakeLength(initialSnakeLength),
+      mGrid(grid),
       gameMode(mode)
 {
     // 初始化蛇
@@ -56,6 +71,16 @@ Snake::Snake(int gameBoardWidth, int gameBoardHeight, int initialSnakeLength, Ga
     this->setRandomSeed();
 }
 
+// 重新开始
+void Snake::reset(GameMode mode)
+{
+    this->gameMode = mode;
+    this->mFood = NO_CELL;
+    this->mSpeed = 15.0f;
+    this->mAccumulatedTime = 0.0f;
+    this->initializeSnake();
+}
+
 // 设置随机数种子
 void Snake::setRandomSeed()
 {
@@ -69,11 +94,12 @@ void Snake::initializeSnake()
     int centerX = this->mGameBoardWidth / 2;
     int centerY = this->mGameBoardHeight / 2;
 
-    // 初始化蛇的身体部位
+    // 初始化蛇的身体部位，预留整个游戏区域的格子 (加上越界的蛇头)，蛇变长时不再扩容
+    this->mSnake.reserve(static_cast<size_t>(this->mGameBoardWidth) * this->mGameBoardHeight + 1);
     this->mSnake.resize(this->mInitialSnakeLength);
     for (int i = 0; i < this->mInitialSnakeLength; i++)
     {
-        this->mSnake[i] = SnakeBody(centerX, centerY + i);
+        this->mSnake[i] = this->mGrid.toCell(centerX, centerY + i);
     }
     // 设置蛇的初始方向为向上
     this->mDirection = Direction::Up;
@@ -82,17 +108,18 @@ void Snake::initializeSnake()
 // 判断给定坐标点是否在蛇的身体上
 bool Snake::isPartOfSnake(int x, int y) const
 {
-    // 遍历蛇的身体部分
-    for (const auto &part : mSnake)
+    // 蛇身最多越界一格 (撞墙后的蛇头)，更远的坐标不可能在蛇身上
+    if (x < -1 || x > mGameBoardWidth || y < -1 || y > mGameBoardHeight)
     {
-        // 如果找到匹配的坐标，返回 true
-        if (part.getX() == x && part.getY() == y)
-        {
-            return true;
-        }
+        return false;
     }
-    // 如果没有找到匹配的坐标，返回 false
-    return false;
+    return this->isPartOfSnake(mGrid.toCell(x, y));
+}
+
+// 判断给定格子是否在蛇的身体上：比较紧凑的格子编号
+bool Snake::isPartOfSnake(CellIndex cell) const
+{
+    return containsCell(mSnake.data(), mSnake.size(), cell);
 }
 
 /*
@@ -103,20 +130,21 @@ bool Snake::isPartOfSnake(int x, int y) const
 // 判断蛇是否撞到墙壁
 bool Snake::hitWall()
 {
-    // 获取蛇头的坐标
-    int headX = mSnake[0].getX();
-    int headY = mSnake[0].getY();
+    // 蛇头在游戏区域内 (不在外圈上)
+    if (mGrid.isInside(mSnake[0]))
+    {
+        return false;
+    }
 
     if (gameMode == GameMode::Bounded)
     {
-        // 检查蛇头是否超出游戏板的边界
-        if (headX < 0 || headX >= mGameBoardWidth || headY < 0 || headY >= mGameBoardHeight)
-        {
-            return true; // 蛇头撞到墙壁
-        }
+        return true; // 蛇头撞到墙壁
     }
     else
     { //  无边界模式
+        // createNewHead 已经把蛇头放在游戏区域内，只有直接设置的蛇身才需要调整
+        int headX = mGrid.getX(mSnake[0]);
+        int headY = mGrid.getY(mSnake[0]);
         //  如果蛇头超出边界，则将其坐标调整到另一侧
         if (headX < 0)
         {
@@ -134,7 +162,7 @@ bool Snake::hitWall()
         {
             headY = 0;
         }
-        mSnake[0] = SnakeBody(headX, headY); //  更新蛇头坐标
+        mSnake[0] = mGrid.toCell(headX, headY); //  更新蛇头坐标
     }
 
     return false; // 蛇头没有撞到墙壁
@@ -146,29 +174,15 @@ bool Snake::hitWall()
 // 判断蛇是否撞到自身
 bool Snake::hitSelf() const
 {
-    // 判断蛇是否撞到自身
-    // 获取蛇头的坐标
-    int headX = mSnake[0].getX();
-    int headY = mSnake[0].getY();
-    // 遍历蛇的身体部分（从第二个开始）
-    for (size_t i = 1; i < mSnake.size(); ++i)
-    {
-        // 如果蛇头的坐标与身体的某个部分的坐标重叠，返回 true
-        if (headX == mSnake[i].getX() && headY == mSnake[i].getY())
-        {
-            return true;
-        }
-    }
-
-    // 如果没有重叠，返回 false
-    return false;
+    // 判断蛇是否撞到自身：蛇头的格子编号是否出现在身体的其他部分中 (从第二个开始)
+    return containsCell(mSnake.data() + 1, mSnake.size() - 1, mSnake[0]);
 }
 
 // 判断蛇是否接触到食物
 bool Snake::touchFood() const
 {
     // 获取蛇头的下一个位置
-    SnakeBody newHead = this->createNewHead();
+    CellIndex newHead = this->createNewHead();
     // 判断蛇头下一个位置是否与食物重合
     if (this->mFood == newHead)
     {
@@ -181,17 +195,27 @@ bool Snake::touchFood() const
 }
 
 // 让蛇感知到食物的位置
-void Snake::senseFood(const SnakeBody &food) //  参数改为 const 引用
+void Snake::senseFood(CellIndex food)
 {
     this->mFood = food;
 }
 
-// 获取蛇的身体部位列表
-const std::vector<SnakeBody> &Snake::getSnake() const //  返回 const 引用，添加 const
+// 获取蛇身占据的格子
+const std::vector<CellIndex> &Snake::getCells() const
 {
     return this->mSnake;
 }
 
+CellIndex Snake::getHead() const
+{
+    return this->mSnake[0];
+}
+
+const CellGrid &Snake::getGrid() const
+{
+    return this->mGrid;
+}
+
 // 改变蛇的移动方向
 bool Snake::changeDirection(Direction newDirection)
 {
@@ -251,31 +275,17 @@ bool Snake::changeDirection(Direction newDirection)
     return false;
 }
 
-// 生成蛇头的下一个位置
-SnakeBody Snake::createNewHead() const
+// 生成蛇头的下一个位置：格子编号加上移动方向的偏移量
+CellIndex Snake::createNewHead() const
 {
-    int headX = mSnake[0].getX();
-    int headY = mSnake[0].getY();
+    CellIndex newHead = mGrid.neighbor(mSnake[0], mDirection);
 
-    switch (mDirection)
+    // 无边界模式下蛇头从另一侧进入，查找食物和移动都使用调整后的位置
+    if (gameMode == GameMode::Unbounded && !mGrid.isInside(newHead))
     {
-    case Direction::Up:
-        headY--; //  每次移动一个网格单位
-        break;
-    case Direction::Down:
-        headY++;
-        break;
-    case Direction::Left:
-        headX--;
-        break;
-    case Direction::Right:
-        headX++;
-        break;
-    case Direction::None:
-        break;
+        newHead = mGrid.wrap(newHead, mDirection);
     }
-
-    return SnakeBody(headX, headY);
+    return newHead;
 }
 /*
  * 如果吃到食物，返回true，否则返回false
@@ -283,11 +293,15 @@ SnakeBody Snake::createNewHead() const
 // 移动蛇
 bool Snake::moveFoward()
 {
-    // 获取蛇头的下一个位置
-    SnakeBody newHead = this->createNewHead();
+    return this->moveTo(this->createNewHead());
+}
+
+// 蛇头移动到 newHead
+bool Snake::moveTo(CellIndex newHead)
+{
     bool eatFood = false;
 
-    if (this->touchFood())
+    if (this->mFood == newHead)
     {
         // 蛇吃到了食物
         eatFood = true;
@@ -357,16 +371,48 @@ void Snake::setSpeed(float speed)
     mSpeed = speed;
 }
 
-void SnakeBody::setFoodType(FoodType type)
+std::vector<SnakeBody> Snake::getSnakebody() const
 {
-    mFoodType = type;
+    std::vector<SnakeBody> body;
+    body.reserve(this->mSnake.size());
+    for (CellIndex cell : this->mSnake)
+    {
+        body.push_back(SnakeBody(this->mGrid.getX(cell), this->mGrid.getY(cell)));
+    }
+    return body;
 }
 
-FoodType SnakeBody::getFoodType() const
+void Snake::setBody(const std::vector<SnakeBody> &body)
 {
-    return mFoodType;
+    this->mSnake.resize(body.size());
+    for (size_t i = 0; i < body.size(); i++)
+    {
+        this->mSnake[i] = this->mGrid.toCell(body[i].getX(), body[i].getY());
+    }
 }
-std::vector<SnakeBody> Snake::getSnakebody()
+
+void Snake::setCells(const std::vector<CellIndex> &cells)
 {
-    return this->mSnake;
+    this->mSnake = cells;
+}
+
+void Snake::setDirection(Direction direction)
+{
+    this->mDirection = direction;
+}
+
+void Snake::setAccumulatedTime(float accumulatedTime)
+{
+    this->mAccumulatedTime = accumulatedTime;
+}
+
+// 复制另一条蛇的状态
+void Snake::copyFrom(const Snake &other)
+{
+    this->gameMode = other.gameMode;
+    this->mDirection = other.mDirection;
+    this->mFood = other.mFood;
+    this->mSnake.assign(other.mSnake.begin(), other.mSnake.end());
+    this->mSpeed = other.mSpeed;
+    this->mAccumulatedTime = other.mAccumulatedTime;
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include "constants.h"
+#include "cell_grid.h"
 
 enum class GameMode
 {
@@ -40,33 +41,26 @@ enum class FoodType
     DoublePoints
 };
 
-// 蛇身体部位类
+// 格子坐标，用于构造蛇身和与格子编号相互转换 (游戏状态中保存的是格子编号 CellIndex)
 class SnakeBody
 {
 public:
     // 默认构造函数
     SnakeBody();
-    // 构造函数，初始化蛇身体部位的坐标
+    // 构造函数，初始化格子坐标
     SnakeBody(int x, int y);
-    // 获取蛇身体部位的横坐标
+    // 获取横坐标
     int getX() const;
-    // 获取蛇身体部位的纵坐标
+    // 获取纵坐标
     int getY() const;
-    // 重载 == 运算符，用于比较两个蛇身体部位是否相同
+    // 重载 == 运算符，用于比较两个坐标是否相同
     bool operator==(const SnakeBody &snakeBody) const;
-    // 设置食物类型
-    void setFoodType(FoodType type);
-
-    // 获取食物类型
-    FoodType getFoodType() const;
 
 private:
-    // 蛇身体部位的横坐标
-    int mX;
-    // 蛇身体部位的纵坐标
-    int mY;
-    // 食物类型
-    FoodType mFoodType;
+    // 横坐标
+    int mX = 0;
+    // 纵坐标
+    int mY = 0;
 };
 
 // 蛇类，负责蛇的逻辑实现
@@ -77,13 +71,19 @@ public:
     // Snake();
     Snake(int gameBoardWidth, int gameBoardHeight, int initialSnakeLength);
     Snake(int gameBoardWidth, int gameBoardHeight, int initialSnakeLength, GameMode mode);
+    // 使用已有的格子编号规则 (复制，不必重新计算)
+    Snake(const CellGrid &grid, int initialSnakeLength, GameMode mode);
     // 设置随机数种子
     void setRandomSeed();
     // 初始化蛇
     void initializeSnake();
+    // 按给定的模式重新开始：蛇身、方向、食物、速度和累积时间恢复初始值，复用蛇身的内存
+    void reset(GameMode mode);
     // 判断给定坐标点是否在蛇的身体上
     bool isPartOfSnake(int x, int y) const;
-    void senseFood(const SnakeBody &food);
+    bool isPartOfSnake(CellIndex cell) const;
+    // 让蛇感知食物所在的格子 (NO_CELL 表示没有食物)
+    void senseFood(CellIndex food);
     // 判断蛇是否接触到食物
     bool touchFood() const;
     // 判断蛇是否撞到墙壁
@@ -95,14 +95,19 @@ public:
 
     // 改变蛇的移动方向
     bool changeDirection(Direction newDirection);
-    // 获取蛇的身体部位列表
-    const std::vector<SnakeBody> &getSnake() const;
+    // 获取蛇身占据的格子，第一个是蛇头
+    const std::vector<CellIndex> &getCells() const;
+    CellIndex getHead() const;
+    // 格子编号规则
+    const CellGrid &getGrid() const;
     // 获取蛇的长度
     int getLength() const;
     // 生成蛇头的下一个位置
-    SnakeBody createNewHead() const;
+    CellIndex createNewHead() const;
     // 移动蛇
     bool moveFoward();
+    // 蛇头移动到 newHead (已经由调用者处理好边界)，吃到食物时蛇身增长，返回是否吃到食物
+    bool moveTo(CellIndex newHead);
     // 更新蛇的位置 (根据时间)
     void update(float deltaTime);
 
@@ -114,7 +119,15 @@ public:
     void resetAccumulatedTime();
     Direction getDirection() const;
     void setSpeed(float speed);
-    std::vector<SnakeBody> getSnakebody();
+    // 蛇身的坐标列表 (逐个从格子编号转换)
+    std::vector<SnakeBody> getSnakebody() const;
+    // 直接设置蛇身、方向和累积时间 (用于从快照恢复)
+    void setBody(const std::vector<SnakeBody> &body);
+    void setCells(const std::vector<CellIndex> &cells);
+    void setDirection(Direction direction);
+    void setAccumulatedTime(float accumulatedTime);
+    // 复制另一条蛇的状态 (游戏区域大小必须相同)，蛇身内存足够时不分配内存
+    void copyFrom(const Snake &other);
 
 private:
     // 游戏区域宽度
@@ -123,19 +136,21 @@ private:
     const int mGameBoardHeight;
     // 蛇的初始长度
     const int mInitialSnakeLength;
+    // 格子编号规则
+    const CellGrid mGrid;
     // 蛇的当前移动方向
     Direction mDirection;
-    // 食物的位置
-    SnakeBody mFood;
-    // 蛇的身体部位列表
-    std::vector<SnakeBody> mSnake;
+    // 食物所在的格子
+    CellIndex mFood = NO_CELL;
+    // 蛇身占据的格子，第一个是蛇头
+    std::vector<CellIndex> mSnake;
     // 蛇的移动速度 (每个网格单位/秒)
     float mSpeed = 15.0f;
 
     // 累积时间 (用于控制蛇的移动)
     float mAccumulatedTime = 0.0f;
 
-    GameMode gameMode;
+    GameMode gameMode = GameMode::Bounded;
 };
 
 #endif
\ No newline at end of file
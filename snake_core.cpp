@@ -0,0 +1,331 @@
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "snake_core.h"
+#include "simulation.h"
+
+// 观测中格子的种类，比平面编号大一 (0 表示空格子)
+enum CellCode : uint8_t
+{
+    CODE_EMPTY = 0,
+    CODE_BODY = SNAKECORE_PLANE_BODY + 1,
+    CODE_HEAD = SNAKECORE_PLANE_HEAD + 1,
+    CODE_FOOD = SNAKECORE_PLANE_FOOD + 1,
+    CODE_OBSTACLE = SNAKECORE_PLANE_OBSTACLE + 1
+};
+
+// 一个批次：N 局游戏和编码观测用的缓冲区，全部在创建时分配
+struct SnakeCoreBatch
+{
+    SnakeCoreConfig config;
+    GameMode mode = GameMode::Bounded;
+    Difficulty difficulty = Difficulty::Easy;
+    MapType mapType = MapType::Empty;
+    int32_t cells = 0; // 每个平面的格子数 (列数 x 行数)
+
+    std::vector<std::unique_ptr<Simulation>> games;
+    std::vector<uint64_t> seeds; // 每局当前使用的种子
+    std::vector<int32_t> moves;
+    std::vector<uint8_t> dones;
+
+    // 格子编号 (CellIndex) 到平面中位置的映射，外圈为 -1
+    std::vector<int32_t> planeIndex;
+    // 只有障碍物的格子种类表，所有局的障碍物相同
+    std::vector<uint8_t> obstacleCodes;
+    // 编码一局观测时的格子种类表
+    std::vector<uint8_t> codes;
+};
+
+static bool validConfig(const SnakeCoreConfig &config)
+{
+    if (config.columns < 8 || config.columns > 254 || config.rows < 8 || config.rows > 254)
+    {
+        return false;
+    }
+    // 障碍物地图的障碍物在固定的位置上 (simulation.cpp)
+    if (config.obstacles != 0 && (config.columns < 11 || config.rows < 16))
+    {
+        return false;
+    }
+    // 蛇从中心向下排列
+    if (config.initialLength < 1 || config.initialLength > config.rows - config.rows / 2)
+    {
+        return false;
+    }
+    return config.foodCount >= 1 && config.foodCount <= config.columns * config.rows / 2 && config.foodLifetime >= 0 &&
+           config.maxMoves >= 0;
+}
+
+// 开始第 index 局
+static void resetGame(SnakeCoreBatch &batch, int32_t index, uint64_t seed)
+{
+    batch.seeds[index] = seed;
+    batch.moves[index] = 0;
+    batch.dones[index] = 0;
+    batch.games[index]->reset(batch.mode, batch.difficulty, batch.mapType, seed);
+}
+
+// 把一局的格子种类表展开成 4 个独热平面
+// 种类表按平面中的位置排列，展开是对连续数组的逐元素比较：每块 32 个格子的内层循环次数固定且没有分支，
+// 两个数组标记为不重叠 (__restrict，种类表是批次自己的缓冲区)，
+// 编译器 (-O2) 可以把一块编译成几条 SIMD 比较指令 (与 containsCell 相同的写法)
+template <typename T>
+static void encodePlanes(const uint8_t *__restrict codes, int32_t cells, T *__restrict out)
+{
+    const int32_t BLOCK = 32;
+    for (int plane = 0; plane < SNAKECORE_PLANES; plane++)
+    {
+        const uint8_t code = static_cast<uint8_t>(plane + 1);
+        T *target = out + static_cast<size_t>(plane) * cells;
+        int32_t i = 0;
+        for (; i + BLOCK <= cells; i += BLOCK)
+        {
+            for (int32_t k = 0; k < BLOCK; k++)
+            {
+                target[i + k] = static_cast<T>(codes[i + k] == code);
+            }
+        }
+        for (; i < cells; i++)
+        {
+            target[i] = static_cast<T>(codes[i] == code);
+        }
+    }
+}
+
+// 编码一局的观测：从障碍物表复制，再写入食物、蛇身和蛇头 (撞到之后蛇头覆盖它撞到的格子)
+template <typename T>
+static void observeGame(SnakeCoreBatch &batch, const Simulation &game, T *out)
+{
+    uint8_t *codes = batch.codes.data();
+    const int32_t *planeIndex = batch.planeIndex.data();
+    std::memcpy(codes, batch.obstacleCodes.data(), batch.cells);
+    for (const FoodItem &food : game.getFoods().getItems())
+    {
+        codes[planeIndex[food.cell]] = CODE_FOOD;
+    }
+    const std::vector<CellIndex> &body = game.getSnake().getCells();
+    for (size_t i = 1; i < body.size(); i++)
+    {
+        codes[planeIndex[body[i]]] = CODE_BODY;
+    }
+    // 撞墙后的蛇头在外圈上，不在观测中
+    int32_t head = planeIndex[body.front()];
+    if (head >= 0)
+    {
+        codes[head] = CODE_HEAD;
+    }
+    encodePlanes(codes, batch.cells, out);
+}
+
+template <typename T>
+static int observeAll(SnakeCoreBatch *batch, T *out)
+{
+    if (batch == nullptr || out == nullptr)
+    {
+        return SNAKECORE_ERROR_ARGUMENT;
+    }
+    const size_t stride = static_cast<size_t>(SNAKECORE_PLANES) * batch->cells;
+    for (size_t i = 0; i < batch->games.size(); i++)
+    {
+        observeGame(*batch, *batch->games[i], out + i * stride);
+    }
+    return SNAKECORE_OK;
+}
+
+extern "C"
+{
+
+uint32_t snakecore_version(void)
+{
+    return SNAKECORE_VERSION;
+}
+
+void snakecore_default_config(SnakeCoreConfig *config)
+{
+    if (config == nullptr)
+    {
+        return;
+    }
+    config->columns = (WINDOW_WIDTH - 10 * GRID_SIZE) / GRID_SIZE;
+    config->rows = (WINDOW_HEIGHT - 2 * GRID_SIZE) / GRID_SIZE;
+    config->unbounded = 0;
+    config->hard = 0;
+    config->obstacles = 0;
+    config->initialLength = 2;
+    config->foodCount = 1;
+    config->foodLifetime = 0;
+    config->maxMoves = 2000;
+    config->autoReset = 1;
+}
+
+SnakeCoreBatch *snakecore_create(const SnakeCoreConfig *config, int32_t count, const uint64_t *seeds)
+{
+    if (config == nullptr || count < 1 || !validConfig(*config))
+    {
+        return nullptr;
+    }
+    try
+    {
+        std::unique_ptr<SnakeCoreBatch> batch(new SnakeCoreBatch());
+        batch->config = *config;
+        batch->mode = config->unbounded != 0 ? GameMode::Unbounded : GameMode::Bounded;
+        batch->difficulty = config->hard != 0 ? Difficulty::Hard : Difficulty::Easy;
+        batch->mapType = config->obstacles != 0 ? MapType::Obstacles : MapType::Empty;
+        batch->cells = config->columns * config->rows;
+        batch->seeds.resize(count);
+        batch->moves.resize(count);
+        batch->dones.resize(count);
+        batch->games.reserve(count);
+        for (int32_t i = 0; i < count; i++)
+        {
+            std::unique_ptr<Simulation> game(
+                new Simulation(config->columns * GRID_SIZE, config->rows * GRID_SIZE, config->initialLength));
+            game->setFoodOptions(config->foodCount, static_cast<uint32_t>(config->foodLifetime));
+            batch->games.push_back(std::move(game));
+            resetGame(*batch, i, seeds != nullptr ? seeds[i] : static_cast<uint64_t>(i) + 1);
+        }
+
+        const CellGrid &grid = batch->games[0]->getGrid();
+        batch->planeIndex.assign(grid.getCellCount(), -1);
+        for (int y = 0; y < config->rows; y++)
+        {
+            for (int x = 0; x < config->columns; x++)
+            {
+                batch->planeIndex[grid.toCell(x, y)] = y * config->columns + x;
+            }
+        }
+        batch->obstacleCodes.assign(batch->cells, CODE_EMPTY);
+        for (CellIndex cell : batch->games[0]->getObstacles())
+        {
+            batch->obstacleCodes[batch->planeIndex[cell]] = CODE_OBSTACLE;
+        }
+        batch->codes.resize(batch->cells);
+        return batch.release();
+    }
+    catch (const std::bad_alloc &)
+    {
+        return nullptr;
+    }
+}
+
+void snakecore_destroy(SnakeCoreBatch *batch)
+{
+    delete batch;
+}
+
+int32_t snakecore_batch_size(const SnakeCoreBatch *batch)
+{
+    return batch != nullptr ? static_cast<int32_t>(batch->games.size()) : 0;
+}
+
+int32_t snakecore_observation_size(const SnakeCoreBatch *batch)
+{
+    return batch != nullptr ? SNAKECORE_PLANES * batch->cells : 0;
+}
+
+int snakecore_reset(SnakeCoreBatch *batch, const uint64_t *seeds)
+{
+    if (batch == nullptr)
+    {
+        return SNAKECORE_ERROR_ARGUMENT;
+    }
+    const int32_t count = static_cast<int32_t>(batch->games.size());
+    for (int32_t i = 0; i < count; i++)
+    {
+        resetGame(*batch, i, seeds != nullptr ? seeds[i] : batch->seeds[i] + count);
+    }
+    return SNAKECORE_OK;
+}
+
+int snakecore_reset_game(SnakeCoreBatch *batch, int32_t index, uint64_t seed)
+{
+    if (batch == nullptr || index < 0 || index >= static_cast<int32_t>(batch->games.size()))
+    {
+        return SNAKECORE_ERROR_ARGUMENT;
+    }
+    resetGame(*batch, index, seed);
+    return SNAKECORE_OK;
+}
+
+int snakecore_step(SnakeCoreBatch *batch, const int32_t *actions, float *rewards, uint8_t *dones)
+{
+    if (batch == nullptr)
+    {
+        return SNAKECORE_ERROR_ARGUMENT;
+    }
+    const int32_t count = static_cast<int32_t>(batch->games.size());
+    for (int32_t i = 0; i < count; i++)
+    {
+        Simulation &game = *batch->games[i];
+        float reward = 0.0f;
+        if (batch->dones[i] == 0)
+        {
+            int32_t action = actions != nullptr ? actions[i] : SNAKECORE_ACTION_NONE;
+            if (action >= SNAKECORE_ACTION_UP && action < SNAKECORE_ACTION_NONE)
+            {
+                game.addDirectionToQueue(static_cast<Direction>(action));
+            }
+            const int points = game.getPoints();
+            const bool alive = game.advanceMove();
+            batch->moves[i]++;
+            reward = alive ? static_cast<float>(game.getPoints() - points) : -1.0f;
+            if (!alive)
+            {
+                batch->dones[i] = 1;
+            }
+            else if (batch->config.maxMoves > 0 && batch->moves[i] >= batch->config.maxMoves)
+            {
+                batch->dones[i] = 2;
+            }
+        }
+        if (rewards != nullptr)
+        {
+            rewards[i] = reward;
+        }
+        if (dones != nullptr)
+        {
+            dones[i] = batch->dones[i];
+        }
+        if (batch->dones[i] != 0 && batch->config.autoReset != 0)
+        {
+            resetGame(*batch, i, batch->seeds[i] + count);
+        }
+    }
+    return SNAKECORE_OK;
+}
+
+int snakecore_observe_u8(SnakeCoreBatch *batch, uint8_t *out)
+{
+    return observeAll(batch, out);
+}
+
+int snakecore_observe_f32(SnakeCoreBatch *batch, float *out)
+{
+    return observeAll(batch, out);
+}
+
+int snakecore_game_info(const SnakeCoreBatch *batch, int32_t index, int32_t *points, int32_t *length, int32_t *moves)
+{
+    if (batch == nullptr || index < 0 || index >= static_cast<int32_t>(batch->games.size()))
+    {
+        return SNAKECORE_ERROR_ARGUMENT;
+    }
+    const Simulation &game = *batch->games[index];
+    if (points != nullptr)
+    {
+        *points = game.getPoints();
+    }
+    if (length != nullptr)
+    {
+        *length = game.getSnake().getLength();
+    }
+    if (moves != nullptr)
+    {
+        *moves = batch->moves[index];
+    }
+    return SNAKECORE_OK;
+}
+
+}
@@ -0,0 +1,104 @@
+#ifndef SNAKE_CORE_H
+#define SNAKE_CORE_H
+
+/*
+ * libsnakecore：不依赖 SDL 的批量对局 C 接口，供训练程序等其他语言的代码链接
+ * 一个批次 (batch) 包含 N 局设置相同、种子不同的游戏，每次 step 每局各移动一步
+ * 观测是每局 4 个按行排列的独热 (one-hot) 平面：蛇身 (不含蛇头)、蛇头、食物、障碍物，
+ * 每个平面 列数 x 行数 个元素，第 i 局的观测从 i * snakecore_observation_size() 开始，
+ * 直接写入调用者提供的连续缓冲区，库不保留指向调用者内存的指针
+ *
+ * 接口只使用 C 类型，返回值表示成功与否，不抛出异常；结构体只在末尾追加字段，
+ * 版本号 SNAKECORE_VERSION 的高 16 位在不兼容的修改时递增
+ * 同一个批次不能在多个线程中同时使用，不同的批次互不影响，可以在各自的线程中运行
+ */
+
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define SNAKECORE_API __attribute__((visibility("default")))
+#else
+#define SNAKECORE_API
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define SNAKECORE_VERSION 0x00010000u
+
+/* 返回值 */
+#define SNAKECORE_OK 0
+#define SNAKECORE_ERROR_ARGUMENT (-1) /* 参数无效 (空指针、下标越界) */
+
+/* 观测平面的顺序 */
+#define SNAKECORE_PLANE_BODY 0
+#define SNAKECORE_PLANE_HEAD 1
+#define SNAKECORE_PLANE_FOOD 2
+#define SNAKECORE_PLANE_OBSTACLE 3
+#define SNAKECORE_PLANES 4
+
+/* 动作：按 Direction 的顺序，SNAKECORE_ACTION_NONE 表示保持当前方向；掉头的动作被忽略 */
+#define SNAKECORE_ACTION_UP 0
+#define SNAKECORE_ACTION_DOWN 1
+#define SNAKECORE_ACTION_LEFT 2
+#define SNAKECORE_ACTION_RIGHT 3
+#define SNAKECORE_ACTION_NONE 4
+
+/* 一个批次中所有游戏的设置 */
+typedef struct SnakeCoreConfig
+{
+    int32_t columns;        /* 游戏区域的列数和行数 (格子)，8 到 254 */
+    int32_t rows;
+    int32_t unbounded;      /* 0 有边界模式，1 无边界模式 (穿过边缘) */
+    int32_t hard;           /* 0 简单，1 困难 (初始速度影响特殊效果的持续移动次数) */
+    int32_t obstacles;      /* 0 空地图，1 带障碍物的地图 (至少 11 列 16 行) */
+    int32_t initialLength;  /* 蛇的初始长度，不超过 行数 - 行数 / 2 */
+    int32_t foodCount;      /* 同时存在的食物数量 */
+    int32_t foodLifetime;   /* 食物寿命 (计时单位 0.01 秒)，0 表示永不消失 */
+    int32_t maxMoves;       /* 每局最多移动次数，到达时这一局结束 (done 为 2)，0 表示不限制 */
+    int32_t autoReset;      /* 非 0 时 step 在一局结束后立即用下一个种子开始新的一局，之后的观测是新一局的开始 */
+} SnakeCoreConfig;
+
+typedef struct SnakeCoreBatch SnakeCoreBatch;
+
+/* 库的版本号 (SNAKECORE_VERSION)，调用者可以用来检查头文件与库是否匹配 */
+SNAKECORE_API uint32_t snakecore_version(void);
+/* 默认设置：40x28 有边界、简单、空地图，初始长度 2，1 个食物，每局最多 2000 次移动，自动开始新的一局 */
+SNAKECORE_API void snakecore_default_config(SnakeCoreConfig *config);
+
+/* 创建 count 局游戏，seeds 为每局的随机数种子 (为空时第 i 局使用 i + 1)；设置无效或内存不足时返回空 */
+SNAKECORE_API SnakeCoreBatch *snakecore_create(const SnakeCoreConfig *config, int32_t count, const uint64_t *seeds);
+SNAKECORE_API void snakecore_destroy(SnakeCoreBatch *batch);
+
+SNAKECORE_API int32_t snakecore_batch_size(const SnakeCoreBatch *batch);
+/* 每局观测的元素个数：SNAKECORE_PLANES * 列数 * 行数 */
+SNAKECORE_API int32_t snakecore_observation_size(const SnakeCoreBatch *batch);
+
+/* 用新的种子重新开始所有游戏 (seeds 为空时每局使用各自的下一个种子：上一个种子加上批次大小) */
+SNAKECORE_API int snakecore_reset(SnakeCoreBatch *batch, const uint64_t *seeds);
+/* 重新开始第 index 局 */
+SNAKECORE_API int snakecore_reset_game(SnakeCoreBatch *batch, int32_t index, uint64_t seed);
+
+/*
+ * 每局按 actions[i] 移动一步 (actions 为空时都保持当前方向)
+ * rewards[i]：这一步的得分增量 (与游戏中的得分相同)，撞到时为 -1
+ * dones[i]：0 继续，1 撞到 (游戏结束)，2 到达移动次数上限
+ * rewards 和 dones 可以为空；已经结束且没有自动重新开始的局不再移动，reward 为 0，done 保持原来的值
+ */
+SNAKECORE_API int snakecore_step(SnakeCoreBatch *batch, const int32_t *actions, float *rewards, uint8_t *dones);
+
+/* 把所有局的观测写入 out (batch_size * observation_size 个元素)，值为 0 或 1 */
+SNAKECORE_API int snakecore_observe_u8(SnakeCoreBatch *batch, uint8_t *out);
+SNAKECORE_API int snakecore_observe_f32(SnakeCoreBatch *batch, float *out);
+
+/* 第 index 局的状态：得分、蛇长、这一局的移动次数 (任意一个指针可以为空) */
+SNAKECORE_API int snakecore_game_info(const SnakeCoreBatch *batch, int32_t index, int32_t *points, int32_t *length,
+                                      int32_t *moves);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
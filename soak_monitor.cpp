@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include "soak_monitor.h"
+
+// 排序后的分位数
+static double percentile(const std::vector<double> &sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+    return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+}
+
+// 构造函数：预先分配采样窗口
+SoakMonitor::SoakMonitor(double sampleInterval, double warmup) : mSampleInterval(sampleInterval), mWarmup(warmup)
+{
+    mWindow.reserve(MAX_WINDOW_FRAMES);
+    mSamples.reserve(4096);
+}
+
+void SoakMonitor::recordFrame(double milliseconds)
+{
+    if (mWindow.size() < MAX_WINDOW_FRAMES)
+    {
+        mWindow.push_back(static_cast<float>(milliseconds));
+    }
+}
+
+void SoakMonitor::recordGame()
+{
+    mGames++;
+}
+
+bool SoakMonitor::poll(double seconds, int liveTextures)
+{
+    if (seconds - mLastSample < mSampleInterval)
+    {
+        return false;
+    }
+    sample(seconds, liveTextures, readResidentBytes(), countOpenFiles());
+    return true;
+}
+
+// 采样：窗口内的帧耗时排序后取分位数，然后清空窗口
+void SoakMonitor::sample(double seconds, int liveTextures, size_t rssBytes, int openFiles)
+{
+    SoakSample sample;
+    sample.seconds = seconds;
+    sample.games = mGames;
+    sample.frames = mWindow.size();
+    sample.rssBytes = rssBytes;
+    sample.openFiles = openFiles;
+    sample.liveTextures = liveTextures;
+    if (!mWindow.empty())
+    {
+        std::sort(mWindow.begin(), mWindow.end());
+        sample.frameP50 = mWindow[static_cast<size_t>(0.5 * (mWindow.size() - 1))];
+        sample.frameP99 = mWindow[static_cast<size_t>(0.99 * (mWindow.size() - 1))];
+        sample.frameMax = mWindow.back();
+    }
+    mWindow.clear();
+    mSamples.push_back(sample);
+    mLastSample = seconds;
+}
+
+const std::vector<SoakSample> &SoakMonitor::getSamples() const
+{
+    return mSamples;
+}
+
+uint64_t SoakMonitor::getGames() const
+{
+    return mGames;
+}
+
+// 预热之后的样本分成 4 段，比较每段的代表值
+SoakVerdict SoakMonitor::analyze() const
+{
+    SoakVerdict verdict;
+    std::vector<const SoakSample *> steady;
+    for (const SoakSample &sample : mSamples)
+    {
+        if (sample.seconds >= mWarmup)
+        {
+            steady.push_back(&sample);
+        }
+    }
+    if (steady.size() < MIN_SAMPLES)
+    {
+        return verdict;
+    }
+    verdict.enoughSamples = true;
+
+    const int SEGMENTS = 4;
+    double rss[SEGMENTS];
+    double files[SEGMENTS];
+    double textures[SEGMENTS];
+    double p99[SEGMENTS];
+    verdict.enoughFrames = true;
+    for (int segment = 0; segment < SEGMENTS; segment++)
+    {
+        size_t begin = steady.size() * segment / SEGMENTS;
+        size_t end = steady.size() * (segment + 1) / SEGMENTS;
+        std::vector<double> tails;
+        rss[segment] = static_cast<double>(steady[begin]->rssBytes);
+        files[segment] = steady[begin]->openFiles;
+        textures[segment] = steady[begin]->liveTextures;
+        for (size_t i = begin; i < end; i++)
+        {
+            rss[segment] = std::min(rss[segment], static_cast<double>(steady[i]->rssBytes));
+            files[segment] = std::min(files[segment], static_cast<double>(steady[i]->openFiles));
+            textures[segment] = std::min(textures[segment], static_cast<double>(steady[i]->liveTextures));
+            if (steady[i]->frames >= MIN_WINDOW_FRAMES)
+            {
+                tails.push_back(steady[i]->frameP99);
+            }
+        }
+        std::sort(tails.begin(), tails.end());
+        p99[segment] = percentile(tails, 0.5);
+        verdict.enoughFrames = verdict.enoughFrames && tails.size() >= MIN_SEGMENT_SAMPLES;
+    }
+
+    // 逐段不下降，且总共增长超过阈值
+    auto growing = [&](const double *values, double threshold) {
+        for (int segment = 1; segment < SEGMENTS; segment++)
+        {
+            if (values[segment] < values[segment - 1])
+            {
+                return false;
+            }
+        }
+        return values[SEGMENTS - 1] - values[0] > threshold;
+    };
+    verdict.rssGrowth = growing(rss, std::max(static_cast<double>(RSS_GROWTH_BYTES), 0.02 * rss[0]));
+    verdict.fileGrowth = growing(files, 0.0);
+    verdict.textureGrowth = growing(textures, 0.0);
+    verdict.latencyDrift =
+        verdict.enoughFrames && growing(p99, LATENCY_DRIFT_MS) && p99[SEGMENTS - 1] > 1.5 * p99[0];
+
+    verdict.rssFirst = rss[0];
+    verdict.rssLast = rss[SEGMENTS - 1];
+    verdict.filesFirst = files[0];
+    verdict.filesLast = files[SEGMENTS - 1];
+    verdict.texturesFirst = textures[0];
+    verdict.texturesLast = textures[SEGMENTS - 1];
+    verdict.p99First = p99[0];
+    verdict.p99Last = p99[SEGMENTS - 1];
+    return verdict;
+}
+
+// 按时间段汇总：每段的局数、帧数、段末的内存 (以及相对上一段的变化)、文件和纹理、帧耗时分位数
+bool SoakMonitor::report(std::ostream &out, double bucketSeconds) const
+{
+    const double MB = 1024.0 * 1024.0;
+    out << std::fixed << std::setprecision(2);
+    out << "时间段    局数      帧数   内存(MB)     变化  文件  纹理   p50(ms)   p99(ms)  最大(ms)" << std::endl;
+    size_t begin = 0;
+    uint64_t previousGames = 0;
+    double previousRss = mSamples.empty() ? 0.0 : mSamples.front().rssBytes / MB;
+    while (begin < mSamples.size())
+    {
+        const int bucket = static_cast<int>(mSamples[begin].seconds / bucketSeconds);
+        size_t end = begin;
+        uint64_t frames = 0;
+        double worst = 0.0;
+        std::vector<double> medians;
+        std::vector<double> tails;
+        while (end < mSamples.size() && static_cast<int>(mSamples[end].seconds / bucketSeconds) == bucket)
+        {
+            frames += mSamples[end].frames;
+            worst = std::max(worst, mSamples[end].frameMax);
+            medians.push_back(mSamples[end].frameP50);
+            tails.push_back(mSamples[end].frameP99);
+            end++;
+        }
+        std::sort(medians.begin(), medians.end());
+        std::sort(tails.begin(), tails.end());
+        const SoakSample &last = mSamples[end - 1];
+        double rss = last.rssBytes / MB;
+        out << std::setw(6) << bucket << std::setw(8) << last.games - previousGames << std::setw(10) << frames
+            << std::setw(11) << rss << std::setw(9) << std::showpos << rss - previousRss << std::noshowpos
+            << std::setw(6) << last.openFiles << std::setw(6) << last.liveTextures << std::setw(10)
+            << percentile(medians, 0.5) << std::setw(10) << percentile(tails, 0.5) << std::setw(10) << worst
+            << std::endl;
+        previousGames = last.games;
+        previousRss = rss;
+        begin = end;
+    }
+
+    SoakVerdict verdict = analyze();
+    if (!verdict.enoughSamples)
+    {
+        out << "预热之后的样本不足 " << MIN_SAMPLES << " 个，不判断趋势" << std::endl;
+        return true;
+    }
+    out << "内存 " << verdict.rssFirst / MB << " -> " << verdict.rssLast / MB << " MB"
+        << (verdict.rssGrowth ? " (持续增长)" : "") << "，文件 " << verdict.filesFirst << " -> " << verdict.filesLast
+        << (verdict.fileGrowth ? " (持续增长)" : "") << "，纹理 " << verdict.texturesFirst << " -> "
+        << verdict.texturesLast << (verdict.textureGrowth ? " (持续增长)" : "") << "，帧耗时 p99 " << verdict.p99First
+        << " -> " << verdict.p99Last << " ms" << (verdict.latencyDrift ? " (变慢)" : "")
+        << (verdict.enoughFrames ? "" : " (帧数不足，不判断)") << std::endl;
+    return verdict.isHealthy();
+}
+
+// /proc/self/statm 的第二个字段是常驻内存的页数
+size_t SoakMonitor::readResidentBytes()
+{
+    FILE *file = std::fopen("/proc/self/statm", "r");
+    if (file == nullptr)
+    {
+        return 0;
+    }
+    unsigned long pages = 0;
+    unsigned long resident = 0;
+    int fields = std::fscanf(file, "%lu %lu", &pages, &resident);
+    std::fclose(file);
+    if (fields != 2)
+    {
+        return 0;
+    }
+    return static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+// /proc/self/fd 下的项数，不包括 . 和 .. 以及读取目录本身打开的描述符
+int SoakMonitor::countOpenFiles()
+{
+    DIR *directory = opendir("/proc/self/fd");
+    if (directory == nullptr)
+    {
+        return -1;
+    }
+    int count = 0;
+    while (struct dirent *entry = readdir(directory))
+    {
+        if (entry->d_name[0] != '.')
+        {
+            count++;
+        }
+    }
+    closedir(directory);
+    return count - 1;
+}
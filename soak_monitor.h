@@ -0,0 +1,107 @@
+#ifndef SOAK_MONITOR_H
+#define SOAK_MONITOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// 一次采样：进程的资源占用，以及上一次采样以来的帧耗时分位数
+struct SoakSample
+{
+    double seconds = 0.0;  // 从开始算起的时间
+    uint64_t games = 0;    // 到这次采样为止完成的局数
+    uint64_t frames = 0;   // 这个采样窗口内的帧数
+    size_t rssBytes = 0;   // 常驻内存
+    int openFiles = 0;     // 打开的文件描述符
+    int liveTextures = 0;  // 渲染后端持有的纹理
+    double frameP50 = 0.0; // 帧耗时 (毫秒)
+    double frameP99 = 0.0;
+    double frameMax = 0.0;
+};
+
+// 长时间运行的判断结果
+struct SoakVerdict
+{
+    bool enoughSamples = false; // 预热之后的样本足够分析 (至少 MIN_SAMPLES 个)
+    bool enoughFrames = false;  // 每段都有至少 MIN_SEGMENT_SAMPLES 个帧数足够的样本，可以判断帧耗时
+    bool rssGrowth = false;     // 常驻内存持续增长
+    bool fileGrowth = false;    // 文件描述符持续增长
+    bool textureGrowth = false; // 纹理持续增长
+    bool latencyDrift = false;  // 帧耗时的尾部 (p99) 变慢
+    // 预热之后第一段和最后一段的代表值 (内存、文件、纹理取段内最小值，p99 取段内样本 p99 的中位数)
+    double rssFirst = 0.0;
+    double rssLast = 0.0;
+    double filesFirst = 0.0;
+    double filesLast = 0.0;
+    double texturesFirst = 0.0;
+    double texturesLast = 0.0;
+    double p99First = 0.0;
+    double p99Last = 0.0;
+
+    bool isHealthy() const
+    {
+        return !rssGrowth && !fileGrowth && !textureGrowth && !latencyDrift;
+    }
+};
+
+// 长时间运行 (soak) 的监控：按固定间隔采样常驻内存、文件描述符、纹理数量和帧耗时的分位数，
+// 结束时按时间段 (默认每小时) 汇总趋势，并判断资源是否持续增长、帧耗时的尾部是否变慢
+// 判断只看预热之后的样本：分成 4 段，内存、文件和纹理取每段的最小值 (泄漏会抬高下限，偶尔的峰值不会)，
+// 4 段的最小值逐段不下降且总共增长超过阈值时认为持续增长；帧耗时取每段样本 p99 的中位数 (只用帧数足够的样本，
+// 每段至少 MIN_SEGMENT_SAMPLES 个)，逐段不下降、最后一段比第一段慢 50% 并且多出 LATENCY_DRIFT_MS 时认为变慢，
+// 写存档、调度等偶尔的长尾只影响个别样本或个别段，不会被当作变慢
+// 不依赖 SDL，时间由调用者给出 (游戏用实际时间，基准测试可以用模拟的时间)
+class SoakMonitor
+{
+public:
+    // 一个采样窗口最多记录的帧数，超过后不再记录 (窗口的分位数只来自前面的帧)
+    static const size_t MAX_WINDOW_FRAMES = 1 << 16;
+    // 分析需要的最少样本数
+    static const size_t MIN_SAMPLES = 16;
+    // 判断帧耗时时每段至少需要的样本数，以及一个样本的 p99 有意义需要的帧数 (少于 100 帧时 p99 就是最慢的一帧)
+    static const size_t MIN_SEGMENT_SAMPLES = 4;
+    static const uint64_t MIN_WINDOW_FRAMES = 100;
+    // 帧耗时 p99 增加超过这么多毫秒 (60 FPS 的半帧) 才可能掉帧，小于它的变化不算变慢
+    static constexpr double LATENCY_DRIFT_MS = 8.0;
+    // 内存增长的阈值：1 MB，且超过第一段的 2%
+    static const size_t RSS_GROWTH_BYTES = 1 << 20;
+
+    // sampleInterval 为采样间隔 (秒)，warmup 之前的样本不参与判断 (纹理缓存、节点池等在前几局填满)
+    explicit SoakMonitor(double sampleInterval = 10.0, double warmup = 60.0);
+
+    // 记录一帧的耗时 (毫秒)
+    void recordFrame(double milliseconds);
+    // 完成了一局
+    void recordGame();
+    // 距离上一次采样超过采样间隔时采样，返回是否采样了
+    bool poll(double seconds, int liveTextures);
+    // 采样 (内存和文件描述符由调用者给出，用于基准测试构造数据)
+    void sample(double seconds, int liveTextures, size_t rssBytes, int openFiles);
+
+    const std::vector<SoakSample> &getSamples() const;
+    uint64_t getGames() const;
+
+    SoakVerdict analyze() const;
+    // 打印每个时间段的趋势和判断结果，返回是否正常
+    bool report(std::ostream &out, double bucketSeconds = 3600.0) const;
+
+    // 当前进程的常驻内存 (/proc/self/statm)，读取失败时返回 0
+    static size_t readResidentBytes();
+    // 当前进程打开的文件描述符数量 (/proc/self/fd)，读取失败时返回 -1
+    static int countOpenFiles();
+
+private:
+    const double mSampleInterval;
+    const double mWarmup;
+    double mLastSample = 0.0;
+    uint64_t mGames = 0;
+    // 当前采样窗口的帧耗时，预先分配
+    std::vector<float> mWindow;
+    std::vector<SoakSample> mSamples;
+
+    SoakMonitor(const SoakMonitor &) = delete;
+    SoakMonitor &operator=(const SoakMonitor &) = delete;
+};
+
+#endif
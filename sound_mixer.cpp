@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "sound_mixer.h"
+
+// 构造函数
+SoundMixer::SoundMixer(int sampleRate, int channels)
+    : mSampleRate(sampleRate), mChannels(channels)
+{
+}
+
+// 合成一段频率从 startHz 线性变化到 endHz 的音，带有指数衰减的包络，noise 为噪声的比例
+static void synthesizeTone(std::vector<int16_t> &out, int sampleRate, int channels,
+                           double startHz, double endHz, double seconds, double volume, double noise)
+{
+    const double PI = 3.14159265358979323846;
+    size_t frames = static_cast<size_t>(seconds * sampleRate);
+    out.assign(frames * channels, 0);
+    double phase = 0.0;
+    uint32_t random = 0x9E3779B9u;
+    for (size_t i = 0; i < frames; i++)
+    {
+        double t = static_cast<double>(i) / frames;
+        phase += 2.0 * PI * (startHz + (endHz - startHz) * t) / sampleRate;
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        double white = static_cast<double>(random) / 4294967295.0 * 2.0 - 1.0;
+        // 开头 2 毫秒淡入，避免爆音
+        double attack = std::min(1.0, i / (0.002 * sampleRate));
+        double envelope = attack * std::exp(-4.0 * t) * (1.0 - t);
+        double value = ((1.0 - noise) * std::sin(phase) + noise * white) * envelope * volume;
+        int16_t sample = static_cast<int16_t>(value * 32767.0);
+        for (int c = 0; c < channels; c++)
+        {
+            out[i * channels + c] = sample;
+        }
+    }
+}
+
+// 合成默认音效
+void SoundMixer::synthesize()
+{
+    struct Tone
+    {
+        double startHz, endHz, seconds, volume, noise;
+    };
+    // 按 SoundEffect 的顺序：吃到食物、特殊效果、食物消失、游戏结束
+    const Tone tones[SOUND_EFFECT_COUNT] = {
+        {880.0, 1320.0, 0.06, 0.35, 0.0},
+        {440.0, 1760.0, 0.25, 0.30, 0.0},
+        {660.0, 330.0, 0.15, 0.20, 0.0},
+        {330.0, 80.0, 0.60, 0.40, 0.3},
+    };
+    for (int i = 0; i < SOUND_EFFECT_COUNT; i++)
+    {
+        synthesizeTone(mOwned[i], mSampleRate, mChannels, tones[i].startHz, tones[i].endHz,
+                       tones[i].seconds, tones[i].volume, tones[i].noise);
+        mSamples[i] = mOwned[i].data();
+        mFrames[i] = mOwned[i].size() / mChannels;
+    }
+}
+
+// 使用外部已解码的采样
+void SoundMixer::setSamples(SoundEffect effect, const int16_t *samples, size_t frames)
+{
+    int index = static_cast<int>(effect);
+    mOwned[index].clear();
+    mSamples[index] = samples;
+    mFrames[index] = frames;
+}
+
+size_t SoundMixer::getFrames(SoundEffect effect) const
+{
+    return mFrames[static_cast<int>(effect)];
+}
+
+// 触发音效，记录触发时刻
+bool SoundMixer::trigger(SoundEffect effect)
+{
+    return trigger(effect, now());
+}
+
+bool SoundMixer::trigger(SoundEffect effect, uint64_t triggerTime)
+{
+    mTriggered++;
+    if (!mCommands.push({effect, triggerTime}))
+    {
+        mDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+// 开始播放一个音效，声部池用完时替换剩余采样最少的声部
+void SoundMixer::startVoice(SoundEffect effect)
+{
+    int index = static_cast<int>(effect);
+    if (mFrames[index] == 0)
+    {
+        return;
+    }
+    Voice *voice;
+    if (mActiveVoices < MAX_VOICES)
+    {
+        voice = &mVoices[mActiveVoices++];
+    }
+    else
+    {
+        voice = &mVoices[0];
+        for (int i = 1; i < MAX_VOICES; i++)
+        {
+            if (mVoices[i].remaining < voice->remaining)
+            {
+                voice = &mVoices[i];
+            }
+        }
+        mStolen.fetch_add(1, std::memory_order_relaxed);
+    }
+    voice->samples = mSamples[index];
+    voice->remaining = mFrames[index] * mChannels;
+}
+
+// 取出触发命令并把正在播放的音效叠加到输出缓冲区
+void SoundMixer::mix(int16_t *out, int frames)
+{
+    uint64_t begin = now();
+    SoundCommand command;
+    while (mCommands.pop(command))
+    {
+        size_t count = mLatencyCount.load(std::memory_order_relaxed);
+        if (count < MAX_LATENCY_SAMPLES)
+        {
+            uint64_t latency = begin > command.triggerTime ? (begin - command.triggerTime) / 1000 : 0;
+            mLatencies[count] = static_cast<uint32_t>(std::min<uint64_t>(latency, UINT32_MAX));
+            mLatencyCount.store(count + 1, std::memory_order_release);
+        }
+        startVoice(command.effect);
+    }
+
+    // 分块累加到 32 位整数，每块最后截断一次
+    const size_t BLOCK = 512;
+    int32_t sums[BLOCK];
+    size_t total = static_cast<size_t>(frames) * mChannels;
+    for (size_t offset = 0; offset < total && mActiveVoices > 0; offset += BLOCK)
+    {
+        size_t count = std::min(BLOCK, total - offset);
+        for (size_t i = 0; i < count; i++)
+        {
+            sums[i] = out[offset + i];
+        }
+        for (int v = 0; v < mActiveVoices;)
+        {
+            Voice &voice = mVoices[v];
+            size_t n = std::min(count, voice.remaining);
+            for (size_t i = 0; i < n; i++)
+            {
+                sums[i] += voice.samples[i];
+            }
+            voice.samples += n;
+            voice.remaining -= n;
+            if (voice.remaining == 0)
+            {
+                // 播放完的声部用最后一个声部填补，填补的声部在这一块中还没有处理，不增加 v
+                voice = mVoices[--mActiveVoices];
+            }
+            else
+            {
+                v++;
+            }
+        }
+        for (size_t i = 0; i < count; i++)
+        {
+            out[offset + i] = static_cast<int16_t>(std::max(-32768, std::min(32767, sums[i])));
+        }
+    }
+
+    mCallbacks.fetch_add(1, std::memory_order_relaxed);
+    mMixedFrames.fetch_add(frames, std::memory_order_relaxed);
+    mMixTime.fetch_add(now() - begin, std::memory_order_relaxed);
+}
+
+int SoundMixer::getSampleRate() const
+{
+    return mSampleRate;
+}
+
+int SoundMixer::getChannels() const
+{
+    return mChannels;
+}
+
+int SoundMixer::getActiveVoices() const
+{
+    return mActiveVoices;
+}
+
+// 触发到音频回调取出命令的延迟 (毫秒)
+std::vector<double> SoundMixer::getLatencies() const
+{
+    size_t count = mLatencyCount.load(std::memory_order_acquire);
+    std::vector<double> latencies(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        latencies[i] = mLatencies[i] / 1000.0;
+    }
+    return latencies;
+}
+
+uint64_t SoundMixer::getTriggered() const
+{
+    return mTriggered;
+}
+
+uint64_t SoundMixer::getDropped() const
+{
+    return mDropped.load(std::memory_order_relaxed);
+}
+
+uint64_t SoundMixer::getStolen() const
+{
+    return mStolen.load(std::memory_order_relaxed);
+}
+
+uint64_t SoundMixer::getCallbacks() const
+{
+    return mCallbacks.load(std::memory_order_relaxed);
+}
+
+// 混音耗时占音频时长的比例
+double SoundMixer::getCpuLoad() const
+{
+    uint64_t frames = mMixedFrames.load(std::memory_order_relaxed);
+    if (frames == 0)
+    {
+        return 0.0;
+    }
+    double audioNs = frames * 1e9 / mSampleRate;
+    return mMixTime.load(std::memory_order_relaxed) / audioNs;
+}
+
+// 平均每次回调的混音耗时 (纳秒)
+double SoundMixer::getMixNanoseconds() const
+{
+    uint64_t callbacks = mCallbacks.load(std::memory_order_relaxed);
+    return callbacks == 0 ? 0.0 : static_cast<double>(mMixTime.load(std::memory_order_relaxed)) / callbacks;
+}
+
+// 单调时钟 (纳秒)
+uint64_t SoundMixer::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
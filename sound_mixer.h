@@ -0,0 +1,109 @@
+#ifndef SOUND_MIXER_H
+#define SOUND_MIXER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "event_bus.h"
+
+// 音效种类
+enum class SoundEffect : uint8_t
+{
+    Eat,     // 吃到普通食物
+    PowerUp, // 特殊效果开始
+    Expire,  // 食物到期消失
+    Death    // 游戏结束
+};
+const int SOUND_EFFECT_COUNT = 4;
+
+// 音效触发命令：游戏线程写入，音频回调取出
+struct SoundCommand
+{
+    SoundEffect effect;
+    uint64_t triggerTime; // 触发时刻 (SoundMixer::now()，纳秒)
+};
+
+// 低延迟音效混音器，不依赖 SDL
+// 音效在加载时解码 (或合成) 一次，之后只引用这些采样；游戏线程通过无锁队列触发音效，
+// 音频回调取出命令并把正在播放的音效叠加到输出缓冲区 (16 位有符号交错采样)，
+// 回调中不加锁也不分配内存，声部池用完时替换播放进度最靠后的声部
+class SoundMixer
+{
+public:
+    static const int MAX_VOICES = 16;
+    static const size_t QUEUE_CAPACITY = 64;
+    // 保存的触发延迟样本数，超过后不再记录
+    static const size_t MAX_LATENCY_SAMPLES = 4096;
+
+    SoundMixer(int sampleRate = 44100, int channels = 2);
+
+    // 合成默认音效 (没有音效文件时使用)
+    void synthesize();
+    // 使用外部已解码的采样 (交错，frames 帧)，采样由调用者持有，在停止回调之前不能释放
+    void setSamples(SoundEffect effect, const int16_t *samples, size_t frames);
+    size_t getFrames(SoundEffect effect) const;
+
+    // 游戏线程调用：触发音效，队列已满时返回 false 并计数
+    bool trigger(SoundEffect effect);
+    bool trigger(SoundEffect effect, uint64_t triggerTime);
+    // 音频回调调用：取出触发命令，把音效叠加到 out (frames 帧)，超出范围的值截断
+    void mix(int16_t *out, int frames);
+
+    int getSampleRate() const;
+    int getChannels() const;
+    // 正在播放的声部数 (只在音频回调所在的线程中准确)
+    int getActiveVoices() const;
+
+    // 统计，可以在其他线程中读取
+    // 触发到音频回调取出命令的延迟 (毫秒)
+    std::vector<double> getLatencies() const;
+    uint64_t getTriggered() const;
+    uint64_t getDropped() const;
+    uint64_t getStolen() const;
+    uint64_t getCallbacks() const;
+    // 混音耗时占音频时长的比例
+    double getCpuLoad() const;
+    // 平均每次回调的混音耗时 (纳秒)
+    double getMixNanoseconds() const;
+
+    // 单调时钟 (纳秒)
+    static uint64_t now();
+
+private:
+    struct Voice
+    {
+        const int16_t *samples = nullptr;
+        size_t remaining = 0; // 剩余的采样数 (帧数 * 声道数)
+    };
+
+    const int mSampleRate;
+    const int mChannels;
+    // 每种音效的采样和帧数，mOwned 保存合成的采样
+    const int16_t *mSamples[SOUND_EFFECT_COUNT] = {nullptr};
+    size_t mFrames[SOUND_EFFECT_COUNT] = {0};
+    std::vector<int16_t> mOwned[SOUND_EFFECT_COUNT];
+
+    SpscRing<SoundCommand, QUEUE_CAPACITY> mCommands;
+    // 以下只在音频回调中访问
+    Voice mVoices[MAX_VOICES];
+    int mActiveVoices = 0;
+    void startVoice(SoundEffect effect);
+
+    // 统计
+    uint64_t mTriggered = 0;
+    std::atomic<uint64_t> mDropped{0};
+    std::atomic<uint64_t> mStolen{0};
+    std::atomic<uint64_t> mCallbacks{0};
+    std::atomic<uint64_t> mMixedFrames{0};
+    std::atomic<uint64_t> mMixTime{0};
+    // 延迟样本 (微秒) 只追加不覆盖，mLatencyCount 发布已经写好的样本数
+    uint32_t mLatencies[MAX_LATENCY_SAMPLES];
+    std::atomic<size_t> mLatencyCount{0};
+
+    SoundMixer(const SoundMixer &) = delete;
+    SoundMixer &operator=(const SoundMixer &) = delete;
+};
+
+#endif
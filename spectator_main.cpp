@@ -0,0 +1,155 @@
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "sdl_render_backend.h"
+#include "spectator_wall.h"
+
+// 观战墙入口：一个窗口中同时显示多个由机器人操作的对局，按 Esc 或关闭窗口退出
+// 退出时打印每帧的耗时 (模拟和绘制) 分位数；在无界面主机上可以用 SDL_VIDEODRIVER=dummy 和 --seconds 运行
+
+const int BOARD_WIDTH = WINDOW_WIDTH - 10 * GRID_SIZE;
+const int BOARD_HEIGHT = WINDOW_HEIGHT - 2 * GRID_SIZE;
+
+// 打印用法
+static void printUsage()
+{
+    std::cout << "用法: snakewall [--tiles 数量] [--width 像素] [--height 像素] [--fps 帧率] [--seconds 秒]\n"
+                 "                 [--mode bounded|unbounded] [--difficulty easy|hard] [--map empty|obstacles] [--seed 种子]"
+              << std::endl;
+}
+
+// 打印耗时的分位数 (微秒)
+static void report(const char *name, std::vector<double> &samples)
+{
+    if (samples.empty())
+    {
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) {
+        return samples[static_cast<size_t>(p * (samples.size() - 1))];
+    };
+    std::cout << name << " (us): p50 " << percentile(0.5) << ", p99 " << percentile(0.99) << ", 最大 "
+              << samples.back() << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    int tiles = 64;
+    int width = 1920;
+    int height = 1080;
+    int fps = 60;
+    double seconds = 0.0;
+    GameMode mode = GameMode::Unbounded;
+    Difficulty difficulty = Difficulty::Hard;
+    MapType mapType = MapType::Empty;
+    uint64_t seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        std::string value = (i + 1 < argc) ? argv[i + 1] : "";
+        if (arg == "--tiles")
+            tiles = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--width")
+            width = std::atoi(value.c_str());
+        else if (arg == "--height")
+            height = std::atoi(value.c_str());
+        else if (arg == "--fps")
+            fps = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--seconds")
+            seconds = std::atof(value.c_str());
+        else if (arg == "--mode")
+            mode = (value == "bounded") ? GameMode::Bounded : GameMode::Unbounded;
+        else if (arg == "--difficulty")
+            difficulty = (value == "easy") ? Difficulty::Easy : Difficulty::Hard;
+        else if (arg == "--map")
+            mapType = (value == "obstacles") ? MapType::Obstacles : MapType::Empty;
+        else if (arg == "--seed")
+            seed = std::strtoull(value.c_str(), nullptr, 10);
+        else
+        {
+            printUsage();
+            return 1;
+        }
+        i++;
+    }
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        std::cerr << "SDL 初始化失败: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    SDL_Window *window = SDL_CreateWindow("Snake Spectator Wall", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                                          width, height, SDL_WINDOW_SHOWN);
+    SDL_Renderer *renderer = window ? SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED) : nullptr;
+    if (renderer == nullptr)
+    {
+        std::cerr << "渲染器创建失败: " << SDL_GetError() << std::endl;
+        if (window != nullptr)
+        {
+            SDL_DestroyWindow(window);
+        }
+        SDL_Quit();
+        return 1;
+    }
+
+    std::vector<double> updateMicros;
+    std::vector<double> renderMicros;
+    {
+        // 观战墙不显示文字，不需要字体
+        SdlRenderBackend backend(renderer, nullptr, width, height);
+        SpectatorWall wall(backend, width, height, tiles, BOARD_WIDTH, BOARD_HEIGHT);
+        wall.reset(mode, difficulty, mapType, seed);
+        std::cout << tiles << " 个对局，" << wall.getColumns() << "x" << wall.getRows() << " 网格，格子 "
+                  << wall.getCellSize() << " 像素" << std::endl;
+
+        using clock = std::chrono::steady_clock;
+        const float frameTime = 1.0f / fps;
+        auto start = clock::now();
+        bool running = true;
+        while (running)
+        {
+            auto frameStart = clock::now();
+            SDL_Event e;
+            while (SDL_PollEvent(&e) != 0)
+            {
+                if (e.type == SDL_QUIT || (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_ESCAPE))
+                {
+                    running = false;
+                }
+            }
+            wall.update(frameTime);
+            auto updated = clock::now();
+            wall.render();
+            auto rendered = clock::now();
+            updateMicros.push_back(std::chrono::duration<double, std::micro>(updated - frameStart).count());
+            renderMicros.push_back(std::chrono::duration<double, std::micro>(rendered - updated).count());
+
+            if (seconds > 0.0 && std::chrono::duration<double>(rendered - start).count() >= seconds)
+            {
+                running = false;
+            }
+            float sleepTime = frameTime - std::chrono::duration<float>(clock::now() - frameStart).count();
+            if (sleepTime > 0)
+            {
+                SDL_Delay(static_cast<Uint32>(sleepTime * 1000.0f));
+            }
+        }
+        double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        std::cout << "帧数 " << renderMicros.size() << "，平均 " << renderMicros.size() / elapsed << " FPS，重新开始 "
+                  << wall.getRestarts() << " 局" << std::endl;
+    }
+    report("每帧模拟", updateMicros);
+    report("每帧绘制", renderMicros);
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 0;
+}
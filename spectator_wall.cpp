@@ -0,0 +1,152 @@
+#include <algorithm>
+
+#include "spectator_wall.h"
+
+// 小块的背景颜色 (深灰色)
+static const RenderColor TILE_COLOR = {0x20, 0x20, 0x20, 0xFF};
+
+// 构造函数
+SpectatorWall::SpectatorWall(RenderBackend &backend, int width, int height, int tiles, int gameBoardWidth, int gameBoardHeight)
+    : mBackend(backend), mWidth(width), mHeight(height), mTiles(std::max(1, tiles))
+{
+    for (Tile &tile : mTiles)
+    {
+        tile.simulation.reset(new Simulation(gameBoardWidth, gameBoardHeight, 2));
+        tile.lastHead = NO_CELL;
+    }
+    const CellGrid &grid = mTiles[0].simulation->getGrid();
+    layout(static_cast<int>(mTiles.size()), grid.getColumns(), grid.getRows());
+    // 背景加上最多占满游戏区域的蛇、障碍物和食物
+    size_t maxRects = static_cast<size_t>(grid.getColumns()) * grid.getRows() + 1;
+    mRects.reserve(maxRects);
+    mColors.reserve(maxRects);
+}
+
+// 选择网格的列数：格子大小由宽和高中较紧的一方决定，取格子最大的方案，整体在窗口中居中
+void SpectatorWall::layout(int tiles, int boardColumns, int boardRows)
+{
+    int bestCell = 0;
+    for (int columns = 1; columns <= tiles; columns++)
+    {
+        int rows = (tiles + columns - 1) / columns;
+        int cell = std::min((mWidth / columns - GAP) / boardColumns, (mHeight / rows - GAP) / boardRows);
+        if (cell > bestCell)
+        {
+            bestCell = cell;
+            mColumns = columns;
+            mRows = rows;
+        }
+    }
+    mCellSize = std::max(1, bestCell);
+    int tileWidth = boardColumns * mCellSize + GAP;
+    int tileHeight = boardRows * mCellSize + GAP;
+    int left = (mWidth - mColumns * tileWidth) / 2;
+    int top = (mHeight - mRows * tileHeight) / 2;
+    for (int i = 0; i < tiles; i++)
+    {
+        mTiles[i].x = left + (i % mColumns) * tileWidth + GAP / 2;
+        mTiles[i].y = top + (i / mColumns) * tileHeight + GAP / 2;
+    }
+}
+
+// 开始所有对局
+void SpectatorWall::reset(GameMode mode, Difficulty difficulty, MapType mapType, uint64_t seed)
+{
+    mMode = mode;
+    mDifficulty = difficulty;
+    mMapType = mapType;
+    mNextSeed = seed;
+    for (Tile &tile : mTiles)
+    {
+        tile.simulation->reset(mode, difficulty, mapType, mNextSeed++);
+        tile.lastHead = NO_CELL;
+    }
+}
+
+// 推进所有对局
+void SpectatorWall::update(float deltaTime)
+{
+    for (Tile &tile : mTiles)
+    {
+        Simulation &simulation = *tile.simulation;
+        CellIndex head = simulation.getSnake().getHead();
+        if (head != tile.lastHead)
+        {
+            simulation.addDirectionToQueue(mBot.choose(simulation));
+            tile.lastHead = head;
+        }
+        if (!simulation.tick(deltaTime))
+        {
+            simulation.reset(mMode, mDifficulty, mMapType, mNextSeed++);
+            tile.lastHead = NO_CELL;
+            mRestarts++;
+        }
+    }
+}
+
+// 把格子列表转换成小块中的矩形
+void SpectatorWall::appendCells(const Tile &tile, const std::vector<CellIndex> &cells, RenderColor color)
+{
+    const CellGrid &grid = tile.snapshot.grid;
+    for (CellIndex cell : cells)
+    {
+        mRects.push_back({tile.x + grid.getX(cell) * mCellSize, tile.y + grid.getY(cell) * mCellSize, mCellSize, mCellSize});
+        mColors.push_back(color);
+    }
+}
+
+// 绘制所有对局：每个小块一次批量绘制
+void SpectatorWall::render()
+{
+    mBackend.setColor({0x00, 0x00, 0x00, 0xFF});
+    mBackend.clear();
+    for (Tile &tile : mTiles)
+    {
+        tile.snapshot.capture(*tile.simulation);
+        const CellGrid &grid = tile.snapshot.grid;
+        mRects.clear();
+        mColors.clear();
+        mRects.push_back({tile.x, tile.y, grid.getColumns() * mCellSize, grid.getRows() * mCellSize});
+        mColors.push_back(TILE_COLOR);
+        appendCells(tile, tile.snapshot.obstacles, OBSTACLE_COLOR);
+        appendCells(tile, tile.snapshot.snake, SNAKE_COLOR);
+        for (const FoodItem &food : tile.snapshot.foods)
+        {
+            mRects.push_back({tile.x + grid.getX(food.cell) * mCellSize, tile.y + grid.getY(food.cell) * mCellSize,
+                              mCellSize, mCellSize});
+            mColors.push_back(FOOD_COLORS[static_cast<int>(food.type)]);
+        }
+        mBackend.fillColoredRects(mRects.data(), mColors.data(), static_cast<int>(mRects.size()));
+    }
+    mBackend.present();
+}
+
+int SpectatorWall::getTiles() const
+{
+    return static_cast<int>(mTiles.size());
+}
+
+int SpectatorWall::getColumns() const
+{
+    return mColumns;
+}
+
+int SpectatorWall::getRows() const
+{
+    return mRows;
+}
+
+int SpectatorWall::getCellSize() const
+{
+    return mCellSize;
+}
+
+Simulation &SpectatorWall::getGame(int index)
+{
+    return *mTiles[index].simulation;
+}
+
+uint64_t SpectatorWall::getRestarts() const
+{
+    return mRestarts;
+}
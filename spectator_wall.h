@@ -0,0 +1,78 @@
+#ifndef SPECTATOR_WALL_H
+#define SPECTATOR_WALL_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "board_renderer.h"
+#include "board_snapshot.h"
+#include "greedy_bot.h"
+#include "render_backend.h"
+#include "simulation.h"
+
+// 观战墙：在一个窗口中按网格排列多个独立的对局，每个对局缩小格子后画在自己的小块里
+// 每个对局由 GreedyBot 自动操作，结束后用新的种子重新开始
+// 每个小块的背景、障碍物、蛇和食物 (与 BoardRenderer 使用同样的快照和颜色) 合成一次 fillColoredRects
+class SpectatorWall
+{
+public:
+    // 小块之间的间隔 (像素)
+    static const int GAP = 2;
+
+    // 窗口宽度和高度、对局数量，以及每个对局的游戏区域宽度和高度 (像素，与 Simulation 的构造函数相同)
+    SpectatorWall(RenderBackend &backend, int width, int height, int tiles, int gameBoardWidth, int gameBoardHeight);
+
+    // 用给定的设置开始所有对局，第 i 个对局的种子为 seed + i
+    void reset(GameMode mode, Difficulty difficulty, MapType mapType, uint64_t seed);
+    // 机器人在蛇每次移动之后选择方向，推进所有对局，结束的对局重新开始
+    void update(float deltaTime);
+    // 绘制所有对局并提交
+    void render();
+
+    int getTiles() const;
+    // 网格的列数和行数
+    int getColumns() const;
+    int getRows() const;
+    // 缩小后的格子大小 (像素)
+    int getCellSize() const;
+    // 第 index 个对局 (用于构造测试场景)
+    Simulation &getGame(int index);
+    // 结束后重新开始的次数
+    uint64_t getRestarts() const;
+
+private:
+    struct Tile
+    {
+        std::unique_ptr<Simulation> simulation;
+        BoardSnapshot snapshot;
+        CellIndex lastHead; // 机器人上一次选择方向时的蛇头
+        int x;              // 小块左上角 (像素)
+        int y;
+    };
+
+    RenderBackend &mBackend;
+    const int mWidth;
+    const int mHeight;
+    int mColumns = 1;
+    int mRows = 1;
+    int mCellSize = 1;
+    std::vector<Tile> mTiles;
+    GreedyBot mBot;
+
+    GameMode mMode = GameMode::Bounded;
+    Difficulty mDifficulty = Difficulty::Easy;
+    MapType mMapType = MapType::Empty;
+    uint64_t mNextSeed = 0;
+    uint64_t mRestarts = 0;
+
+    // 一个小块的矩形和颜色，每帧复用
+    std::vector<RenderRect> mRects;
+    std::vector<RenderColor> mColors;
+    // 把格子列表转换成小块中的矩形
+    void appendCells(const Tile &tile, const std::vector<CellIndex> &cells, RenderColor color);
+    // 选择网格的列数，使格子尽可能大
+    void layout(int tiles, int boardColumns, int boardRows);
+};
+
+#endif
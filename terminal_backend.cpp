@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+
+#include "terminal_backend.h"
+#include "constants.h"
+
+// 构造函数
+TerminalRenderBackend::TerminalRenderBackend(int columns, int rows, int fd)
+    : mColumns(columns), mRows(rows), mFd(fd),
+      mBack(static_cast<size_t>(columns) * rows, Cell{' ', 16, 16}),
+      mStaticLayer(static_cast<size_t>(columns) * rows, Cell{' ', 16, 16})
+{
+    invalidate();
+}
+
+// RGB 转换成 xterm 256 色中 6x6x6 颜色立方体的下标
+uint8_t TerminalRenderBackend::toColorIndex(RenderColor color)
+{
+    int r = (color.r * 5 + 127) / 255;
+    int g = (color.g * 5 + 127) / 255;
+    int b = (color.b * 5 + 127) / 255;
+    return static_cast<uint8_t>(16 + 36 * r + 6 * g + b);
+}
+
+int TerminalRenderBackend::toColumn(int x)
+{
+    return x * 2 / GRID_SIZE;
+}
+
+int TerminalRenderBackend::toRow(int y)
+{
+    return y / GRID_SIZE;
+}
+
+void TerminalRenderBackend::putCell(int column, int row, char ch, uint8_t fg, uint8_t bg)
+{
+    if (column >= 0 && column < mColumns && row >= 0 && row < mRows)
+    {
+        mBack[static_cast<size_t>(row) * mColumns + column] = Cell{ch, fg, bg};
+    }
+}
+
+void TerminalRenderBackend::setColor(RenderColor color)
+{
+    mColor = toColorIndex(color);
+}
+
+void TerminalRenderBackend::clear()
+{
+    std::fill(mBack.begin(), mBack.end(), Cell{' ', mColor, mColor});
+    mStats.clears++;
+}
+
+// 矩形覆盖的格子填充为背景色
+void TerminalRenderBackend::fillRects(const RenderRect *rects, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        const RenderRect &rect = rects[i];
+        int left = toColumn(rect.x);
+        int right = std::max(left + 1, toColumn(rect.x + rect.w));
+        int top = toRow(rect.y);
+        int bottom = std::max(top + 1, toRow(rect.y + rect.h));
+        for (int row = top; row < bottom; row++)
+        {
+            for (int column = left; column < right; column++)
+            {
+                putCell(column, row, ' ', mColor, mColor);
+            }
+        }
+    }
+    mStats.rects += count;
+    mStats.rectCalls++;
+}
+
+// 只支持水平线和竖直线 (游戏中只画边框)，保留格子原来的背景色
+void TerminalRenderBackend::drawLine(int x1, int y1, int x2, int y2)
+{
+    if (y1 == y2)
+    {
+        int row = toRow(y1);
+        int right = std::min(toColumn(std::max(x1, x2)), mColumns - 1);
+        for (int column = toColumn(std::min(x1, x2)); column <= right; column++)
+        {
+            if (row >= 0 && row < mRows)
+            {
+                putCell(column, row, '-', mColor, mBack[static_cast<size_t>(row) * mColumns + column].bg);
+            }
+        }
+    }
+    else if (x1 == x2)
+    {
+        int column = toColumn(x1);
+        int bottom = std::min(toRow(std::max(y1, y2)), mRows - 1);
+        for (int row = toRow(std::min(y1, y2)); row <= bottom; row++)
+        {
+            if (column >= 0 && column < mColumns)
+            {
+                putCell(column, row, '|', mColor, mBack[static_cast<size_t>(row) * mColumns + column].bg);
+            }
+        }
+    }
+    mStats.lines++;
+}
+
+// 每个字符占一个字符格子，保留格子原来的背景色
+void TerminalRenderBackend::drawText(const std::string &text, int x, int y, RenderColor color)
+{
+    int row = toRow(y);
+    int column = toColumn(x);
+    uint8_t fg = toColorIndex(color);
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        int c = column + static_cast<int>(i);
+        if (c >= 0 && c < mColumns && row >= 0 && row < mRows)
+        {
+            putCell(c, row, text[i], fg, mBack[static_cast<size_t>(row) * mColumns + c].bg);
+        }
+    }
+    mStats.texts++;
+}
+
+void TerminalRenderBackend::getTextSize(const std::string &text, int &width, int &height)
+{
+    width = static_cast<int>(text.size()) * GRID_SIZE / 2;
+    height = GRID_SIZE;
+}
+
+// 开始绘制静态层
+void TerminalRenderBackend::beginStaticLayer()
+{
+    mBack.swap(mStaticLayer);
+    std::fill(mBack.begin(), mBack.end(), Cell{' ', 16, 16});
+    mRecordingStatic = true;
+}
+
+void TerminalRenderBackend::endStaticLayer()
+{
+    if (mRecordingStatic)
+    {
+        mBack.swap(mStaticLayer);
+        mRecordingStatic = false;
+    }
+}
+
+void TerminalRenderBackend::drawStaticLayer()
+{
+    std::copy(mStaticLayer.begin(), mStaticLayer.end(), mBack.begin());
+    mStats.staticLayers++;
+}
+
+// 光标移动：在绝对定位、同一行内前移/后移中选择最短的序列
+void TerminalRenderBackend::moveCursor(int column, int row)
+{
+    if (column == mCursorColumn && row == mCursorRow)
+    {
+        return;
+    }
+    std::string best = "\x1b[" + std::to_string(row + 1);
+    if (column > 0)
+    {
+        best += ";" + std::to_string(column + 1);
+    }
+    best += "H";
+    if (row == mCursorRow && mCursorColumn >= 0)
+    {
+        int distance = column - mCursorColumn;
+        std::string relative = "\x1b[";
+        if (std::abs(distance) > 1)
+        {
+            relative += std::to_string(std::abs(distance));
+        }
+        relative += distance > 0 ? "C" : "D";
+        if (relative.size() < best.size())
+        {
+            best = relative;
+        }
+    }
+    mOutput += best;
+    mCursorColumn = column;
+    mCursorRow = row;
+}
+
+// 只输出发生变化的颜色 (空格只需要背景色)
+void TerminalRenderBackend::setCellColor(uint8_t fg, uint8_t bg)
+{
+    bool fgChanged = fg != mCurrentFg;
+    bool bgChanged = bg != mCurrentBg;
+    if (!fgChanged && !bgChanged)
+    {
+        return;
+    }
+    mOutput += "\x1b[";
+    if (fgChanged)
+    {
+        mOutput += "38;5;" + std::to_string(fg);
+        mCurrentFg = fg;
+    }
+    if (bgChanged)
+    {
+        mOutput += fgChanged ? ";48;5;" : "48;5;";
+        mOutput += std::to_string(bg);
+        mCurrentBg = bg;
+    }
+    mOutput += "m";
+}
+
+// 比较前后缓冲区，只输出变化的字符
+void TerminalRenderBackend::present()
+{
+    mOutput.clear();
+    mChangedCells = 0;
+    for (int row = 0; row < mRows; row++)
+    {
+        for (int column = 0; column < mColumns; column++)
+        {
+            size_t index = static_cast<size_t>(row) * mColumns + column;
+            const Cell &cell = mBack[index];
+            if (!mFullRedraw && !(cell != mFront[index]))
+            {
+                continue;
+            }
+
+            // 光标和变化的字符之间只隔着几个颜色相同的字符时，直接重写这几个字符比移动光标更短
+            if (row == mCursorRow && mCursorColumn >= 0 && column > mCursorColumn && column - mCursorColumn <= 3)
+            {
+                bool sameColor = true;
+                for (int c = mCursorColumn; c < column && sameColor; c++)
+                {
+                    const Cell &skipped = mBack[static_cast<size_t>(row) * mColumns + c];
+                    sameColor = skipped.bg == mCurrentBg && (skipped.ch == ' ' || skipped.fg == mCurrentFg);
+                }
+                if (sameColor)
+                {
+                    for (int c = mCursorColumn; c < column; c++)
+                    {
+                        mOutput += mBack[static_cast<size_t>(row) * mColumns + c].ch;
+                    }
+                    mCursorColumn = column;
+                }
+            }
+
+            moveCursor(column, row);
+            setCellColor(cell.ch == ' ' && mCurrentFg >= 0 ? static_cast<uint8_t>(mCurrentFg) : cell.fg, cell.bg);
+            mOutput += cell.ch;
+            mFront[index] = cell;
+            mChangedCells++;
+            // 写到最后一列之后光标的位置取决于终端，当作未知
+            mCursorColumn = column + 1 < mColumns ? column + 1 : -1;
+        }
+    }
+    writeOutput();
+    mStats.frames++;
+}
+
+// 把输出全部写出
+void TerminalRenderBackend::writeOutput()
+{
+    if (mFd < 0)
+    {
+        return;
+    }
+    size_t written = 0;
+    while (written < mOutput.size())
+    {
+        ssize_t result = write(mFd, mOutput.data() + written, mOutput.size() - written);
+        if (result < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN)
+            {
+                continue;
+            }
+            return;
+        }
+        written += static_cast<size_t>(result);
+    }
+}
+
+// 下一帧重新输出所有字符
+void TerminalRenderBackend::invalidate()
+{
+    mFront.assign(static_cast<size_t>(mColumns) * mRows, Cell{'\0', 0, 0});
+    mCursorColumn = -1;
+    mCursorRow = -1;
+    mCurrentFg = -1;
+    mCurrentBg = -1;
+}
+
+void TerminalRenderBackend::setFullRedraw(bool fullRedraw)
+{
+    mFullRedraw = fullRedraw;
+}
+
+const std::string &TerminalRenderBackend::getOutput() const
+{
+    return mOutput;
+}
+
+size_t TerminalRenderBackend::getLastFrameBytes() const
+{
+    return mOutput.size();
+}
+
+int TerminalRenderBackend::getLastChangedCells() const
+{
+    return mChangedCells;
+}
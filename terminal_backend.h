@@ -0,0 +1,83 @@
+#ifndef TERMINAL_BACKEND_H
+#define TERMINAL_BACKEND_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "render_backend.h"
+
+// 终端渲染后端：把游戏画面画到字符格子上，用 ANSI 转义序列输出
+// 一个游戏格子 (GRID_SIZE 像素) 对应终端中横向 2 个、纵向 1 个字符，文字每个字符占半个格子
+// 保存前后两个缓冲区，每帧只输出发生变化的字符，并选择最短的光标移动序列
+class TerminalRenderBackend : public RenderBackend
+{
+public:
+    // columns 和 rows 为终端的列数和行数，fd 为输出的文件描述符 (-1 表示只生成输出，不写出)
+    TerminalRenderBackend(int columns, int rows, int fd);
+
+    void setColor(RenderColor color) override;
+    void clear() override;
+    void fillRects(const RenderRect *rects, int count) override;
+    void drawLine(int x1, int y1, int x2, int y2) override;
+    void drawText(const std::string &text, int x, int y, RenderColor color) override;
+    void getTextSize(const std::string &text, int &width, int &height) override;
+    void beginStaticLayer() override;
+    void endStaticLayer() override;
+    void drawStaticLayer() override;
+    // 比较前后缓冲区，生成输出并写出
+    void present() override;
+
+    // 下一帧重新输出所有字符 (例如终端内容被破坏之后)
+    void invalidate();
+    // 每帧都重新输出所有字符，用于和差分输出对比
+    void setFullRedraw(bool fullRedraw);
+    // 最近一帧的输出、字节数和变化的字符数
+    const std::string &getOutput() const;
+    size_t getLastFrameBytes() const;
+    int getLastChangedCells() const;
+
+private:
+    // 一个字符格子：字符、前景色和背景色 (xterm 256 色)
+    struct Cell
+    {
+        char ch;
+        uint8_t fg;
+        uint8_t bg;
+        bool operator!=(const Cell &other) const
+        {
+            return ch != other.ch || fg != other.fg || bg != other.bg;
+        }
+    };
+
+    int mColumns;
+    int mRows;
+    int mFd;
+    uint8_t mColor = 16;
+    std::vector<Cell> mBack;        // 正在绘制的画面
+    std::vector<Cell> mFront;       // 终端上当前显示的画面
+    std::vector<Cell> mStaticLayer; // 静态层
+    bool mRecordingStatic = false;
+    bool mFullRedraw = false;
+    std::string mOutput;
+    int mChangedCells = 0;
+
+    // 终端当前的光标位置和颜色，-1 表示未知
+    int mCursorColumn = -1;
+    int mCursorRow = -1;
+    int mCurrentFg = -1;
+    int mCurrentBg = -1;
+
+    // 把 RGB 颜色转换成最接近的 xterm 256 色
+    static uint8_t toColorIndex(RenderColor color);
+    // 像素坐标转换成字符坐标
+    static int toColumn(int x);
+    static int toRow(int y);
+    void putCell(int column, int row, char ch, uint8_t fg, uint8_t bg);
+    // 把光标移动到 (column, row)，选择最短的转义序列
+    void moveCursor(int column, int row);
+    void setCellColor(uint8_t fg, uint8_t bg);
+    void writeOutput();
+};
+
+#endif
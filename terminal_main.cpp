@@ -0,0 +1,237 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <csignal>
+#include <cstdlib>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#include "simulation.h"
+#include "board_renderer.h"
+#include "terminal_backend.h"
+#include "leader_board.h"
+
+// 画面和游戏区域 (像素)，与 Game 相同；终端中一个格子占 2 列 1 行
+const int SCREEN_WIDTH = WINDOW_WIDTH;
+const int SCREEN_HEIGHT = WINDOW_HEIGHT;
+const int BOARD_WIDTH = WINDOW_WIDTH - 10 * GRID_SIZE;
+const int BOARD_HEIGHT = WINDOW_HEIGHT - 2 * GRID_SIZE;
+const int TERMINAL_COLUMNS = SCREEN_WIDTH * 2 / GRID_SIZE;
+const int TERMINAL_ROWS = SCREEN_HEIGHT / GRID_SIZE;
+const int FRAME_MILLIS = 33;
+
+static struct termios gSavedTermios;
+static volatile sig_atomic_t gResized = 0;
+static volatile sig_atomic_t gTerminated = 0;
+
+// 打印用法
+static void printUsage()
+{
+    std::cout << "用法: snaketerm [--mode bounded|unbounded] [--difficulty easy|hard] [--map empty|obstacles]\n"
+                 "                 [--foods 数量] [--food-lifetime 秒] [--seed 种子]"
+              << std::endl;
+}
+
+static void onResize(int)
+{
+    gResized = 1;
+}
+
+static void onTerminate(int)
+{
+    gTerminated = 1;
+}
+
+// 进入原始模式和备用屏幕，隐藏光标
+static bool enterTerminal()
+{
+    if (tcgetattr(STDIN_FILENO, &gSavedTermios) != 0)
+    {
+        return false;
+    }
+    struct termios raw = gSavedTermios;
+    raw.c_lflag &= ~(ICANON | ECHO | ISIG | IEXTEN);
+    raw.c_iflag &= ~(IXON | ICRNL);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) != 0)
+    {
+        return false;
+    }
+    const std::string setup = "\x1b[?1049h\x1b[?25l\x1b[2J";
+    return write(STDOUT_FILENO, setup.data(), setup.size()) == static_cast<ssize_t>(setup.size());
+}
+
+// 恢复终端
+static void leaveTerminal()
+{
+    const std::string restore = "\x1b[0m\x1b[?25h\x1b[?1049l";
+    if (write(STDOUT_FILENO, restore.data(), restore.size()) < 0)
+    {
+        // 终端已经关闭，忽略
+    }
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &gSavedTermios);
+}
+
+// 终端版入口：原始模式读取按键，差分输出游戏画面
+int main(int argc, char **argv)
+{
+    GameMode mode = GameMode::Bounded;
+    Difficulty difficulty = Difficulty::Easy;
+    MapType mapType = MapType::Empty;
+    int foods = 1;
+    float foodLifetime = 0.0f;
+    uint64_t seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        std::string value = (i + 1 < argc) ? argv[i + 1] : "";
+        if (arg == "--mode")
+            mode = (value == "unbounded") ? GameMode::Unbounded : GameMode::Bounded;
+        else if (arg == "--difficulty")
+            difficulty = (value == "hard") ? Difficulty::Hard : Difficulty::Easy;
+        else if (arg == "--map")
+            mapType = (value == "obstacles") ? MapType::Obstacles : MapType::Empty;
+        else if (arg == "--foods")
+            foods = std::atoi(value.c_str());
+        else if (arg == "--food-lifetime")
+            foodLifetime = static_cast<float>(std::atof(value.c_str()));
+        else if (arg == "--seed")
+            seed = std::strtoull(value.c_str(), nullptr, 10);
+        else
+        {
+            printUsage();
+            return 1;
+        }
+        i++;
+    }
+
+    struct winsize size;
+    if (!isatty(STDIN_FILENO) || ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0)
+    {
+        std::cerr << "需要在终端中运行" << std::endl;
+        return 1;
+    }
+    if (size.ws_col < TERMINAL_COLUMNS || size.ws_row < TERMINAL_ROWS)
+    {
+        std::cerr << "终端至少需要 " << TERMINAL_COLUMNS << "x" << TERMINAL_ROWS << " 个字符，当前为 "
+                  << size.ws_col << "x" << size.ws_row << std::endl;
+        return 1;
+    }
+
+    Simulation simulation(BOARD_WIDTH, BOARD_HEIGHT, 2);
+    simulation.setFoodOptions(foods, static_cast<uint32_t>(foodLifetime / EFFECT_TICK_SECONDS));
+    simulation.reset(mode, difficulty, mapType, seed);
+    // 按实际经过的时间推进：进程被挂起 (Ctrl+Z) 之后恢复时不一下子追赶很多步
+    simulation.setMaxTickTime(Simulation::STALL_TICK_TIME);
+
+    TerminalRenderBackend backend(TERMINAL_COLUMNS, TERMINAL_ROWS, STDOUT_FILENO);
+    BoardRenderer boardRenderer(backend, SCREEN_WIDTH, SCREEN_HEIGHT, BOARD_WIDTH, BOARD_HEIGHT);
+    // 排行榜只读取显示，不写入
+    LeaderBoard leaderBoard("record.dat", 3);
+    leaderBoard.read();
+    boardRenderer.renderStaticLayer(leaderBoard.getScores());
+
+    if (!enterTerminal())
+    {
+        std::cerr << "无法设置终端" << std::endl;
+        return 1;
+    }
+    std::signal(SIGWINCH, onResize);
+    std::signal(SIGTERM, onTerminate);
+    std::signal(SIGHUP, onTerminate);
+
+    auto startTime = std::chrono::steady_clock::now();
+    auto lastTime = startTime;
+    bool quit = false;
+    while (!quit && !gTerminated)
+    {
+        auto frameStart = std::chrono::steady_clock::now();
+        uint64_t timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(frameStart - startTime).count();
+
+        // 读取这一帧的所有按键
+        char buffer[64];
+        ssize_t count = read(STDIN_FILENO, buffer, sizeof(buffer));
+        for (ssize_t i = 0; i < count; i++)
+        {
+            char key = buffer[i];
+            if (key == '\x1b' && i + 2 < count && buffer[i + 1] == '[')
+            {
+                key = buffer[i + 2];
+                i += 2;
+                if (key == 'A')
+                    simulation.addDirectionToQueue(Direction::Up, timestamp);
+                else if (key == 'B')
+                    simulation.addDirectionToQueue(Direction::Down, timestamp);
+                else if (key == 'D')
+                    simulation.addDirectionToQueue(Direction::Left, timestamp);
+                else if (key == 'C')
+                    simulation.addDirectionToQueue(Direction::Right, timestamp);
+            }
+            else if (key == 'w' || key == 'W')
+                simulation.addDirectionToQueue(Direction::Up, timestamp);
+            else if (key == 's' || key == 'S')
+                simulation.addDirectionToQueue(Direction::Down, timestamp);
+            else if (key == 'a' || key == 'A')
+                simulation.addDirectionToQueue(Direction::Left, timestamp);
+            else if (key == 'd' || key == 'D')
+                simulation.addDirectionToQueue(Direction::Right, timestamp);
+            else if (key == ' ' && !simulation.isGameOver())
+                simulation.togglePause();
+            else if (key == 'q' || key == 'Q' || key == '\x03')
+                quit = true;
+            else if ((key == 'r' || key == 'R') && simulation.isGameOver())
+            {
+                simulation.reset(mode, difficulty, mapType, seed + timestamp);
+                leaderBoard.read();
+                boardRenderer.renderStaticLayer(leaderBoard.getScores());
+            }
+        }
+
+        // 终端大小改变后重新输出整个画面
+        if (gResized)
+        {
+            gResized = 0;
+            const std::string clearScreen = "\x1b[0m\x1b[2J";
+            if (write(STDOUT_FILENO, clearScreen.data(), clearScreen.size()) < 0)
+            {
+                break;
+            }
+            backend.invalidate();
+        }
+
+        float deltaTime = std::chrono::duration<float>(frameStart - lastTime).count();
+        lastTime = frameStart;
+        if (!simulation.isGameOver())
+        {
+            simulation.tick(deltaTime);
+        }
+
+        if (simulation.isGameOver())
+        {
+            // 游戏结束：在最后的画面上叠加提示
+            backend.setColor({0x00, 0x00, 0x00, 0xFF});
+            backend.clear();
+            backend.drawStaticLayer();
+            BoardSnapshot snapshot;
+            snapshot.capture(simulation);
+            boardRenderer.renderDynamic(snapshot);
+            backend.drawText("Game Over!  R: restart  Q: quit", BOARD_WIDTH / 4, BOARD_HEIGHT / 2, {0xFF, 0xFF, 0xFF, 0xFF});
+            backend.present();
+        }
+        else
+        {
+            boardRenderer.renderFrame(simulation);
+        }
+
+        auto frameTime = std::chrono::steady_clock::now() - frameStart;
+        std::this_thread::sleep_for(std::chrono::milliseconds(FRAME_MILLIS) - frameTime);
+    }
+
+    leaveTerminal();
+    std::cout << "得分: " << simulation.getPoints() << std::endl;
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include <algorithm>
+
+#include "timer_wheel.h"
+
+// 构造函数
+TimerWheel::TimerWheel()
+{
+    clear();
+}
+
+// 清空所有定时器
+void TimerWheel::clear()
+{
+    mNodes.clear();
+    mFreeList.clear();
+    for (int bucket = 0; bucket < LEVELS * SLOTS; bucket++)
+    {
+        mSlots[bucket] = NIL;
+    }
+    mNow = 0;
+    mSize = 0;
+}
+
+// 预先分配节点池
+void TimerWheel::reserve(size_t count)
+{
+    mNodes.reserve(count);
+    mFreeList.reserve(count);
+}
+
+// 根据剩余时间选择层，根据到期时间选择槽
+int TimerWheel::slotFor(uint64_t expires) const
+{
+    uint64_t delta = expires - mNow;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (1ULL << (SLOT_BITS * (level + 1))))
+    {
+        level++;
+    }
+    return level * SLOTS + static_cast<int>((expires >> (SLOT_BITS * level)) & (SLOTS - 1));
+}
+
+// 把节点插入到对应槽的链表头部
+void TimerWheel::insert(int32_t index)
+{
+    int bucket = slotFor(mNodes[index].expires);
+    int32_t &head = mSlots[bucket];
+    mNodes[index].bucket = static_cast<uint16_t>(bucket);
+    mNodes[index].prev = NIL;
+    mNodes[index].next = head;
+    if (head != NIL)
+    {
+        mNodes[head].prev = index;
+    }
+    head = index;
+}
+
+// 从链表中移除节点
+void TimerWheel::unlink(int32_t index)
+{
+    Node &node = mNodes[index];
+    if (node.prev != NIL)
+    {
+        mNodes[node.prev].next = node.next;
+    }
+    else
+    {
+        mSlots[node.bucket] = node.next;
+    }
+    if (node.next != NIL)
+    {
+        mNodes[node.next].prev = node.prev;
+    }
+}
+
+// 添加定时器
+TimerWheel::TimerId TimerWheel::schedule(uint32_t delayTicks, uint32_t payload)
+{
+    const uint64_t maxDelay = (1ULL << (SLOT_BITS * LEVELS)) - 1;
+    uint64_t delay = delayTicks < 1 ? 1 : delayTicks;
+    if (delay > maxDelay)
+    {
+        delay = maxDelay;
+    }
+
+    int32_t index;
+    if (!mFreeList.empty())
+    {
+        index = mFreeList.back();
+        mFreeList.pop_back();
+    }
+    else
+    {
+        index = static_cast<int32_t>(mNodes.size());
+        mNodes.push_back(Node());
+    }
+    Node &node = mNodes[index];
+    node.expires = mNow + delay;
+    node.payload = payload;
+    node.active = true;
+    insert(index);
+    mSize++;
+    return static_cast<TimerId>(index);
+}
+
+// 取消定时器
+bool TimerWheel::cancel(TimerId id)
+{
+    if (id >= mNodes.size() || !mNodes[id].active)
+    {
+        return false;
+    }
+    unlink(static_cast<int32_t>(id));
+    mNodes[id].active = false;
+    mFreeList.push_back(static_cast<int32_t>(id));
+    mSize--;
+    return true;
+}
+
+// 把高层当前槽中的定时器重新插入，它们的剩余时间已经小于这一层的跨度
+void TimerWheel::cascade(int level)
+{
+    int32_t &head = mSlots[level * SLOTS + ((mNow >> (SLOT_BITS * level)) & (SLOTS - 1))];
+    int32_t index = head;
+    head = NIL;
+    while (index != NIL)
+    {
+        int32_t next = mNodes[index].next;
+        insert(index);
+        index = next;
+    }
+}
+
+// 前进 ticks 帧
+void TimerWheel::advance(uint32_t ticks, std::vector<uint32_t> &expired)
+{
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        mNow++;
+        // 低层转完一圈时，从高到低把上一层的槽分配下来
+        int levels = 0;
+        while (levels < LEVELS - 1 && ((mNow >> (SLOT_BITS * (levels + 1) - SLOT_BITS)) & (SLOTS - 1)) == 0)
+        {
+            levels++;
+        }
+        for (int level = levels; level >= 1; level--)
+        {
+            cascade(level);
+        }
+
+        // 第 0 层当前槽中的定时器全部到期
+        const size_t first = expired.size();
+        int32_t &head = mSlots[mNow & (SLOTS - 1)];
+        int32_t index = head;
+        head = NIL;
+        while (index != NIL)
+        {
+            Node &node = mNodes[index];
+            int32_t next = node.next;
+            expired.push_back(node.payload);
+            node.active = false;
+            mFreeList.push_back(index);
+            mSize--;
+            index = next;
+        }
+        // 槽中的链表顺序取决于添加和下放的经过，按 payload 排序使同一帧到期的顺序只由定时器本身决定
+        std::sort(expired.begin() + first, expired.end());
+    }
+}
+
+uint64_t TimerWheel::getNow() const
+{
+    return mNow;
+}
+
+void TimerWheel::setNow(uint64_t now)
+{
+    mNow = now;
+}
+
+size_t TimerWheel::size() const
+{
+    return mSize;
+}
@@ -0,0 +1,81 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 分层时间轮，以模拟帧 (tick) 为单位
+// 4 层，每层 64 个槽，最长定时 2^24 帧；添加、取消和到期都是 O(1)
+// 定时器保存在节点池中，用下标组成双向链表，稳定运行时不分配内存
+class TimerWheel
+{
+public:
+    typedef uint32_t TimerId;
+    static const TimerId INVALID_TIMER = 0xFFFFFFFF;
+
+    TimerWheel();
+    // 清空所有定时器，当前时间归零 (保留节点池的内存)
+    void clear();
+    // 预先分配 count 个定时器的节点池
+    void reserve(size_t count);
+    // 在 delayTicks 帧之后到期 (至少 1 帧)，payload 由调用者解释
+    TimerId schedule(uint32_t delayTicks, uint32_t payload);
+    // 取消定时器，定时器已经到期或不存在时返回 false
+    bool cancel(TimerId id);
+    // 前进 ticks 帧，把到期定时器的 payload 追加到 expired
+    // 按到期的帧排列，同一帧到期的按 payload 从小到大排列 (与添加顺序和从快照恢复无关)
+    void advance(uint32_t ticks, std::vector<uint32_t> &expired);
+
+    // 当前时间 (帧)
+    uint64_t getNow() const;
+    // 设置当前时间，只能在没有定时器时调用 (用于从快照恢复)
+    void setNow(uint64_t now);
+    // 活动的定时器数量
+    size_t size() const;
+    // 遍历所有活动的定时器：callback(剩余帧数, payload)
+    template <typename Callback>
+    void forEach(Callback callback) const
+    {
+        for (const auto &node : mNodes)
+        {
+            if (node.active)
+            {
+                callback(static_cast<uint32_t>(node.expires - mNow), node.payload);
+            }
+        }
+    }
+
+private:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int32_t NIL = -1;
+
+    struct Node
+    {
+        uint64_t expires;
+        uint32_t payload;
+        int32_t prev;
+        int32_t next;
+        // 所在的槽 (层 * SLOTS + 槽)：取消时按这里找到链表头，
+        // 不能按到期时间重新计算，高层的定时器在下放之前剩余时间已经小于这一层的跨度
+        uint16_t bucket;
+        bool active;
+    };
+
+    std::vector<Node> mNodes;
+    std::vector<int32_t> mFreeList;
+    int32_t mSlots[LEVELS * SLOTS];
+    uint64_t mNow = 0;
+    size_t mSize = 0;
+
+    // 按照到期时间把节点放入对应的层和槽
+    void insert(int32_t index);
+    void unlink(int32_t index);
+    int slotFor(uint64_t expires) const;
+    // 把第 level 层当前槽中的定时器重新分配到低层
+    void cascade(int level);
+};
+
+#endif
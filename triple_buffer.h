@@ -0,0 +1,58 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// 无锁三缓冲：一个写线程和一个读线程，各自独占一个缓冲区，第三个缓冲区用于交换
+// 写线程写完后把自己的缓冲区和中间的缓冲区交换 (publish)；读线程在有新数据时把自己的缓冲区和中间的交换 (update)
+// 双方都不会等待对方，读线程总是读到最近一次完整发布的数据，中间没有被读到的数据直接被覆盖
+template <typename T>
+class TripleBuffer
+{
+public:
+    // 写线程：正在写的缓冲区
+    T &getWriteBuffer()
+    {
+        return mBuffers[mWriteIndex];
+    }
+    // 写线程：发布写好的缓冲区，之后 getWriteBuffer 返回另一个缓冲区 (内容是更早的数据，需要整体覆盖)
+    void publish()
+    {
+        uint8_t previous = mMiddle.exchange(static_cast<uint8_t>(mWriteIndex | FRESH), std::memory_order_acq_rel);
+        mWriteIndex = previous & INDEX_MASK;
+    }
+
+    // 读线程：取得最新发布的缓冲区，返回是否有新数据
+    bool update()
+    {
+        if ((mMiddle.load(std::memory_order_relaxed) & FRESH) == 0)
+        {
+            return false;
+        }
+        uint8_t previous = mMiddle.exchange(mReadIndex, std::memory_order_acq_rel);
+        mReadIndex = previous & INDEX_MASK;
+        return true;
+    }
+    // 读线程：当前读的缓冲区 (在下一次 update 之前不会被写线程修改)
+    const T &getReadBuffer() const
+    {
+        return mBuffers[mReadIndex];
+    }
+    // 初始化时两个线程都还没有开始，可以直接访问全部缓冲区 (例如预留内存)
+    T &getBuffer(int index)
+    {
+        return mBuffers[index];
+    }
+
+private:
+    static const uint8_t INDEX_MASK = 0x3;
+    static const uint8_t FRESH = 0x4; // 中间的缓冲区有读线程还没有取走的新数据
+
+    T mBuffers[3];
+    alignas(64) std::atomic<uint8_t> mMiddle{1};
+    alignas(64) uint8_t mWriteIndex = 0;
+    alignas(64) uint8_t mReadIndex = 2;
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+#include "snake.h"
+#include "cell_grid.h"
+
+// Zobrist 哈希：状态的每个成分 (蛇身占据的格子、蛇头、方向、每个食物的格子和类型、障碍物、每种特殊效果的层数)
+// 对应一个 64 位的键，状态的哈希是所有成分的键的异或；成分改变时异或掉旧键再异或上新键，更新是 O(1)
+// 键不查表，由成分种类和编号经 splitmix64 混合得到 (对不同的输入是双射，不会重复)，
+// 所有进程和所有大小的游戏区域都相同，也不占内存
+
+// 成分种类，与编号一起组成混合的输入
+enum class ZobristKind : uint64_t
+{
+    Body = 1,
+    Head = 2,
+    Direction = 3,
+    Food = 4,
+    Obstacle = 5,
+    Effect = 6
+};
+
+// splitmix64 的混合函数
+inline uint64_t zobristKey(ZobristKind kind, uint64_t index)
+{
+    uint64_t z = ((static_cast<uint64_t>(kind) << 48) | index) + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// 蛇身占据的格子 (包括蛇头)
+inline uint64_t zobristBody(CellIndex cell)
+{
+    return zobristKey(ZobristKind::Body, cell);
+}
+
+// 蛇头所在的格子，区分位置相同但朝向不同的蛇
+inline uint64_t zobristHead(CellIndex cell)
+{
+    return zobristKey(ZobristKind::Head, cell);
+}
+
+inline uint64_t zobristDirection(Direction direction)
+{
+    return zobristKey(ZobristKind::Direction, static_cast<uint64_t>(direction));
+}
+
+inline uint64_t zobristFood(CellIndex cell, FoodType type)
+{
+    return zobristKey(ZobristKind::Food, (static_cast<uint64_t>(cell) << 2) | static_cast<uint64_t>(type));
+}
+
+inline uint64_t zobristObstacle(CellIndex cell)
+{
+    return zobristKey(ZobristKind::Obstacle, cell);
+}
+
+// 某种特殊效果叠加了 count 层
+inline uint64_t zobristEffect(FoodType type, int count)
+{
+    return zobristKey(ZobristKind::Effect, (static_cast<uint64_t>(type) << 32) | static_cast<uint32_t>(count));
+}
+
+#endif